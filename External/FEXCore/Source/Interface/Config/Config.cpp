@@ -34,7 +34,7 @@ namespace FEXCore::Config {
       CTX->Config.TSOEnabled = Config != 0;
     break;
     case FEXCore::Config::CONFIG_SMC_CHECKS:
-      CTX->Config.SMCChecks = Config != 0;
+      CTX->Config.SMCChecks = static_cast<FEXCore::Config::ConfigSMCChecks>(Config);
     break;
     case FEXCore::Config::CONFIG_ABI_LOCAL_FLAGS:
       CTX->Config.ABILocalFlags = Config != 0;
@@ -51,6 +51,33 @@ namespace FEXCore::Config {
     case FEXCore::Config::CONFIG_AOTIR_LOAD:
       CTX->Config.AOTIRLoad = Config != 0;
     break;
+    case FEXCore::Config::CONFIG_SHARED_CODE_CACHE:
+      CTX->Config.SharedCodeCache = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_AOTCODE_GENERATE:
+      CTX->Config.AOTCodeCapture = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_AOTCODE_LOAD:
+      CTX->Config.AOTCodeLoad = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_COMPILE_THREADS:
+      CTX->Config.CompileThreads = Config;
+    break;
+    case FEXCore::Config::CONFIG_TIER_UP_THRESHOLD:
+      CTX->Config.TierUpThreshold = Config;
+    break;
+    case FEXCore::Config::CONFIG_HUGEPAGES:
+      CTX->Config.HugePages = static_cast<FEXCore::Config::ConfigHugePages>(Config);
+    break;
+    case FEXCore::Config::CONFIG_NUMA_LOCAL:
+      CTX->Config.NUMALocal = Config != 0;
+    break;
+    case FEXCore::Config::CONFIG_REGISTER_ALLOCATOR:
+      CTX->Config.RegisterAllocator = static_cast<FEXCore::Config::ConfigRegisterAllocator>(Config);
+    break;
+    case FEXCore::Config::CONFIG_X87_REDUCED_PRECISION:
+      CTX->Config.X87ReducedPrecision = Config != 0;
+    break;
     default: LogMan::Msg::A("Unknown configuration option");
     }
   }
@@ -113,6 +140,33 @@ namespace FEXCore::Config {
     case FEXCore::Config::CONFIG_AOTIR_LOAD:
       return CTX->Config.AOTIRLoad;
     break;
+    case FEXCore::Config::CONFIG_SHARED_CODE_CACHE:
+      return CTX->Config.SharedCodeCache;
+    break;
+    case FEXCore::Config::CONFIG_AOTCODE_GENERATE:
+      return CTX->Config.AOTCodeCapture;
+    break;
+    case FEXCore::Config::CONFIG_AOTCODE_LOAD:
+      return CTX->Config.AOTCodeLoad;
+    break;
+    case FEXCore::Config::CONFIG_COMPILE_THREADS:
+      return CTX->Config.CompileThreads;
+    break;
+    case FEXCore::Config::CONFIG_TIER_UP_THRESHOLD:
+      return CTX->Config.TierUpThreshold;
+    break;
+    case FEXCore::Config::CONFIG_HUGEPAGES:
+      return CTX->Config.HugePages;
+    break;
+    case FEXCore::Config::CONFIG_NUMA_LOCAL:
+      return CTX->Config.NUMALocal;
+    break;
+    case FEXCore::Config::CONFIG_REGISTER_ALLOCATOR:
+      return CTX->Config.RegisterAllocator;
+    break;
+    case FEXCore::Config::CONFIG_X87_REDUCED_PRECISION:
+      return CTX->Config.X87ReducedPrecision;
+    break;
     default: LogMan::Msg::A("Unknown configuration option");
     }
 
@@ -1,6 +1,7 @@
 #include "Common/Paths.h"
 #include "Interface/Context/Context.h"
 #include "Interface/Core/Core.h"
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/OpcodeDispatcher.h"
 
 #include <FEXCore/Config/Config.h>
@@ -66,6 +67,8 @@ namespace FEXCore::Context {
 
   void GetCPUState(FEXCore::Context::Context *CTX, FEXCore::Core::CPUState *State) {
     memcpy(State, &CTX->ParentThread->State.State, sizeof(FEXCore::Core::CPUState));
+    // Only the copy gets its flags calculated, the thread's own deferred state is left alone
+    FEXCore::CPU::CalculateDeferredFlags(State);
   }
 
   void SetCPUState(FEXCore::Context::Context *CTX, FEXCore::Core::CPUState *State) {
@@ -135,6 +138,10 @@ namespace FEXCore::Context {
       DeadThread->State.RunningEvents.Running = false;
     }
 
+    // Their host threads didn't come along in to the child, reusing one would join a thread that doesn't exist
+    // Left to leak, destroying them would join as well
+    CTX->IdleThreads.clear();
+
     // We now only have one thread
     CTX->IdleWaitRefCount = 1;
   }
@@ -151,7 +158,7 @@ namespace FEXCore::Context {
     return CTX->CPUID.RunFunction(Function);
   }
 
-  void SetAOTIRLoader(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::istream>(const std::string&)> CacheReader) {
+  void SetAOTIRLoader(FEXCore::Context::Context *CTX, std::function<int(const std::string&)> CacheReader) {
     CTX->AOTIRLoader = CacheReader;
   }
 
@@ -159,6 +166,14 @@ namespace FEXCore::Context {
     return CTX->WriteAOTIRCache(CacheWriter);
   }
 
+  void SetAOTCodeLoader(FEXCore::Context::Context *CTX, std::function<int(const std::string&)> CacheReader) {
+    CTX->AOTCodeLoader = CacheReader;
+  }
+
+  bool WriteAOTCode(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter) {
+    return CTX->WriteAOTCodeCache(CacheWriter);
+  }
+
   void AddNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, uintptr_t Offset, const std::string& Name) {
     return CTX->AddNamedRegion(Base, Length, Offset, Name);
   }
@@ -166,6 +181,28 @@ namespace FEXCore::Context {
     return CTX->RemoveNamedRegion(Base, Length);
   }
 
+  void GuestMemoryChangeBegin(FEXCore::Context::Context *CTX) {
+    CTX->GuestMemoryChangeBegin();
+  }
+  void GuestMemoryChangeEnd(FEXCore::Context::Context *CTX) {
+    CTX->GuestMemoryChangeEnd();
+  }
+  void GuestMemoryMapped(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, int Prot) {
+    CTX->GuestMemoryMapped(Base, Length, Prot);
+  }
+  void GuestMemoryProtected(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, int Prot) {
+    CTX->GuestMemoryProtected(Base, Length, Prot);
+  }
+  void GuestMemoryUnmapped(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length) {
+    CTX->GuestMemoryUnmapped(Base, Length);
+  }
+  void PrepareGuestMemoryHostWrite(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length) {
+    CTX->PrepareGuestMemoryHostWrite(Base, Length);
+  }
+  void InvalidateGuestCodeRange(FEXCore::Context::Context *CTX, uint64_t Base, uint64_t Length) {
+    CTX->InvalidateGuestCodeRange(Base, Length);
+  }
+
 namespace Debug {
   void CompileRIP(FEXCore::Context::Context *CTX, uint64_t RIP) {
     CTX->CompileRIP(CTX->ParentThread, RIP);
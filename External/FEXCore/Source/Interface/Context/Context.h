@@ -16,6 +16,7 @@
 #include <map>
 #include <set>
 #include <mutex>
+#include <shared_mutex>
 #include <istream>
 #include <ostream>
 #include <functional>
@@ -25,6 +26,11 @@ class ThunkHandler;
 class BlockSamplingData;
 class GdbServer;
 class SiganlDelegator;
+class SharedCodeCache;
+class AOTCodeCache;
+class CompilePool;
+class SMCTracker;
+class BlockRangeIndex;
 
 namespace CPU {
   class JITCore;
@@ -67,13 +73,36 @@ namespace FEXCore::Context {
 
       bool Is64BitMode {true};
       bool TSOEnabled {true};
-      bool SMCChecks {false};
+      // MTRACK write protects code pages instead of checking every instruction
+      FEXCore::Config::ConfigSMCChecks SMCChecks {FEXCore::Config::CONFIG_SMC_NONE};
       bool ABILocalFlags {false};
       bool ABINoPF {false};
 
       bool AOTIRCapture {false};
       bool AOTIRLoad {false};
 
+      // Relocatable host code cache, JIT only
+      bool AOTCodeCapture {false};
+      bool AOTCodeLoad {false};
+
+      // Share compiled code between all guest threads, JIT only
+      bool SharedCodeCache {false};
+
+      // Tiered compilation, needs the shared code cache
+      // Hot blocks are recompiled by a pool of this many threads, 0 disables tiering
+      uint32_t CompileThreads {0};
+      uint32_t TierUpThreshold {1000};
+
+      // Backing of code buffers and lookup tables, see HostMemory.h
+      FEXCore::Config::ConfigHugePages HugePages {FEXCore::Config::CONFIG_HUGEPAGES_NONE};
+      bool NUMALocal {false};
+
+      // JIT only, linear scan trades code quality for compile time
+      FEXCore::Config::ConfigRegisterAllocator RegisterAllocator {FEXCore::Config::CONFIG_RA_GRAPH};
+
+      // x87 stack holds host doubles and uses inline FP ops instead of the 80bit softfloat
+      bool X87ReducedPrecision {false};
+
       std::string DumpIR;
 
       // this is for internal use
@@ -90,8 +119,21 @@ namespace FEXCore::Context {
     uint64_t ThreadID{};
     FEXCore::Core::InternalThreadState* ParentThread;
     std::vector<FEXCore::Core::InternalThreadState*> Threads;
+    // Guest threads that exited, kept with their compiler state and code for CreateThread to hand out again
+    std::vector<FEXCore::Core::InternalThreadState*> IdleThreads;
     std::atomic_bool CoreShuttingDown{false};
 
+    // Only exists when Config.SharedCodeCache is enabled
+    std::unique_ptr<FEXCore::SharedCodeCache> SharedCache;
+    // Only exists when Config.CompileThreads is set
+    std::unique_ptr<FEXCore::CompilePool> CompileThreadPool;
+    // Held exclusively around guest syscalls that unmap or reprotect memory, shared by compile threads while they decode
+    std::shared_mutex GuestMemoryChangeLock;
+    // Guest code ranges of every block, for invalidating what a memory change touched
+    std::unique_ptr<FEXCore::BlockRangeIndex> BlockRanges;
+    // Only exists when Config.SMCChecks is CONFIG_SMC_MTRACK
+    std::unique_ptr<FEXCore::SMCTracker> SMCTracking;
+
     std::mutex IdleWaitMutex;
     std::condition_variable IdleWaitCV;
     std::atomic<uint32_t> IdleWaitRefCount{};
@@ -113,10 +155,29 @@ namespace FEXCore::Context {
       uint64_t crc;
       IR::IRListView *IR;
       IR::RegisterAllocationData *RAData;
+      // IR and RAData point in to the mapped cache file
+      bool Mapped;
     };
-    
-    std::function<std::unique_ptr<std::istream>(const std::string&)> AOTIRLoader;
-    std::unordered_map<std::string, std::map<uint64_t, AOTIRCacheEntry>> AOTIRCache;
+
+    struct AOTIRIndexEntry;
+
+    struct AOTIRModule {
+      // Cache file mapping, null if there wasn't a usable file
+      uint8_t *Base{};
+      size_t Size{};
+      AOTIRIndexEntry const *Index{};
+      uint64_t IndexCount{};
+      // Captured entries and mapped entries that have been looked up
+      std::map<uint64_t, AOTIRCacheEntry> Entries;
+    };
+
+    // Returns an fd for the AOTIR cache file of a module or -1
+    std::function<int(const std::string&)> AOTIRLoader;
+    std::unordered_map<std::string, AOTIRModule> AOTIRCache;
+
+    // Returns an fd for the host code cache file of a module or -1
+    std::function<int(const std::string&)> AOTCodeLoader;
+    std::unique_ptr<FEXCore::AOTCodeCache> AOTCode;
     
     struct AddrToFileEntry {
       uint64_t Start;
@@ -124,6 +185,7 @@ namespace FEXCore::Context {
       uint64_t Offset;
       std::string fileid;
       void *CachedFileEntry;
+      void *CachedCodeModule;
     };
 
     std::map<uint64_t, AddrToFileEntry> AddrToFile;
@@ -180,21 +242,43 @@ namespace FEXCore::Context {
     std::tuple<void *, FEXCore::IR::IRListView *, FEXCore::Core::DebugData *, FEXCore::IR::RegisterAllocationData *, bool, uint64_t, uint64_t> CompileCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
     uintptr_t CompileBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP);
 
-    bool LoadAOTIRCache(std::istream &stream);
+    bool LoadAOTIRCache(std::string const &fileid, int fd);
+    AOTIRCacheEntry *FindAOTIREntry(AOTIRModule *Module, uint64_t Offset);
     bool WriteAOTIRCache(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter);
+
+    bool WriteAOTCodeCache(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter);
+    void *LoadAOTCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t *StartAddr, uint64_t *Length);
+    void CaptureAOTCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t StartAddr, uint64_t Length, void *CodePtr, size_t CodeSize);
     // Used for thread creation from syscalls
     void InitializeCompiler(FEXCore::Core::InternalThreadState* State, bool CompileThread);
     FEXCore::Core::InternalThreadState* CreateThread(FEXCore::Core::CPUState *NewThreadState, uint64_t ParentTID);
+    void RecycleThread(FEXCore::Core::InternalThreadState *Thread);
     void InitializeThreadData(FEXCore::Core::InternalThreadState *Thread);
     void InitializeThread(FEXCore::Core::InternalThreadState *Thread);
     void CopyMemoryMapping(FEXCore::Core::InternalThreadState *ParentThread, FEXCore::Core::InternalThreadState *ChildThread);
     void RunThread(FEXCore::Core::InternalThreadState *Thread);
 
-    std::vector<FEXCore::Core::InternalThreadState*> *const GetThreads() { return &Threads; }
+    // Copy since threads leave the list when they exit, the thread objects themselves live as long as the context
+    std::vector<FEXCore::Core::InternalThreadState*> GetThreads() {
+      std::lock_guard<std::mutex> lk(ThreadCreationMutex);
+      return Threads;
+    }
 
     void AddNamedRegion(uintptr_t Base, uintptr_t Size, uintptr_t Offset, const std::string &filename);
     void RemoveNamedRegion(uintptr_t Base, uintptr_t Size);
 
+    /**
+     * @brief Erases every block compiled from guest code in the range, along with its links and IR
+     */
+    void InvalidateGuestCodeRange(uint64_t Base, uint64_t Size);
+
+    void GuestMemoryChangeBegin();
+    void GuestMemoryChangeEnd();
+    void GuestMemoryMapped(uintptr_t Base, uintptr_t Size, int Prot);
+    void GuestMemoryProtected(uintptr_t Base, uintptr_t Size, int Prot);
+    void GuestMemoryUnmapped(uintptr_t Base, uintptr_t Size);
+    void PrepareGuestMemoryHostWrite(uintptr_t Base, uintptr_t Size);
+
 #if ENABLE_JITSYMBOLS
     FEXCore::JITSymbols Symbols;
 #endif
@@ -208,7 +292,7 @@ namespace FEXCore::Context {
     void ExecutionThread(FEXCore::Core::InternalThreadState *Thread);
     void NotifyPause();
 
-    void AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr);
+    uintptr_t AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr);
 
     FEXCore::CodeLoader *LocalLoader{};
 
@@ -0,0 +1,428 @@
+#include "Common/MathUtils.h"
+#include "Interface/Context/Context.h"
+#include "Interface/Core/AOTCodeCache.h"
+
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <cstring>
+#include <dlfcn.h>
+#include <elf.h>
+#include <link.h>
+#include <sys/auxv.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+  // Host image offsets are taken relative to this function
+  // Its only job is to have an address inside of the FEXCore image
+  __attribute__((noinline)) void ImageAnchor() {
+    asm volatile("");
+  }
+
+  struct ImageIdentity {
+    uint8_t ID[32];
+    uint32_t Size;
+  };
+
+  int FindBuildID(struct dl_phdr_info *Info, size_t, void *Data) {
+    auto Identity = reinterpret_cast<ImageIdentity*>(Data);
+    uintptr_t Anchor = reinterpret_cast<uintptr_t>(&ImageAnchor);
+
+    bool ContainsAnchor = false;
+    for (size_t i = 0; i < Info->dlpi_phnum; ++i) {
+      auto const &Phdr = Info->dlpi_phdr[i];
+      uintptr_t Start = Info->dlpi_addr + Phdr.p_vaddr;
+      if (Phdr.p_type == PT_LOAD && Anchor >= Start && Anchor < (Start + Phdr.p_memsz)) {
+        ContainsAnchor = true;
+        break;
+      }
+    }
+
+    if (!ContainsAnchor) {
+      return 0;
+    }
+
+    for (size_t i = 0; i < Info->dlpi_phnum; ++i) {
+      auto const &Phdr = Info->dlpi_phdr[i];
+      if (Phdr.p_type != PT_NOTE) {
+        continue;
+      }
+
+      auto Note = reinterpret_cast<uint8_t const*>(Info->dlpi_addr + Phdr.p_vaddr);
+      auto NoteEnd = Note + Phdr.p_memsz;
+      while ((Note + sizeof(ElfW(Nhdr))) <= NoteEnd) {
+        auto Header = reinterpret_cast<ElfW(Nhdr) const*>(Note);
+        auto Name = Note + sizeof(ElfW(Nhdr));
+        auto Desc = Name + ((Header->n_namesz + 3) & ~3U);
+        if (Header->n_type == NT_GNU_BUILD_ID && Header->n_namesz == 4 && memcmp(Name, "GNU", 4) == 0 &&
+            (Desc + Header->n_descsz) <= NoteEnd) {
+          Identity->Size = std::min<uint32_t>(Header->n_descsz, sizeof(Identity->ID));
+          memcpy(Identity->ID, Desc, Identity->Size);
+          return 1;
+        }
+        Note = Desc + ((Header->n_descsz + 3) & ~3U);
+      }
+    }
+
+    // Found the image but it has no build-id
+    return 1;
+  }
+
+  ImageIdentity const &GetImageIdentity() {
+    static ImageIdentity Identity = []() {
+      ImageIdentity Result{};
+      dl_iterate_phdr(FindBuildID, &Result);
+
+      if (Result.Size == 0) {
+        // Built without a build-id, fall back to the identity of the file on disk
+        Dl_info Info{};
+        struct stat Stat{};
+        if (dladdr(reinterpret_cast<void*>(&ImageAnchor), &Info) && Info.dli_fname && stat(Info.dli_fname, &Stat) == 0) {
+          uint64_t Fallback[3] = { static_cast<uint64_t>(Stat.st_size), static_cast<uint64_t>(Stat.st_mtime), static_cast<uint64_t>(Stat.st_ino) };
+          memcpy(Result.ID, Fallback, sizeof(Fallback));
+          Result.Size = sizeof(Fallback);
+        }
+        else {
+          LogMan::Msg::D("AOTCode: Couldn't identify the FEXCore image");
+        }
+      }
+
+      return Result;
+    }();
+
+    return Identity;
+  }
+}
+
+namespace FEXCore::CPU {
+  uint64_t GetHostImageOffset(void const *Ptr) {
+    return reinterpret_cast<uintptr_t>(Ptr) - reinterpret_cast<uintptr_t>(&ImageAnchor);
+  }
+
+  bool ResolveRelocation(FEXCore::Context::Context *CTX, uint64_t GuestEntry, RelocationType Type, uint64_t Data, uint64_t *Value) {
+    switch (Type) {
+      case RelocationType::GUEST_ENTRY:
+        *Value = GuestEntry + static_cast<int64_t>(Data);
+        return true;
+      case RelocationType::HOST_IMAGE:
+        *Value = reinterpret_cast<uintptr_t>(&ImageAnchor) + Data;
+        return true;
+      case RelocationType::CONTEXT:
+        *Value = reinterpret_cast<uintptr_t>(CTX) + Data;
+        return true;
+      case RelocationType::SYSCALL_HANDLER:
+        *Value = reinterpret_cast<uintptr_t>(CTX->SyscallHandler) + Data;
+        return true;
+      case RelocationType::THREAD_POINTER:
+      default:
+        return false;
+    }
+  }
+
+  void ApplyRelocation(uint8_t *Code, Relocation const &Reloc, uint64_t Value) {
+    uint8_t *Location = Code + Reloc.Offset;
+    switch (Reloc.Encoding) {
+      case RelocationEncoding::ABS64:
+        memcpy(Location, &Value, sizeof(Value));
+        break;
+      case RelocationEncoding::ARM64_MOVZ_MOVK:
+        for (size_t i = 0; i < 4; ++i) {
+          uint32_t Instr;
+          memcpy(&Instr, Location + i * 4, sizeof(Instr));
+          Instr = (Instr & ~(0xFFFFU << 5)) | (((Value >> (16 * i)) & 0xFFFF) << 5);
+          memcpy(Location + i * 4, &Instr, sizeof(Instr));
+        }
+        break;
+      default:
+        LogMan::Msg::A("Unknown relocation encoding: %d", static_cast<int>(Reloc.Encoding));
+        break;
+    }
+  }
+}
+
+namespace FEXCore {
+  constexpr static uint64_t AOTCODE_MAGIC = 0x45444F43'544F4146ULL; // "FAOTCODE"
+  constexpr static uint32_t AOTCODE_VERSION = 2;
+
+  // Config the code was generated with, loading code built for another config silently changes behaviour
+  struct CodegenConfig {
+    uint8_t Core;
+    uint8_t RegisterAllocator;
+    uint8_t SMCChecks;
+    uint8_t SRA;
+    uint8_t Multiblock;
+    uint8_t TSOEnabled;
+    uint8_t ABILocalFlags;
+    uint8_t ABINoPF;
+    uint8_t Is64BitMode;
+    uint8_t X87ReducedPrecision;
+    uint8_t SharedCodeCache;
+    uint8_t Tiered;
+    uint8_t Pad[4];
+  };
+  static_assert(sizeof(CodegenConfig) == 16, "Written to disk as is");
+
+  struct AOTCodeCache::FileHeader {
+    uint64_t Magic;
+    uint32_t Version;
+    uint32_t ImageIDSize;
+    uint8_t ImageID[32];
+    uint64_t HostCaps[2];
+    CodegenConfig Config;
+    uint64_t NumEntries;
+    uint64_t FileSize;
+  };
+
+  struct AOTCodeCache::FileEntry {
+    uint64_t Offset;
+    uint64_t Start;
+    uint64_t Length;
+    uint64_t Hash;
+    uint64_t CodeOffset;
+    uint64_t CodeSize;
+    uint64_t RelocOffset;
+    uint64_t NumRelocs;
+  };
+
+  AOTCodeCache::AOTCodeCache(FEXCore::Context::Context *CTX)
+    : CTX {CTX} {
+  }
+
+  AOTCodeCache::~AOTCodeCache() {
+    for (auto &[fileid, Module] : Mapped) {
+      if (Module.Base) {
+        munmap(const_cast<uint8_t*>(Module.Base), Module.Size);
+      }
+    }
+  }
+
+  bool AOTCodeCache::LoadModule(std::string const &fileid, int fd) {
+    std::lock_guard<std::mutex> lk(CacheLock);
+
+    if (Mapped.contains(fileid)) {
+      return Mapped[fileid].Base != nullptr;
+    }
+
+    // Remember the failure so the file isn't opened again
+    auto &Module = Mapped[fileid];
+    Module = {};
+
+    struct stat Stat{};
+    if (fd == -1 || fstat(fd, &Stat) != 0 || static_cast<size_t>(Stat.st_size) < sizeof(FileHeader)) {
+      return false;
+    }
+
+    auto Base = reinterpret_cast<uint8_t const*>(mmap(nullptr, Stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+    if (Base == MAP_FAILED) {
+      return false;
+    }
+
+    FileHeader Expected{};
+    FillHeader(&Expected, 0, 0);
+
+    auto Header = reinterpret_cast<FileHeader const*>(Base);
+    if (Header->Magic != Expected.Magic ||
+        Header->Version != Expected.Version ||
+        Header->ImageIDSize != Expected.ImageIDSize ||
+        memcmp(Header->ImageID, Expected.ImageID, sizeof(Expected.ImageID)) != 0 ||
+        memcmp(Header->HostCaps, Expected.HostCaps, sizeof(Expected.HostCaps)) != 0 ||
+        memcmp(&Header->Config, &Expected.Config, sizeof(Expected.Config)) != 0 ||
+        Header->FileSize != static_cast<uint64_t>(Stat.st_size) ||
+        Header->NumEntries > ((Stat.st_size - sizeof(FileHeader)) / sizeof(FileEntry))) {
+      LogMan::Msg::D("AOTCode: Ignoring stale cache for %s", fileid.c_str());
+      munmap(const_cast<uint8_t*>(Base), Stat.st_size);
+      return false;
+    }
+
+    Module.Base = Base;
+    Module.Size = Stat.st_size;
+    Module.Entries = reinterpret_cast<FileEntry const*>(Base + sizeof(FileHeader));
+    Module.NumEntries = Header->NumEntries;
+
+    LogMan::Msg::D("AOTCode: Module %s has %ld blocks", fileid.c_str(), Module.NumEntries);
+    return true;
+  }
+
+  void *AOTCodeCache::GetModule(std::string const &fileid) {
+    std::lock_guard<std::mutex> lk(CacheLock);
+    auto it = Mapped.find(fileid);
+    if (it == Mapped.end() || it->second.Base == nullptr) {
+      return nullptr;
+    }
+    return &it->second;
+  }
+
+  bool AOTCodeCache::HasModule(std::string const &fileid) {
+    std::lock_guard<std::mutex> lk(CacheLock);
+    return Mapped.contains(fileid);
+  }
+
+  bool AOTCodeCache::FindEntry(void *Module, uint64_t Offset, Entry *Out) const {
+    auto Mod = reinterpret_cast<MappedModule const*>(Module);
+    auto End = Mod->Entries + Mod->NumEntries;
+    auto it = std::lower_bound(Mod->Entries, End, Offset, [](FileEntry const &Entry, uint64_t Offset) {
+      return Entry.Offset < Offset;
+    });
+
+    if (it == End || it->Offset != Offset) {
+      return false;
+    }
+
+    // The index is only validated as a whole on load, check the entry before handing out pointers in to the file
+    if (it->CodeOffset > Mod->Size || it->CodeSize > (Mod->Size - it->CodeOffset) ||
+        it->RelocOffset > Mod->Size || it->NumRelocs > ((Mod->Size - it->RelocOffset) / sizeof(CPU::Relocation)) ||
+        (it->RelocOffset % alignof(CPU::Relocation)) != 0) {
+      return false;
+    }
+
+    auto Relocations = reinterpret_cast<CPU::Relocation const*>(Mod->Base + it->RelocOffset);
+    for (size_t i = 0; i < it->NumRelocs; ++i) {
+      if (Relocations[i].Offset > it->CodeSize || (it->CodeSize - Relocations[i].Offset) < 16) {
+        return false;
+      }
+    }
+
+    Out->Start = it->Start;
+    Out->Length = it->Length;
+    Out->Hash = it->Hash;
+    Out->Code = Mod->Base + it->CodeOffset;
+    Out->CodeSize = it->CodeSize;
+    Out->Relocations = Relocations;
+    Out->NumRelocations = it->NumRelocs;
+    return true;
+  }
+
+  void AOTCodeCache::Capture(std::string const &fileid, uint64_t Offset, uint64_t Start, uint64_t Length, uint64_t Hash,
+                             void const *Code, size_t CodeSize, std::vector<CPU::Relocation> const &Relocations) {
+    std::lock_guard<std::mutex> lk(CacheLock);
+    auto &Mod = Captured[fileid];
+    if (Mod.contains(Offset)) {
+      return;
+    }
+
+    auto CodeStart = reinterpret_cast<uint8_t const*>(Code);
+    Mod.emplace(Offset, CapturedEntry{Start, Length, Hash, {CodeStart, CodeStart + CodeSize}, Relocations});
+  }
+
+  bool AOTCodeCache::Write(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter) {
+    std::lock_guard<std::mutex> lk(CacheLock);
+
+    bool rv = true;
+
+    for (auto &[fileid, Entries] : Captured) {
+      if (Entries.empty()) {
+        continue;
+      }
+
+      // Blocks that were loaded from the old file are never captured again, carry them over
+      auto OldModule = Mapped.find(fileid);
+      if (OldModule != Mapped.end() && OldModule->second.Base) {
+        for (size_t i = 0; i < OldModule->second.NumEntries; ++i) {
+          uint64_t Offset = OldModule->second.Entries[i].Offset;
+          Entry Old;
+          if (!Entries.contains(Offset) && FindEntry(&OldModule->second, Offset, &Old)) {
+            Entries.emplace(Offset, CapturedEntry{Old.Start, Old.Length, Old.Hash, {Old.Code, Old.Code + Old.CodeSize},
+                                                  {Old.Relocations, Old.Relocations + Old.NumRelocations}});
+          }
+        }
+      }
+
+      // Lay out the data section first so the index can be written in one go
+      std::vector<FileEntry> Index;
+      Index.reserve(Entries.size());
+      uint64_t DataOffset = sizeof(FileHeader) + Entries.size() * sizeof(FileEntry);
+      for (auto &[Offset, Entry] : Entries) {
+        FileEntry IndexEntry{};
+        IndexEntry.Offset = Offset;
+        IndexEntry.Start = Entry.Start;
+        IndexEntry.Length = Entry.Length;
+        IndexEntry.Hash = Entry.Hash;
+
+        DataOffset = AlignUp(DataOffset, 16);
+        IndexEntry.CodeOffset = DataOffset;
+        IndexEntry.CodeSize = Entry.Code.size();
+        DataOffset += Entry.Code.size();
+
+        DataOffset = AlignUp(DataOffset, alignof(CPU::Relocation));
+        IndexEntry.RelocOffset = DataOffset;
+        IndexEntry.NumRelocs = Entry.Relocations.size();
+        DataOffset += Entry.Relocations.size() * sizeof(CPU::Relocation);
+
+        Index.emplace_back(IndexEntry);
+      }
+
+      auto stream = CacheWriter(fileid);
+      if (!*stream) {
+        rv = false;
+        continue;
+      }
+
+      FileHeader Header{};
+      FillHeader(&Header, Index.size(), DataOffset);
+      stream->write(reinterpret_cast<char const*>(&Header), sizeof(Header));
+      stream->write(reinterpret_cast<char const*>(Index.data()), Index.size() * sizeof(FileEntry));
+
+      uint64_t Written = sizeof(FileHeader) + Index.size() * sizeof(FileEntry);
+      auto Pad = [&](uint64_t Offset) {
+        static char const Zero[16]{};
+        stream->write(Zero, Offset - Written);
+        Written = Offset;
+      };
+
+      size_t i = 0;
+      for (auto &[Offset, Entry] : Entries) {
+        Pad(Index[i].CodeOffset);
+        stream->write(reinterpret_cast<char const*>(Entry.Code.data()), Entry.Code.size());
+        Written += Entry.Code.size();
+
+        Pad(Index[i].RelocOffset);
+        stream->write(reinterpret_cast<char const*>(Entry.Relocations.data()), Entry.Relocations.size() * sizeof(CPU::Relocation));
+        Written += Entry.Relocations.size() * sizeof(CPU::Relocation);
+        ++i;
+      }
+
+      if (!*stream) {
+        rv = false;
+      }
+    }
+
+    return rv;
+  }
+
+  void AOTCodeCache::FillHeader(FileHeader *Header, uint64_t NumEntries, uint64_t FileSize) const {
+    auto const &Identity = GetImageIdentity();
+    Header->Magic = AOTCODE_MAGIC;
+    Header->Version = AOTCODE_VERSION;
+    Header->ImageIDSize = Identity.Size;
+    memcpy(Header->ImageID, Identity.ID, sizeof(Header->ImageID));
+    // Code is generated for the features of the host it was captured on
+    Header->HostCaps[0] = getauxval(AT_HWCAP);
+    Header->HostCaps[1] = getauxval(AT_HWCAP2);
+
+#if _M_ARM_64
+    constexpr bool DoSRA = true;
+#else
+    constexpr bool DoSRA = false;
+#endif
+
+    auto const &Config = CTX->Config;
+    Header->Config = {};
+    Header->Config.Core = Config.Core;
+    Header->Config.RegisterAllocator = Config.RegisterAllocator;
+    Header->Config.SMCChecks = Config.SMCChecks;
+    // Changes which guest registers live in host registers across blocks
+    Header->Config.SRA = DoSRA;
+    Header->Config.Multiblock = Config.Multiblock;
+    Header->Config.TSOEnabled = Config.TSOEnabled;
+    Header->Config.ABILocalFlags = Config.ABILocalFlags;
+    Header->Config.ABINoPF = Config.ABINoPF;
+    Header->Config.Is64BitMode = Config.Is64BitMode;
+    Header->Config.X87ReducedPrecision = Config.X87ReducedPrecision;
+    Header->Config.SharedCodeCache = Config.SharedCodeCache;
+    // Tier zero blocks are built without multiblock and count their entries
+    Header->Config.Tiered = Config.CompileThreads != 0;
+    Header->NumEntries = NumEntries;
+    Header->FileSize = FileSize;
+  }
+}
@@ -0,0 +1,171 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace FEXCore::Context {
+  struct Context;
+}
+
+namespace FEXCore::CPU {
+  /**
+   * @brief What a relocated value is relative to
+   */
+  enum class RelocationType : uint8_t {
+    GUEST_ENTRY,     ///< Data is a signed offset from the guest entry of the block
+    HOST_IMAGE,      ///< Data is an offset from an anchor inside of the FEXCore image
+    CONTEXT,         ///< Data is an offset from the Context
+    SYSCALL_HANDLER, ///< Data is an offset from the syscall handler
+    THREAD_POINTER,  ///< Data is a RelocationThreadPointer, only the backend knows these
+  };
+
+  /**
+   * @brief How a relocated value is encoded in the code
+   */
+  enum class RelocationEncoding : uint8_t {
+    ABS64,           ///< Raw 64bit value
+    ARM64_MOVZ_MOVK, ///< movz followed by three movk, one 16bit chunk each
+  };
+
+  /**
+   * @brief Per backend pointers that change between threads and runs
+   */
+  enum class RelocationThreadPointer : uint64_t {
+    LOOP_TOP,
+    EXIT_FUNCTION_LINKER,
+    THREAD_PAUSE_HANDLER,
+    THREAD_STOP_HANDLER,
+    SIGNAL_RETURN,
+  };
+
+  struct Relocation {
+    uint32_t Offset; ///< From the start of the block's host code
+    RelocationType Type;
+    RelocationEncoding Encoding;
+    uint16_t Pad;
+    uint64_t Data;
+  };
+  static_assert(sizeof(Relocation) == 16, "Relocations are written to disk as is");
+
+  /**
+   * @brief Returns the offset of a host pointer from the FEXCore image anchor
+   *
+   * Only valid for code and static data that is linked in to the same image as FEXCore
+   */
+  uint64_t GetHostImageOffset(void const *Ptr);
+
+  /**
+   * @brief Resolves every relocation type except THREAD_POINTER
+   *
+   * @return false if the type needs to be resolved by the backend
+   */
+  bool ResolveRelocation(FEXCore::Context::Context *CTX, uint64_t GuestEntry, RelocationType Type, uint64_t Data, uint64_t *Value);
+
+  /**
+   * @brief Patches Value in to Code using the encoding of the relocation
+   */
+  void ApplyRelocation(uint8_t *Code, Relocation const &Reloc, uint64_t Value);
+}
+
+namespace FEXCore {
+
+/**
+ * @brief Persistent cache of relocatable host code
+ *
+ * One file per module, keyed by the same fileid and guest code hash as the AOTIR cache.
+ * Files are mapped read only so they are shared through the page cache and only the pages of blocks that
+ * get used are ever read. Blocks are copied out to the thread's code buffer and relocated there, so the
+ * file never needs to be written to.
+ *
+ * A file is only accepted if it was written by the exact same FEXCore image since host function offsets
+ * and the generated code are only stable within a single build. Every config option that changes the
+ * generated code or the block ABI has to match as well.
+ *
+ * File layout
+ * FileHeader
+ * FileEntry[NumEntries] sorted by Offset
+ * Host code and relocations for each entry
+ */
+class AOTCodeCache final {
+public:
+  AOTCodeCache(FEXCore::Context::Context *CTX);
+  ~AOTCodeCache();
+
+  struct Entry {
+    uint64_t Start;  ///< Guest code range covered by the block, file relative
+    uint64_t Length;
+    uint64_t Hash;   ///< fasthash64 of the guest code range
+    uint8_t const *Code;
+    uint64_t CodeSize;
+    CPU::Relocation const *Relocations;
+    uint64_t NumRelocations;
+  };
+
+  /**
+   * @brief Maps the cache file of a module
+   *
+   * fd is only used during the call
+   *
+   * @return false if the file is malformed or belongs to a different build
+   */
+  bool LoadModule(std::string const &fileid, int fd);
+
+  /**
+   * @return Opaque module handle for FindEntry or nullptr if no file is mapped for fileid
+   */
+  void *GetModule(std::string const &fileid);
+
+  /**
+   * @brief Has a file already been looked for this fileid
+   */
+  bool HasModule(std::string const &fileid);
+
+  /**
+   * @brief Binary searches the module index, safe to call without any lock
+   *
+   * @param Offset File relative guest address of the block entry
+   */
+  bool FindEntry(void *Module, uint64_t Offset, Entry *Out) const;
+
+  void Capture(std::string const &fileid, uint64_t Offset, uint64_t Start, uint64_t Length, uint64_t Hash,
+               void const *Code, size_t CodeSize, std::vector<CPU::Relocation> const &Relocations);
+
+  bool Write(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter);
+
+private:
+  struct FileHeader;
+  struct FileEntry;
+
+  void FillHeader(FileHeader *Header, uint64_t NumEntries, uint64_t FileSize) const;
+
+  FEXCore::Context::Context *CTX;
+
+  struct MappedModule {
+    uint8_t const *Base;
+    size_t Size;
+    FileEntry const *Entries;
+    uint64_t NumEntries;
+  };
+
+  struct CapturedEntry {
+    uint64_t Start;
+    uint64_t Length;
+    uint64_t Hash;
+    std::vector<uint8_t> Code;
+    std::vector<CPU::Relocation> Relocations;
+  };
+
+  std::mutex CacheLock;
+  // A null Base marks a fileid that had no usable file so it isn't looked up again
+  std::unordered_map<std::string, MappedModule> Mapped;
+  std::unordered_map<std::string, std::map<uint64_t, CapturedEntry>> Captured;
+};
+}
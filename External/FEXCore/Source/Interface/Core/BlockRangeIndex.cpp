@@ -0,0 +1,141 @@
+#include "Interface/Context/Context.h"
+#include "Interface/Core/BlockRangeIndex.h"
+#include "Interface/Core/LookupCache.h"
+#include "Interface/Core/SharedCodeCache.h"
+
+#include <FEXCore/Debug/InternalThreadState.h>
+
+#include <algorithm>
+
+namespace FEXCore {
+  BlockRangeIndex::BlockRangeIndex(FEXCore::Context::Context *ctx)
+    : CTX {ctx} {
+  }
+
+  void BlockRangeIndex::AddBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t Start, uint64_t Length) {
+    Length = std::max<uint64_t>(Length, 1);
+    BlockKey Key{Thread, GuestRIP};
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    auto Existing = BlockLookup.find(Key);
+    if (Existing != BlockLookup.end()) {
+      Blocks.erase(Existing->second);
+      BlockLookup.erase(Existing);
+    }
+
+    BlockLookup[Key] = Blocks.emplace(Start, BlockEntry{Start + Length, Key});
+    MaxLength = std::max(MaxLength, Length);
+  }
+
+  size_t BlockRangeIndex::Invalidate(FEXCore::Core::InternalThreadState *Caller, uint64_t Base, uint64_t Length) {
+    uint64_t End = Base + Length;
+    size_t Erased{};
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    uint64_t SearchStart = Base > MaxLength ? Base - MaxLength : 0;
+    auto it = Blocks.lower_bound(SearchStart);
+    while (it != Blocks.end() && it->first < End) {
+      if (it->second.End <= Base) {
+        ++it;
+        continue;
+      }
+
+      auto Key = it->second.Key;
+      if (CTX->SharedCache) {
+        auto SharedBlocks = CTX->SharedCache->GetBlockCache();
+        std::scoped_lock<std::recursive_mutex> lk(SharedBlocks->GetLock());
+        SharedBlocks->Erase(Key.GuestRIP);
+      }
+      else if (Key.Thread == Caller) {
+        Key.Thread->LookupCache->Erase(Key.GuestRIP);
+      }
+      else {
+        // The owner may be running the block or its links, it erases the block itself once it gets back to the dispatcher
+        // Missing in its lookup tables sends it there the next time it looks the block up
+        Key.Thread->LookupCache->EvictFromLookup(Key.GuestRIP);
+      }
+
+      // Compile threads of the pool don't keep their IR
+      if (Key.Thread && !Key.Thread->IsCompileService) {
+        PendingErase[Key.Thread].emplace_back(Key.GuestRIP);
+        HasPendingErase.store(true, std::memory_order_release);
+      }
+
+      auto Next = std::next(it);
+      EraseBlock(it);
+      it = Next;
+      ++Erased;
+    }
+
+    return Erased;
+  }
+
+  void BlockRangeIndex::ErasePending(FEXCore::Core::InternalThreadState *Thread) {
+    if (!HasPendingErase.load(std::memory_order_acquire)) {
+      return;
+    }
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    auto it = PendingErase.find(Thread);
+    if (it == PendingErase.end()) {
+      return;
+    }
+
+    for (auto GuestRIP : it->second) {
+      if (!CTX->SharedCache) {
+        // Erasing twice is harmless if we invalidated the block ourselves
+        Thread->LookupCache->Erase(GuestRIP);
+      }
+      Thread->LocalIRCache.erase(GuestRIP);
+    }
+
+    PendingErase.erase(it);
+    HasPendingErase.store(!PendingErase.empty(), std::memory_order_release);
+  }
+
+  void BlockRangeIndex::ThreadExited(FEXCore::Core::InternalThreadState *Thread) {
+    std::scoped_lock<std::mutex> lk(Lock);
+
+    auto it = Blocks.begin();
+    while (it != Blocks.end()) {
+      auto Next = std::next(it);
+
+      if (it->second.Key.Thread == Thread) {
+        if (CTX->SharedCache) {
+          // The code stays mapped for the other threads, only the IR went away
+          BlockKey Orphan{nullptr, it->second.Key.GuestRIP};
+          uint64_t Start = it->first;
+          uint64_t End = it->second.End;
+
+          // Merge with the block another exited thread left behind
+          auto Existing = BlockLookup.find(Orphan);
+          if (Existing != BlockLookup.end()) {
+            Start = std::min(Start, Existing->second->first);
+            End = std::max(End, Existing->second->second.End);
+            if (Existing->second == Next) {
+              ++Next;
+            }
+            EraseBlock(Existing->second);
+          }
+
+          EraseBlock(it);
+          BlockLookup[Orphan] = Blocks.emplace(Start, BlockEntry{End, Orphan});
+        }
+        else {
+          EraseBlock(it);
+        }
+      }
+
+      it = Next;
+    }
+
+    PendingErase.erase(Thread);
+    HasPendingErase.store(!PendingErase.empty(), std::memory_order_release);
+  }
+
+  void BlockRangeIndex::EraseBlock(BlockMap::iterator it) {
+    // Must be called with Lock held
+    BlockLookup.erase(it->second.Key);
+    Blocks.erase(it);
+  }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace FEXCore {
+namespace Context {
+  struct Context;
+}
+namespace Core {
+  struct InternalThreadState;
+}
+
+/**
+ * @brief Index from guest code ranges to the blocks that were compiled from them
+ *
+ * Every block is recorded with the range of guest code it was decoded from, so that unmapping or changing guest
+ * memory only throws away the blocks that overlap it instead of the whole code cache.
+ *
+ * Blocks are kept sorted by start address. A block overlaps [Base, End) if it starts before End and ends after Base,
+ * so a lookup only has to walk the blocks starting in [Base - MaxLength, End).
+ *
+ * Blocks are keyed by the thread that owns their IR. Without the shared code cache that thread also owns the
+ * lookup cache the block lives in, and only that thread erases and unlinks blocks from it.
+ */
+class BlockRangeIndex final {
+public:
+  BlockRangeIndex(FEXCore::Context::Context *CTX);
+
+  /**
+   * @brief Records a block that is about to be published
+   *
+   * Replaces the previous range of the same block
+   */
+  void AddBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t Start, uint64_t Length);
+
+  /**
+   * @brief Erases every block that overlaps the range from the lookup caches, unlinking them
+   *
+   * Shared blocks and the blocks of Caller are erased right away. Blocks in the private cache of another thread are
+   * only dropped from its lookup tables, that thread erases and unlinks them in ErasePending. Its linked paths can
+   * run the old code until then.
+   *
+   * Takes Lock and the block cache locks. The SMC write fault is the only signal handler that may call this, it is
+   * raised by guest stores and those never happen with one of these held.
+   *
+   * @param Caller The thread doing the invalidation, null if it isn't a guest thread
+   *
+   * @return Number of blocks that were erased
+   */
+  size_t Invalidate(FEXCore::Core::InternalThreadState *Caller, uint64_t Base, uint64_t Length);
+
+  /**
+   * @brief Finishes the invalidations other threads left for this thread
+   *
+   * Drops the IR of invalidated blocks and, without the shared code cache, erases them from the thread's lookup cache.
+   * Each thread does this itself before compiling, the dispatcher is the only point where none of its code is running.
+   */
+  void ErasePending(FEXCore::Core::InternalThreadState *Thread);
+
+  void ThreadExited(FEXCore::Core::InternalThreadState *Thread);
+
+private:
+  struct BlockKey {
+    FEXCore::Core::InternalThreadState *Thread; ///< Owner of the IR, null once the thread is gone
+    uint64_t GuestRIP;
+
+    bool operator==(BlockKey const &rhs) const {
+      return Thread == rhs.Thread && GuestRIP == rhs.GuestRIP;
+    }
+  };
+
+  struct BlockKeyHash {
+    size_t operator()(BlockKey const &Key) const {
+      return std::hash<uint64_t>{}(Key.GuestRIP ^ (reinterpret_cast<uintptr_t>(Key.Thread) << 16));
+    }
+  };
+
+  struct BlockEntry {
+    uint64_t End;
+    BlockKey Key;
+  };
+
+  using BlockMap = std::multimap<uint64_t, BlockEntry>;
+
+  void EraseBlock(BlockMap::iterator it);
+
+  FEXCore::Context::Context *CTX;
+
+  std::mutex Lock;
+  BlockMap Blocks;
+  std::unordered_map<BlockKey, BlockMap::iterator, BlockKeyHash> BlockLookup;
+  uint64_t MaxLength{};
+
+  std::unordered_map<FEXCore::Core::InternalThreadState*, std::vector<uint64_t>> PendingErase;
+  std::atomic_bool HasPendingErase{false};
+};
+}
@@ -0,0 +1,138 @@
+#include "Interface/Core/BlockTable.h"
+
+#include <FEXCore/Utils/LogManager.h>
+
+#include <sys/mman.h>
+
+namespace FEXCore {
+BlockTable::BlockTable(size_t InitialEntries) {
+  LogMan::Throw::A((InitialEntries & (InitialEntries - 1)) == 0, "Block table size must be a power of 2");
+  Live = AllocateTable(InitialEntries);
+}
+
+BlockTable::~BlockTable() {
+  FreeTable(Live);
+  for (auto Old : Retired) {
+    FreeTable(Old);
+  }
+}
+
+BlockTable::Table *BlockTable::AllocateTable(size_t Entries) {
+  auto NewTable = new Table{};
+  NewTable->Entries = reinterpret_cast<Entry*>(mmap(nullptr, Entries * sizeof(Entry), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+  LogMan::Throw::A(NewTable->Entries != MAP_FAILED, "Failed to allocate block table");
+  NewTable->Mask = Entries - 1;
+  NewTable->Shift = 64 - __builtin_ctzll(Entries);
+  return NewTable;
+}
+
+void BlockTable::FreeTable(Table *Old) {
+  munmap(Old->Entries, (Old->Mask + 1) * sizeof(Entry));
+  delete Old;
+}
+
+BlockTable::Entry *BlockTable::FindEntry(uint64_t Key) {
+  size_t Index = Live->Hash(Key);
+  while (true) {
+    Entry &Slot = Live->Entries[Index];
+    if (Slot.Key == Key) {
+      return &Slot;
+    }
+    if (Slot.Key == EMPTY_KEY) {
+      return nullptr;
+    }
+    Index = (Index + 1) & Live->Mask;
+  }
+}
+
+void BlockTable::Grow() {
+  Table *NewTable = AllocateTable((Live->Mask + 1) * 2);
+
+  // Nobody can see the new table yet, so no need for the ordered writes
+  for (size_t i = 0; i <= Live->Mask; ++i) {
+    const Entry &Slot = Live->Entries[i];
+    if (Slot.Key == EMPTY_KEY) {
+      continue;
+    }
+
+    size_t Index = NewTable->Hash(Slot.Key);
+    while (NewTable->Entries[Index].Key != EMPTY_KEY) {
+      Index = (Index + 1) & NewTable->Mask;
+    }
+    NewTable->Entries[Index] = Slot;
+  }
+
+  Retired.emplace_back(Live);
+  __atomic_store_n(&Live, NewTable, __ATOMIC_RELEASE);
+}
+
+uintptr_t BlockTable::Insert(uint64_t Key, uintptr_t Value) {
+  LogMan::Throw::A(Key != EMPTY_KEY, "Can't map guest address 0");
+
+  if (auto Existing = FindEntry(Key)) {
+    return Existing->Value;
+  }
+
+  // Keep the load factor at or below a half so probes stay short
+  if ((Count + 1) * 2 > Live->Mask + 1) {
+    Grow();
+  }
+
+  size_t Index = Live->Hash(Key);
+  while (Live->Entries[Index].Key != EMPTY_KEY) {
+    Index = (Index + 1) & Live->Mask;
+  }
+
+  WriteEntry(Live->Entries[Index], Key, Value);
+  ++Count;
+  return Value;
+}
+
+void BlockTable::Set(uint64_t Key, uintptr_t Value) {
+  if (auto Existing = FindEntry(Key)) {
+    WriteEntry(*Existing, Key, Value);
+    return;
+  }
+
+  Insert(Key, Value);
+}
+
+bool BlockTable::Erase(uint64_t Key) {
+  auto Slot = FindEntry(Key);
+  if (!Slot) {
+    return false;
+  }
+
+  size_t Hole = Slot - Live->Entries;
+  WriteEntry(*Slot, EMPTY_KEY, 0);
+  --Count;
+
+  // Shift back any following entries of the cluster that can now live closer to their home
+  size_t Index = Hole;
+  while (true) {
+    Index = (Index + 1) & Live->Mask;
+    Entry &Next = Live->Entries[Index];
+    if (Next.Key == EMPTY_KEY) {
+      break;
+    }
+
+    size_t Home = Live->Hash(Next.Key);
+    if (((Index - Home) & Live->Mask) >= ((Index - Hole) & Live->Mask)) {
+      // Publish the new location before removing the old one
+      // A reader racing this can miss the entry but never sees the wrong value
+      WriteEntry(Live->Entries[Hole], Next.Key, Next.Value);
+      WriteEntry(Next, EMPTY_KEY, 0);
+      Hole = Index;
+    }
+  }
+
+  return true;
+}
+
+void BlockTable::Clear() {
+  // Zero the entries and give the memory back
+  madvise(Live->Entries, (Live->Mask + 1) * sizeof(Entry), MADV_DONTNEED);
+  Count = 0;
+}
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace FEXCore {
+
+/**
+ * @brief Open addressing map of guest addresses to host code
+ *
+ * Linear probing over 16 byte entries, four to a cache line, so a lookup usually touches a single line.
+ * Key 0 marks an empty entry so guest address 0 can't be stored.
+ *
+ * Writers must be serialized by the owner. Find doesn't take any lock and can run concurrently with writers.
+ * Each entry is written like a seqlock: the key is cleared, the value is stored and then the key is
+ * published. A reader re-checks the key after loading the value, so a racing reader only ever sees
+ * a valid mapping or a miss. A miss that races a writer may be spurious and should be retried under the lock.
+ *
+ * Erase uses backward shift deletion so there are no tombstones and probe lengths don't degrade under churn.
+ * Growing publishes a new table. The old table is kept alive until destruction since a reader may still be
+ * walking it. Growth is geometric so the retired tables never add up to more than the live one.
+ */
+class BlockTable final {
+public:
+  BlockTable(size_t InitialEntries = 4096);
+  ~BlockTable();
+
+  BlockTable(const BlockTable&) = delete;
+  BlockTable &operator=(const BlockTable&) = delete;
+
+  /**
+   * @brief Lock free lookup
+   *
+   * @return Value for Key or 0 if it isn't in the table
+   */
+  uintptr_t Find(uint64_t Key) const {
+    const Table *Current = __atomic_load_n(&Live, __ATOMIC_ACQUIRE);
+    size_t Index = Current->Hash(Key);
+
+    for (size_t i = 0; i <= Current->Mask; ++i) {
+      const Entry &Slot = Current->Entries[Index];
+      uint64_t SlotKey = __atomic_load_n(&Slot.Key, __ATOMIC_ACQUIRE);
+
+      if (SlotKey == Key) {
+        uintptr_t Value = __atomic_load_n(&Slot.Value, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        // Entry was rewritten while we were reading it
+        if (__atomic_load_n(&Slot.Key, __ATOMIC_RELAXED) != Key) {
+          return 0;
+        }
+        return Value;
+      }
+
+      if (SlotKey == EMPTY_KEY) {
+        return 0;
+      }
+
+      Index = (Index + 1) & Current->Mask;
+    }
+
+    return 0;
+  }
+
+  /**
+   * @brief Inserts Key if it isn't already in the table
+   *
+   * @return The value that ends up mapped for Key, which is the existing one if there was one
+   */
+  uintptr_t Insert(uint64_t Key, uintptr_t Value);
+
+  /**
+   * @brief Inserts Key or replaces the value of an existing entry
+   */
+  void Set(uint64_t Key, uintptr_t Value);
+
+  /**
+   * @return true if Key was in the table
+   */
+  bool Erase(uint64_t Key);
+
+  void Clear();
+
+  /**
+   * @brief Calls Func(Key, Value) for every entry
+   *
+   * Writer side only, Func must not modify the table
+   */
+  template<typename F>
+  void ForEach(F &&Func) const {
+    for (size_t i = 0; i <= Live->Mask; ++i) {
+      const Entry &Slot = Live->Entries[i];
+      if (Slot.Key != EMPTY_KEY) {
+        Func(Slot.Key, Slot.Value);
+      }
+    }
+  }
+
+  size_t Size() const { return Count; }
+  size_t Capacity() const { return Live->Mask + 1; }
+
+private:
+  constexpr static uint64_t EMPTY_KEY = 0;
+
+  struct Entry {
+    uint64_t Key;
+    uintptr_t Value;
+  };
+  static_assert(sizeof(Entry) == 16, "Entries need to pack evenly in to cache lines");
+
+  struct Table {
+    Entry *Entries;
+    size_t Mask;
+    uint32_t Shift;
+
+    size_t Hash(uint64_t Key) const {
+      // Fibonacci hashing, guest code addresses are clustered so the high bits of the product are used
+      return (Key * 0x9E37'79B9'7F4A'7C15ULL) >> Shift;
+    }
+  };
+
+  static Table *AllocateTable(size_t Entries);
+  static void FreeTable(Table *Old);
+
+  static void WriteEntry(Entry &Slot, uint64_t Key, uintptr_t Value) {
+    __atomic_store_n(&Slot.Key, EMPTY_KEY, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    __atomic_store_n(&Slot.Value, Value, __ATOMIC_RELAXED);
+    __atomic_store_n(&Slot.Key, Key, __ATOMIC_RELEASE);
+  }
+
+  Entry *FindEntry(uint64_t Key);
+  void Grow();
+
+  Table *Live;
+  std::vector<Table*> Retired;
+  size_t Count{};
+};
+
+}
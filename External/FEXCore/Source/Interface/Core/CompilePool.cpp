@@ -0,0 +1,283 @@
+#include "Interface/Context/Context.h"
+#include "Interface/Core/BlockRangeIndex.h"
+#include "Interface/Core/CompilePool.h"
+#include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/LookupCache.h"
+#include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/Core/SharedCodeCache.h"
+#include "Interface/Core/SMCTracker.h"
+
+#include <FEXCore/Core/CPUBackend.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <pthread.h>
+#include <shared_mutex>
+
+namespace FEXCore {
+  CompilePool::IndexRing::IndexRing(size_t Size)
+    : Cells {new Cell[Size]}
+    , Mask {Size - 1} {
+    LogMan::Throw::A((Size & Mask) == 0, "Ring size must be a power of 2");
+
+    for (size_t i = 0; i < Size; ++i) {
+      Cells[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  bool CompilePool::IndexRing::Push(uint32_t Value) {
+    size_t Pos = EnqueuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &Cell = Cells[Pos & Mask];
+      size_t Sequence = Cell.Sequence.load(std::memory_order_acquire);
+      intptr_t Diff = static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Pos);
+
+      if (Diff == 0) {
+        // Cell is free for this lap, claim it
+        if (EnqueuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+          Cell.Value = Value;
+          Cell.Sequence.store(Pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (Diff < 0) {
+        // Full
+        return false;
+      }
+      else {
+        // Another producer got here first
+        Pos = EnqueuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  bool CompilePool::IndexRing::Pop(uint32_t *Value) {
+    size_t Pos = DequeuePos.load(std::memory_order_relaxed);
+    while (true) {
+      auto &Cell = Cells[Pos & Mask];
+      size_t Sequence = Cell.Sequence.load(std::memory_order_acquire);
+      intptr_t Diff = static_cast<intptr_t>(Sequence) - static_cast<intptr_t>(Pos + 1);
+
+      if (Diff == 0) {
+        if (DequeuePos.compare_exchange_weak(Pos, Pos + 1, std::memory_order_relaxed)) {
+          *Value = Cell.Value;
+          // Hand the cell back to producers for the next lap
+          Cell.Sequence.store(Pos + Mask + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (Diff < 0) {
+        // Empty
+        return false;
+      }
+      else {
+        Pos = DequeuePos.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  CompilePool::CompilePool(FEXCore::Context::Context *ctx, uint32_t NumWorkers)
+    : CTX {ctx}
+    , Profiles {new Profile[NUM_PROFILES]{}}
+    , FreeProfiles {NUM_PROFILES}
+    , WorkQueue {NUM_PROFILES} {
+    LogMan::Throw::A(CTX->SharedCache != nullptr, "Tiered compilation needs the shared code cache");
+
+    for (uint32_t i = 0; i < NUM_PROFILES; ++i) {
+      FreeProfiles.Push(i);
+    }
+
+    for (uint32_t i = 0; i < NumWorkers; ++i) {
+      Workers.emplace_back([this, i]() {
+        WorkerThread(i);
+      });
+    }
+  }
+
+  CompilePool::~CompilePool() {
+    Shutdown();
+  }
+
+  void CompilePool::Shutdown() {
+    ShuttingDown = true;
+    for (auto &Worker : Workers) {
+      // Kick everyone that is waiting for work
+      WorkAvailable.NotifyAll();
+      Worker.join();
+    }
+    Workers.clear();
+  }
+
+  CompilePool::Profile *CompilePool::AllocateProfile(uint64_t GuestRIP) {
+    uint32_t Index;
+    if (!FreeProfiles.Pop(&Index)) {
+      NeedsReclaim = true;
+      return nullptr;
+    }
+
+    auto Slot = &Profiles[Index];
+    Slot->Counter = std::min<uint32_t>(CTX->Config.TierUpThreshold, INT32_MAX);
+    Slot->GuestRIP = GuestRIP;
+    Slot->HostCode = 0;
+    return Slot;
+  }
+
+  void CompilePool::ArmProfile(Profile *Slot, uintptr_t HostCode) {
+    Slot->HostCode = HostCode;
+    Slot->Epoch = CTX->SharedCache->GetFlushEpoch();
+    Slot->State.store(STATE_COUNTING, std::memory_order_release);
+  }
+
+  void CompilePool::ReleaseProfile(Profile *Slot) {
+    Slot->State.store(STATE_FREE, std::memory_order_relaxed);
+    FreeProfiles.Push(Slot - Profiles.get());
+  }
+
+  void CompilePool::ScanProfiles() {
+    // Must be called with ScanLock held
+    auto Now = std::chrono::steady_clock::now();
+    if ((Now - LastScan) < SCAN_INTERVAL) {
+      return;
+    }
+    LastScan = Now;
+
+    uint64_t Epoch = CTX->SharedCache->GetFlushEpoch();
+    bool Reclaim = NeedsReclaim.exchange(false);
+    auto Blocks = CTX->SharedCache->GetBlockCache();
+    bool Queued = false;
+
+    for (uint32_t i = 0; i < NUM_PROFILES; ++i) {
+      auto Slot = &Profiles[i];
+      if (Slot->State.load(std::memory_order_acquire) != STATE_COUNTING) {
+        continue;
+      }
+
+      // Flushed code is never entered again, so the counter would never get there
+      // Invalidated blocks are only looked for when we are out of slots, a racing writer can make this miss spuriously
+      if (Slot->Epoch != Epoch ||
+          (Reclaim && Blocks->FindBlockLockless(Slot->GuestRIP) != Slot->HostCode)) {
+        ReleaseProfile(Slot);
+        continue;
+      }
+
+      if (__atomic_load_n(&Slot->Counter, __ATOMIC_RELAXED) > 0) {
+        continue;
+      }
+
+      Slot->State.store(STATE_QUEUED, std::memory_order_relaxed);
+      if (WorkQueue.Push(i)) {
+        Queued = true;
+      }
+      else {
+        // Try again on the next scan
+        Slot->State.store(STATE_COUNTING, std::memory_order_relaxed);
+      }
+    }
+
+    if (Queued) {
+      WorkAvailable.NotifyAll();
+    }
+  }
+
+  std::unique_ptr<FEXCore::Core::InternalThreadState> CompilePool::CreateCompileThread() {
+    auto Thread = std::make_unique<FEXCore::Core::InternalThreadState>();
+    Thread->IsCompileService = true;
+
+    // Compile threads get the full pipeline
+    CTX->InitializeCompiler(Thread.get(), true);
+
+    // Code generated here jumps back in to the shared dispatcher
+    std::scoped_lock<std::mutex> lk(CTX->SharedCache->DispatcherLock);
+    LogMan::Throw::A(CTX->SharedCache->DispatcherOwner != nullptr, "Tiering up before any thread has a dispatcher");
+    Thread->CPUBackend->CopyNecessaryDataForCompileThread(CTX->SharedCache->DispatcherOwner);
+
+    return Thread;
+  }
+
+  void CompilePool::TierUp(FEXCore::Core::InternalThreadState *Thread, Profile *Slot) {
+    uint64_t GuestRIP = Slot->GuestRIP;
+    uint64_t SMCGeneration = CTX->SMCTracking ? CTX->SMCTracking->GetGeneration() : 0;
+
+    // The guest can't unmap or reprotect its memory while we hold this, so the decoder never reads memory that is going away
+    // Changes that happened while the job was queued have already invalidated the tier 0 block, don't decode code that is gone
+    std::shared_lock<std::shared_mutex> lk(CTX->GuestMemoryChangeLock);
+    if (CTX->SharedCache->GetBlockCache()->FindBlockLockless(GuestRIP) != Slot->HostCode) {
+      ReleaseProfile(Slot);
+      return;
+    }
+
+    Thread->State.State.rip = GuestRIP;
+    auto [CodePtr, IRList, DebugData, RAData, Generated, StartAddr, Length] = CTX->CompileCode(Thread, GuestRIP);
+
+    // Guest threads keep the IR of their tier 0 compile, ours is dropped here
+    Core::LocalIREntry Entry = {StartAddr, Length, decltype(Entry.IR)(IRList), decltype(Entry.RAData)(RAData), decltype(Entry.DebugData)(DebugData)};
+
+    if (CodePtr) {
+      // Multiblock can pull in guest code the tier 0 block didn't cover
+      CTX->BlockRanges->AddBlock(Thread, GuestRIP, StartAddr, Length);
+      if (CTX->SMCTracking) {
+        CTX->SMCTracking->ProtectRange(StartAddr, Length);
+        if (CTX->SMCTracking->InvalidatedSince(StartAddr, Length, SMCGeneration)) {
+          CodePtr = nullptr;
+        }
+      }
+    }
+
+    // Only swaps if the tier 0 block is still the one that is mapped
+    // It may have been invalidated or flushed while we were compiling
+    if (CodePtr &&
+        CTX->SharedCache->ReplaceBlockMapping(GuestRIP, Slot->HostCode, reinterpret_cast<uintptr_t>(CodePtr))) {
+#if ENABLE_JITSYMBOLS
+      if (Entry.DebugData) {
+        CTX->Symbols.Register(CodePtr, GuestRIP, Entry.DebugData->HostCodeSize);
+      }
+#endif
+    }
+
+    ReleaseProfile(Slot);
+  }
+
+  void CompilePool::WorkerThread(uint32_t WorkerIndex) {
+    // Ignore signals coming from the guest
+    CTX->SignalDelegation->MaskThreadSignals();
+
+    char ThreadName[16]{};
+    snprintf(ThreadName, 16, "CompilePool-%u", WorkerIndex);
+    pthread_setname_np(pthread_self(), ThreadName);
+
+    // Created on the first work item, the dispatcher doesn't exist until a guest thread starts
+    std::unique_ptr<FEXCore::Core::InternalThreadState> Thread;
+
+    while (!ShuttingDown.load()) {
+      if (ScanLock.try_lock()) {
+        ScanProfiles();
+        ScanLock.unlock();
+      }
+
+      uint32_t Index;
+      if (!WorkQueue.Pop(&Index)) {
+        WorkAvailable.WaitFor(SCAN_INTERVAL);
+        continue;
+      }
+
+      if (!Thread) {
+        Thread = CreateCompileThread();
+      }
+
+      // While registered the cache won't release a region we are still emitting in to
+      // Only stay registered while compiling so an idle worker never holds back reclaiming
+      CTX->SharedCache->RegisterThread(Thread.get());
+      do {
+        // Let another worker pick up the rest of the queue
+        WorkAvailable.NotifyOne();
+        TierUp(Thread.get(), &Profiles[Index]);
+      } while (!ShuttingDown.load() && WorkQueue.Pop(&Index));
+      CTX->SharedCache->UnregisterThread(Thread.get());
+    }
+
+    if (Thread) {
+      CTX->BlockRanges->ThreadExited(Thread.get());
+    }
+  }
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <FEXCore/Utils/Event.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+
+namespace FEXCore {
+namespace Context {
+  struct Context;
+}
+namespace Core {
+  struct InternalThreadState;
+}
+
+/**
+ * @brief Background recompilation of hot blocks
+ *
+ * With tiered compilation the guest threads only do a quick tier 0 compile of a block, without the optimization
+ * passes and without multiblock. Tier 0 blocks decrement a profile counter every time they are entered.
+ * The pool scans the counters and recompiles the blocks that crossed the threshold on one of its workers with the
+ * full pipeline, then swaps the new code in through the shared code cache.
+ *
+ * Code from the workers is run by every guest thread, so this needs the shared code cache where all threads
+ * share a single dispatcher and code is only ever freed once no thread can be running it.
+ *
+ * Profile slots and the work queue are fixed size and lock free, nothing is allocated per block.
+ */
+class CompilePool final {
+public:
+  CompilePool(FEXCore::Context::Context *CTX, uint32_t NumWorkers);
+  ~CompilePool();
+
+  struct Profile {
+    int32_t Counter; ///< Decremented by the tier 0 code on every entry, lost updates are fine
+    std::atomic<uint32_t> State;
+    uint64_t GuestRIP;
+    uintptr_t HostCode;
+    uint64_t Epoch;  ///< Shared code cache flush epoch the block was published in
+  };
+
+  /**
+   * @brief Grabs a profile slot for a block that is about to be compiled
+   *
+   * @return nullptr if every slot is in use, the block then stays at tier 0
+   */
+  Profile *AllocateProfile(uint64_t GuestRIP);
+
+  /**
+   * @brief Starts watching the counter once the tier 0 code is published
+   */
+  void ArmProfile(Profile *Slot, uintptr_t HostCode);
+
+  void ReleaseProfile(Profile *Slot);
+
+  void Shutdown();
+
+private:
+  /**
+   * @brief Bounded lock free multi producer multi consumer queue of slot indices
+   */
+  class IndexRing final {
+  public:
+    explicit IndexRing(size_t Size);
+
+    bool Push(uint32_t Value);
+    bool Pop(uint32_t *Value);
+
+  private:
+    struct Cell {
+      std::atomic<size_t> Sequence;
+      uint32_t Value;
+    };
+
+    std::unique_ptr<Cell[]> Cells;
+    size_t Mask;
+    alignas(64) std::atomic<size_t> EnqueuePos{};
+    alignas(64) std::atomic<size_t> DequeuePos{};
+  };
+
+  enum ProfileState : uint32_t {
+    STATE_FREE,
+    STATE_COUNTING,
+    STATE_QUEUED,
+  };
+
+  void WorkerThread(uint32_t WorkerIndex);
+  std::unique_ptr<FEXCore::Core::InternalThreadState> CreateCompileThread();
+  void ScanProfiles();
+  void TierUp(FEXCore::Core::InternalThreadState *Thread, Profile *Slot);
+
+  constexpr static uint32_t NUM_PROFILES = 64 * 1024; // Must be a power of 2
+  constexpr static std::chrono::milliseconds SCAN_INTERVAL{10};
+
+  FEXCore::Context::Context *CTX;
+
+  // Never reallocated, tier 0 code has the counter addresses baked in
+  std::unique_ptr<Profile[]> Profiles;
+  IndexRing FreeProfiles;
+  IndexRing WorkQueue;
+
+  std::mutex ScanLock;
+  std::chrono::steady_clock::time_point LastScan{};
+  // Set when we ran out of slots, the next scan also drops slots of blocks that were invalidated
+  std::atomic_bool NeedsReclaim{false};
+
+  Event WorkAvailable;
+  std::atomic_bool ShuttingDown{false};
+  std::vector<std::thread> Workers;
+};
+}
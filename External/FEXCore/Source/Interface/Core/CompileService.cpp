@@ -64,6 +64,7 @@ namespace FEXCore {
 
     // Clear the inverse cache of what is calling us from the Context ClearCache routine
     auto SelectedThread = Thread->IsCompileService ? ParentThread : Thread;
+    SelectedThread->Returns.Clear();
     SelectedThread->LookupCache->ClearCache();
     SelectedThread->CPUBackend->ClearCache();
   }
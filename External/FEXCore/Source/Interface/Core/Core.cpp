@@ -2,15 +2,23 @@
 #include "Common/Paths.h"
 
 #include "Interface/Context/Context.h"
+#include "Interface/Core/AOTCodeCache.h"
+#include "Interface/Core/BlockRangeIndex.h"
+#include "Interface/Core/HostMemory.h"
 #include "Interface/Core/LookupCache.h"
 #include "Interface/Core/BlockSamplingData.h"
+#include "Interface/Core/CompilePool.h"
 #include "Interface/Core/CompileService.h"
 #include "Interface/Core/Core.h"
 #include "Interface/Core/DebugData.h"
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/OpcodeDispatcher.h"
+#include "Interface/Core/SharedCodeCache.h"
+#include "Interface/Core/SMCTracker.h"
 #include "Interface/Core/Interpreter/InterpreterCore.h"
 #include "Interface/Core/JIT/JITCore.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
+#include "Interface/IR/Passes/ValueNumberingPass.h"
 #include "Interface/IR/Passes.h"
 
 #include <FEXCore/Config/Config.h>
@@ -22,7 +30,10 @@
 
 #include "Interface/HLE/Thunks/Thunks.h"
 
+#include <algorithm>
 #include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <filesystem>
 
@@ -81,6 +92,34 @@ namespace FEXCore::CPU {
 
 static std::mutex AOTIRCacheLock;
 
+namespace FEXCore::Context {
+  // AOTIR cache files are mapped and used in place
+  // Header page, index page aligned after it, then the IR and RA data of each entry
+  constexpr static uint64_t AOTIR_TAG = 0xDEADBEEFC0D30003;
+  constexpr static uint64_t AOTIR_PAGE_SIZE = 4096;
+  constexpr static uint64_t AOTIR_DATA_ALIGNMENT = 16;
+
+  struct AOTIRFileHeader {
+    uint64_t Tag;
+    uint64_t NumOps; ///< IR layout changes when ops are added or removed
+    uint64_t IndexCount;
+    uint64_t FileSize;
+  };
+
+  struct Context::AOTIRIndexEntry {
+    uint64_t Offset; ///< File relative guest entry, the index is sorted by this
+    uint64_t Start;
+    uint64_t Len;
+    uint64_t Crc;
+    uint64_t DataOffset;
+    uint64_t DataSize;
+    uint64_t ListOffset;
+    uint64_t ListSize;
+    uint64_t RAOffset;
+    uint64_t RACount;
+  };
+}
+
 namespace FEXCore::Core {
 struct ThreadLocalData {
   FEXCore::Core::InternalThreadState* Thread;
@@ -176,6 +215,8 @@ namespace DefaultFallbackCore {
 namespace FEXCore::Context {
   Context::Context() {
     FallbackCPUFactory = FEXCore::Core::DefaultFallbackCore::CPUCreationFactory;
+    AOTCode = std::make_unique<FEXCore::AOTCodeCache>(this);
+    BlockRanges = std::make_unique<FEXCore::BlockRangeIndex>(this);
 #ifdef BLOCKSTATS
     BlockData = std::make_unique<FEXCore::BlockSamplingData>();
 #endif
@@ -252,7 +293,14 @@ namespace FEXCore::Context {
   }
 
   Context::~Context() {
+    if (CompileThreadPool) {
+      CompileThreadPool->Shutdown();
+    }
+
     {
+      Threads.insert(Threads.end(), IdleThreads.begin(), IdleThreads.end());
+      IdleThreads.clear();
+
       for (auto &Thread : Threads) {
         if (Thread->ExecutionThread.joinable()) {
           Thread->ExecutionThread.join();
@@ -277,9 +325,15 @@ namespace FEXCore::Context {
 
     // AOTIRCache needs manual clear
     for (auto &Mod: AOTIRCache) {
-      for (auto &Entry: Mod.second) {
+      for (auto &Entry: Mod.second.Entries) {
         delete Entry.second.IR;
-        free(Entry.second.RAData);
+        if (!Entry.second.Mapped) {
+          free(Entry.second.RAData);
+        }
+      }
+
+      if (Mod.second.Base) {
+        munmap(Mod.second.Base, Mod.second.Size);
       }
     }
   }
@@ -288,6 +342,32 @@ namespace FEXCore::Context {
     ThunkHandler.reset(FEXCore::ThunkHandler::Create());
 
     LocalLoader = Loader;
+
+    if (Config.SharedCodeCache) {
+      if (Config.Core == FEXCore::Config::CONFIG_IRJIT) {
+        SharedCache = std::make_unique<FEXCore::SharedCodeCache>(this);
+      }
+      else {
+        LogMan::Msg::I("Shared code cache is only supported with the JIT, ignoring");
+      }
+    }
+
+    if (Config.CompileThreads) {
+      if (SharedCache) {
+        CompileThreadPool = std::make_unique<FEXCore::CompilePool>(this, Config.CompileThreads);
+      }
+      else {
+        LogMan::Msg::I("Tiered compilation needs the shared code cache, ignoring");
+      }
+    }
+
+    if (Config.SMCChecks == FEXCore::Config::CONFIG_SMC_MTRACK) {
+      SMCTracking = std::make_unique<FEXCore::SMCTracker>(this);
+      SignalDelegation->RegisterHostSignalHandler(SIGSEGV, [this](FEXCore::Core::InternalThreadState *Thread, int Signal, void *info, void *ucontext) -> bool {
+        return SMCTracking->HandleWriteFault(Thread, info);
+      });
+    }
+
     using namespace FEXCore::Core;
     FEXCore::Core::CPUState NewThreadState{};
 
@@ -435,6 +515,12 @@ namespace FEXCore::Context {
       for (auto &Thread : Threads) {
         ClearCodeCache(Thread, true);
       }
+
+      // Exited threads keep their code for when they get reused, which would skip the single stepping
+      // Their host thread is done with the caches before they land in IdleThreads
+      for (auto &Thread : IdleThreads) {
+        ClearCodeCache(Thread, true);
+      }
     }
     CoreRunningMode PreviousRunningMode = this->Config.RunningMode;
     int64_t PreviousMaxIntPerBlock = this->Config.MaxInstPerBlock;
@@ -520,7 +606,7 @@ namespace FEXCore::Context {
     auto IRHandler = [Thread](uint64_t Addr, IR::IREmitter *IR) -> void {
       // Run the passmanager over the IR from the dispatcher
       Thread->PassManager->Run(IR);
-      Core::LocalIREntry Entry = {Addr, 0ULL, decltype(Entry.IR)(IR->CreateIRCopy()), decltype(Entry.RAData)(Thread->PassManager->GetRAPass() ? Thread->PassManager->GetRAPass()->PullAllocationData() : nullptr), decltype(Entry.DebugData)(new Core::DebugData())};
+      Core::LocalIREntry Entry = {Addr, 0ULL, decltype(Entry.IR)(IR->CreateIRCopy(&Thread->IRStorage)), decltype(Entry.RAData)(Thread->PassManager->GetRAPass() ? Thread->PassManager->GetRAPass()->PullAllocationData() : nullptr), decltype(Entry.DebugData)(new Core::DebugData())};
       Thread->LocalIRCache.insert({Addr, std::move(Entry)});
     };
 
@@ -529,13 +615,21 @@ namespace FEXCore::Context {
     // Compile all of our cached entries
     LogMan::Msg::D("Precompiling: %ld blocks...", EntryList.size());
     for (auto Entry : EntryList) {
-      CompileRIP(Thread, Entry);
+      if (SharedCache) {
+        // Don't throw away blocks that other threads have already published
+        CompileBlock(Thread, Entry);
+      }
+      else {
+        CompileRIP(Thread, Entry);
+      }
     }
     LogMan::Msg::D("Done", EntryList.size());
   }
 
   void Context::InitializeThread(FEXCore::Core::InternalThreadState *Thread) {
-    InitializeThreadData(Thread);
+    if (!Thread->Recycled) {
+      InitializeThreadData(Thread);
+    }
 
     // This will create the execution thread but it won't actually start executing
     Thread->ExecutionThread = std::thread(&Context::ExecutionThread, this, Thread);
@@ -550,9 +644,14 @@ namespace FEXCore::Context {
   }
 
   void Context::InitializeCompiler(FEXCore::Core::InternalThreadState* State, bool CompileThread) {
+    // With tiered compilation guest threads only do a quick compile, the full one happens on the compile pool
+    bool TierZero = CompileThreadPool && !CompileThread;
+
     State->OpDispatcher = std::make_unique<FEXCore::IR::OpDispatchBuilder>(this);
-    State->OpDispatcher->SetMultiblock(Config.Multiblock);
-    State->LookupCache = std::make_unique<FEXCore::LookupCache>(this);
+    State->OpDispatcher->SetMultiblock(Config.Multiblock && !TierZero);
+    // Compile threads never execute code, so they keep their own cache even when sharing
+    State->LookupCache = std::make_unique<FEXCore::LookupCache>(this, SharedCache && !CompileThread ? SharedCache->GetBlockCache() : nullptr);
+    State->L1Pointer = State->LookupCache->GetL1Pointer();
     State->FrontendDecoder = std::make_unique<FEXCore::Frontend::Decoder>(this);
     State->PassManager = std::make_unique<FEXCore::IR::PassManager>();
     State->PassManager->RegisterExitHandler([this]() {
@@ -565,7 +664,7 @@ namespace FEXCore::Context {
     bool DoSRA = false;
     #endif
 
-    State->PassManager->AddDefaultPasses(Config.Core == FEXCore::Config::CONFIG_IRJIT, DoSRA);
+    State->PassManager->AddDefaultPasses(Config.Core == FEXCore::Config::CONFIG_IRJIT, DoSRA, !TierZero);
     State->PassManager->AddDefaultValidationPasses();
 
     State->PassManager->RegisterSyscallHandler(SyscallHandler);
@@ -577,10 +676,13 @@ namespace FEXCore::Context {
     case FEXCore::Config::CONFIG_INTERPRETER:
       State->CPUBackend.reset(FEXCore::CPU::CreateInterpreterCore(this, State, CompileThread));
       break;
-    case FEXCore::Config::CONFIG_IRJIT:
-      State->PassManager->InsertRegisterAllocationPass(DoSRA);
+    case FEXCore::Config::CONFIG_IRJIT: {
+      bool LinearScan = Config.RegisterAllocator == FEXCore::Config::CONFIG_RA_LINEAR_SCAN ||
+        (Config.RegisterAllocator == FEXCore::Config::CONFIG_RA_TIERED && TierZero);
+      State->PassManager->InsertRegisterAllocationPass(DoSRA, LinearScan);
       State->CPUBackend.reset(FEXCore::CPU::CreateJITCore(this, State, CompileThread));
       break;
+    }
     case FEXCore::Config::CONFIG_CUSTOM:      State->CPUBackend.reset(CustomCPUFactory(this, &State->State)); break;
     default: LogMan::Msg::A("Unknown core configuration");
     }
@@ -589,33 +691,91 @@ namespace FEXCore::Context {
   FEXCore::Core::InternalThreadState* Context::CreateThread(FEXCore::Core::CPUState *NewThreadState, uint64_t ParentTID) {
     FEXCore::Core::InternalThreadState *Thread{};
 
-    // Grab the new thread object
+    // Grab the new thread object, a thread that already exited is much cheaper than building the compiler again
     {
       std::lock_guard<std::mutex> lk(ThreadCreationMutex);
-      Thread = Threads.emplace_back(new FEXCore::Core::InternalThreadState{});
+      if (!IdleThreads.empty()) {
+        Thread = Threads.emplace_back(IdleThreads.back());
+        IdleThreads.pop_back();
+      }
+      else {
+        Thread = Threads.emplace_back(new FEXCore::Core::InternalThreadState{});
+      }
       Thread->State.ThreadManager.TID = ++ThreadID;
     }
 
+    if (Thread->Recycled) {
+      RecycleThread(Thread);
+    }
+
     // Copy over the new thread state to the new object
     memcpy(&Thread->State.State, NewThreadState, sizeof(FEXCore::Core::CPUState));
 
     // Set up the thread manager state
     Thread->State.ThreadManager.parent_tid = ParentTID;
 
-    InitializeCompiler(Thread, false);
+    if (!Thread->Recycled) {
+      InitializeCompiler(Thread, false);
+    }
+
+    if (SharedCache) {
+      SharedCache->RegisterThread(Thread);
+    }
 
     return Thread;
   }
 
-  void Context::AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr) {
+  void Context::RecycleThread(FEXCore::Core::InternalThreadState *Thread) {
+    // The previous guest thread is gone but its host thread can still be unwinding
+    if (Thread->ExecutionThread.joinable()) {
+      Thread->ExecutionThread.join();
+    }
+
+    // Only the guest side is reset, the compiler, lookup cache and code carry over
+    Thread->State.ThreadManager.set_child_tid = nullptr;
+    Thread->State.ThreadManager.clear_child_tid = nullptr;
+    Thread->State.ThreadManager.robust_list_head = 0;
+    Thread->State.RunningEvents.Running = false;
+    Thread->State.RunningEvents.WaitingToStart = false;
+    Thread->SignalReason.store(FEXCore::Core::SignalEvent::SIGNALEVENT_NONE);
+    Thread->SignalHandlerRefCounter = 0;
+    Thread->CompileBlockReentrantRefCount = 0;
+    Thread->StatusCode = 0;
+    Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_WAITING;
+    Thread->Stats.InstructionsExecuted = 0;
+    Thread->Stats.BlocksCompiled = 0;
+    Thread->Returns.Clear();
+
+    if (SharedCache) {
+      // Regions can have been reclaimed while the thread wasn't registered, so nothing in the L1 can be trusted
+      Thread->LookupCache->ClearL1Cache();
+    }
+  }
+
+  uintptr_t Context::AddBlockMapping(FEXCore::Core::InternalThreadState *Thread, uint64_t Address, void *Ptr) {
+    if (SharedCache) {
+      return SharedCache->AddBlockMapping(Address, reinterpret_cast<uintptr_t>(Ptr));
+    }
+
     Thread->LookupCache->AddBlockMapping(Address, Ptr);
+    return reinterpret_cast<uintptr_t>(Ptr);
   }
 
   void Context::ClearCodeCache(FEXCore::Core::InternalThreadState *Thread, bool AlsoClearIRCache) {
-    Thread->LookupCache->ClearCache();
-    Thread->CPUBackend->ClearCache();
-    if (Thread->CompileService) {
-      Thread->CompileService->ClearCache(Thread);
+    // Predicted returns point in to the code that is about to go away
+    Thread->Returns.Clear();
+
+    if (SharedCache) {
+      // Retires the code of every thread, each thread drops its L1 once it is safe to do so
+      SharedCache->Flush();
+      Thread->CPUBackend->ClearCache();
+    }
+    else {
+      Thread->LookupCache->ClearCache();
+      Thread->CPUBackend->ClearCache();
+      if (Thread->CompileService) {
+        Thread->CompileService->ClearCache(Thread);
+      }
     }
 
     if (AlsoClearIRCache) {
@@ -670,7 +830,9 @@ namespace FEXCore::Context {
         TableInfo = Block.DecodedInstructions[i].TableInfo;
         DecodedInfo = &Block.DecodedInstructions[i];
 
-        if (Config.SMCChecks) {
+        // Pages the SMC tracker stopped protecting check their code the same way
+        if (Config.SMCChecks == FEXCore::Config::CONFIG_SMC_FULL ||
+            (SMCTracking && SMCTracking->NeedsCodeChecks(Block.Entry + BlockInstructionsLength, DecodedInfo->InstSize))) {
           auto ExistingCodePtr = reinterpret_cast<uint64_t*>(Block.Entry + BlockInstructionsLength);
 
           auto CodeChanged = Thread->OpDispatcher->_ValidateCode(ExistingCodePtr[0], ExistingCodePtr[1], (uintptr_t)ExistingCodePtr - GuestRIP, DecodedInfo->InstSize);
@@ -757,7 +919,8 @@ namespace FEXCore::Context {
       if (f) {
         std::stringstream out;
         auto NewIR = Thread->OpDispatcher->ViewIR();
-        FEXCore::IR::Dump(&out, &NewIR, RA);
+        auto VNPass = RA ? Thread->PassManager->GetValueNumberingPass() : nullptr;
+        FEXCore::IR::Dump(&out, &NewIR, RA, VNPass ? VNPass->GetEliminatedNodeCounts() : nullptr);
         fprintf(f,"IR-%s 0x%lx:\n%s\n@@@@@\n", RA ? "post" : "pre", GuestRIP, out.str().c_str());
 
         if (CloseAfter) {
@@ -803,12 +966,13 @@ namespace FEXCore::Context {
     if (Thread->OpDispatcher->ShouldDump) {
       std::stringstream out;
       auto NewIR = Thread->OpDispatcher->ViewIR();
-      FEXCore::IR::Dump(&out, &NewIR, Thread->PassManager->GetRAPass() ? Thread->PassManager->GetRAPass()->GetAllocationData() : nullptr);
+      auto VNPass = Thread->PassManager->GetValueNumberingPass();
+      FEXCore::IR::Dump(&out, &NewIR, Thread->PassManager->GetRAPass() ? Thread->PassManager->GetRAPass()->GetAllocationData() : nullptr, VNPass ? VNPass->GetEliminatedNodeCounts() : nullptr);
       printf("IR 0x%lx:\n%s\n@@@@@\n", GuestRIP, out.str().c_str());
     }
 
     auto RAData = Thread->PassManager->GetRAPass() ? Thread->PassManager->GetRAPass()->PullAllocationData() : nullptr;
-    auto IRList = Thread->OpDispatcher->CreateIRCopy();
+    auto IRList = Thread->OpDispatcher->CreateIRCopy(&Thread->IRStorage);
 
     Thread->OpDispatcher->ResetWorkingList();
 
@@ -840,30 +1004,34 @@ namespace FEXCore::Context {
 
     if (IRList == nullptr && Config.AOTIRLoad) {
       std::lock_guard<std::mutex> lk(AOTIRCacheLock);
-      auto file = AddrToFile.lower_bound(GuestRIP);
+      auto file = AddrToFile.upper_bound(GuestRIP);
       if (file != AddrToFile.begin()) {
         --file;
-        auto Mod = (decltype(AOTIRCache)::value_type::second_type*) file->second.CachedFileEntry;
+        auto Mod = (AOTIRModule*) file->second.CachedFileEntry;
 
         if (Mod == nullptr) {
           file->second.CachedFileEntry = Mod = &AOTIRCache[file->second.fileid];
         }
 
-        auto AOTEntry = Mod->find(GuestRIP - file->second.Start + file->second.Offset);
-        
-        if (AOTEntry != Mod->end()) {
+        auto AOTEntry = GuestRIP < (file->second.Start + file->second.Len) ?
+          FindAOTIREntry(Mod, GuestRIP - file->second.Start + file->second.Offset) : nullptr;
+
+        if (AOTEntry) {
+          uint64_t GuestStart = AOTEntry->start + file->second.Start - file->second.Offset;
           // verify hash
-          auto hash = fasthash64((void*)(AOTEntry->second.start + file->second.Start  - file->second.Offset), AOTEntry->second.len, 0);
-          if (hash == AOTEntry->second.crc) {
-            IRList = AOTEntry->second.IR;
+          // Cached IR doesn't check its code, it can't be used on pages that aren't write protected
+          if (GuestStart >= file->second.Start && (GuestStart + AOTEntry->len) <= (file->second.Start + file->second.Len) &&
+              fasthash64((void*)GuestStart, AOTEntry->len, 0) == AOTEntry->crc &&
+              !(SMCTracking && SMCTracking->NeedsCodeChecks(GuestStart, AOTEntry->len))) {
+            IRList = AOTEntry->IR;
             //LogMan::Msg::D("using %s + %lx -> %lx\n", file->second.fileid.c_str(), AOTEntry->first, GuestRIP);
             // relocate
             IRList->GetHeader()->Entry = GuestRIP;
 
-            RAData = AOTEntry->second.RAData;
+            RAData = AOTEntry->RAData;
             DebugData = new FEXCore::Core::DebugData();
-            StartAddr = AOTEntry->second.start;
-            Length = AOTEntry->second.len;
+            StartAddr = GuestStart;
+            Length = AOTEntry->len;
 
             GeneratedIR = true;
           }
@@ -894,128 +1062,259 @@ namespace FEXCore::Context {
     }
 
     // Attempt to get the CPU backend to compile this code
-    return { Thread->CPUBackend->CompileCode(IRList, DebugData, RAData), IRList, DebugData, RAData, GeneratedIR, StartAddr, Length};
+    auto CodePtr = Thread->CPUBackend->CompileCode(IRList, DebugData, RAData);
+
+    if (Config.AOTCodeCapture && CodePtr && DebugData) {
+      CaptureAOTCode(Thread, GuestRIP, StartAddr, Length, CodePtr, DebugData->HostCodeSize);
+    }
+
+    return { CodePtr, IRList, DebugData, RAData, GeneratedIR, StartAddr, Length};
   }
 
-  bool Context::LoadAOTIRCache(std::istream &stream) {
+  void *Context::LoadAOTCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t *StartAddr, uint64_t *Length) {
+    void *Module{};
+    uint64_t FileStart{}, FileLen{}, FileOffset{};
+
+    {
+      std::lock_guard<std::mutex> lk(AOTIRCacheLock);
+      auto file = AddrToFile.upper_bound(GuestRIP);
+      if (file == AddrToFile.begin()) {
+        return nullptr;
+      }
+      --file;
+
+      if (GuestRIP >= (file->second.Start + file->second.Len)) {
+        return nullptr;
+      }
+
+      if (file->second.CachedCodeModule == nullptr) {
+        file->second.CachedCodeModule = AOTCode->GetModule(file->second.fileid);
+      }
+
+      Module = file->second.CachedCodeModule;
+      FileStart = file->second.Start;
+      FileLen = file->second.Len;
+      FileOffset = file->second.Offset;
+    }
+
+    if (Module == nullptr) {
+      return nullptr;
+    }
+
+    // The mapped file is never modified or unmapped while running, no need to hold the lock
+    FEXCore::AOTCodeCache::Entry Entry;
+    if (!AOTCode->FindEntry(Module, GuestRIP - FileStart + FileOffset, &Entry)) {
+      return nullptr;
+    }
+
+    uint64_t GuestStart = Entry.Start + FileStart - FileOffset;
+    if (GuestStart < FileStart || (GuestStart + Entry.Length) > (FileStart + FileLen)) {
+      return nullptr;
+    }
+
+    // verify hash
+    if (fasthash64((void*)GuestStart, Entry.Length, 0) != Entry.Hash) {
+      return nullptr;
+    }
+
+    // Cached code doesn't check its guest code, it can't be used on pages that aren't write protected
+    if (SMCTracking && SMCTracking->NeedsCodeChecks(GuestStart, Entry.Length)) {
+      return nullptr;
+    }
+
+    *StartAddr = GuestStart;
+    *Length = Entry.Length;
+    return Thread->CPUBackend->RelocateJITObjectCode(GuestRIP, Entry.Code, Entry.CodeSize, Entry.Relocations, Entry.NumRelocations);
+  }
+
+  void Context::CaptureAOTCode(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP, uint64_t StartAddr, uint64_t Length, void *CodePtr, size_t CodeSize) {
+    auto Relocations = Thread->CPUBackend->GetRelocations();
+    if (!Relocations) {
+      return;
+    }
+
     std::lock_guard<std::mutex> lk(AOTIRCacheLock);
-    uint64_t tag;
-    stream.read((char*)&tag, sizeof(tag));
-    if (!stream || tag != 0xDEADBEEFC0D30002)
-      return false;
+    auto file = AddrToFile.upper_bound(StartAddr);
+    if (file == AddrToFile.begin()) {
+      return;
+    }
+    --file;
 
-    uint64_t ModCount;
-    stream.read((char*)&ModCount, sizeof(ModCount));
-    if (!stream)
+    if (file->second.Start <= StartAddr && (file->second.Start + file->second.Len) >= (StartAddr + Length) &&
+        GuestRIP >= file->second.Start && GuestRIP < (file->second.Start + file->second.Len)) {
+      auto hash = fasthash64((void*)StartAddr, Length, 0);
+      AOTCode->Capture(file->second.fileid, GuestRIP - file->second.Start + file->second.Offset, StartAddr - file->second.Start + file->second.Offset,
+                       Length, hash, CodePtr, CodeSize, *Relocations);
+    }
+  }
+
+  bool Context::LoadAOTIRCache(std::string const &fileid, int fd) {
+    std::lock_guard<std::mutex> lk(AOTIRCacheLock);
+    if (AOTIRCache.contains(fileid)) {
       return false;
+    }
 
-    for (int ModIndex = 0; ModIndex < ModCount; ModIndex++) {
-      std::string Module;
-      uint64_t ModSize;
-      stream.read((char*)&ModSize, sizeof(ModSize));
-      if (!stream)
-        return false;
-
-      Module.resize(ModSize);
-      stream.read((char*)&Module[0], Module.size());
-      if (!stream)
-        return false;
-
-      auto &Mod = AOTIRCache[Module];
-
-      uint64_t FnCount;
-      stream.read((char*)&FnCount, sizeof(FnCount));
-      if (!stream)
-        return false;
-
-      LogMan::Msg::D("AOTIR: Module %s has %ld functions", Module.c_str(), FnCount);
-      for (int FnIndex = 0; FnIndex < FnCount; FnIndex++) {
-        uint64_t addr, start, crc, len;
-        stream.read((char*)&addr, sizeof(addr));
-        if (!stream)
-          return false;
-        
-        stream.read((char*)&start, sizeof(start));
-        if (!stream)
-          return false;
-        stream.read((char*)&len, sizeof(len));
-        if (!stream)
-          return false;
-        stream.read((char*)&crc, sizeof(crc));
-        if (!stream)
-          return false;
-        auto IR = new IR::IRListView(stream);
-        if (!stream) {
-          delete IR;
-          return false;
-        }
-        uint64_t RASize;
-        stream.read((char*)&RASize, sizeof(RASize));
-        if (!stream) {
-          delete IR;
-          return false;
-        }
-        IR::RegisterAllocationData *RAData = (IR::RegisterAllocationData *)malloc(IR::RegisterAllocationData::Size(RASize));
-        RAData->MapCount = RASize;
-        
-        stream.read((char*)&RAData->Map[0], sizeof(RAData->Map[0]) * RASize);
-        
-        if (!stream) {
-          delete IR;
-          return false;
-        }
-        stream.read((char*)&RAData->SpillSlotCount, sizeof(RAData->SpillSlotCount));
-        if (!stream) {
-          delete IR;
-          return false;
-        }
+    // Recorded even if there is no usable file so it isn't looked for again
+    auto &Mod = AOTIRCache[fileid];
 
-        IR->IsShared = true;
-        RAData->IsShared = true;
+    struct stat Stat{};
+    if (fd == -1 || fstat(fd, &Stat) != 0 || Stat.st_size < AOTIR_PAGE_SIZE) {
+      return false;
+    }
 
-        Mod.insert({addr, {start, len, crc, IR, RAData}});
-      }
+    // Private and writable since the IR header Entry is relocated in place.
+    // Only the pages that are written to stop being shared with the page cache.
+    auto Base = reinterpret_cast<uint8_t*>(mmap(nullptr, Stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0));
+    if (Base == MAP_FAILED) {
+      return false;
+    }
+
+    auto Header = reinterpret_cast<AOTIRFileHeader const*>(Base);
+    if (Header->Tag != AOTIR_TAG ||
+        Header->NumOps != IR::IROps::OP_LAST ||
+        Header->FileSize != static_cast<uint64_t>(Stat.st_size) ||
+        Header->IndexCount > (Header->FileSize - AOTIR_PAGE_SIZE) / sizeof(AOTIRIndexEntry)) {
+      LogMan::Msg::D("AOTIR: Ignoring stale cache for %s", fileid.c_str());
+      munmap(Base, Stat.st_size);
+      return false;
     }
 
+    Mod.Base = Base;
+    Mod.Size = Stat.st_size;
+    Mod.Index = reinterpret_cast<AOTIRIndexEntry const*>(Base + AOTIR_PAGE_SIZE);
+    Mod.IndexCount = Header->IndexCount;
+
+    LogMan::Msg::D("AOTIR: Module %s has %ld functions", fileid.c_str(), Mod.IndexCount);
     return true;
   }
 
+  Context::AOTIRCacheEntry *Context::FindAOTIREntry(AOTIRModule *Module, uint64_t Offset) {
+    auto Entry = Module->Entries.find(Offset);
+    if (Entry != Module->Entries.end()) {
+      return &Entry->second;
+    }
+
+    if (!Module->Base) {
+      return nullptr;
+    }
+
+    auto End = Module->Index + Module->IndexCount;
+    auto Index = std::lower_bound(Module->Index, End, Offset, [](AOTIRIndexEntry const &IndexEntry, uint64_t Value) {
+      return IndexEntry.Offset < Value;
+    });
+
+    if (Index == End || Index->Offset != Offset) {
+      return nullptr;
+    }
+
+    auto InFile = [Module](uint64_t DataOffset, uint64_t Size) {
+      return DataOffset <= Module->Size && Size <= (Module->Size - DataOffset);
+    };
+
+    if (Index->RACount > UINT32_MAX ||
+        (Index->RAOffset % alignof(IR::RegisterAllocationData)) != 0 ||
+        !InFile(Index->DataOffset, Index->DataSize) ||
+        !InFile(Index->ListOffset, Index->ListSize) ||
+        !InFile(Index->RAOffset, IR::RegisterAllocationData::Size(Index->RACount))) {
+      LogMan::Msg::D("AOTIR: Corrupt entry %lx", Offset);
+      return nullptr;
+    }
+
+    // Nothing is copied, the view and the RA data point straight in to the mapping
+    auto IR = new IR::IRListView(Module->Base + Index->DataOffset, Index->DataSize, Module->Base + Index->ListOffset, Index->ListSize);
+    IR->IsShared = true;
+
+    auto RAData = reinterpret_cast<IR::RegisterAllocationData*>(Module->Base + Index->RAOffset);
+
+    return &Module->Entries.insert({Offset, {Index->Start, Index->Len, Index->Crc, IR, RAData, true}}).first->second;
+  }
+
+  bool Context::WriteAOTCodeCache(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter) {
+    return AOTCode->Write(CacheWriter);
+  }
+
   bool Context::WriteAOTIRCache(std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter) {
     std::lock_guard<std::mutex> lk(AOTIRCacheLock);
 
     bool rv = true;
 
-    for (auto AOTModule: AOTIRCache) {
-      if (AOTModule.second.size() == 0) {
+    for (auto &[fileid, Mod]: AOTIRCache) {
+      // Carry over everything from the old file, the writer replaces it
+      for (uint64_t i = 0; i < Mod.IndexCount; ++i) {
+        FindAOTIREntry(&Mod, Mod.Index[i].Offset);
+      }
+
+      bool HasNewEntries = std::any_of(Mod.Entries.begin(), Mod.Entries.end(), [](auto const &Entry) {
+        return !Entry.second.Mapped;
+      });
+
+      if (!HasNewEntries) {
         continue;
       }
 
-      auto stream = CacheWriter(AOTModule.first);
+      // Lay out the file, std::map already keeps the index sorted
+      std::vector<AOTIRIndexEntry> Index;
+      Index.reserve(Mod.Entries.size());
+
+      uint64_t DataEnd = AlignUp(AOTIR_PAGE_SIZE + Mod.Entries.size() * sizeof(AOTIRIndexEntry), AOTIR_PAGE_SIZE);
+      for (auto &[Offset, Entry]: Mod.Entries) {
+        AOTIRIndexEntry &IndexEntry = Index.emplace_back();
+        IndexEntry.Offset = Offset;
+        IndexEntry.Start = Entry.start;
+        IndexEntry.Len = Entry.len;
+        IndexEntry.Crc = Entry.crc;
+
+        IndexEntry.DataOffset = AlignUp(DataEnd, AOTIR_DATA_ALIGNMENT);
+        IndexEntry.DataSize = Entry.IR->GetDataSize();
+        IndexEntry.ListOffset = AlignUp(IndexEntry.DataOffset + IndexEntry.DataSize, AOTIR_DATA_ALIGNMENT);
+        IndexEntry.ListSize = Entry.IR->GetListSize();
+        IndexEntry.RAOffset = AlignUp(IndexEntry.ListOffset + IndexEntry.ListSize, AOTIR_DATA_ALIGNMENT);
+        IndexEntry.RACount = Entry.RAData->MapCount;
+        DataEnd = IndexEntry.RAOffset + IR::RegisterAllocationData::Size(IndexEntry.RACount);
+      }
+
+      auto stream = CacheWriter(fileid);
       if (!*stream) {
         rv = false;
+        continue;
       }
-      uint64_t tag = 0xDEADBEEFC0D30002;
-      stream->write((char*)&tag, sizeof(tag));
-
-      uint64_t ModCount = 1;
-      stream->write((char*)&ModCount, sizeof(ModCount));
-      auto ModSize = AOTModule.first.size();
-      stream->write((char*)&ModSize, sizeof(ModSize));
-      stream->write((char*)&AOTModule.first[0], ModSize);
-
-      auto FnCount = AOTModule.second.size();
-      stream->write((char*)&FnCount, sizeof(FnCount));
-
-      for (auto entry: AOTModule.second) {
-        stream->write((char*)&entry.first, sizeof(entry.first));
-        stream->write((char*)&entry.second.start, sizeof(entry.second.start));
-        stream->write((char*)&entry.second.len, sizeof(entry.second.len));
-        stream->write((char*)&entry.second.crc, sizeof(entry.second.crc));
-        entry.second.IR->Serialize(*stream);
-        uint64_t RASize = entry.second.RAData->MapCount;
-        stream->write((char*)&RASize, sizeof(RASize));
-        stream->write((char*)&entry.second.RAData->Map[0], sizeof(entry.second.RAData->Map[0]) * RASize);
-        stream->write((char*)&entry.second.RAData->SpillSlotCount, sizeof(entry.second.RAData->SpillSlotCount));
+
+      uint64_t Written = 0;
+      auto Write = [&](void const *Data, uint64_t Size) {
+        stream->write(reinterpret_cast<char const*>(Data), Size);
+        Written += Size;
+      };
+
+      auto PadTo = [&](uint64_t Offset) {
+        static const char Zero[AOTIR_PAGE_SIZE]{};
+        while (Written < Offset) {
+          Write(Zero, std::min<uint64_t>(Offset - Written, sizeof(Zero)));
+        }
+      };
+
+      AOTIRFileHeader Header{};
+      Header.Tag = AOTIR_TAG;
+      Header.NumOps = IR::IROps::OP_LAST;
+      Header.IndexCount = Index.size();
+      Header.FileSize = DataEnd;
+      Write(&Header, sizeof(Header));
+
+      PadTo(AOTIR_PAGE_SIZE);
+      Write(Index.data(), Index.size() * sizeof(AOTIRIndexEntry));
+
+      size_t i = 0;
+      for (auto &[Offset, Entry]: Mod.Entries) {
+        auto &IndexEntry = Index[i++];
+        PadTo(IndexEntry.DataOffset);
+        Write(reinterpret_cast<void const*>(Entry.IR->GetData()), IndexEntry.DataSize);
+        PadTo(IndexEntry.ListOffset);
+        Write(reinterpret_cast<void const*>(Entry.IR->GetListData()), IndexEntry.ListSize);
+        PadTo(IndexEntry.RAOffset);
+        Write(Entry.RAData, IR::RegisterAllocationData::Size(IndexEntry.RACount));
+      }
+
+      if (!*stream) {
+        rv = false;
       }
     }
 
@@ -1024,10 +1323,24 @@ namespace FEXCore::Context {
 
 
   uintptr_t Context::CompileBlock(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
-    
+    if (SharedCache &&
+        Thread->CompileBlockReentrantRefCount == 0 &&
+        Thread->SignalHandlerRefCounter == 0) {
+      // Coming from the dispatcher with no guest code on the stack
+      SharedCache->QuiescentPoint(Thread);
+    }
+
+    // Invalidation from other threads leaves our IR, and without the shared cache our blocks, behind
+    BlockRanges->ErasePending(Thread);
+
+    uint64_t SMCGeneration = SMCTracking ? SMCTracking->GetGeneration() : 0;
+
     // Is the code in the cache?
     // The backends only check L1 and L2, not L3
     if (auto HostCode = Thread->LookupCache->FindBlock(GuestRIP)) {
+      if (SharedCache) {
+        SharedCache->Touch(HostCode);
+      }
       return HostCode;
     }
 
@@ -1039,6 +1352,7 @@ namespace FEXCore::Context {
     bool DecrementRefCount = false;
     bool GeneratedIR {};
     uint64_t StartAddr {}, Length {};
+    FEXCore::CompilePool::Profile *Profile {};
 
     if (Thread->CompileBlockReentrantRefCount != 0) {
       if (!Thread->CompileService) {
@@ -1064,14 +1378,32 @@ namespace FEXCore::Context {
     } else {
       ++Thread->CompileBlockReentrantRefCount;
       DecrementRefCount = true;
-      auto [Code, IR, Data, RA, Generated, _StartAddr, _Length] = CompileCode(Thread, GuestRIP);
-      CodePtr = Code;
-      IRList = IR;
-      DebugData = Data;
-      RAData = RA;
-      GeneratedIR = Generated;
-      StartAddr = _StartAddr;
-      Length = _Length;
+
+      if (Config.AOTCodeLoad) {
+        // Blocks from the host code cache don't have any IR to insert in to the other caches
+        CodePtr = LoadAOTCode(Thread, GuestRIP, &StartAddr, &Length);
+      }
+
+      if (!CodePtr) {
+        if (CompileThreadPool) {
+          // Count entries so the pool can recompile the block once it is hot
+          Profile = CompileThreadPool->AllocateProfile(GuestRIP);
+          Thread->CPUBackend->SetBlockEntryCounter(Profile ? &Profile->Counter : nullptr);
+        }
+
+        auto [Code, IR, Data, RA, Generated, _StartAddr, _Length] = CompileCode(Thread, GuestRIP);
+        CodePtr = Code;
+        IRList = IR;
+        DebugData = Data;
+        RAData = RA;
+        GeneratedIR = Generated;
+        StartAddr = _StartAddr;
+        Length = _Length;
+
+        if (Profile) {
+          Thread->CPUBackend->SetBlockEntryCounter(nullptr);
+        }
+      }
     }
 
     LogMan::Throw::A(CodePtr != nullptr, "Failed to compile code %lX", GuestRIP);
@@ -1092,6 +1424,9 @@ namespace FEXCore::Context {
     // Insert to caches if we generated IR
     if (GeneratedIR) {
       Core::LocalIREntry Entry = {StartAddr, Length, decltype(Entry.IR)(IRList), decltype(Entry.RAData)(RAData), decltype(Entry.DebugData)(DebugData)};
+      if (auto Deleter = Thread->CPUBackend->GetCodeDeleter()) {
+        Entry.Code = decltype(Entry.Code)(CodePtr, Deleter);
+      }
       Thread->LocalIRCache.insert({GuestRIP, std::move(Entry)});
 
       // Add to AOT cache if aot generation is enabled
@@ -1107,19 +1442,48 @@ namespace FEXCore::Context {
         if (file != AddrToFile.begin()) {
           --file;
           if (file->second.Start <= StartAddr && (file->second.Start + file->second.Len) >= (StartAddr + Length)) {
-            AOTIRCache[file->second.fileid].insert({GuestRIP - file->second.Start + file->second.Offset, {StartAddr - file->second.Start + file->second.Offset, Length, hash, IRList, RAData}});
+            AOTIRCache[file->second.fileid].Entries.insert({GuestRIP - file->second.Start + file->second.Offset, {StartAddr - file->second.Start + file->second.Offset, Length, hash, IRList, RAData, false}});
           }
         }
       }
     }
+    else if (auto Deleter = Thread->CPUBackend->GetCodeDeleter()) {
+      // Compiled again from IR we kept, the old code isn't reachable any more
+      Thread->LocalIRCache.at(GuestRIP).Code = decltype(Core::LocalIREntry::Code)(CodePtr, Deleter);
+    }
 
     if (DecrementRefCount)
       --Thread->CompileBlockReentrantRefCount;
 
+    BlockRanges->AddBlock(Thread, GuestRIP, StartAddr, Length);
+    if (SMCTracking) {
+      // Protect before publishing so no store can slip in between
+      SMCTracking->ProtectRange(StartAddr, Length);
+    }
+
     // Insert to lookup cache
-    AddBlockMapping(Thread, GuestRIP, CodePtr);
+    auto HostCode = AddBlockMapping(Thread, GuestRIP, CodePtr);
 
-    return (uintptr_t)CodePtr;
+    if (SMCTracking && SMCTracking->InvalidatedSince(StartAddr, Length, SMCGeneration)) {
+      // Another thread wrote to the code while we were decoding it, try again
+      if (Profile) {
+        CompileThreadPool->ReleaseProfile(Profile);
+      }
+      RemoveCodeEntry(Thread, GuestRIP);
+      return CompileBlock(Thread, GuestRIP);
+    }
+
+    if (Profile) {
+      // Another thread may have published this block first, only its code is entered from now on
+      if (HostCode == reinterpret_cast<uintptr_t>(CodePtr)) {
+        CompileThreadPool->ArmProfile(Profile, HostCode);
+      }
+      else {
+        CompileThreadPool->ReleaseProfile(Profile);
+      }
+    }
+
+    return HostCode;
 
     if (DecrementRefCount)
       --Thread->CompileBlockReentrantRefCount;
@@ -1151,6 +1515,11 @@ namespace FEXCore::Context {
 
     LogMan::Msg::D("[%d] Running", Thread->State.ThreadManager.TID.load());
 
+#if ENABLE_TLB_STATS
+    // Reported when the thread leaves, compare runs with and without --huge-pages
+    FEXCore::HostMemory::TLBMissCounters TLBMisses;
+#endif
+
     Thread->ExitReason = FEXCore::Context::ExitReason::EXIT_NONE;
 
     Thread->State.RunningEvents.Running = true;
@@ -1171,10 +1540,29 @@ namespace FEXCore::Context {
       }
     }
 
+    // Child threads are kept for reuse, thread pools and servers create and exit threads constantly
+    bool Reusable = Thread != ParentThread && !CoreShuttingDown.load();
+
+    if (SharedCache) {
+      SharedCache->UnregisterThread(Thread);
+    }
+
+    // A reusable thread keeps its code, so its blocks stay tracked for invalidation
+    if (!Reusable) {
+      BlockRanges->ThreadExited(Thread);
+    }
+
     --IdleWaitRefCount;
     IdleWaitCV.notify_all();
 
     SignalDelegation->UninstallTLSState(Thread);
+
+    if (Reusable) {
+      std::lock_guard<std::mutex> lk(ThreadCreationMutex);
+      Threads.erase(std::find(Threads.begin(), Threads.end(), Thread));
+      Thread->Recycled = true;
+      IdleThreads.emplace_back(Thread);
+    }
   }
 
   void Context::RemoveCodeEntry(FEXCore::Core::InternalThreadState *Thread, uint64_t GuestRIP) {
@@ -1205,7 +1593,9 @@ namespace FEXCore::Context {
   }
 
   FEXCore::Core::CPUState Context::GetCPUState() {
-    return ParentThread->State.State;
+    FEXCore::Core::CPUState State = ParentThread->State.State;
+    FEXCore::CPU::CalculateDeferredFlags(&State);
+    return State;
   }
 
   bool Context::GetDebugDataForRIP(uint64_t RIP, FEXCore::Core::DebugData *Data) {
@@ -1248,17 +1638,26 @@ namespace FEXCore::Context {
       auto fileid = base_filename + "-" + std::to_string(filename_hash) + "-";
 
       // append optimization flags to the fileid
-      fileid += Config.SMCChecks ? "S" : "s";
+      fileid += Config.SMCChecks == FEXCore::Config::CONFIG_SMC_FULL ? "S" : "s";
       fileid += Config.TSOEnabled ? "T" : "t";
       fileid += Config.ABILocalFlags ? "L" : "l";
       fileid += Config.ABINoPF ? "p" : "P";
 
-      AddrToFile.insert({ Base, { Base, Size, Offset, fileid, nullptr } });
+      AddrToFile.insert({ Base, { Base, Size, Offset, fileid, nullptr, nullptr } });
 
-      if (Config.AOTIRLoad && !AOTIRCache.contains(fileid) && AOTIRLoader) {
-        auto stream = AOTIRLoader(fileid);
-        if (*stream) {
-          LoadAOTIRCache(*stream);
+      if (Config.AOTIRLoad && AOTIRLoader) {
+        int fd = AOTIRLoader(fileid);
+        LoadAOTIRCache(fileid, fd);
+        if (fd != -1) {
+          close(fd);
+        }
+      }
+
+      if (Config.AOTCodeLoad && AOTCodeLoader && !AOTCode->HasModule(fileid)) {
+        int fd = AOTCodeLoader(fileid);
+        AOTCode->LoadModule(fileid, fd);
+        if (fd != -1) {
+          close(fd);
         }
       }
     }
@@ -1268,4 +1667,58 @@ namespace FEXCore::Context {
     // TODO: Support partial removing
     AddrToFile.erase(Base);
   }
+
+  void Context::InvalidateGuestCodeRange(uint64_t Base, uint64_t Size) {
+    BlockRanges->Invalidate(Core::ThreadData.Thread, Base, Size);
+  }
+
+  void Context::GuestMemoryChangeBegin() {
+    // Only compile threads read guest code they weren't asked to run
+    if (CompileThreadPool) {
+      GuestMemoryChangeLock.lock();
+    }
+  }
+
+  void Context::GuestMemoryChangeEnd() {
+    if (CompileThreadPool) {
+      GuestMemoryChangeLock.unlock();
+    }
+  }
+
+  void Context::GuestMemoryMapped(uintptr_t Base, uintptr_t Size, int Prot) {
+    if (SMCTracking) {
+      SMCTracking->MemoryMapped(Base, Size, Prot);
+    }
+
+    // A fixed mapping replaces whatever code was here
+    InvalidateGuestCodeRange(Base, Size);
+  }
+
+  void Context::GuestMemoryProtected(uintptr_t Base, uintptr_t Size, int Prot) {
+    if (SMCTracking) {
+      SMCTracking->MemoryProtected(Base, Size, Prot);
+    }
+
+    // JITs flip their code pages between writable and executable around modifying them
+    // Code only goes stale once it can be written, or can't be read or run any more. Going back to read and execute
+    // keeps what was compiled, anything compiled before the page became writable was already thrown away then
+    constexpr int CodeProt = PROT_READ | PROT_EXEC;
+    if ((Prot & PROT_WRITE) || (Prot & CodeProt) != CodeProt) {
+      InvalidateGuestCodeRange(Base, Size);
+    }
+  }
+
+  void Context::PrepareGuestMemoryHostWrite(uintptr_t Base, uintptr_t Size) {
+    if (SMCTracking) {
+      SMCTracking->PrepareHostWrite(Base, Size);
+    }
+  }
+
+  void Context::GuestMemoryUnmapped(uintptr_t Base, uintptr_t Size) {
+    if (SMCTracking) {
+      SMCTracking->MemoryUnmapped(Base, Size);
+    }
+
+    InvalidateGuestCodeRange(Base, Size);
+  }
 }
@@ -0,0 +1,54 @@
+#include "Interface/Core/DeferredFlags.h"
+
+#include <FEXCore/Core/X86Enums.h>
+#include <FEXCore/Utils/LogManager.h>
+
+namespace FEXCore::CPU {
+void CalculateDeferredFlags(FEXCore::Core::CPUState *State) {
+  auto Op = State->DeferredFlagsOp;
+  if (Op == DEFERRED_FLAGS_NONE) {
+    return;
+  }
+
+  uint32_t Bits = State->DeferredFlagsSize * 8;
+  uint64_t Mask = Bits == 64 ? ~0ULL : (1ULL << Bits) - 1;
+  uint32_t SignBit = Bits - 1;
+
+  // Generated code stores full registers, the operation only cares about the operand size
+  uint64_t Res = State->DeferredFlagsRes & Mask;
+  uint64_t Src1 = State->DeferredFlagsSrc1 & Mask;
+  uint64_t Src2 = State->DeferredFlagsSrc2 & Mask;
+
+  auto Flags = State->flags;
+  Flags[FEXCore::X86State::RFLAG_SF_LOC] = (Res >> SignBit) & 1;
+  Flags[FEXCore::X86State::RFLAG_ZF_LOC] = Res == 0;
+  Flags[FEXCore::X86State::RFLAG_PF_LOC] = (__builtin_popcountll(Res & 0xFF) & 1) ^ 1;
+
+  switch (Op) {
+  case DEFERRED_FLAGS_ADD:
+  case DEFERRED_FLAGS_INC:
+    Flags[FEXCore::X86State::RFLAG_AF_LOC] = ((Src1 ^ Src2 ^ Res) >> 4) & 1;
+    Flags[FEXCore::X86State::RFLAG_OF_LOC] = ((~(Src1 ^ Src2) & (Res ^ Src1)) >> SignBit) & 1;
+    if (Op == DEFERRED_FLAGS_ADD) {
+      Flags[FEXCore::X86State::RFLAG_CF_LOC] = Res < Src2;
+    }
+  break;
+  case DEFERRED_FLAGS_SUB:
+  case DEFERRED_FLAGS_DEC:
+    Flags[FEXCore::X86State::RFLAG_AF_LOC] = ((Src1 ^ Src2 ^ Res) >> 4) & 1;
+    Flags[FEXCore::X86State::RFLAG_OF_LOC] = (((Src1 ^ Src2) & (Res ^ Src1)) >> SignBit) & 1;
+    if (Op == DEFERRED_FLAGS_SUB) {
+      Flags[FEXCore::X86State::RFLAG_CF_LOC] = Src1 < Src2;
+    }
+  break;
+  case DEFERRED_FLAGS_LOGICAL:
+    Flags[FEXCore::X86State::RFLAG_AF_LOC] = 0;
+    Flags[FEXCore::X86State::RFLAG_CF_LOC] = 0;
+    Flags[FEXCore::X86State::RFLAG_OF_LOC] = 0;
+  break;
+  default: LogMan::Msg::A("Unknown deferred flags op: %d", Op); break;
+  }
+
+  State->DeferredFlagsOp = DEFERRED_FLAGS_NONE;
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <FEXCore/Core/CoreState.h>
+
+#include <stdint.h>
+
+/**
+ * @brief Lazy calculation of the arithmetic flags
+ *
+ * The frontend doesn't calculate the flags of the last ADD, SUB, INC, DEC or logical op in a block.
+ * It stores its kind, size, result and sources in to the context instead, the flags are only calculated
+ * once something reads them. Code that doesn't know the producer at compile time calls CalculateDeferredFlags.
+ */
+namespace FEXCore::CPU {
+  enum DeferredFlagsType : uint8_t {
+    DEFERRED_FLAGS_NONE = 0, ///< flags is up to date
+    DEFERRED_FLAGS_ADD,
+    DEFERRED_FLAGS_SUB,
+    DEFERRED_FLAGS_INC,      ///< ADD that leaves CF alone
+    DEFERRED_FLAGS_DEC,      ///< SUB that leaves CF alone
+    DEFERRED_FLAGS_LOGICAL,
+  };
+
+  /**
+   * @brief Calculates CF, PF, AF, ZF, SF and OF from the deferred producer in to flags
+   *
+   * Does nothing if there is no deferred producer, afterwards there is never one.
+   * Called by generated code, it only touches the flags and the deferred state.
+   */
+  void CalculateDeferredFlags(FEXCore::Core::CPUState *State);
+}
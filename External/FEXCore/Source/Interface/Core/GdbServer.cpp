@@ -19,6 +19,7 @@
 #include <fstream>
 
 #include "GdbServer.h"
+#include "Interface/Core/DeferredFlags.h"
 #include <FEXCore/Core/CodeLoader.h>
 #include <FEXCore/Core/X86Enums.h>
 
@@ -231,7 +232,7 @@ std::string GdbServer::readRegs() {
   auto Threads = CTX->GetThreads();
   bool Found = false;
 
-  for (auto &Thread : *Threads) {
+  for (auto &Thread : Threads) {
     if (Thread->State.ThreadManager.GetTID() != CurrentDebuggingThread) {
       continue;
     }
@@ -245,6 +246,9 @@ std::string GdbServer::readRegs() {
     state = CTX->GetCPUState();
   }
 
+  // The thread may not have calculated its last flags yet
+  FEXCore::CPU::CalculateDeferredFlags(&state);
+
   // Encode the GDB context definition
   memcpy(&GDB.gregs[0], &state.gregs[0], sizeof(GDB.gregs));
   memcpy(&GDB.rip, &state.rip, sizeof(GDB.rip));
@@ -283,7 +287,7 @@ GdbServer::HandledPacketType GdbServer::readReg(std::string& packet) {
   auto Threads = CTX->GetThreads();
   bool Found = false;
 
-  for (auto &Thread : *Threads) {
+  for (auto &Thread : Threads) {
     if (Thread->State.ThreadManager.GetTID() != CurrentDebuggingThread) {
       continue;
     }
@@ -523,8 +527,8 @@ GdbServer::HandledPacketType GdbServer::handleXfer(std::string &packet) {
         std::ostringstream ss;
         ss << "<?xml version=\"1.0\?>\n";
         ss << "<threads>\n";
-        for (size_t i = 0; i < Threads->size(); ++i) {
-          auto Thread = Threads->at(i);
+        for (size_t i = 0; i < Threads.size(); ++i) {
+          auto Thread = Threads.at(i);
           ss << "\t<thread id=\"" << std::hex << Thread->State.ThreadManager.GetTID() << "\" core=\"" << i << "\" name=\"" <<  getThreadName(Thread->State.ThreadManager.GetTID()) << "\">\n";
           ss << "\t</thread>\n";
         }
@@ -651,8 +655,8 @@ GdbServer::HandledPacketType GdbServer::handleQuery(std::string &packet) {
 
     std::ostringstream ss;
     ss << "m";
-    for (size_t i = 0; i < Threads->size(); ++i) {
-      auto Thread = Threads->at(i);
+    for (size_t i = 0; i < Threads.size(); ++i) {
+      auto Thread = Threads.at(i);
       ss << std::hex << Thread->State.ThreadManager.TID << ",";
     }
     return {ss.str(), HandledPacketType::TYPE_ACK};
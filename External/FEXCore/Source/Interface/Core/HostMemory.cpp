@@ -0,0 +1,144 @@
+#include "Interface/Context/Context.h"
+#include "Interface/Core/HostMemory.h"
+
+#include <FEXCore/Utils/LogManager.h>
+
+#include <cstring>
+#include <linux/mempolicy.h>
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <vector>
+
+namespace FEXCore::HostMemory {
+  static bool UsesHugePages(size_t Size, Policy const &Policy) {
+    return Policy.HugePages != FEXCore::Config::CONFIG_HUGEPAGES_NONE && Size >= HUGE_PAGE_SIZE;
+  }
+
+  static size_t MappedSize(size_t Size, Policy const &Policy) {
+    if (UsesHugePages(Size, Policy)) {
+      return (Size + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1);
+    }
+    return Size;
+  }
+
+  static void BindToLocalNode(void *Ptr, size_t Size) {
+    unsigned CPU, Node;
+    if (::syscall(SYS_getcpu, &CPU, &Node, nullptr) != 0) {
+      return;
+    }
+
+    // Preferred instead of bind so we still get memory once the node is full
+    std::vector<unsigned long> NodeMask(Node / (sizeof(unsigned long) * 8) + 1);
+    NodeMask[Node / (sizeof(unsigned long) * 8)] = 1UL << (Node % (sizeof(unsigned long) * 8));
+    if (::syscall(SYS_mbind, Ptr, Size, MPOL_PREFERRED, NodeMask.data(), NodeMask.size() * sizeof(unsigned long) * 8 + 1, 0) != 0) {
+      LogMan::Msg::D("Couldn't bind JIT memory to NUMA node %d", Node);
+    }
+  }
+
+  Policy GetPolicy(FEXCore::Context::Context *CTX) {
+    return {CTX->Config.HugePages, CTX->Config.NUMALocal};
+  }
+
+  void *Allocate(size_t Size, int Prot, Policy const &Policy) {
+    size_t Mapped = MappedSize(Size, Policy);
+    void *Ptr = MAP_FAILED;
+
+    if (UsesHugePages(Size, Policy) && Policy.HugePages == FEXCore::Config::CONFIG_HUGEPAGES_HUGETLB) {
+      Ptr = mmap(nullptr, Mapped, Prot, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (Ptr == MAP_FAILED) {
+        LogMan::Msg::D("Out of hugetlbfs pages, falling back to transparent huge pages");
+      }
+    }
+
+    if (Ptr == MAP_FAILED && UsesHugePages(Size, Policy)) {
+      // Overallocate so the range can be trimmed to a huge page boundary
+      uint8_t *Reserved = static_cast<uint8_t*>(mmap(nullptr, Mapped + HUGE_PAGE_SIZE, Prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+      if (Reserved == MAP_FAILED) {
+        return nullptr;
+      }
+
+      uint8_t *Aligned = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(Reserved) + HUGE_PAGE_SIZE - 1) & ~(HUGE_PAGE_SIZE - 1));
+      if (Aligned != Reserved) {
+        munmap(Reserved, Aligned - Reserved);
+      }
+      munmap(Aligned + Mapped, (Reserved + HUGE_PAGE_SIZE) - Aligned);
+
+      madvise(Aligned, Mapped, MADV_HUGEPAGE);
+      Ptr = Aligned;
+    }
+
+    if (Ptr == MAP_FAILED) {
+      Ptr = mmap(nullptr, Mapped, Prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (Ptr == MAP_FAILED) {
+        return nullptr;
+      }
+    }
+
+    if (Policy.NUMALocal) {
+      BindToLocalNode(Ptr, Mapped);
+    }
+
+    return Ptr;
+  }
+
+  void Free(void *Ptr, size_t Size, Policy const &Policy) {
+    munmap(Ptr, MappedSize(Size, Policy));
+  }
+
+  void Advise(void *Ptr, size_t Size, Policy const &Policy) {
+    if (UsesHugePages(Size, Policy)) {
+      madvise(Ptr, Size, MADV_HUGEPAGE);
+    }
+
+    if (Policy.NUMALocal) {
+      BindToLocalNode(Ptr, Size);
+    }
+  }
+
+  void Discard(void *Ptr, size_t Size) {
+    if (madvise(Ptr, Size, MADV_DONTNEED) != 0) {
+      memset(Ptr, 0, Size);
+    }
+  }
+
+  static int OpenTLBCounter(uint64_t Cache) {
+    perf_event_attr Attr{};
+    Attr.type = PERF_TYPE_HW_CACHE;
+    Attr.size = sizeof(Attr);
+    Attr.config = Cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    Attr.exclude_kernel = 1;
+    Attr.exclude_hv = 1;
+    return ::syscall(SYS_perf_event_open, &Attr, 0, -1, -1, 0);
+  }
+
+  static uint64_t ReadTLBCounter(int FD) {
+    uint64_t Value{};
+    if (FD == -1 || read(FD, &Value, sizeof(Value)) != sizeof(Value)) {
+      return 0;
+    }
+    return Value;
+  }
+
+  TLBMissCounters::TLBMissCounters()
+    : ITLBFD {OpenTLBCounter(PERF_COUNT_HW_CACHE_ITLB)}
+    , DTLBFD {OpenTLBCounter(PERF_COUNT_HW_CACHE_DTLB)} {
+    if (ITLBFD == -1 || DTLBFD == -1) {
+      LogMan::Msg::D("TLB miss counters aren't available");
+    }
+  }
+
+  TLBMissCounters::~TLBMissCounters() {
+    if (ITLBFD != -1 || DTLBFD != -1) {
+      LogMan::Msg::I("[%d] TLB misses: iTLB %ld dTLB %ld", ::gettid(), ReadTLBCounter(ITLBFD), ReadTLBCounter(DTLBFD));
+    }
+
+    if (ITLBFD != -1) {
+      close(ITLBFD);
+    }
+    if (DTLBFD != -1) {
+      close(DTLBFD);
+    }
+  }
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <FEXCore/Config/Config.h>
+
+#include <cstddef>
+#include <stdint.h>
+
+namespace FEXCore::Context {
+  struct Context;
+}
+
+/**
+ * @brief Backing for the JIT's own large allocations
+ *
+ * Code buffers and lookup tables are hammered by the dispatcher, so with enough guest code they miss in the iTLB and
+ * dTLB constantly. These can optionally be backed by 2MB pages, either transparent huge pages or hugetlbfs pages, and
+ * be bound to the NUMA node of the thread that allocates them.
+ *
+ * Only allocations of at least HUGE_PAGE_SIZE use huge pages, their size is rounded up to a multiple of it.
+ * Free has to be passed the same size and policy as Allocate so it unmaps the same range.
+ */
+namespace FEXCore::HostMemory {
+  constexpr static size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  struct Policy {
+    FEXCore::Config::ConfigHugePages HugePages {FEXCore::Config::CONFIG_HUGEPAGES_NONE};
+    bool NUMALocal {false};
+  };
+
+  Policy GetPolicy(FEXCore::Context::Context *CTX);
+
+  /**
+   * @brief Maps private anonymous memory following the policy
+   *
+   * Falls back to transparent huge pages if no hugetlbfs pages are available
+   *
+   * @return nullptr on failure
+   */
+  void *Allocate(size_t Size, int Prot, Policy const &Policy);
+  void Free(void *Ptr, size_t Size, Policy const &Policy);
+
+  /**
+   * @brief Applies the policy to memory that is already mapped
+   *
+   * hugetlbfs pages can't be applied after the fact, transparent huge pages are used instead
+   */
+  void Advise(void *Ptr, size_t Size, Policy const &Policy);
+
+  /**
+   * @brief Gives the memory back to the kernel, it reads as zero afterwards
+   *
+   * hugetlbfs pages can't always be discarded, those are cleared instead
+   */
+  void Discard(void *Ptr, size_t Size);
+
+  /**
+   * @brief Counts the iTLB and dTLB misses of the calling thread
+   *
+   * Reports them when destroyed. Silently does nothing if perf events aren't available.
+   */
+  class TLBMissCounters final {
+  public:
+    TLBMissCounters();
+    ~TLBMissCounters();
+
+  private:
+    int ITLBFD {-1};
+    int DTLBFD {-1};
+  };
+}
@@ -233,9 +233,11 @@ DispatchGenerator::DispatchGenerator(FEXCore::Context::Context *ctx, FEXCore::Co
     cbz(x1, &NoBlock);
 
     // If we've made it here then we have a real compiled block
+    // The block pointer is the decoded IR, hand it to the interpreter loop
     {
       mov(x0, STATE);
-      blr(x1);
+      LoadConstant(x2, reinterpret_cast<uint64_t>(&InterpreterOps::InterpretIR));
+      blr(x2);
     }
 
     if (CTX->GetGdbServerStatus()) {
@@ -2,6 +2,7 @@
 
 #include "Interface/Core/LookupCache.h"
 #include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/Interpreter/InterpreterOps.h"
 
 #include <FEXCore/Core/CPUBackend.h>
 #include <FEXCore/IR/IR.h>
@@ -28,6 +29,8 @@ public:
 
   bool NeedsOpDispatch() override { return true; }
 
+  CodeDeleter GetCodeDeleter() override { return InterpreterOps::DeleteDecodedIR; }
+
   void CreateAsmDispatch(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread);
   void DeleteAsmDispatch();
 
@@ -30,12 +30,6 @@
 
 namespace FEXCore::CPU {
 
-static void InterpreterExecution(FEXCore::Core::InternalThreadState *Thread) {
-  auto LocalEntry = Thread->LocalIRCache.find(Thread->State.State.rip);
-  
-  InterpreterOps::InterpretIR(Thread, LocalEntry->second.IR.get(), LocalEntry->second.DebugData.get());
-}
-
 
 bool InterpreterCore::HandleSIGBUS(int Signal, void *info, void *ucontext) {
 #ifdef _M_ARM_64
@@ -104,8 +98,10 @@ InterpreterCore::~InterpreterCore() {
 }
 
 
-void *InterpreterCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [[maybe_unused]] FEXCore::Core::DebugData *DebugData, FEXCore::IR::RegisterAllocationData *RAData) {
-  return reinterpret_cast<void*>(InterpreterExecution);
+void *InterpreterCore::CompileCode(FEXCore::IR::IRListView const *IR, FEXCore::Core::DebugData *DebugData, [[maybe_unused]] FEXCore::IR::RegisterAllocationData *RAData) {
+  // The dispatcher hands this straight back to InterpretIR, no need to find the IR again per block
+  // Freed by the block's LocalIREntry through GetCodeDeleter
+  return InterpreterOps::DecodeIR(IR, DebugData).release();
 }
 
 FEXCore::CPU::CPUBackend *CreateInterpreterCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread, bool CompileThread) {
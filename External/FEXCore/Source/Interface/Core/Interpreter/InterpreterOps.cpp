@@ -8,6 +8,7 @@
 #endif
 #include "Interface/Core/LookupCache.h"
 #include "Interface/Core/DebugData.h"
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/InternalThreadState.h"
 #include "Interface/Core/Interpreter/InterpreterClass.h"
 #include <FEXCore/Utils/LogManager.h>
@@ -19,8 +20,10 @@
 
 #include "Interface/HLE/Thunks/Thunks.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
+#include <initializer_list>
 #include <limits>
 #include <vector>
 #ifdef _M_X86_64
@@ -922,58 +925,226 @@ bool InterpreterOps::GetFallbackHandler(IR::IROp_Header *IROp, FallbackInfo *Inf
   return false;
 }
 
-void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEXCore::IR::IRListView *CurrentIR, FEXCore::Core::DebugData *DebugData) {
-  volatile void* stack = alloca(0);
+namespace {
+  // Handlers the threaded loop dispatches to directly, everything else goes through InterpretOp
+  enum DecodedHandler {
+    HANDLER_FALLBACK,
+    HANDLER_NOP,
+    HANDLER_CONSTANT,
+    HANDLER_LOADCONTEXT,
+    HANDLER_STORECONTEXT,
+    HANDLER_LOADMEM,
+    HANDLER_LOADMEM_OFFSET,
+    HANDLER_STOREMEM,
+    HANDLER_STOREMEM_OFFSET,
+    HANDLER_ADD,
+    HANDLER_SUB,
+    HANDLER_AND,
+    HANDLER_OR,
+    HANDLER_XOR,
+    HANDLER_BFE,
+    HANDLER_SELECT,
+    HANDLER_MOV,
+    HANDLER_JUMP,
+    HANDLER_CONDJUMP,
+    HANDLER_EXITFUNCTION,
+    HANDLER_SIGNALRETURN,
+    HANDLER_CALLBACKRETURN,
+    HANDLER_END,
+    HANDLER_COUNT,
+  };
+}
 
-  // Debug data is only passed in debug builds
-  #ifndef NDEBUG
-  // TODO: should be moved to an IR Op
-  Thread->Stats.InstructionsExecuted.fetch_add(DebugData->GuestInstructionCount);
-  #endif
+std::unique_ptr<DecodedIR> InterpreterOps::DecodeIR(FEXCore::IR::IRListView const *CurrentIR, FEXCore::Core::DebugData *DebugData) {
+  using namespace FEXCore::IR;
 
-  uintptr_t ListSize = CurrentIR->GetSSACount();
+  auto Decoded = std::make_unique<DecodedIR>();
+  Decoded->IR = CurrentIR;
+  Decoded->DebugData = DebugData;
 
   uintptr_t ListBegin = CurrentIR->GetListData();
-  uintptr_t DataBegin = CurrentIR->GetData();
+  size_t ListSize = CurrentIR->GetSSACount();
 
-  static_assert(sizeof(FEXCore::IR::IROp_Header) == 4);
-  static_assert(sizeof(FEXCore::IR::OrderedNode) == 16);
+  // Block node ID to the index of its first op
+  std::vector<uint32_t> BlockStart(ListSize);
+  // Jumps to patch once all the blocks are placed
+  std::vector<uint32_t> Jumps;
 
-  auto BlockIterator = CurrentIR->GetBlocks().begin();
-  auto BlockEnd = CurrentIR->GetBlocks().end();
+  auto IsSize = [](uint8_t Size, std::initializer_list<uint8_t> Sizes) {
+    return std::find(Sizes.begin(), Sizes.end(), Size) != Sizes.end();
+  };
 
-  // Allocate 16 bytes per SSA
-  void *SSAData = alloca(ListSize * 16);
+  for (auto [BlockNode, BlockHeader] : CurrentIR->GetBlocks()) {
+    auto BlockIROp = BlockHeader->CW<IROp_CodeBlock>();
+    LogMan::Throw::A(BlockIROp->Header.Op == IR::OP_CODEBLOCK, "IR type failed to be a code block");
+
+    BlockStart[CurrentIR->GetID(BlockNode)] = Decoded->Ops.size();
+    auto CodeLast = CurrentIR->GetNode(BlockIROp->Last);
 
-  // Clear them all to zero. Required for Zero-extend semantics
-  memset(SSAData, 0, ListSize * 16);
+    for (auto [CodeNode, IROp] : CurrentIR->GetCode(BlockNode)) {
+      DecodedOp Op{};
+      Op.Handler = HANDLER_FALLBACK;
+      Op.Size = IROp->Size;
+      Op.Dest = CodeNode->Wrapped(ListBegin).ID();
+      Op.Node = CodeNode;
+      Op.IROp = IROp;
+
+      for (uint8_t i = 0; i < std::min<uint8_t>(IROp->NumArgs, 4); ++i) {
+        Op.Src[i] = IROp->Args[i].ID();
+      }
+
+      switch (IROp->Op) {
+        case IR::OP_DUMMY:
+        case IR::OP_BEGINBLOCK:
+        case IR::OP_ENDBLOCK:
+        case IR::OP_INVALIDATEFLAGS:
+        case IR::OP_GUESTCALLDIRECT:
+        case IR::OP_GUESTCALLINDIRECT:
+          Op.Handler = HANDLER_NOP;
+          break;
+        case IR::OP_CONSTANT:
+          Op.Handler = HANDLER_CONSTANT;
+          Op.Imm = IROp->C<IR::IROp_Constant>()->Constant;
+          break;
+        case IR::OP_LOADCONTEXT:
+          if (IsSize(Op.Size, {1, 2, 4, 8, 16})) {
+            Op.Handler = HANDLER_LOADCONTEXT;
+            Op.Imm = IROp->C<IR::IROp_LoadContext>()->Offset;
+          }
+          break;
+        case IR::OP_STORECONTEXT:
+          Op.Handler = HANDLER_STORECONTEXT;
+          Op.Imm = IROp->C<IR::IROp_StoreContext>()->Offset;
+          break;
+        case IR::OP_LOADMEM:
+        case IR::OP_LOADMEMTSO: {
+          auto LoadOp = IROp->C<IR::IROp_LoadMem>();
+          Op.Handler = LoadOp->Offset.IsInvalid() ? HANDLER_LOADMEM : HANDLER_LOADMEM_OFFSET;
+          Op.Size = LoadOp->Size;
+          Op.Cond = LoadOp->OffsetType.Val;
+          Op.Imm = LoadOp->OffsetScale;
+          Op.Disp = LoadOp->OffsetDisp;
+          break;
+        }
+        case IR::OP_STOREMEM:
+        case IR::OP_STOREMEMTSO: {
+          auto StoreOp = IROp->C<IR::IROp_StoreMem>();
+          Op.Handler = StoreOp->Offset.IsInvalid() ? HANDLER_STOREMEM : HANDLER_STOREMEM_OFFSET;
+          Op.Size = StoreOp->Size;
+          Op.Cond = StoreOp->OffsetType.Val;
+          Op.Imm = StoreOp->OffsetScale;
+          Op.Disp = StoreOp->OffsetDisp;
+          break;
+        }
+        case IR::OP_ADD:
+          if (IsSize(Op.Size, {4, 8})) Op.Handler = HANDLER_ADD;
+          break;
+        case IR::OP_SUB:
+          if (IsSize(Op.Size, {4, 8})) Op.Handler = HANDLER_SUB;
+          break;
+        case IR::OP_AND:
+          if (IsSize(Op.Size, {1, 2, 4, 8})) Op.Handler = HANDLER_AND;
+          break;
+        case IR::OP_OR:
+          if (IsSize(Op.Size, {1, 2, 4, 8})) Op.Handler = HANDLER_OR;
+          break;
+        case IR::OP_XOR:
+          if (IsSize(Op.Size, {1, 2, 4, 8})) Op.Handler = HANDLER_XOR;
+          break;
+        case IR::OP_BFE: {
+          auto BfeOp = IROp->C<IR::IROp_Bfe>();
+          if (Op.Size <= 8) {
+            uint64_t SourceMask = (1ULL << BfeOp->Width) - 1;
+            if (BfeOp->Width == 64)
+              SourceMask = ~0ULL;
+            Op.Handler = HANDLER_BFE;
+            Op.Imm = SourceMask << BfeOp->lsb;
+            Op.Cond = BfeOp->lsb;
+          }
+          break;
+        }
+        case IR::OP_SELECT: {
+          auto SelectOp = IROp->C<IR::IROp_Select>();
+          Op.Handler = HANDLER_SELECT;
+          Op.Cond = SelectOp->Cond.Val;
+          Op.CompareSize = SelectOp->CompareSize;
+          break;
+        }
+        case IR::OP_MOV:
+          Op.Handler = HANDLER_MOV;
+          break;
+        case IR::OP_JUMP:
+          Op.Handler = HANDLER_JUMP;
+          Jumps.emplace_back(Decoded->Ops.size());
+          break;
+        case IR::OP_CONDJUMP: {
+          auto CondJumpOp = IROp->C<IR::IROp_CondJump>();
+          Op.Handler = HANDLER_CONDJUMP;
+          Op.Cond = CondJumpOp->Cond.Val;
+          Op.CompareSize = CondJumpOp->CompareSize;
+          Jumps.emplace_back(Decoded->Ops.size());
+          break;
+        }
+        case IR::OP_EXITFUNCTION:
+        // Return prediction only matters for the JITs
+        case IR::OP_GUESTRETURN:
+          Op.Handler = HANDLER_EXITFUNCTION;
+          break;
+        case IR::OP_SIGNALRETURN:
+          Op.Handler = HANDLER_SIGNALRETURN;
+          break;
+        case IR::OP_CALLBACKRETURN:
+          Op.Handler = HANDLER_CALLBACKRETURN;
+          break;
+        default:
+          break;
+      }
+
+      Decoded->Ops.emplace_back(Op);
+
+      // CodeLast is inclusive. So we still need to dump the CodeLast op as well
+      if (CodeNode == CodeLast) {
+        break;
+      }
+    }
+  }
+
+  // Falling off the last block leaves the interpreter
+  DecodedOp End{};
+  End.Handler = HANDLER_END;
+  Decoded->Ops.emplace_back(End);
+
+  // Successors resolve to op indices so taking a branch never walks the IR
+  for (auto Index : Jumps) {
+    auto &Op = Decoded->Ops[Index];
+    if (Op.Handler == HANDLER_JUMP) {
+      Op.Imm = BlockStart[Op.Src[0]];
+    }
+    else {
+      auto CondJumpOp = Op.IROp->C<IR::IROp_CondJump>();
+      Op.Imm = BlockStart[CondJumpOp->TrueBlock.ID()] | (static_cast<uint64_t>(BlockStart[CondJumpOp->FalseBlock.ID()]) << 32);
+    }
+  }
+
+  return Decoded;
+}
 
 #define GD *GetDest<uint64_t*>(SSAData, WrapperOp)
 #define GDP GetDest<void*>(SSAData, WrapperOp)
+
+static void InterpretOp(FEXCore::Core::InternalThreadState *Thread, FEXCore::IR::IRListView const *CurrentIR, void *SSAData, FEXCore::IR::OrderedNode *CodeNode, FEXCore::IR::IROp_Header *IROp) {
+  using namespace FEXCore::IR;
+
+  uintptr_t ListBegin = CurrentIR->GetListData();
+  OrderedNodeWrapper WrapperOp = CodeNode->Wrapped(ListBegin);
+  uint8_t OpSize = IROp->Size;
+
   auto GetOpSize = [&](IR::OrderedNodeWrapper Node) {
     auto IROp = CurrentIR->GetOp<FEXCore::IR::IROp_Header>(Node);
     return IROp->Size;
   };
 
-  while (1) {
-    using namespace FEXCore::IR;
-    auto [BlockNode, BlockHeader] = BlockIterator();
-    auto BlockIROp = BlockHeader->CW<IROp_CodeBlock>();
-    LogMan::Throw::A(BlockIROp->Header.Op == IR::OP_CODEBLOCK, "IR type failed to be a code block");
-
-    // We grab these nodes this way so we can iterate easily
-    auto CodeBegin = CurrentIR->at(BlockIROp->Begin);
-    auto CodeLast = CurrentIR->at(BlockIROp->Last);
-    struct {
-      bool Quit;
-      bool Redo;
-    } BlockResults{};
-
-    auto HandleBlock = [&](OrderedNode *BlockNode) {
-      for (auto [CodeNode, IROp] : CurrentIR->GetCode(BlockNode)) {
-        OrderedNodeWrapper WrapperOp = CodeNode->Wrapped(ListBegin);
-        uint8_t OpSize = IROp->Size;
-
+  // Kept at the indentation of the old per block loop so the history of every op stays intact
         switch (IROp->Op) {
           case IR::OP_VALIDATECODE: {
             auto Op = IROp->C<IR::IROp_ValidateCode>();
@@ -997,6 +1168,8 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
           case IR::OP_BEGINBLOCK:
           case IR::OP_ENDBLOCK:
           case IR::OP_INVALIDATEFLAGS:
+          case IR::OP_GUESTCALLDIRECT:
+          case IR::OP_GUESTCALLINDIRECT:
             break;
           case IR::OP_FENCE: {
             auto Op = IROp->C<IR::IROp_Fence>();
@@ -1014,48 +1187,6 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
             }
             break;
           }
-          case IR::OP_EXITFUNCTION: {
-            auto Op = IROp->C<IR::IROp_ExitFunction>();
-            uintptr_t* ContextPtr = reinterpret_cast<uintptr_t*>(&Thread->State.State.rip);
-
-            void *Data = reinterpret_cast<void*>(ContextPtr);
-            void *Src = GetSrc<void*>(SSAData, Op->Header.Args[0]);
-
-            memcpy(Data, Src, OpSize);
-
-            BlockResults.Quit = true;
-            return;
-            break;
-          }
-          case IR::OP_CONDJUMP: {
-            auto Op = IROp->C<IR::IROp_CondJump>();
-            bool CompResult;
-
-            uint64_t Src1 = *GetSrc<uint64_t*>(SSAData, Op->Cmp1);
-            uint64_t Src2 = *GetSrc<uint64_t*>(SSAData, Op->Cmp2);
-
-            if (Op->CompareSize == 4)
-              CompResult = IsConditionTrue<uint32_t, int32_t, float>(Op->Cond.Val, Src1, Src2);
-            else
-              CompResult = IsConditionTrue<uint64_t, int64_t, double>(Op->Cond.Val, Src1, Src2);
-
-            if (CompResult) {
-              BlockIterator = NodeIterator(ListBegin, DataBegin, Op->TrueBlock);
-            }
-            else  {
-              BlockIterator = NodeIterator(ListBegin, DataBegin, Op->FalseBlock);
-            }
-            BlockResults.Redo = true;
-            return;
-            break;
-          }
-          case IR::OP_JUMP: {
-            auto Op = IROp->C<IR::IROp_Jump>();
-            BlockIterator = NodeIterator(ListBegin, DataBegin, Op->Header.Args[0]);
-            BlockResults.Redo = true;
-            return;
-            break;
-          }
           case IR::OP_BREAK: {
             auto Op = IROp->C<IR::IROp_Break>();
             switch (Op->Reason) {
@@ -1066,14 +1197,6 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
             }
             break;
           }
-          case IR::OP_SIGNALRETURN: {
-            SignalReturn(Thread);
-            break;
-          }
-          case IR::OP_CALLBACKRETURN: {
-            Thread->CTX->InterpreterCallbackReturn(Thread, stack);
-            break;
-          }
           case IR::OP_SYSCALL: {
             auto Op = IROp->C<IR::IROp_Syscall>();
 
@@ -1103,6 +1226,10 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
             memcpy(DstPtr, &Results, sizeof(uint32_t) * 4);
             break;
           }
+          case IR::OP_CALCULATEDEFERREDFLAGS: {
+            FEXCore::CPU::CalculateDeferredFlags(&Thread->State.State);
+            break;
+          }
           case IR::OP_PRINT: {
             auto Op = IROp->C<IR::IROp_Print>();
 
@@ -1397,6 +1524,7 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
                 case MEM_OFFSET_UXTW.Val: Data += (uint32_t)Offset; break;
                 case MEM_OFFSET_SXTW.Val: Data += (int32_t)Offset; break;
               }
+              Data += Op->OffsetDisp;
             }
             memset(GDP, 0, 16);
             memcpy(GDP, Data, Op->Size);
@@ -1425,6 +1553,7 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
                 case MEM_OFFSET_UXTW.Val: Data += (uint32_t)Offset; break;
                 case MEM_OFFSET_SXTW.Val: Data += (int32_t)Offset; break;
               }
+              Data += Op->OffsetDisp;
             }
             memcpy(Data, GetSrc<void*>(SSAData, Op->Value), Op->Size);
             break;
@@ -5136,25 +5265,244 @@ void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEX
             LogMan::Msg::A("Unknown IR Op: %d(%s)", IROp->Op, FEXCore::IR::GetName(IROp->Op).data());
             break;
         }
+}
 
-        // CodeLast is inclusive. So we still need to dump the CodeLast op as well
-        if (CodeBegin == CodeLast) {
-          break;
-        }
-        ++CodeBegin;
-      }
-    };
+#undef GD
+#undef GDP
 
-    HandleBlock(BlockNode);
+DecodedIR::~DecodedIR() {
+  auto Frame = Frames.load(std::memory_order_relaxed);
+  while (Frame) {
+    auto Next = Frame->Next;
+    delete Frame;
+    Frame = Next;
+  }
+}
 
-    if (BlockResults.Redo) {
-      continue;
+void InterpreterOps::DeleteDecodedIR(void *Decoded) {
+  delete reinterpret_cast<DecodedIR*>(Decoded);
+}
+
+static InterpreterFrame *ClaimFrame(DecodedIR *Decoded, uintptr_t StackLocation) {
+  for (auto Frame = Decoded->Frames.load(std::memory_order_acquire); Frame; Frame = Frame->Next) {
+    // A run that never returned still holds its frame, a thread stop unwinds past it
+    // Our own run is only still live if it is further up the stack than we are
+    uintptr_t Owner = Frame->Owner.load(std::memory_order_relaxed);
+    if (Owner <= StackLocation &&
+        Frame->Owner.compare_exchange_strong(Owner, StackLocation, std::memory_order_acquire, std::memory_order_relaxed)) {
+      return Frame;
     }
+  }
 
-    if (BlockResults.Quit || ++BlockIterator == BlockEnd) {
-      break;
+  // Every frame is held by a run further up the stack. Either a guest signal handler interrupted it or
+  // the handler longjmp'd out and left it there for good, the new frame is the one later runs pick up
+  auto Frame = new InterpreterFrame{};
+  Frame->Owner.store(StackLocation, std::memory_order_relaxed);
+  Frame->Data.reset(new __uint128_t[Decoded->IR->GetSSACount()]());
+  Frame->Next = Decoded->Frames.load(std::memory_order_relaxed);
+  while (!Decoded->Frames.compare_exchange_weak(Frame->Next, Frame, std::memory_order_release, std::memory_order_relaxed));
+  return Frame;
+}
+
+void InterpreterOps::InterpretIR(FEXCore::Core::InternalThreadState *Thread, DecodedIR *Decoded) {
+  volatile void* stack = alloca(0);
+
+  auto CurrentIR = Decoded->IR;
+
+  // Debug data is only passed in debug builds
+  #ifndef NDEBUG
+  // TODO: should be moved to an IR Op
+  Thread->Stats.InstructionsExecuted.fetch_add(Decoded->DebugData->GuestInstructionCount);
+  #endif
+
+  static_assert(sizeof(FEXCore::IR::IROp_Header) == 4);
+  static_assert(sizeof(FEXCore::IR::OrderedNode) == 16);
+
+  // Frames are already zeroed, only a nested run of the same block needs a new one
+  auto Frame = ClaimFrame(Decoded, reinterpret_cast<uintptr_t>(stack));
+  void *SSAData = Frame->Data.get();
+
+  auto ReleaseFrame = [&]() {
+    Frame->Owner.store(0, std::memory_order_release);
+  };
+
+  #define SRC(x) (reinterpret_cast<__uint128_t*>(SSAData) + Op->Src[x])
+  #define DST (reinterpret_cast<__uint128_t*>(SSAData) + Op->Dest)
+
+  // Indexed by DecodedHandler
+  static void const *Handlers[HANDLER_COUNT] = {
+    &&Fallback,
+    &&Nop,
+    &&Constant,
+    &&LoadContext,
+    &&StoreContext,
+    &&LoadMem,
+    &&LoadMemOffset,
+    &&StoreMem,
+    &&StoreMemOffset,
+    &&Add,
+    &&Sub,
+    &&And,
+    &&Or,
+    &&Xor,
+    &&Bfe,
+    &&Select,
+    &&Mov,
+    &&Jump,
+    &&CondJump,
+    &&ExitFunction,
+    &&SignalReturnOp,
+    &&CallbackReturn,
+    &&End,
+  };
+
+  DecodedOp const *OpBegin = Decoded->Ops.data();
+  DecodedOp const *Op = OpBegin;
+
+  #define DISPATCH() goto *Handlers[Op->Handler]
+  #define NEXT() do { ++Op; DISPATCH(); } while (0)
+
+  auto ApplyOffset = [](DecodedOp const *Op, uint8_t *Data, uintptr_t Offset) {
+    Offset *= Op->Imm;
+    Data += Op->Disp;
+    switch (Op->Cond) {
+      case IR::MEM_OFFSET_SXTX.Val: return Data + Offset;
+      case IR::MEM_OFFSET_UXTW.Val: return Data + (uint32_t)Offset;
+      case IR::MEM_OFFSET_SXTW.Val: return Data + (int32_t)Offset;
+    }
+    return Data;
+  };
+
+  // Integer ops write their own width, same as the ops in InterpretOp
+  #define BINARY_OP(Name, Operator)                                                               \
+  Name: {                                                                                         \
+    switch (Op->Size) {                                                                           \
+      case 1: *(uint8_t*)DST = *(uint8_t*)SRC(0) Operator *(uint8_t*)SRC(1); break;               \
+      case 2: *(uint16_t*)DST = *(uint16_t*)SRC(0) Operator *(uint16_t*)SRC(1); break;            \
+      case 4: *(uint32_t*)DST = *(uint32_t*)SRC(0) Operator *(uint32_t*)SRC(1); break;            \
+      case 8: *(uint64_t*)DST = *(uint64_t*)SRC(0) Operator *(uint64_t*)SRC(1); break;            \
+    }                                                                                             \
+    NEXT();                                                                                       \
+  }
+
+  DISPATCH();
+
+  Fallback:
+    InterpretOp(Thread, CurrentIR, SSAData, Op->Node, Op->IROp);
+    NEXT();
+
+  Nop:
+    NEXT();
+
+  Constant:
+    *(uint64_t*)DST = Op->Imm;
+    NEXT();
+
+  LoadContext: {
+    auto Data = reinterpret_cast<uint8_t const*>(&Thread->State.State) + Op->Imm;
+    switch (Op->Size) {
+      case 1: *(uint64_t*)DST = *reinterpret_cast<uint8_t const*>(Data); break;
+      case 2: *(uint64_t*)DST = *reinterpret_cast<uint16_t const*>(Data); break;
+      case 4: *(uint64_t*)DST = *reinterpret_cast<uint32_t const*>(Data); break;
+      case 8: *(uint64_t*)DST = *reinterpret_cast<uint64_t const*>(Data); break;
+      case 16: memcpy(DST, Data, 16); break;
     }
+    NEXT();
+  }
+
+  StoreContext:
+    memcpy(reinterpret_cast<uint8_t*>(&Thread->State.State) + Op->Imm, SRC(0), Op->Size);
+    NEXT();
+
+  LoadMem:
+    memset(DST, 0, 16);
+    memcpy(DST, *(uint8_t const**)SRC(0), Op->Size);
+    NEXT();
+
+  LoadMemOffset:
+    memset(DST, 0, 16);
+    memcpy(DST, ApplyOffset(Op, *(uint8_t**)SRC(0), *(uintptr_t*)SRC(1)), Op->Size);
+    NEXT();
+
+  StoreMem:
+    memcpy(*(uint8_t**)SRC(0), SRC(1), Op->Size);
+    NEXT();
+
+  StoreMemOffset:
+    memcpy(ApplyOffset(Op, *(uint8_t**)SRC(0), *(uintptr_t*)SRC(2)), SRC(1), Op->Size);
+    NEXT();
+
+  BINARY_OP(Add, +)
+  BINARY_OP(Sub, -)
+  BINARY_OP(And, &)
+  BINARY_OP(Or, |)
+  BINARY_OP(Xor, ^)
+
+  Bfe:
+    *(uint64_t*)DST = (*(uint64_t*)SRC(0) & Op->Imm) >> Op->Cond;
+    NEXT();
+
+  Select: {
+    uint64_t Src1 = *(uint64_t*)SRC(0);
+    uint64_t Src2 = *(uint64_t*)SRC(1);
+    bool CompResult;
+
+    if (Op->CompareSize == 4)
+      CompResult = IsConditionTrue<uint32_t, int32_t, float>(Op->Cond, Src1, Src2);
+    else
+      CompResult = IsConditionTrue<uint64_t, int64_t, double>(Op->Cond, Src1, Src2);
+
+    void *Src = SRC(CompResult ? 2 : 3);
+    *(uint64_t*)DST = Op->Size == 4 ? *(uint32_t*)Src : *(uint64_t*)Src;
+    NEXT();
   }
+
+  Mov:
+    memcpy(DST, SRC(0), Op->Size);
+    NEXT();
+
+  Jump:
+    Op = OpBegin + Op->Imm;
+    DISPATCH();
+
+  CondJump: {
+    uint64_t Src1 = *(uint64_t*)SRC(0);
+    uint64_t Src2 = *(uint64_t*)SRC(1);
+    bool CompResult;
+
+    if (Op->CompareSize == 4)
+      CompResult = IsConditionTrue<uint32_t, int32_t, float>(Op->Cond, Src1, Src2);
+    else
+      CompResult = IsConditionTrue<uint64_t, int64_t, double>(Op->Cond, Src1, Src2);
+
+    Op = OpBegin + (CompResult ? (uint32_t)Op->Imm : (uint32_t)(Op->Imm >> 32));
+    DISPATCH();
+  }
+
+  ExitFunction:
+    memcpy(&Thread->State.State.rip, SRC(0), Op->Size);
+    ReleaseFrame();
+    return;
+
+  // These never come back in to this frame
+  SignalReturnOp:
+    ReleaseFrame();
+    SignalReturn(Thread);
+
+  CallbackReturn:
+    ReleaseFrame();
+    Thread->CTX->InterpreterCallbackReturn(Thread, stack);
+    return;
+
+  End:
+    ReleaseFrame();
+    return;
+
+  #undef BINARY_OP
+  #undef NEXT
+  #undef DISPATCH
+  #undef DST
+  #undef SRC
 }
 
-}
\ No newline at end of file
+}
@@ -1,9 +1,18 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
 namespace FEXCore::Core {
   struct InternalThreadState;
 }
 
 namespace FEXCore::IR {
     class IRListView;
+    class OrderedNode;
+    struct IROp_Header;
 }
 
 namespace FEXCore::Core{
@@ -33,10 +42,61 @@ namespace FEXCore::CPU {
     void *fn;
   };
   
+  /**
+   * @brief A single IR op lowered for the threaded interpreter loop
+   *
+   * Operands are resolved to SSA slots ahead of time and branch targets to indices in to the op array
+   * Ops without a dedicated handler keep their IR node and go through the generic op switch
+   */
+  struct DecodedOp {
+    uint16_t Handler;
+    uint8_t Size;
+    uint8_t CompareSize;
+    uint8_t Cond;
+    uint32_t Dest;
+    uint32_t Src[4];
+    int32_t Disp;
+    uint64_t Imm;
+    FEXCore::IR::OrderedNode *Node;
+    FEXCore::IR::IROp_Header *IROp;
+  };
+
+  /**
+   * @brief Zeroed SSA frame for one run of a block
+   *
+   * Each op always writes the same bytes of its slot so the zero-extension the interpreter relies on
+   * still holds on the next run, even one after a run that never finished
+   */
+  struct InterpreterFrame {
+    // Stack location of the run using the frame, 0 while it is free
+    std::atomic<uintptr_t> Owner {};
+    std::unique_ptr<__uint128_t[]> Data;
+    InterpreterFrame *Next {};
+  };
+
+  /**
+   * @brief Pre-decoded IR list, this is what the interpreter hands to the dispatcher as a block's host code
+   *
+   * Blocks are laid out back to back in Ops so falling off the end of one block enters the next
+   * Fallback ops point in to the IR, the block's LocalIREntry owns this so it goes away together with the IR
+   * Only the thread that compiled the block runs it, a guest signal handler can nest a second run of it though
+   */
+  struct DecodedIR {
+    ~DecodedIR();
+
+    FEXCore::IR::IRListView const *IR;
+    FEXCore::Core::DebugData *DebugData;
+    std::vector<DecodedOp> Ops;
+    // Frames are only ever added, newest first
+    std::atomic<InterpreterFrame*> Frames {};
+  };
+
   class InterpreterOps {
 
     public:
-      static void InterpretIR(FEXCore::Core::InternalThreadState *Thread, FEXCore::IR::IRListView *CurrentIR, FEXCore::Core::DebugData *DebugData);
+      static std::unique_ptr<DecodedIR> DecodeIR(FEXCore::IR::IRListView const *CurrentIR, FEXCore::Core::DebugData *DebugData);
+      static void InterpretIR(FEXCore::Core::InternalThreadState *Thread, DecodedIR *Decoded);
+      static void DeleteDecodedIR(void *Decoded);
       static bool GetFallbackHandler(IR::IROp_Header *IROp, FallbackInfo *Info);
   };
 };
\ No newline at end of file
@@ -128,7 +128,10 @@ DispatchGenerator::DispatchGenerator(FEXCore::Context::Context *ctx, FEXCore::Co
     je(NoBlock);
 
     // Real block if we made it here
+    // The block pointer is the decoded IR, hand it to the interpreter loop
     mov(rdi, STATE);
+    mov(rsi, rax);
+    mov(rax, reinterpret_cast<uint64_t>(&InterpreterOps::InterpretIR));
     call(rax);
 
     if (CTX->GetGdbServerStatus()) {
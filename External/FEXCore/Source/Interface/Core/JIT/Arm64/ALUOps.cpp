@@ -54,9 +54,8 @@ DEF_OP(Constant) {
 DEF_OP(EntrypointOffset) {
   auto Op = IROp->C<IR::IROp_EntrypointOffset>();
 
-  auto Constant = IR->GetHeader()->Entry + Op->Offset;
   auto Dst = GetReg<RA_64>(Node);
-  LoadConstant(Dst, Constant);
+  LoadConstantRelocated(Dst, RelocationType::GUEST_ENTRY, Op->Offset);
 }
 
 DEF_OP(InlineConstant) {
@@ -109,27 +108,29 @@ DEF_OP(Sub) {
   auto Op = IROp->C<IR::IROp_Sub>();
   uint8_t OpSize = IROp->Size;
 
+  // subs leaves NZCV as a cmp between the sources would, a CMP/SUB + Jcc then doesn't need its own cmp
   uint64_t Const;
   if (IsInlineConstant(Op->Header.Args[1], &Const)) {
     switch (OpSize) {
       case 4:
       case 8:
-        sub(GRS(Node), GRS(Op->Header.Args[0].ID()), Const);
+        subs(GRS(Node), GRS(Op->Header.Args[0].ID()), Const);
         break;
       default: LogMan::Msg::A("Unsupported Sub size: %d", OpSize);
     }
   } else {
     switch (OpSize) {
       case 4:
-        sub(GetReg<RA_32>(Node), GetReg<RA_32>(Op->Header.Args[0].ID()), GetReg<RA_32>(Op->Header.Args[1].ID()));
+        subs(GetReg<RA_32>(Node), GetReg<RA_32>(Op->Header.Args[0].ID()), GetReg<RA_32>(Op->Header.Args[1].ID()));
         break;
       case 8:
-        sub(GetReg<RA_64>(Node), GetReg<RA_64>(Op->Header.Args[0].ID()), GetReg<RA_64>(Op->Header.Args[1].ID()));
+        subs(GetReg<RA_64>(Node), GetReg<RA_64>(Op->Header.Args[0].ID()), GetReg<RA_64>(Op->Header.Args[1].ID()));
         break;
       default: LogMan::Msg::A("Unsupported Sub size: %d", OpSize);
     }
   }
 
+  SetHostFlags(Node, OpSize, HOST_FLAGS_ALL_INT, Op->Header.Args[0].ID(), Op->Header.Args[1]);
 }
 
 DEF_OP(Neg) {
@@ -380,10 +381,13 @@ DEF_OP(And) {
   auto Op = IROp->C<IR::IROp_And>();
   uint64_t Const;
   if (IsInlineConstant(Op->Header.Args[1], &Const)) {
-    and_(GRS(Node), GRS(Op->Header.Args[0].ID()), Const);
+    ands(GRS(Node), GRS(Op->Header.Args[0].ID()), Const);
   } else {
-    and_(GRS(Node), GRS(Op->Header.Args[0].ID()), GRS(Op->Header.Args[1].ID()));
+    ands(GRS(Node), GRS(Op->Header.Args[0].ID()), GRS(Op->Header.Args[1].ID()));
   }
+
+  // NZCV now holds the result compared against zero, which is what TEST + Jcc checks
+  SetHostFlags(Node, IROp->Size <= 4 ? 4 : 8, HOST_FLAGS_LOGICAL, Node, 0);
 }
 
 DEF_OP(Xor) {
@@ -527,7 +531,7 @@ DEF_OP(LDiv) {
 #if _M_X86_64
       CallRuntime(LDIV);
 #else
-      LoadConstant(x3, reinterpret_cast<uint64_t>(LDIV));
+      LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(LDIV)));
       SpillStaticRegs();
       blr(x3);
       FillStaticRegs();
@@ -574,7 +578,7 @@ DEF_OP(LUDiv) {
 #if _M_X86_64
       CallRuntime(LUDIV);
 #else
-      LoadConstant(x3, reinterpret_cast<uint64_t>(LUDIV));
+      LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(LUDIV)));
       SpillStaticRegs();
       blr(x3);
       FillStaticRegs();
@@ -631,7 +635,7 @@ DEF_OP(LRem) {
 #if _M_X86_64
       CallRuntime(LREM);
 #else
-      LoadConstant(x3, reinterpret_cast<uint64_t>(LREM));
+      LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(LREM)));
       SpillStaticRegs();
       blr(x3);
       FillStaticRegs();
@@ -685,7 +689,7 @@ DEF_OP(LURem) {
 #if _M_X86_64
       CallRuntime(LUREM);
 #else
-      LoadConstant(x3, reinterpret_cast<uint64_t>(LUREM));
+      LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(LUREM)));
       SpillStaticRegs();
       blr(x3);
       FillStaticRegs();
@@ -936,10 +940,17 @@ DEF_OP(Select) {
   uint64_t Const;
 
   if (IsGPR(Op->Cmp1.ID())) {
-    if (IsInlineConstant(Op->Cmp2, &Const))
-      cmp(GRCMP(Op->Cmp1.ID()), Const);
-    else
-      cmp(GRCMP(Op->Cmp1.ID()), GRCMP(Op->Cmp2.ID()));
+    if (!HostFlagsHold(Op->Cmp1, Op->Cmp2, Op->CompareSize, Op->Cond)) {
+      if (IsInlineConstant(Op->Cmp2, &Const))
+        cmp(GRCMP(Op->Cmp1.ID()), Const);
+      else
+        cmp(GRCMP(Op->Cmp1.ID()), GRCMP(Op->Cmp2.ID()));
+      // csel doesn't touch NZCV, a following select on the same compare can reuse it
+      SetHostFlags(Node, Op->CompareSize, HOST_FLAGS_ALL_INT, Op->Cmp1.ID(), Op->Cmp2);
+    }
+    else {
+      HostFlags.SetBy = Node;
+    }
   } else if (IsFPR(Op->Cmp1.ID())) {
     fcmp(GRFCMP(Op->Cmp1.ID()), GRFCMP(Op->Cmp2.ID()));
   } else {
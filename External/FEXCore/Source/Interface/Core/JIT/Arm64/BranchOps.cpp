@@ -1,3 +1,4 @@
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/JIT/Arm64/JITClass.h"
 #include "Interface/Core/InternalThreadState.h"
 
@@ -9,16 +10,111 @@ namespace FEXCore::CPU {
 using namespace vixl;
 using namespace vixl::aarch64;
 #define DEF_OP(x) void JITCore::Op_##x(FEXCore::IR::IROp_Header *IROp, uint32_t Node)
+void JITCore::EmitLinkableExit(uint64_t NewRIP, bool IsConstant, Literal<uint64_t> *GuestRIPLiteral) {
+  Literal l_BranchHost{GetRelocationValue(RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::EXIT_FUNCTION_LINKER))};
+
+  // The linker patches l_BranchHost from other threads when code is shared, keep it naturally aligned
+  if (GetBuffer()->GetOffsetAddress<uint64_t>(GetCursorOffset()) & 7) {
+    nop();
+  }
+
+  ldr(x0, &l_BranchHost);
+  blr(x0);
+
+  AddRelocation(RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::EXIT_FUNCTION_LINKER), RelocationEncoding::ABS64);
+  place(&l_BranchHost);
+  if (!IsConstant) {
+    AddRelocation(RelocationType::GUEST_ENTRY, NewRIP - IR->GetHeader()->Entry, RelocationEncoding::ABS64);
+  }
+  place(GuestRIPLiteral);
+}
+
+void JITCore::EmitLookupExit(aarch64::Register RipReg) {
+  Label FullLookup;
+
+  // L1 Cache
+  ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, L1Pointer)));
+
+  and_(x3, RipReg, LookupCache::L1_ENTRIES_MASK);
+  add(x0, x0, Operand(x3, Shift::LSL, 4));
+
+  ldp(x1, x0, MemOperand(x0));
+  cmp(x0, RipReg);
+  b(&FullLookup, Condition::ne);
+  br(x1);
+
+  bind(&FullLookup);
+  LoadConstantRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::LOOP_TOP));
+  str(RipReg, MemOperand(STATE, offsetof(FEXCore::Core::ThreadState, State.rip)));
+  br(TMP1);
+}
+
+void JITCore::PushReturnStack(IR::OrderedNodeWrapper NextRIP) {
+  uint64_t ReturnRIP;
+  bool IsConstant = IsInlineConstant(NextRIP, &ReturnRIP);
+
+  if (!IsConstant && !IsInlineEntrypointOffset(NextRIP, &ReturnRIP)) {
+    // The exit to the return site can only be linked with a known address
+    return;
+  }
+
+  Literal<uint64_t> l_ReturnRIP{ReturnRIP};
+  Label l_ReturnExit;
+  Label l_Continue;
+
+  ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, Returns.Top)));
+  add(x0, x0, 1);
+  and_(x0, x0, FEXCore::Core::ReturnStack::MASK);
+  str(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, Returns.Top)));
+  add(x0, STATE, Operand(x0, Shift::LSL, 4));
+
+  // Load the return address back from the exit so it carries the relocation
+  ldr(x1, &l_ReturnRIP);
+  str(x1, MemOperand(x0, offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].GuestRIP)));
+  adr(x1, &l_ReturnExit);
+  str(x1, MemOperand(x0, offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].HostCode)));
+  b(&l_Continue);
+
+  // Only reached from GuestReturn, the linker links it to the return site the first time around
+  bind(&l_ReturnExit);
+  EmitLinkableExit(ReturnRIP, IsConstant, &l_ReturnRIP);
+
+  bind(&l_Continue);
+}
+
 DEF_OP(GuestCallDirect) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestCallDirect>();
+  PushReturnStack(Op->NextRIP);
 }
 
 DEF_OP(GuestCallIndirect) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestCallIndirect>();
+  PushReturnStack(Op->NextRIP);
 }
 
 DEF_OP(GuestReturn) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestReturn>();
+  Label Mispredicted;
+
+  ResetStack();
+
+  aarch64::Register RipReg = GetReg<RA_64>(Op->NewRIP.ID());
+
+  // Pop the prediction even if it misses so a mismatch doesn't throw off the rest of the stack
+  ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, Returns.Top)));
+  sub(x1, x0, 1);
+  and_(x1, x1, FEXCore::Core::ReturnStack::MASK);
+  str(x1, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, Returns.Top)));
+  add(x0, STATE, Operand(x0, Shift::LSL, 4));
+
+  ldr(x1, MemOperand(x0, offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].GuestRIP)));
+  cmp(x1, RipReg);
+  b(&Mispredicted, Condition::ne);
+  ldr(x1, MemOperand(x0, offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].HostCode)));
+  br(x1);
+
+  bind(&Mispredicted);
+  EmitLookupExit(RipReg);
 }
 
 DEF_OP(SignalReturn) {
@@ -27,7 +123,7 @@ DEF_OP(SignalReturn) {
 
   // Now branch to our signal return helper
   // This can't be a direct branch since the code needs to live at a constant location
-  LoadConstant(x0, ThreadSharedData.SignalReturnInstruction);
+  LoadConstantRelocated(x0, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::SIGNAL_RETURN));
   br(x0);
 }
 
@@ -40,10 +136,9 @@ DEF_OP(CallbackReturn) {
   ResetStack();
 
   // We can now lower the ref counter again
-  LoadConstant(x0, reinterpret_cast<uint64_t>(ThreadSharedData.SignalHandlerRefCounterPtr));
-  ldr(w2, MemOperand(x0));
+  ldr(w2, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)));
   sub(w2, w2, 1);
-  str(w2, MemOperand(x0));
+  str(w2, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)));
 
   // We need to adjust an additional 8 bytes to get back to the original "misaligned" RSP state
   ldr(x2, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, State.State.gregs[X86State::REG_RSP])));
@@ -59,40 +154,17 @@ DEF_OP(CallbackReturn) {
 DEF_OP(ExitFunction) {
   auto Op = IROp->C<IR::IROp_ExitFunction>();
 
-  Label FullLookup;
-
   ResetStack();
 
-  aarch64::Register RipReg;
   uint64_t NewRIP;
 
-  if (IsInlineConstant(Op->NewRIP, &NewRIP) || IsInlineEntrypointOffset(Op->NewRIP, &NewRIP)) {
-    Literal l_BranchHost{ExitFunctionLinkerAddress};
-    Literal l_BranchGuest{NewRIP};
-
-    ldr(x0, &l_BranchHost);
-    blr(x0);
+  bool IsConstant = IsInlineConstant(Op->NewRIP, &NewRIP);
 
-    place(&l_BranchHost);
-    place(&l_BranchGuest);
+  if (IsConstant || IsInlineEntrypointOffset(Op->NewRIP, &NewRIP)) {
+    Literal l_BranchGuest{NewRIP};
+    EmitLinkableExit(NewRIP, IsConstant, &l_BranchGuest);
   } else {
-    RipReg = GetReg<RA_64>(Op->Header.Args[0].ID());
-    
-    // L1 Cache
-    LoadConstant(x0, State->LookupCache->GetL1Pointer());
-
-    and_(x3, RipReg, LookupCache::L1_ENTRIES_MASK);
-    add(x0, x0, Operand(x3, Shift::LSL, 4));
-
-    ldp(x1, x0, MemOperand(x0));
-    cmp(x0, RipReg);
-    b(&FullLookup, Condition::ne);
-    br(x1);
-
-    bind(&FullLookup);
-    LoadConstant(TMP1, AbsoluteLoopTopAddress);
-    str(RipReg, MemOperand(STATE, offsetof(FEXCore::Core::ThreadState, State.rip)));
-    br(TMP1);
+    EmitLookupExit(GetReg<RA_64>(Op->Header.Args[0].ID()));
   }
 }
 
@@ -170,7 +242,10 @@ DEF_OP(CondJump) {
     cbnz(GRCMP(Op->Cmp1.ID()), TrueTargetLabel);
   } else {
     if (IsGPR(Op->Cmp1.ID())) {
-      if (isConst)
+      if (HostFlagsHold(Op->Cmp1, Op->Cmp2, Op->CompareSize, Op->Cond)) {
+        // The subs/ands producing Cmp1 already left this compare in NZCV
+      }
+      else if (isConst)
         cmp(GRCMP(Op->Cmp1.ID()), Const);
       else
         cmp(GRCMP(Op->Cmp1.ID()), GRCMP(Op->Cmp2.ID()));
@@ -209,11 +284,11 @@ DEF_OP(Syscall) {
     str(GetReg<RA_64>(Op->Header.Args[i].ID()), MemOperand(sp, i * 8));
   }
 
-  LoadConstant(x0, reinterpret_cast<uint64_t>(CTX->SyscallHandler));
+  LoadConstantRelocated(x0, RelocationType::SYSCALL_HANDLER, 0);
   mov(x1, STATE);
   mov(x2, sp);
 
-  LoadConstant(x3, reinterpret_cast<uint64_t>(FEXCore::Context::HandleSyscall));
+  LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(FEXCore::Context::HandleSyscall)));
   blr(x3);
 
   add(sp, sp, SPOffset);
@@ -243,6 +318,8 @@ DEF_OP(Thunk) {
   ERROR_AND_DIE("JIT: OP_THUNK not supported with arm simulator")
 #else
   auto thunkFn = State->CTX->ThunkHandler->LookupThunk(Op->ThunkNameHash);
+  // Thunks live in host libraries that are loaded at a different address every run
+  IsRelocatable = false;
   LoadConstant(x2, (uintptr_t)thunkFn);
   blr(x2);
 #endif
@@ -260,7 +337,7 @@ DEF_OP(ValidateCode) {
   int idx = 0;
 
   LoadConstant(GetReg<RA_64>(Node), 0);
-  LoadConstant(x0, IR->GetHeader()->Entry + Op->Offset);
+  LoadConstantRelocated(x0, RelocationType::GUEST_ENTRY, Op->Offset);
   LoadConstant(x1, 1);
   
   while (len >= 8)
@@ -310,9 +387,9 @@ DEF_OP(RemoveCodeEntry) {
   PushDynamicRegsAndLR();
   
   mov(x0, STATE);
-  LoadConstant(x1, IR->GetHeader()->Entry);
+  LoadConstantRelocated(x1, RelocationType::GUEST_ENTRY, 0);
  
-  LoadConstant(x2, reinterpret_cast<uintptr_t>(&Context::Context::RemoveCodeEntry));
+  LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(&Context::Context::RemoveCodeEntry)));
   SpillStaticRegs();
   blr(x2);
   FillStaticRegs();
@@ -328,7 +405,7 @@ DEF_OP(CPUID) {
 
   // x0 = CPUID Handler
   // x1 = CPUID Function
-  LoadConstant(x0, reinterpret_cast<uint64_t>(&CTX->CPUID));
+  LoadConstantRelocated(x0, RelocationType::CONTEXT, reinterpret_cast<uintptr_t>(&CTX->CPUID) - reinterpret_cast<uintptr_t>(CTX));
   mov(x1, GetReg<RA_64>(Op->Header.Args[0].ID()));
 
   using ClassPtrType = FEXCore::CPUID::FunctionResults (FEXCore::CPUIDEmu::*)(uint32_t);
@@ -339,7 +416,7 @@ DEF_OP(CPUID) {
 
   PtrCast Ptr;
   Ptr.ClassPtr = &FEXCore::CPUIDEmu::RunFunction;
-  LoadConstant(x3, Ptr.Data);
+  LoadConstantRelocated(x3, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(Ptr.Data)));
   SpillStaticRegs();
   blr(x3);
   FillStaticRegs();
@@ -353,6 +430,27 @@ DEF_OP(CPUID) {
   mov(Dst.second, x1);
 }
 
+DEF_OP(CalculateDeferredFlags) {
+  Label Calculated;
+
+  // Most blocks that read flags come after a producer that already calculated them
+  ldrb(TMP1.W(), MemOperand(STATE, offsetof(FEXCore::Core::CPUState, DeferredFlagsOp)));
+  cbz(TMP1.W(), &Calculated);
+
+  PushDynamicRegsAndLR();
+
+  // x0 = State
+  mov(x0, STATE);
+  LoadConstantRelocated(x1, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(FEXCore::CPU::CalculateDeferredFlags)));
+  SpillStaticRegs();
+  blr(x1);
+  FillStaticRegs();
+
+  PopDynamicRegsAndLR();
+
+  bind(&Calculated);
+}
+
 #undef DEF_OP
 void JITCore::RegisterBranchHandlers() {
 #define REGISTER_OP(op, x) OpHandlers[FEXCore::IR::IROps::OP_##op] = &JITCore::Op_##x
@@ -369,6 +467,7 @@ void JITCore::RegisterBranchHandlers() {
   REGISTER_OP(VALIDATECODE,      ValidateCode);
   REGISTER_OP(REMOVECODEENTRY,   RemoveCodeEntry);
   REGISTER_OP(CPUID,             CPUID);
+  REGISTER_OP(CALCULATEDEFERREDFLAGS, CalculateDeferredFlags);
 #undef REGISTER_OP
 }
 }
@@ -1,8 +1,10 @@
 #include "Interface/Context/Context.h"
 
 #include "Interface/Core/ArchHelpers/Arm64.h"
+#include "Interface/Core/HostMemory.h"
 #include "Interface/Core/JIT/Arm64/JITClass.h"
 #include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/SharedCodeCache.h"
 
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 
@@ -22,6 +24,46 @@ namespace FEXCore::CPU {
 void JITCore::CopyNecessaryDataForCompileThread(CPUBackend *Original) {
   JITCore *Core = reinterpret_cast<JITCore*>(Original);
   ThreadSharedData = Core->ThreadSharedData;
+
+  // Code generated on the compile thread jumps back in to the parent's dispatcher
+  AbsoluteLoopTopAddressFillSRA = Core->AbsoluteLoopTopAddressFillSRA;
+  AbsoluteLoopTopAddress = Core->AbsoluteLoopTopAddress;
+  ThreadPauseHandlerAddressSpillSRA = Core->ThreadPauseHandlerAddressSpillSRA;
+  ExitFunctionLinkerAddress = Core->ExitFunctionLinkerAddress;
+  ThreadPauseHandlerAddress = Core->ThreadPauseHandlerAddress;
+  ThreadStopHandlerAddressSpillSRA = Core->ThreadStopHandlerAddressSpillSRA;
+  ThreadStopHandlerAddress = Core->ThreadStopHandlerAddress;
+  PauseReturnInstruction = Core->PauseReturnInstruction;
+}
+
+void JITCore::CopyDispatcher(JITCore *Owner) {
+  // The dispatcher only references the thread through the STATE register so it is safe to share
+  DispatchPtr = Owner->DispatchPtr;
+  CallbackPtr = Owner->CallbackPtr;
+  DispatcherCodeBuffer = Owner->DispatcherCodeBuffer;
+  OwnsDispatcher = false;
+
+  AbsoluteLoopTopAddressFillSRA = Owner->AbsoluteLoopTopAddressFillSRA;
+  AbsoluteLoopTopAddress = Owner->AbsoluteLoopTopAddress;
+  ThreadPauseHandlerAddressSpillSRA = Owner->ThreadPauseHandlerAddressSpillSRA;
+  ExitFunctionLinkerAddress = Owner->ExitFunctionLinkerAddress;
+  ThreadPauseHandlerAddress = Owner->ThreadPauseHandlerAddress;
+  ThreadStopHandlerAddressSpillSRA = Owner->ThreadStopHandlerAddressSpillSRA;
+  ThreadStopHandlerAddress = Owner->ThreadStopHandlerAddress;
+  PauseReturnInstruction = Owner->PauseReturnInstruction;
+  ThreadSharedData.SignalReturnInstruction = Owner->ThreadSharedData.SignalReturnInstruction;
+}
+
+void JITCore::SwitchToNewCodeRegion(size_t MinSize) {
+  // Nothing more gets emitted in to the old region, from now on it can be evicted
+  CTX->SharedCache->CloseRegion(InitialCodeBuffer.Ptr, CodeRegionEpoch);
+
+  auto Region = CTX->SharedCache->AllocateRegion(MinSize);
+  // The old region belongs to the shared cache, it gets released once every thread is done with it
+  InitialCodeBuffer = CodeBuffer{Region.Ptr, Region.Size};
+  CurrentCodeBuffer = &InitialCodeBuffer;
+  CodeRegionEpoch = Region.Epoch;
+  *GetBuffer() = vixl::CodeBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
 }
 
 static void SleepThread(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
@@ -52,7 +94,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushDynamicRegsAndLR();
 
         mov(w0, GetReg<RA_32>(IROp->Args[0].ID()));
-        LoadConstant(x1, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x1, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x1);
 
@@ -68,7 +110,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushDynamicRegsAndLR();
 
         fmov(v0.S(), GetSrc(IROp->Args[0].ID()).S()) ;
-        LoadConstant(x0, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x0, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x0);
 
@@ -88,7 +130,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushDynamicRegsAndLR();
 
         mov(v0.D(), GetSrc(IROp->Args[0].ID()).D());
-        LoadConstant(x0, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x0, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x0);
 
@@ -109,7 +151,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushDynamicRegsAndLR();
 
         mov(w0, GetReg<RA_32>(IROp->Args[0].ID()));
-        LoadConstant(x1, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x1, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x1);
 
@@ -131,7 +173,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
 
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -151,7 +193,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
 
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -171,7 +213,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
 
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -190,7 +232,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
 
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -209,7 +251,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
 
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -231,7 +273,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x2, GetSrc(IROp->Args[1].ID()).V2D(), 0);
         umov(x3, GetSrc(IROp->Args[1].ID()).V2D(), 1);
         
-        LoadConstant(x4, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x4, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x4);
 
@@ -250,7 +292,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x0, GetSrc(IROp->Args[0].ID()).V2D(), 0);
         umov(x1, GetSrc(IROp->Args[0].ID()).V2D(), 1);
         
-        LoadConstant(x2, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x2, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x2);
 
@@ -274,7 +316,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         umov(x2, GetSrc(IROp->Args[1].ID()).V2D(), 0);
         umov(x3, GetSrc(IROp->Args[1].ID()).V2D(), 1);
         
-        LoadConstant(x4, (uintptr_t)Info.fn);
+        LoadConstantRelocated(x4, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         blr(x4);
 
@@ -300,6 +342,11 @@ void JITCore::Op_NoOp(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
 }
 
 bool JITCore::IsAddressInJITCode(uint64_t Address, bool IncludeDispatcher) {
+  if (CTX->SharedCache && CTX->SharedCache->IsCodeAddress(Address)) {
+    // Code from any thread's region can be running on this thread
+    return true;
+  }
+
   // Check the initial code buffer first
   // It's the most likely place to end up
 
@@ -438,7 +485,7 @@ bool JITCore::HandleSIGILL(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --State->SignalHandlerRefCounter;
     return true;
   }
 
@@ -447,7 +494,7 @@ bool JITCore::HandleSIGILL(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --State->SignalHandlerRefCounter;
     return true;
   }
 
@@ -467,7 +514,7 @@ bool JITCore::HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSig
 
   // Ref count our faults
   // We use this to track if it is safe to clear cache
-  ++SignalHandlerRefCounter;
+  ++State->SignalHandlerRefCounter;
 
   State->State.State.gregs[X86State::REG_RDI] = Signal;
   uint64_t OldGuestSP = State->State.State.gregs[X86State::REG_RSP];
@@ -604,21 +651,19 @@ bool JITCore::HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSig
   return true;
 }
 
-JITCore::CodeBuffer JITCore::AllocateNewCodeBuffer(size_t Size) {
+JITCore::CodeBuffer JITCore::AllocateNewCodeBuffer(FEXCore::Context::Context *CTX, size_t Size) {
   CodeBuffer Buffer;
   Buffer.Size = Size;
   Buffer.Ptr = static_cast<uint8_t*>(
-               mmap(nullptr,
-                    Buffer.Size,
-                    PROT_READ | PROT_WRITE | PROT_EXEC,
-                    MAP_PRIVATE | MAP_ANONYMOUS,
-                    -1, 0));
+               HostMemory::Allocate(Buffer.Size,
+                                    PROT_READ | PROT_WRITE | PROT_EXEC,
+                                    HostMemory::GetPolicy(CTX)));
   LogMan::Throw::A(!!Buffer.Ptr, "Couldn't allocate code buffer");
   return Buffer;
 }
 
 void JITCore::FreeCodeBuffer(CodeBuffer Buffer) {
-  munmap(Buffer.Ptr, Buffer.Size);
+  HostMemory::Free(Buffer.Ptr, Buffer.Size, HostMemory::GetPolicy(CTX));
 }
 
 bool JITCore::HandleSIGBUS(int Signal, void *info, void *ucontext) {
@@ -719,7 +764,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    ++SignalHandlerRefCounter;
+    ++State->SignalHandlerRefCounter;
 
     State->SignalReason.store(FEXCore::Core::SIGNALEVENT_NONE);
     return true;
@@ -730,7 +775,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --State->SignalHandlerRefCounter;
 
     State->SignalReason.store(FEXCore::Core::SIGNALEVENT_NONE);
     return true;
@@ -746,7 +791,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
     _mcontext->sp = State->State.ReturningStackLocation;
 
     // Our ref counting doesn't matter anymore
-    SignalHandlerRefCounter = 0;
+    State->SignalHandlerRefCounter = 0;
 
     // Set the new PC
     if (!IsAddressInJITCode(_mcontext->pc, false)) {
@@ -775,7 +820,7 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
   , InitialCodeBuffer {Buffer}
 {
   CurrentCodeBuffer = &InitialCodeBuffer;
-  ThreadSharedData.SignalHandlerRefCounterPtr = &SignalHandlerRefCounter;
+  ThreadSharedData.SignalHandlerRefCounterPtr = &Thread->SignalHandlerRefCounter;
 
   auto Features = vixl::CPUFeatures::InferFromOS();
   SupportsAtomics = Features.Has(vixl::CPUFeatures::Feature::kAtomics);
@@ -834,7 +879,20 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
   RegisterEncryptionHandlers();
 
   if (!CompileThread) {
-    CreateCustomDispatch(Thread);
+    if (CTX->SharedCache) {
+      // Every thread shares the dispatcher of the first one
+      std::scoped_lock<std::mutex> lk(CTX->SharedCache->DispatcherLock);
+      if (CTX->SharedCache->DispatcherOwner) {
+        CopyDispatcher(static_cast<JITCore*>(CTX->SharedCache->DispatcherOwner));
+      }
+      else {
+        CreateCustomDispatch(Thread);
+        CTX->SharedCache->DispatcherOwner = this;
+      }
+    }
+    else {
+      CreateCustomDispatch(Thread);
+    }
 
     // This will register the host signal handler per thread, which is fine
     CTX->SignalDelegation->RegisterHostSignalHandler(SIGILL, [](FEXCore::Core::InternalThreadState *Thread, int Signal, void *info, void *ucontext) -> bool {
@@ -864,6 +922,12 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
 }
 
 void JITCore::ClearCache() {
+  if (CTX->SharedCache) {
+    // Other threads may still be running the old code, never reuse it here
+    SwitchToNewCodeRegion(0);
+    return;
+  }
+
   // Get the backing code buffer
   auto Buffer = GetBuffer();
   if (*ThreadSharedData.SignalHandlerRefCounterPtr == 0) {
@@ -891,7 +955,7 @@ void JITCore::ClearCache() {
       InitialCodeBuffer.Size *= 1.5;
       InitialCodeBuffer.Size = std::min(InitialCodeBuffer.Size, MAX_CODE_SIZE);
 
-      InitialCodeBuffer = JITCore::AllocateNewCodeBuffer(InitialCodeBuffer.Size);
+      InitialCodeBuffer = JITCore::AllocateNewCodeBuffer(CTX, InitialCodeBuffer.Size);
       *Buffer = vixl::CodeBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
     }
   }
@@ -899,7 +963,7 @@ void JITCore::ClearCache() {
     // We have signal handlers that have generated code
     // This means that we can not safely clear the code at this point in time
     // Allocate some new code buffers that we can switch over to instead
-    auto NewCodeBuffer = JITCore::AllocateNewCodeBuffer(JITCore::INITIAL_CODE_SIZE);
+    auto NewCodeBuffer = JITCore::AllocateNewCodeBuffer(CTX, JITCore::INITIAL_CODE_SIZE);
     EmplaceNewCodeBuffer(NewCodeBuffer);
     *Buffer = vixl::CodeBuffer(NewCodeBuffer.Ptr, NewCodeBuffer.Size);
   }
@@ -911,11 +975,19 @@ JITCore::~JITCore() {
   }
   CodeBuffers.clear();
 
-  if (DispatcherCodeBuffer.Ptr) {
+  if (DispatcherCodeBuffer.Ptr && OwnsDispatcher) {
     // Dispatcher may not exist if this is a compile thread
+    // Shared dispatchers are only torn down with the context, the owner outlives the other threads
     FreeCodeBuffer(DispatcherCodeBuffer);
   }
-  FreeCodeBuffer(InitialCodeBuffer);
+
+  if (CTX->SharedCache) {
+    // Shared cache regions are owned by the cache
+    CTX->SharedCache->CloseRegion(InitialCodeBuffer.Ptr, CodeRegionEpoch);
+  }
+  else {
+    FreeCodeBuffer(InitialCodeBuffer);
+  }
 }
 
 void JITCore::LoadConstant(vixl::aarch64::Register Reg, uint64_t Constant) {
@@ -936,6 +1008,77 @@ void JITCore::LoadConstant(vixl::aarch64::Register Reg, uint64_t Constant) {
   }
 }
 
+void JITCore::EnsureCodeBufferSpace(size_t Size) {
+  if (CTX->SharedCache) {
+    // Only need a new region, the rest of the cache remains valid
+    if (CodeRegionEpoch != CTX->SharedCache->GetFlushEpoch() ||
+        (GetCursorOffset() + Size) > CurrentCodeBuffer->Size) {
+      SwitchToNewCodeRegion(Size);
+    }
+  }
+  else if ((GetCursorOffset() + Size) > CurrentCodeBuffer->Size) {
+    State->CTX->ClearCodeCache(State, false);
+  }
+}
+
+uint64_t JITCore::GetThreadPointer(RelocationThreadPointer Pointer) {
+  switch (Pointer) {
+    case RelocationThreadPointer::LOOP_TOP: return AbsoluteLoopTopAddress;
+    case RelocationThreadPointer::EXIT_FUNCTION_LINKER: return ExitFunctionLinkerAddress;
+    case RelocationThreadPointer::THREAD_PAUSE_HANDLER: return ThreadPauseHandlerAddressSpillSRA;
+    case RelocationThreadPointer::THREAD_STOP_HANDLER: return ThreadStopHandlerAddressSpillSRA;
+    case RelocationThreadPointer::SIGNAL_RETURN: return ThreadSharedData.SignalReturnInstruction;
+    default:
+      LogMan::Msg::A("Unknown thread pointer: %ld", static_cast<uint64_t>(Pointer));
+      return 0;
+  }
+}
+
+uint64_t JITCore::GetRelocationValue(RelocationType Type, uint64_t Data) {
+  uint64_t Value{};
+  if (!FEXCore::CPU::ResolveRelocation(CTX, RelocationGuestEntry, Type, Data, &Value)) {
+    Value = GetThreadPointer(static_cast<RelocationThreadPointer>(Data));
+  }
+  return Value;
+}
+
+void JITCore::AddRelocation(RelocationType Type, uint64_t Data, RelocationEncoding Encoding) {
+  Relocations.emplace_back(Relocation{static_cast<uint32_t>(GetCursorOffset() - BlockEntryOffset), Type, Encoding, 0, Data});
+}
+
+void JITCore::LoadConstantRelocated(vixl::aarch64::Register Reg, RelocationType Type, uint64_t Data) {
+  AddRelocation(Type, Data, RelocationEncoding::ARM64_MOVZ_MOVK);
+
+  // Always the full sequence, unlike LoadConstant, so every chunk can be patched in place
+  uint64_t Value = GetRelocationValue(Type, Data);
+  movz(Reg, Value & 0xFFFF, 0);
+  movk(Reg, (Value >> 16) & 0xFFFF, 16);
+  movk(Reg, (Value >> 32) & 0xFFFF, 32);
+  movk(Reg, (Value >> 48) & 0xFFFF, 48);
+}
+
+void *JITCore::RelocateJITObjectCode(uint64_t Entry, uint8_t const *Code, size_t Size, Relocation const *CodeRelocations, size_t NumRelocations) {
+  if (CTX->GetGdbServerStatus()) {
+    return nullptr;
+  }
+
+  EnsureCodeBufferSpace(Size);
+
+  // Guest RIP relative values are resolved against the entry this copy is being placed at
+  RelocationGuestEntry = Entry;
+
+  auto Buffer = GetBuffer();
+  auto HostCode = Buffer->GetOffsetAddress<uint8_t*>(GetCursorOffset());
+  Buffer->EmitData(Code, Size);
+
+  for (size_t i = 0; i < NumRelocations; ++i) {
+    ApplyRelocation(HostCode, CodeRelocations[i], GetRelocationValue(CodeRelocations[i].Type, CodeRelocations[i].Data));
+  }
+
+  CPU.EnsureIAndDCacheCoherency(HostCode, Size);
+  return HostCode;
+}
+
 static IR::PhysicalRegister GetPhys(IR::RegisterAllocationData *RAData, uint32_t Node) {
   auto PhyReg = RAData->GetNodeRegister(Node);
 
@@ -1016,6 +1159,64 @@ bool JITCore::IsInlineConstant(const IR::OrderedNodeWrapper& WNode, uint64_t* Va
   }
 }
 
+bool JITCore::IsConstantValue(IR::OrderedNodeWrapper WNode, uint64_t *Value) {
+  if (IsInlineConstant(WNode, Value)) {
+    return true;
+  }
+
+  auto OpHeader = IR->GetOp<IR::IROp_Header>(WNode);
+  if (OpHeader->Op == IR::IROps::OP_CONSTANT) {
+    *Value = OpHeader->C<IR::IROp_Constant>()->Constant;
+    return true;
+  }
+  return false;
+}
+
+void JITCore::SetHostFlags(uint32_t Node, uint8_t CompareSize, uint32_t Conditions, uint32_t Cmp1, IR::OrderedNodeWrapper Cmp2) {
+  uint64_t Const;
+  if (IsConstantValue(Cmp2, &Const)) {
+    SetHostFlags(Node, CompareSize, Conditions, Cmp1, Const);
+  }
+  else {
+    HostFlags = {true, Node, CompareSize, Conditions, Cmp1, Cmp2.ID(), false, 0};
+  }
+}
+
+void JITCore::SetHostFlags(uint32_t Node, uint8_t CompareSize, uint32_t Conditions, uint32_t Cmp1, uint64_t Cmp2Constant) {
+  HostFlags = {true, Node, CompareSize, Conditions, Cmp1, 0, true, Cmp2Constant};
+}
+
+bool JITCore::HostFlagsHold(IR::OrderedNodeWrapper Cmp1, IR::OrderedNodeWrapper Cmp2, uint8_t CompareSize, IR::CondClassType Cond) {
+  if (!HostFlags.Valid ||
+      HostFlags.CompareSize != CompareSize ||
+      !(HostFlags.Conditions & (1U << Cond.Val)) ||
+      HostFlags.Cmp1 != Cmp1.ID()) {
+    return false;
+  }
+
+  uint64_t Const;
+  if (IsConstantValue(Cmp2, &Const)) {
+    return HostFlags.Cmp2IsConstant && HostFlags.Cmp2Constant == Const;
+  }
+  return !HostFlags.Cmp2IsConstant && HostFlags.Cmp2 == Cmp2.ID();
+}
+
+bool JITCore::PreservesHostFlags(IR::IROps Op) {
+  // Ops that show up between a flag producer and its consumer, none of these touch NZCV
+  switch (Op) {
+    case IR::OP_CONSTANT:
+    case IR::OP_INLINECONSTANT:
+    case IR::OP_LOADCONTEXT:
+    case IR::OP_STORECONTEXT:
+    case IR::OP_STOREFLAG:
+    case IR::OP_LOADFLAG:
+    case IR::OP_BFE:
+      return true;
+    default:
+      return false;
+  }
+}
+
 bool JITCore::IsInlineEntrypointOffset(const IR::OrderedNodeWrapper& WNode, uint64_t* Value) {
   auto OpHeader = IR->GetOp<IR::IROp_Header>(WNode);
 
@@ -1064,9 +1265,7 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
 
   // Fairly excessive buffer range to make sure we don't overflow
   uint32_t BufferRange = SSACount * 16;
-  if ((GetCursorOffset() + BufferRange) > CurrentCodeBuffer->Size) {
-    State->CTX->ClearCodeCache(State, false);
-  }
+  EnsureCodeBufferSpace(BufferRange);
 
   // AAPCS64
   // r30      = LR
@@ -1091,6 +1290,12 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
   auto Buffer = GetBuffer();
   auto Entry = Buffer->GetOffsetAddress<uint64_t>(GetCursorOffset());
 
+  Relocations.clear();
+  BlockEntryOffset = GetCursorOffset();
+  RelocationGuestEntry = HeaderOp->Entry;
+  // The gdb checks change the shape of the block, don't let it mix with cached code
+  IsRelocatable = !CTX->GetGdbServerStatus();
+
  if (CTX->GetGdbServerStatus()) {
     aarch64::Label RunBlock;
 
@@ -1105,16 +1310,25 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
     cbz(w0, &RunBlock);
     {
       // Make sure RIP is syncronized to the context
-      LoadConstant(x0, HeaderOp->Entry);
+      LoadConstantRelocated(x0, RelocationType::GUEST_ENTRY, 0);
       str(x0, MemOperand(STATE, offsetof(FEXCore::Core::ThreadState, State.rip)));
 
       // Stop the thread
-      LoadConstant(x0, ThreadPauseHandlerAddressSpillSRA);
+      LoadConstantRelocated(x0, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_PAUSE_HANDLER));
       br(x0);
     }
     bind(&RunBlock);
   }
 
+  if (BlockEntryCounter) {
+    // Tier 0 profiling, the counter lives as long as the context
+    IsRelocatable = false;
+    LoadConstant(TMP1, reinterpret_cast<uint64_t>(BlockEntryCounter));
+    ldr(TMP2.W(), MemOperand(TMP1));
+    sub(TMP2.W(), TMP2.W(), 1);
+    str(TMP2.W(), MemOperand(TMP1));
+  }
+
   //LogMan::Throw::A(RAData->HasFullRA(), "Arm64 JIT only works with RA");
 
   SpillSlots = RAData->SpillSlots();
@@ -1150,6 +1364,9 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
       PendingTargetLabel = nullptr;
       
       bind(&IsTarget->second);
+
+      // Other blocks can branch here with anything in NZCV
+      HostFlags.Valid = false;
     }
 
     if (DebugData) {
@@ -1162,6 +1379,10 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
       // Execute handler
       OpHandler Handler = OpHandlers[IROp->Op];
       (this->*Handler)(IROp, ID);
+
+      if (HostFlags.Valid && HostFlags.SetBy != ID && !PreservesHostFlags(IROp->Op)) {
+        HostFlags.Valid = false;
+      }
     }
 
     if (DebugData) {
@@ -1271,10 +1492,14 @@ void JITCore::PopCalleeSavedRegisters() {
   }
 }
 
-uint64_t JITCore::ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadState *Thread, uint64_t *record) {
+uint64_t JITCore::ExitFunctionLink(FEXCore::Core::InternalThreadState *Thread, uint64_t *record) {
+  auto core = static_cast<JITCore*>(Thread->CPUBackend.get());
   auto GuestRip = record[1];
 
-  auto HostCode = Thread->LookupCache->FindBlock(GuestRip);
+  std::scoped_lock<std::recursive_mutex> lk(Thread->LookupCache->GetLock());
+
+  // Skip the L1, it can still hold retired code when the cache is shared
+  auto HostCode = Thread->LookupCache->GetBlockCache()->FindBlock(GuestRip);
 
   if (!HostCode) {
     //printf("ExitFunctionLink: Aborting, %lX not in cache\n", GuestRip);
@@ -1282,11 +1507,25 @@ uint64_t JITCore::ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadS
     return core->AbsoluteLoopTopAddress;
   }
 
+  bool Shared = core->CTX->SharedCache != nullptr;
+  if (Shared && !core->CTX->SharedCache->IsLiveCode(reinterpret_cast<uintptr_t>(record))) {
+    // The exit is in retired code, linking it would leave a dangling link behind once it is freed
+    return HostCode;
+  }
+
+  if (Shared) {
+    // Both ends of a link are in use
+    core->CTX->SharedCache->Touch(HostCode);
+    core->CTX->SharedCache->Touch(reinterpret_cast<uintptr_t>(record));
+  }
+
   uintptr_t branch = (uintptr_t)(record) - 8;
   auto LinkerAddress = core->ExitFunctionLinkerAddress;
 
   auto offset = HostCode/4 - branch/4;
-  if (IsInt26(offset)) {
+  // Other threads can be executing this code when it is shared
+  // Rewriting the ldr in to a branch isn't safe under concurrent execution, only the literal is
+  if (!Shared && IsInt26(offset)) {
     // optimal case - can branch directly
     // patch the code
     vixl::aarch64::Assembler emit((uint8_t*)(branch), 24);
@@ -1296,7 +1535,8 @@ uint64_t JITCore::ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadS
     vixl::aarch64::CPU::EnsureIAndDCacheCoherency((void*)branch, 24);
     
     // Add de-linking handler
-    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [branch, LinkerAddress]{
+    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [](uintptr_t Record, uintptr_t LinkerAddress) {
+      uintptr_t branch = Record - 8;
       vixl::aarch64::Assembler emit((uint8_t*)(branch), 24);
       vixl::CodeBufferCheckScope scope(&emit, 24, vixl::CodeBufferCheckScope::kDontReserveBufferSpace, vixl::CodeBufferCheckScope::kNoAssert);
       Literal l_BranchHost{LinkerAddress};
@@ -1305,15 +1545,15 @@ uint64_t JITCore::ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadS
       emit.place(&l_BranchHost);
       emit.FinalizeCode();
       vixl::aarch64::CPU::EnsureIAndDCacheCoherency((void*)branch, 24);
-    });
+    }, LinkerAddress);
   } else {
     // fallback case - do a soft-er link by patching the pointer
     record[0] = HostCode;
 
     // Add de-linking handler
-    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [record, LinkerAddress]{
-      record[0] = LinkerAddress;
-    });
+    Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [](uintptr_t Record, uintptr_t LinkerAddress) {
+      reinterpret_cast<uint64_t*>(Record)[0] = LinkerAddress;
+    }, LinkerAddress);
   }
 
   
@@ -1325,7 +1565,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
   auto OriginalBuffer = *GetBuffer();
 
   // Dispatcher lives outside of traditional space-time
-  DispatcherCodeBuffer = JITCore::AllocateNewCodeBuffer(MAX_DISPATCHER_CODE_SIZE);
+  DispatcherCodeBuffer = JITCore::AllocateNewCodeBuffer(CTX, MAX_DISPATCHER_CODE_SIZE);
   *GetBuffer() = vixl::CodeBuffer(DispatcherCodeBuffer.Ptr, DispatcherCodeBuffer.Size);
 
   auto Buffer = GetBuffer();
@@ -1413,7 +1653,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
   auto RipReg = x2;
 
   // L1 Cache
-  LoadConstant(x0, Thread->LookupCache->GetL1Pointer());
+  ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, L1Pointer)));
 
   and_(x3, RipReg, LookupCache::L1_ENTRIES_MASK);
   add(x0, x0, Operand(x3, Shift::LSL, 4));
@@ -1468,7 +1708,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
     // If we've made it here then we have a real compiled block
     {
       // update L1 cache
-      LoadConstant(x0, Thread->LookupCache->GetL1Pointer());
+      ldr(x0, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, L1Pointer)));
 
       and_(x1, RipReg, LookupCache::L1_ENTRIES_MASK);
       add(x0, x0, Operand(x1, Shift::LSL, 4));
@@ -1495,9 +1735,8 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
 
     SpillStaticRegs();
     
-    LoadConstant(x0, (uintptr_t)this);
-    mov(x1, STATE);
-    mov(x2, lr);
+    mov(x0, STATE);
+    mov(x1, lr);
     
     ldr(x3, &l_ExitFunctionLink);
     blr(x3);
@@ -1579,10 +1818,9 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
     mov(STATE, x0);
 
     // Make sure to adjust the refcounter so we don't clear the cache now
-    LoadConstant(x0, reinterpret_cast<uint64_t>(&SignalHandlerRefCounter));
-    ldr(w2, MemOperand(x0));
+    ldr(w2, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)));
     add(w2, w2, 1);
-    str(w2, MemOperand(x0));
+    str(w2, MemOperand(STATE, offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)));
 
     // Now push the callback return trampoline to the guest stack
     // Guest will be misaligned because calling a thunk won't correct the guest's stack once we call the callback from the host
@@ -1705,6 +1943,13 @@ void JITCore::ResetStack() {
 }
 
 FEXCore::CPU::CPUBackend *CreateJITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread, bool CompileThread) {
-  return new JITCore(ctx, Thread, JITCore::AllocateNewCodeBuffer(JITCore::INITIAL_CODE_SIZE), CompileThread);
+  if (ctx->SharedCache) {
+    auto Region = ctx->SharedCache->AllocateRegion(SharedCodeCache::REGION_SIZE);
+    auto Core = new JITCore(ctx, Thread, JITCore::CodeBuffer{Region.Ptr, Region.Size}, CompileThread);
+    Core->CodeRegionEpoch = Region.Epoch;
+    return Core;
+  }
+
+  return new JITCore(ctx, Thread, JITCore::AllocateNewCodeBuffer(ctx, JITCore::INITIAL_CODE_SIZE), CompileThread);
 }
 }
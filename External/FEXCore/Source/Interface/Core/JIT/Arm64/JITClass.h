@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Interface/Core/AOTCodeCache.h"
 #include "Interface/Core/LookupCache.h"
 
 #include "aarch64/assembler-aarch64.h"
@@ -92,10 +93,13 @@ public:
   bool HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSigAction *GuestAction, stack_t *GuestStack);
 
   static constexpr size_t INITIAL_CODE_SIZE = 1024 * 1024 * 16;
-  static CodeBuffer AllocateNewCodeBuffer(size_t Size);
+  static CodeBuffer AllocateNewCodeBuffer(FEXCore::Context::Context *CTX, size_t Size);
 
   void CopyNecessaryDataForCompileThread(CPUBackend *Original) override;
 
+  std::vector<Relocation> const *GetRelocations() override { return IsRelocatable ? &Relocations : nullptr; }
+  void *RelocateJITObjectCode(uint64_t Entry, uint8_t const *Code, size_t Size, Relocation const *CodeRelocations, size_t NumRelocations) override;
+
 private:
   Label *PendingTargetLabel;
   FEXCore::Context::Context *CTX;
@@ -149,7 +153,7 @@ private:
   bool IsFPR(uint32_t Node);
   bool IsGPR(uint32_t Node);
 
-  MemOperand GenerateMemOperand(uint8_t AccessSize, aarch64::Register Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale);
+  MemOperand GenerateMemOperand(uint8_t AccessSize, aarch64::Register Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale, int32_t OffsetDisp);
 
   bool IsInlineConstant(const IR::OrderedNodeWrapper& Node, uint64_t* Value = nullptr);
   bool IsInlineEntrypointOffset(const IR::OrderedNodeWrapper& WNode, uint64_t* Value);
@@ -202,7 +206,18 @@ private:
   void PushCalleeSavedRegisters();
   void PopCalleeSavedRegisters();
 
-  static uint64_t ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadState *Thread, uint64_t *record);
+  static uint64_t ExitFunctionLink(FEXCore::Core::InternalThreadState *Thread, uint64_t *record);
+
+  /**
+   * @name Shared code cache
+   * @{ */
+  // Picks up the dispatcher that another thread generated
+  void CopyDispatcher(JITCore *Owner);
+  // Moves code emission to a fresh region of the shared code cache
+  void SwitchToNewCodeRegion(size_t MinSize);
+  bool OwnsDispatcher{true};
+  uint64_t CodeRegionEpoch{};
+  /**  @} */
 
   /**
    * @name Dispatch Helper functions
@@ -217,8 +232,6 @@ private:
   uint64_t ThreadStopHandlerAddress{};
   uint64_t PauseReturnInstruction{};
 
-  uint32_t SignalHandlerRefCounter{};
-
   void StoreThreadState(int Signal, void *ucontext);
   void RestoreThreadState(void *ucontext);
   /**  @} */
@@ -230,6 +243,24 @@ private:
   };
 
   CompilerSharedData ThreadSharedData;
+
+  /**
+   * @name Relocatable code
+   * @{ */
+  // Makes sure there is room for Size bytes of code before emitting a block
+  void EnsureCodeBufferSpace(size_t Size);
+  uint64_t GetThreadPointer(RelocationThreadPointer Pointer);
+  uint64_t GetRelocationValue(RelocationType Type, uint64_t Data);
+  void AddRelocation(RelocationType Type, uint64_t Data, RelocationEncoding Encoding);
+  // Loads a value that is recorded as a relocation, always a movz and three movk
+  void LoadConstantRelocated(vixl::aarch64::Register Reg, RelocationType Type, uint64_t Data);
+
+  std::vector<Relocation> Relocations;
+  // Cleared by anything that bakes in a pointer we can't describe with a relocation
+  bool IsRelocatable{};
+  size_t BlockEntryOffset{};
+  uint64_t RelocationGuestEntry{};
+  /**  @} */
   IR::RegisterAllocationPass *RAPass;
   IR::RegisterAllocationData *RAData;
 
@@ -243,6 +274,51 @@ private:
 
   void ResetStack();
 
+  /**
+   * @name Block exits
+   * @{ */
+  // Exit that the linker patches to jump straight to the block at NewRIP, GuestRIPLiteral holds NewRIP
+  void EmitLinkableExit(uint64_t NewRIP, bool IsConstant, Literal<uint64_t> *GuestRIPLiteral);
+  // Exit to a dynamic RIP through the L1 cache, falling back to the dispatcher
+  void EmitLookupExit(aarch64::Register RipReg);
+  // Pushes the return address of a call along with a linkable exit to it for GuestReturn to take
+  void PushReturnStack(IR::OrderedNodeWrapper NextRIP);
+  /**  @} */
+
+  /**
+   * @name Host flags
+   * @brief Tracks which compare NZCV currently holds so Select and CondJump can skip their own cmp
+   *
+   * Sub and And set NZCV with subs/ands, the following flag consumer then only needs the b.cond/csel
+   * @{ */
+  struct HostFlagsState {
+    bool Valid;
+    // The op that set the flags, any later op that isn't flag preserving clobbers them
+    uint32_t SetBy;
+    uint8_t CompareSize;
+    // Mask of the conditions that read the same from NZCV as they would after the cmp
+    uint32_t Conditions;
+    uint32_t Cmp1;
+    uint32_t Cmp2;
+    bool Cmp2IsConstant;
+    uint64_t Cmp2Constant;
+  };
+  HostFlagsState HostFlags{};
+
+  // Every integer condition, NZCV matches a `cmp Cmp1, Cmp2` exactly
+  constexpr static uint32_t HOST_FLAGS_ALL_INT = (1U << 14) - 1;
+  // Logical ops clear C and V, only the conditions that don't depend on C survive
+  constexpr static uint32_t HOST_FLAGS_LOGICAL =
+    (1U << IR::COND_EQ) | (1U << IR::COND_NEQ) |
+    (1U << IR::COND_SGE) | (1U << IR::COND_SLT) | (1U << IR::COND_SGT) | (1U << IR::COND_SLE);
+
+  void SetHostFlags(uint32_t Node, uint8_t CompareSize, uint32_t Conditions, uint32_t Cmp1, IR::OrderedNodeWrapper Cmp2);
+  void SetHostFlags(uint32_t Node, uint8_t CompareSize, uint32_t Conditions, uint32_t Cmp1, uint64_t Cmp2Constant);
+  bool HostFlagsHold(IR::OrderedNodeWrapper Cmp1, IR::OrderedNodeWrapper Cmp2, uint8_t CompareSize, IR::CondClassType Cond);
+  bool IsConstantValue(IR::OrderedNodeWrapper WNode, uint64_t *Value);
+  static bool PreservesHostFlags(IR::IROps Op);
+  /**  @} */
+
   using OpHandler = void (JITCore::*)(FEXCore::IR::IROp_Header *IROp, uint32_t Node);
   std::array<OpHandler, FEXCore::IR::IROps::OP_LAST + 1> OpHandlers {};
   void RegisterALUHandlers();
@@ -342,6 +418,7 @@ private:
   DEF_OP(ValidateCode);
   DEF_OP(RemoveCodeEntry);
   DEF_OP(CPUID);
+  DEF_OP(CalculateDeferredFlags);
 
   ///< Conversion ops
   DEF_OP(VInsGPR);
@@ -530,7 +530,7 @@ DEF_OP(StoreFlag) {
   strb(GetReg<RA_64>(Op->Header.Args[0].ID()), MemOperand(STATE, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag));
 }
 
-MemOperand JITCore::GenerateMemOperand(uint8_t AccessSize, aarch64::Register Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale) {
+MemOperand JITCore::GenerateMemOperand(uint8_t AccessSize, aarch64::Register Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale, int32_t OffsetDisp) {
   if (Offset.IsInvalid()) {
     return MemOperand(Base);
   } else {
@@ -539,9 +539,20 @@ MemOperand JITCore::GenerateMemOperand(uint8_t AccessSize, aarch64::Register Bas
     }
     uint64_t Const;
     if (IsInlineConstant(Offset, &Const)) {
-        return MemOperand(Base, Const);
+        return MemOperand(Base, Const + OffsetDisp);
     } else {
       auto RegOffset = GetReg<RA_64>(Offset.ID());
+
+      // There is no base + index + imm form, fold the displacement in to the base first
+      if (OffsetDisp > 0) {
+        add(TMP1, Base, OffsetDisp);
+        Base = TMP1;
+      }
+      else if (OffsetDisp < 0) {
+        sub(TMP1, Base, -(int64_t)OffsetDisp);
+        Base = TMP1;
+      }
+
       switch(OffsetType.Val) {
         case IR::MEM_OFFSET_SXTX.Val: return MemOperand(Base, RegOffset, Extend::SXTX, (int)std::log2(OffsetScale) );
         case IR::MEM_OFFSET_UXTW.Val: return MemOperand(Base, RegOffset.W(), Extend::UXTW, (int)std::log2(OffsetScale) );
@@ -557,7 +568,7 @@ DEF_OP(LoadMem) {
   auto Op = IROp->C<IR::IROp_LoadMem>();
 
   auto MemReg = GetReg<RA_64>(Op->Header.Args[0].ID());
-  auto MemSrc = GenerateMemOperand(Op->Size, MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale);
+  auto MemSrc = GenerateMemOperand(Op->Size, MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale, Op->OffsetDisp);
 
   if (Op->Class == FEXCore::IR::GPRClass) {
     auto Dst = GetReg<RA_64>(Node);
@@ -686,7 +697,7 @@ DEF_OP(StoreMem) {
 
   auto MemReg = GetReg<RA_64>(Op->Header.Args[0].ID());
 
-  auto MemSrc = GenerateMemOperand(Op->Size, MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale);
+  auto MemSrc = GenerateMemOperand(Op->Size, MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale, Op->OffsetDisp);
 
   if (Op->Class == FEXCore::IR::GPRClass) {
     switch (Op->Size) {
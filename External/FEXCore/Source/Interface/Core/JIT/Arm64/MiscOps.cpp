@@ -36,14 +36,14 @@ DEF_OP(Break) {
       add(sp, TMP1, 0);
 
       // Now we need to jump to the thread stop handler
-      LoadConstant(TMP1, ThreadStopHandlerAddressSpillSRA);
+      LoadConstantRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_STOP_HANDLER));
       br(TMP1);
       break;
     }
     case 6: { // INT3
       ResetStack();
 
-      LoadConstant(TMP1, ThreadPauseHandlerAddressSpillSRA);
+      LoadConstantRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_PAUSE_HANDLER));
       br(TMP1);
       break;
     }
@@ -26,8 +26,7 @@ DEF_OP(Constant) {
 DEF_OP(EntrypointOffset) {
   auto Op = IROp->C<IR::IROp_EntrypointOffset>();
 
-  auto Constant = IR->GetHeader()->Entry + Op->Offset;
-  mov(GetDst<RA_64>(Node), Constant);
+  MovRelocated(Xbyak::Reg64(GetDst<RA_64>(Node).getIdx()), RelocationType::GUEST_ENTRY, Op->Offset);
 }
 
 DEF_OP(InlineConstant) {
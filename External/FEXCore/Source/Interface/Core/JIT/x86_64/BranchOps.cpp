@@ -1,3 +1,4 @@
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/JIT/x86_64/JITClass.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 
@@ -7,16 +8,118 @@
 
 namespace FEXCore::CPU {
 #define DEF_OP(x) void JITCore::Op_##x(FEXCore::IR::IROp_Header *IROp, uint32_t Node)
+void JITCore::EmitLinkableExit(uint64_t NewRIP, bool IsConstant, Label &GuestRIPLabel) {
+  Label l_BranchHost;
+
+  lea(rax, ptr[rip + l_BranchHost]);
+  jmp(qword[rax]);
+
+  // The linker patches this from other threads when code is shared, keep it naturally aligned
+  align(8);
+  L(l_BranchHost);
+  LiteralRelocated(RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::EXIT_FUNCTION_LINKER));
+  L(GuestRIPLabel);
+  if (IsConstant) {
+    dq(NewRIP);
+  }
+  else {
+    LiteralRelocated(RelocationType::GUEST_ENTRY, NewRIP - IR->GetHeader()->Entry);
+  }
+}
+
+void JITCore::EmitLookupExit(Xbyak::Reg RipReg) {
+  Label FullLookup;
+
+  // L1 Cache
+  mov(rcx, qword [STATE + offsetof(FEXCore::Core::InternalThreadState, L1Pointer)]);
+  mov(rax, RipReg);
+
+  and_(rax, LookupCache::L1_ENTRIES_MASK);
+  shl(rax, 4);
+
+  Xbyak::RegExp LookupBase = rcx + rax;
+
+  cmp(qword[LookupBase + 8], RipReg);
+  jne(FullLookup);
+  jmp(qword[LookupBase + 0]);
+
+  L(FullLookup);
+  MovRelocated(rax, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::LOOP_TOP));
+  mov(qword [STATE + offsetof(FEXCore::Core::InternalThreadState, State.State.rip)], RipReg);
+  jmp(rax);
+}
+
+void JITCore::PushReturnStack(IR::OrderedNodeWrapper NextRIP) {
+  uint64_t ReturnRIP;
+  bool IsConstant = IsInlineConstant(NextRIP, &ReturnRIP);
+
+  if (!IsConstant && !IsInlineEntrypointOffset(NextRIP, &ReturnRIP)) {
+    // The exit to the return site can only be linked with a known address
+    return;
+  }
+
+  Label l_ReturnExit;
+  Label l_ReturnRIP;
+  Label l_Continue;
+
+  mov(rcx, qword [STATE + offsetof(FEXCore::Core::InternalThreadState, Returns.Top)]);
+  add(rcx, 1);
+  and_(rcx, FEXCore::Core::ReturnStack::MASK);
+  mov(qword [STATE + offsetof(FEXCore::Core::InternalThreadState, Returns.Top)], rcx);
+  shl(rcx, 4);
+
+  // Load the return address back from the exit so it carries the relocation
+  mov(rax, qword [rip + l_ReturnRIP]);
+  mov(qword [STATE + rcx + offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].GuestRIP)], rax);
+  lea(rax, ptr[rip + l_ReturnExit]);
+  mov(qword [STATE + rcx + offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].HostCode)], rax);
+  jmp(l_Continue, T_NEAR);
+
+  // Only reached from GuestReturn, the linker links it to the return site the first time around
+  L(l_ReturnExit);
+  EmitLinkableExit(ReturnRIP, IsConstant, l_ReturnRIP);
+
+  L(l_Continue);
+}
+
 DEF_OP(GuestCallDirect) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestCallDirect>();
+  PushReturnStack(Op->NextRIP);
 }
 
 DEF_OP(GuestCallIndirect) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestCallIndirect>();
+  PushReturnStack(Op->NextRIP);
 }
 
 DEF_OP(GuestReturn) {
-  LogMan::Msg::D("Unimplemented");
+  auto Op = IROp->C<IR::IROp_GuestReturn>();
+  Label Mispredicted;
+
+  if (SpillSlots) {
+    add(rsp, SpillSlots * 16);
+  }
+
+  Xbyak::Reg RipReg = GetSrc<RA_64>(Op->NewRIP.ID());
+
+  // Pop the prediction even if it misses so a mismatch doesn't throw off the rest of the stack
+  mov(rcx, qword [STATE + offsetof(FEXCore::Core::InternalThreadState, Returns.Top)]);
+  mov(rax, rcx);
+  sub(rcx, 1);
+  and_(rcx, FEXCore::Core::ReturnStack::MASK);
+  mov(qword [STATE + offsetof(FEXCore::Core::InternalThreadState, Returns.Top)], rcx);
+  shl(rax, 4);
+
+  cmp(qword [STATE + rax + offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].GuestRIP)], RipReg);
+  jne(Mispredicted);
+  jmp(qword [STATE + rax + offsetof(FEXCore::Core::InternalThreadState, Returns.Entries[0].HostCode)]);
+
+  L(Mispredicted);
+  EmitLookupExit(RipReg);
+
+#ifdef BLOCKSTATS
+  ExitBlock();
+#endif
 }
 
 DEF_OP(SignalReturn) {
@@ -25,7 +128,7 @@ DEF_OP(SignalReturn) {
     add(rsp, SpillSlots * 16); // + 8 to consume return address
   }
 
-  mov(TMP1, ThreadSharedData.SignalHandlerReturnAddress);
+  MovRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::SIGNAL_RETURN));
   jmp(TMP1);
 }
 
@@ -36,8 +139,7 @@ DEF_OP(CallbackReturn) {
   }
 
   // Make sure to adjust the refcounter so we don't clear the cache now
-  mov(rax, reinterpret_cast<uint64_t>(ThreadSharedData.SignalHandlerRefCounterPtr));
-  sub(dword [rax], 1);
+  sub(dword [STATE + offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)], 1);
 
   // We need to adjust an additional 8 bytes to get back to the original "misaligned" RSP state
   add(qword [STATE + offsetof(FEXCore::Core::InternalThreadState, State.State.gregs[X86State::REG_RSP])], 8);
@@ -57,7 +159,6 @@ DEF_OP(CallbackReturn) {
 }
 
 DEF_OP(ExitFunction) {
-  Label FullLookup;
   auto Op = IROp->C<IR::IROp_ExitFunction>();
 
 
@@ -66,38 +167,13 @@ DEF_OP(ExitFunction) {
   }
 
   uint64_t NewRIP;
+  bool IsConstant = IsInlineConstant(Op->NewRIP, &NewRIP);
 
-  if (IsInlineConstant(Op->NewRIP, &NewRIP) || IsInlineEntrypointOffset(Op->NewRIP, &NewRIP)) {
-    Label l_BranchHost;
+  if (IsConstant || IsInlineEntrypointOffset(Op->NewRIP, &NewRIP)) {
     Label l_BranchGuest;
-
-    lea(rax, ptr[rip + l_BranchHost]);
-    jmp(qword[rax]);
-
-    L(l_BranchHost);
-    dq(ExitFunctionLinkerAddress);
-    L(l_BranchGuest);
-    dq(NewRIP);
+    EmitLinkableExit(NewRIP, IsConstant, l_BranchGuest);
   } else {
-    Xbyak::Reg RipReg = GetSrc<RA_64>(Op->NewRIP.ID());
-    
-    // L1 Cache
-    mov(rcx, ThreadState->LookupCache->GetL1Pointer());
-    mov(rax, RipReg);
-
-    and_(rax, LookupCache::L1_ENTRIES_MASK);
-    shl(rax, 4);
-
-    Xbyak::RegExp LookupBase = rcx + rax;
-  
-    cmp(qword[LookupBase + 8], RipReg);
-    jne(FullLookup);
-    jmp(qword[LookupBase + 0]);
-
-    L(FullLookup);
-    mov(rax, AbsoluteLoopTopAddress);
-    mov(qword [STATE + offsetof(FEXCore::Core::InternalThreadState, State.State.rip)], RipReg);
-    jmp(rax);
+    EmitLookupExit(GetSrc<RA_64>(Op->NewRIP.ID()));
   }
 
 #ifdef BLOCKSTATS
@@ -190,10 +266,10 @@ DEF_OP(Syscall) {
   }
 
   mov(rsi, STATE); // Move thread in to rsi
-  mov(rdi, reinterpret_cast<uint64_t>(CTX->SyscallHandler));
+  MovRelocated(rdi, RelocationType::SYSCALL_HANDLER, 0);
   mov(rdx, rsp);
 
-  mov(rax, reinterpret_cast<uint64_t>(FEXCore::Context::HandleSyscall));
+  MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(FEXCore::Context::HandleSyscall)));
 
   if (NumPush & 1)
     sub(rsp, 8); // Align
@@ -229,6 +305,8 @@ DEF_OP(Thunk) {
   mov(rdi, GetSrc<RA_64>(Op->Header.Args[0].ID()));
   
   auto thunkFn = ThreadState->CTX->ThunkHandler->LookupThunk(Op->ThunkNameHash);
+  // Thunks live in host libraries that are loaded at a different address every run
+  IsRelocatable = false;
 
   mov(rax, reinterpret_cast<uintptr_t>(thunkFn));
   call(rax);
@@ -247,7 +325,7 @@ DEF_OP(ValidateCode) {
   int idx = 0;
 
   xor_(GetDst<RA_64>(Node), GetDst<RA_64>(Node));
-  mov(rax, IR->GetHeader()->Entry + Op->Offset);
+  MovRelocated(rax, RelocationType::GUEST_ENTRY, Op->Offset);
   mov(rbx, 1);
   while (len >= 4) {
     cmp(dword[rax + idx], *(uint32_t*)(OldCode + idx));
@@ -282,11 +360,11 @@ DEF_OP(RemoveCodeEntry) {
     sub(rsp, 8); // Align
 
   mov(rdi, STATE);
-  mov(rax, IR->GetHeader()->Entry); // imm64 move
+  MovRelocated(rax, RelocationType::GUEST_ENTRY, 0);
   mov(rsi, rax);
 
 
-  mov(rax, reinterpret_cast<uintptr_t>(&Context::Context::RemoveCodeEntry));
+  MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(&Context::Context::RemoveCodeEntry)));
   call(rax);
 
   if (NumPush & 1)
@@ -316,14 +394,14 @@ DEF_OP(CPUID) {
   // Result: RAX, RDX. 4xi32
 
   mov (rsi, GetSrc<RA_64>(Op->Header.Args[0].ID()));
-  mov (rdi, reinterpret_cast<uint64_t>(&CTX->CPUID));
+  MovRelocated(rdi, RelocationType::CONTEXT, reinterpret_cast<uintptr_t>(&CTX->CPUID) - reinterpret_cast<uintptr_t>(CTX));
 
   auto NumPush = RA64.size();
 
   if (NumPush & 1)
     sub(rsp, 8); // Align
 
-  mov(rax, Ptr.Raw);
+  MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(Ptr.Raw)));
 
   // {rdi, rsi, rdx}
 
@@ -340,6 +418,36 @@ DEF_OP(CPUID) {
   mov(Dst.second, rdx);
 }
 
+DEF_OP(CalculateDeferredFlags) {
+  Label l_Calculated;
+
+  // Most blocks that read flags come after a producer that already calculated them
+  cmp(byte [STATE + offsetof(FEXCore::Core::CPUState, DeferredFlagsOp)], 0);
+  je(l_Calculated, T_NEAR);
+
+  for (auto &Reg : RA64)
+    push(Reg);
+
+  // State: rdi
+  mov(rdi, STATE);
+
+  auto NumPush = RA64.size();
+
+  if (NumPush & 1)
+    sub(rsp, 8); // Align
+
+  MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(FEXCore::CPU::CalculateDeferredFlags)));
+  call(rax);
+
+  if (NumPush & 1)
+    add(rsp, 8); // Align
+
+  for (uint32_t i = RA64.size(); i > 0; --i)
+    pop(RA64[i - 1]);
+
+  L(l_Calculated);
+}
+
 #undef DEF_OP
 void JITCore::RegisterBranchHandlers() {
 #define REGISTER_OP(op, x) OpHandlers[FEXCore::IR::IROps::OP_##op] = &JITCore::Op_##x
@@ -356,6 +464,7 @@ void JITCore::RegisterBranchHandlers() {
   REGISTER_OP(VALIDATECODE,      ValidateCode);
   REGISTER_OP(REMOVECODEENTRY,   RemoveCodeEntry);
   REGISTER_OP(CPUID,             CPUID);
+  REGISTER_OP(CALCULATEDEFERREDFLAGS, CalculateDeferredFlags);
 #undef REGISTER_OP
 }
 }
@@ -1,7 +1,9 @@
 #include "Interface/Context/Context.h"
 
 #include "Interface/Core/JIT/x86_64/JITClass.h"
+#include "Interface/Core/HostMemory.h"
 #include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/SharedCodeCache.h"
 
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
 
@@ -9,6 +11,7 @@
 #include <FEXCore/Core/UContext.h>
 
 #include <cmath>
+#include <cstring>
 #include <signal.h>
 
 #include "Interface/Core/Interpreter/InterpreterOps.h"
@@ -18,21 +21,19 @@
 
 namespace FEXCore::CPU {
 
-CodeBuffer AllocateNewCodeBuffer(size_t Size) {
+CodeBuffer AllocateNewCodeBuffer(FEXCore::Context::Context *CTX, size_t Size) {
   CodeBuffer Buffer;
   Buffer.Size = Size;
   Buffer.Ptr = static_cast<uint8_t*>(
-               mmap(nullptr,
-                    Buffer.Size,
-                    PROT_READ | PROT_WRITE | PROT_EXEC,
-                    MAP_PRIVATE | MAP_ANONYMOUS,
-                    -1, 0));
-  LogMan::Throw::A(Buffer.Ptr != reinterpret_cast<uint8_t*>(~0ULL), "Couldn't allocate code buffer");
+               HostMemory::Allocate(Buffer.Size,
+                                    PROT_READ | PROT_WRITE | PROT_EXEC,
+                                    HostMemory::GetPolicy(CTX)));
+  LogMan::Throw::A(Buffer.Ptr != nullptr, "Couldn't allocate code buffer");
   return Buffer;
 }
 
-void FreeCodeBuffer(CodeBuffer Buffer) {
-  munmap(Buffer.Ptr, Buffer.Size);
+void FreeCodeBuffer(FEXCore::Context::Context *CTX, CodeBuffer Buffer) {
+  HostMemory::Free(Buffer.Ptr, Buffer.Size, HostMemory::GetPolicy(CTX));
 }
 
 }
@@ -134,7 +135,7 @@ bool JITCore::HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSig
 
   // Ref count our faults
   // We use this to track if it is safe to clear cache
-  ++SignalHandlerRefCounter;
+  ++ThreadState->SignalHandlerRefCounter;
 
   uint64_t OldGuestSP = ThreadState->State.State.gregs[X86State::REG_RSP];
   uint64_t NewGuestSP = OldGuestSP;
@@ -255,6 +256,40 @@ bool JITCore::HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSig
 void JITCore::CopyNecessaryDataForCompileThread(CPUBackend *Original) {
   JITCore *Core = reinterpret_cast<JITCore*>(Original);
   ThreadSharedData = Core->ThreadSharedData;
+
+  // Code generated on the compile thread jumps back in to the parent's dispatcher
+  AbsoluteLoopTopAddress = Core->AbsoluteLoopTopAddress;
+  ExitFunctionLinkerAddress = Core->ExitFunctionLinkerAddress;
+  ThreadStopHandlerAddress = Core->ThreadStopHandlerAddress;
+  ThreadPauseHandlerAddress = Core->ThreadPauseHandlerAddress;
+  PauseReturnInstruction = Core->PauseReturnInstruction;
+}
+
+void JITCore::CopyDispatcher(JITCore *Owner) {
+  // The dispatcher only references the thread through the STATE register so it is safe to share
+  DispatchPtr = Owner->DispatchPtr;
+  CallbackPtr = Owner->CallbackPtr;
+  DispatcherCodeBuffer = Owner->DispatcherCodeBuffer;
+  OwnsDispatcher = false;
+
+  AbsoluteLoopTopAddress = Owner->AbsoluteLoopTopAddress;
+  ExitFunctionLinkerAddress = Owner->ExitFunctionLinkerAddress;
+  ThreadStopHandlerAddress = Owner->ThreadStopHandlerAddress;
+  ThreadPauseHandlerAddress = Owner->ThreadPauseHandlerAddress;
+  PauseReturnInstruction = Owner->PauseReturnInstruction;
+  ThreadSharedData.SignalHandlerReturnAddress = Owner->ThreadSharedData.SignalHandlerReturnAddress;
+}
+
+void JITCore::SwitchToNewCodeRegion(size_t MinSize) {
+  // Nothing more gets emitted in to the old region, from now on it can be evicted
+  CTX->SharedCache->CloseRegion(InitialCodeBuffer.Ptr, CodeRegionEpoch);
+
+  auto Region = CTX->SharedCache->AllocateRegion(MinSize);
+  // The old region belongs to the shared cache, it gets released once every thread is done with it
+  InitialCodeBuffer = CodeBuffer{Region.Ptr, Region.Size};
+  CurrentCodeBuffer = &InitialCodeBuffer;
+  CodeRegionEpoch = Region.Epoch;
+  setNewBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
 }
 
 bool JITCore::HandleSIGILL(int Signal, void *info, void *ucontext) {
@@ -266,7 +301,7 @@ bool JITCore::HandleSIGILL(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --ThreadState->SignalHandlerRefCounter;
     return true;
   }
 
@@ -275,7 +310,7 @@ bool JITCore::HandleSIGILL(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --ThreadState->SignalHandlerRefCounter;
     return true;
   }
 
@@ -300,7 +335,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    ++SignalHandlerRefCounter;
+    ++ThreadState->SignalHandlerRefCounter;
 
     ThreadState->SignalReason.store(FEXCore::Core::SIGNALEVENT_NONE);
     return true;
@@ -311,7 +346,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
 
     // Ref count our faults
     // We use this to track if it is safe to clear cache
-    --SignalHandlerRefCounter;
+    --ThreadState->SignalHandlerRefCounter;
 
     ThreadState->SignalReason.store(FEXCore::Core::SIGNALEVENT_NONE);
     return true;
@@ -327,7 +362,7 @@ bool JITCore::HandleSignalPause(int Signal, void *info, void *ucontext) {
     _mcontext->gregs[REG_RSP] = ThreadState->State.ReturningStackLocation;
 
     // Our ref counting doesn't matter anymore
-    SignalHandlerRefCounter = 0;
+    ThreadState->SignalHandlerRefCounter = 0;
 
     // Set the new PC
     _mcontext->gregs[REG_RIP] = ThreadStopHandlerAddress;
@@ -377,7 +412,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
       case FABI_VOID_U16: {
         PushRegs();
         mov(edi, GetSrc<RA_32>(IROp->Args[0].ID()));
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -388,7 +423,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushRegs();
 
         movss(xmm0, GetSrc(IROp->Args[0].ID()));
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -404,7 +439,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushRegs();
 
         movsd(xmm0, GetSrc(IROp->Args[0].ID()));
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -421,7 +456,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         PushRegs();
 
         mov(edi, GetSrc<RA_32>(IROp->Args[0].ID()));
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -439,7 +474,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
 
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -455,7 +490,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
 
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -471,7 +506,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
 
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -486,7 +521,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
 
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -501,7 +536,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
 
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -519,7 +554,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdx, GetSrc(IROp->Args[1].ID()));
         pextrq(rcx, GetSrc(IROp->Args[1].ID()), 1);
         
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -534,7 +569,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdi, GetSrc(IROp->Args[0].ID()));
         pextrq(rsi, GetSrc(IROp->Args[0].ID()), 1);
         
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -554,7 +589,7 @@ void JITCore::Op_Unhandled(FEXCore::IR::IROp_Header *IROp, uint32_t Node) {
         movq(rdx, GetSrc(IROp->Args[1].ID()));
         pextrq(rcx, GetSrc(IROp->Args[1].ID()), 1);
         
-        mov(rax, (uintptr_t)Info.fn);
+        MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(Info.fn));
 
         call(rax);
 
@@ -583,7 +618,7 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
   , ThreadState {Thread}
   , InitialCodeBuffer {Buffer}
 {
-  ThreadSharedData.SignalHandlerRefCounterPtr = &SignalHandlerRefCounter;
+  ThreadSharedData.SignalHandlerRefCounterPtr = &Thread->SignalHandlerRefCounter;
 
   CurrentCodeBuffer = &InitialCodeBuffer;
 
@@ -615,7 +650,20 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
   RegisterEncryptionHandlers();
 
   if (!CompileThread) {
-    CreateCustomDispatch(Thread);
+    if (CTX->SharedCache) {
+      // Every thread shares the dispatcher of the first one
+      std::scoped_lock<std::mutex> lk(CTX->SharedCache->DispatcherLock);
+      if (CTX->SharedCache->DispatcherOwner) {
+        CopyDispatcher(static_cast<JITCore*>(CTX->SharedCache->DispatcherOwner));
+      }
+      else {
+        CreateCustomDispatch(Thread);
+        CTX->SharedCache->DispatcherOwner = this;
+      }
+    }
+    else {
+      CreateCustomDispatch(Thread);
+    }
 
     // This will register the host signal handler per thread, which is fine
     CTX->SignalDelegation->RegisterHostSignalHandler(SIGILL, [](FEXCore::Core::InternalThreadState *Thread, int Signal, void *info, void *ucontext) -> bool {
@@ -641,24 +689,38 @@ JITCore::JITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadSt
 
 JITCore::~JITCore() {
   for (auto CodeBuffer : CodeBuffers) {
-    FreeCodeBuffer(CodeBuffer);
+    FreeCodeBuffer(CTX, CodeBuffer);
   }
   CodeBuffers.clear();
 
-  if (DispatcherCodeBuffer.Ptr) {
+  if (DispatcherCodeBuffer.Ptr && OwnsDispatcher) {
     // Dispatcher may not exist if this is a compile thread
-    FreeCodeBuffer(DispatcherCodeBuffer);
+    // Shared dispatchers are only torn down with the context, the owner outlives the other threads
+    FreeCodeBuffer(CTX, DispatcherCodeBuffer);
+  }
+
+  if (CTX->SharedCache) {
+    // Shared cache regions are owned by the cache
+    CTX->SharedCache->CloseRegion(InitialCodeBuffer.Ptr, CodeRegionEpoch);
+  }
+  else {
+    FreeCodeBuffer(CTX, InitialCodeBuffer);
   }
-  FreeCodeBuffer(InitialCodeBuffer);
 }
 
 void JITCore::ClearCache() {
+  if (CTX->SharedCache) {
+    // Other threads may still be running the old code, never reuse it here
+    SwitchToNewCodeRegion(0);
+    return;
+  }
+
   if (*ThreadSharedData.SignalHandlerRefCounterPtr == 0) {
     if (!CodeBuffers.empty()) {
       // If we have more than one code buffer we are tracking then walk them and delete
       // This is a cleanup step
       for (auto CodeBuffer : CodeBuffers) {
-        FreeCodeBuffer(CodeBuffer);
+        FreeCodeBuffer(CTX, CodeBuffer);
       }
       CodeBuffers.clear();
 
@@ -672,13 +734,13 @@ void JITCore::ClearCache() {
       reset();
     }
     else {
-      FreeCodeBuffer(InitialCodeBuffer);
+      FreeCodeBuffer(CTX, InitialCodeBuffer);
 
       // Resize the code buffer and reallocate our code size
       CurrentCodeBuffer->Size *= 1.5;
       CurrentCodeBuffer->Size = std::min(CurrentCodeBuffer->Size, MAX_CODE_SIZE);
 
-      InitialCodeBuffer = AllocateNewCodeBuffer(CurrentCodeBuffer->Size);
+      InitialCodeBuffer = AllocateNewCodeBuffer(CTX, CurrentCodeBuffer->Size);
       setNewBuffer(InitialCodeBuffer.Ptr, InitialCodeBuffer.Size);
     }
   }
@@ -686,7 +748,7 @@ void JITCore::ClearCache() {
     // We have signal handlers that have generated code
     // This means that we can not safely clear the code at this point in time
     // Allocate some new code buffers that we can switch over to instead
-    auto NewCodeBuffer = AllocateNewCodeBuffer(JITCore::INITIAL_CODE_SIZE);
+    auto NewCodeBuffer = AllocateNewCodeBuffer(CTX, JITCore::INITIAL_CODE_SIZE);
     EmplaceNewCodeBuffer(NewCodeBuffer);
     setNewBuffer(NewCodeBuffer.Ptr, NewCodeBuffer.Size);
   }
@@ -861,13 +923,17 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
 
   // Fairly excessive buffer range to make sure we don't overflow
   uint32_t BufferRange = SSACount * 16;
-  if ((getSize() + BufferRange) > CurrentCodeBuffer->Size) {
-    ThreadState->CTX->ClearCodeCache(ThreadState, false);
-  }
+  EnsureCodeBufferSpace(BufferRange);
 
 	void *Entry = getCurr<void*>();
   this->IR = IR;
 
+  Relocations.clear();
+  BlockEntryOffset = getSize();
+  RelocationGuestEntry = HeaderOp->Entry;
+  // The gdb checks change the shape of the block, don't let it mix with cached code
+  IsRelocatable = !CTX->GetGdbServerStatus();
+
   if (CTX->GetGdbServerStatus()) {
     Label RunBlock;
 
@@ -880,13 +946,20 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
     cmp(dword [rax + (offsetof(FEXCore::Context::Context, Config.RunningMode))], 0);
     je(RunBlock);
     // Else we need to pause now
-    mov(rax, ThreadPauseHandlerAddress);
+    MovRelocated(rax, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_PAUSE_HANDLER));
     jmp(rax);
     ud2();
 
     L(RunBlock);
   }
 
+  if (BlockEntryCounter) {
+    // Tier 0 profiling, the counter lives as long as the context
+    IsRelocatable = false;
+    mov(rax, reinterpret_cast<uint64_t>(BlockEntryCounter));
+    sub(dword [rax], 1);
+  }
+
   LogMan::Throw::A(RAData != nullptr, "Needs RA");
 
   SpillSlots = RAData->SpillSlots();
@@ -896,6 +969,8 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
   }
 
 #ifdef BLOCKSTATS
+  // Sampling data is allocated per run
+  IsRelocatable = false;
   BlockSamplingData::BlockData *SamplingData = CTX->BlockData->GetBlockData(HeaderOp->Entry);
   if (GetSamplingData) {
     mov(rcx, reinterpret_cast<uintptr_t>(SamplingData));
@@ -1024,6 +1099,77 @@ void *JITCore::CompileCode([[maybe_unused]] FEXCore::IR::IRListView const *IR, [
   return Entry;
 }
 
+void JITCore::EnsureCodeBufferSpace(size_t Size) {
+  if (CTX->SharedCache) {
+    // Only need a new region, the rest of the cache remains valid
+    if (CodeRegionEpoch != CTX->SharedCache->GetFlushEpoch() ||
+        (getSize() + Size) > CurrentCodeBuffer->Size) {
+      SwitchToNewCodeRegion(Size);
+    }
+  }
+  else if ((getSize() + Size) > CurrentCodeBuffer->Size) {
+    ThreadState->CTX->ClearCodeCache(ThreadState, false);
+  }
+}
+
+uint64_t JITCore::GetThreadPointer(RelocationThreadPointer Pointer) {
+  switch (Pointer) {
+    case RelocationThreadPointer::LOOP_TOP: return AbsoluteLoopTopAddress;
+    case RelocationThreadPointer::EXIT_FUNCTION_LINKER: return ExitFunctionLinkerAddress;
+    case RelocationThreadPointer::THREAD_PAUSE_HANDLER: return ThreadPauseHandlerAddress;
+    case RelocationThreadPointer::THREAD_STOP_HANDLER: return ThreadStopHandlerAddress;
+    case RelocationThreadPointer::SIGNAL_RETURN: return ThreadSharedData.SignalHandlerReturnAddress;
+    default:
+      LogMan::Msg::A("Unknown thread pointer: %ld", static_cast<uint64_t>(Pointer));
+      return 0;
+  }
+}
+
+uint64_t JITCore::GetRelocationValue(RelocationType Type, uint64_t Data) {
+  uint64_t Value{};
+  if (!FEXCore::CPU::ResolveRelocation(CTX, RelocationGuestEntry, Type, Data, &Value)) {
+    Value = GetThreadPointer(static_cast<RelocationThreadPointer>(Data));
+  }
+  return Value;
+}
+
+void JITCore::AddRelocation(RelocationType Type, uint64_t Data) {
+  Relocations.emplace_back(Relocation{static_cast<uint32_t>(getSize() - BlockEntryOffset), Type, RelocationEncoding::ABS64, 0, Data});
+}
+
+void JITCore::MovRelocated(Xbyak::Reg64 const &Reg, RelocationType Type, uint64_t Data) {
+  // mov r64, imm64 with REX.W, xbyak would pick a shorter encoding for small values
+  db(0x48 | (Reg.getIdx() >> 3));
+  db(0xB8 | (Reg.getIdx() & 7));
+  LiteralRelocated(Type, Data);
+}
+
+void JITCore::LiteralRelocated(RelocationType Type, uint64_t Data) {
+  AddRelocation(Type, Data);
+  dq(GetRelocationValue(Type, Data));
+}
+
+void *JITCore::RelocateJITObjectCode(uint64_t Entry, uint8_t const *Code, size_t Size, Relocation const *CodeRelocations, size_t NumRelocations) {
+  if (CTX->GetGdbServerStatus()) {
+    return nullptr;
+  }
+
+  EnsureCodeBufferSpace(Size);
+
+  // Guest RIP relative values are resolved against the entry this copy is being placed at
+  RelocationGuestEntry = Entry;
+
+  auto HostCode = getCurr<uint8_t*>();
+  memcpy(HostCode, Code, Size);
+  setSize(getSize() + Size);
+
+  for (size_t i = 0; i < NumRelocations; ++i) {
+    ApplyRelocation(HostCode, CodeRelocations[i], GetRelocationValue(CodeRelocations[i].Type, CodeRelocations[i].Data));
+  }
+
+  return HostCode;
+}
+
 static void SleepThread(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread) {
   --ctx->IdleWaitRefCount;
   ctx->IdleWaitCV.notify_all();
@@ -1036,28 +1182,44 @@ static void SleepThread(FEXCore::Context::Context *ctx, FEXCore::Core::InternalT
   ctx->IdleWaitCV.notify_all();
 }
 
-uint64_t JITCore::ExitFunctionLink(JITCore *core, FEXCore::Core::InternalThreadState *Thread, uint64_t *record) {
+uint64_t JITCore::ExitFunctionLink(FEXCore::Core::InternalThreadState *Thread, uint64_t *record) {
+  auto core = static_cast<JITCore*>(Thread->CPUBackend.get());
   auto GuestRip = record[1];
 
-  auto HostCode = Thread->LookupCache->FindBlock(GuestRip);
+  std::scoped_lock<std::recursive_mutex> lk(Thread->LookupCache->GetLock());
+
+  // Skip the L1, it can still hold retired code when the cache is shared
+  auto HostCode = Thread->LookupCache->GetBlockCache()->FindBlock(GuestRip);
 
   if (!HostCode) {
     Thread->State.State.rip = GuestRip;
     return core->AbsoluteLoopTopAddress;
   }
 
+  bool Shared = core->CTX->SharedCache != nullptr;
+  if (Shared && !core->CTX->SharedCache->IsLiveCode(reinterpret_cast<uintptr_t>(record))) {
+    // The exit is in retired code, linking it would leave a dangling link behind once it is freed
+    return HostCode;
+  }
+
+  if (Shared) {
+    // Both ends of a link are in use
+    core->CTX->SharedCache->Touch(HostCode);
+    core->CTX->SharedCache->Touch(reinterpret_cast<uintptr_t>(record));
+  }
+
   auto LinkerAddress = core->ExitFunctionLinkerAddress;
-  Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [record, LinkerAddress]{
+  Thread->LookupCache->AddBlockLink(GuestRip, (uintptr_t)record, [](uintptr_t Record, uintptr_t LinkerAddress) {
     // undo the link
-    record[0] = LinkerAddress;
-  });
+    reinterpret_cast<uint64_t*>(Record)[0] = LinkerAddress;
+  }, LinkerAddress);
 
   record[0] = HostCode;
   return HostCode;
 }
 
 void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
-  DispatcherCodeBuffer = AllocateNewCodeBuffer(MAX_DISPATCHER_CODE_SIZE);
+  DispatcherCodeBuffer = AllocateNewCodeBuffer(CTX, MAX_DISPATCHER_CODE_SIZE);
   setNewBuffer(DispatcherCodeBuffer.Ptr, DispatcherCodeBuffer.Size);
 
 // Temp registers
@@ -1119,7 +1281,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
     mov(rdx, qword [STATE + offsetof(FEXCore::Core::CPUState, rip)]);
 
     // L1 Cache
-    mov(r13, Thread->LookupCache->GetL1Pointer());
+    mov(r13, qword [STATE + offsetof(FEXCore::Core::InternalThreadState, L1Pointer)]);
     mov(rax, rdx);
 
     and_(rax, LookupCache::L1_ENTRIES_MASK);
@@ -1160,7 +1322,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
     je(NoBlock);
 
     // Update L1
-    mov(r13, Thread->LookupCache->GetL1Pointer());
+    mov(r13, qword [STATE + offsetof(FEXCore::Core::InternalThreadState, L1Pointer)]);
     mov(rcx, rdx);
     and_(rcx, LookupCache::L1_ENTRIES_MASK);
     shl(rcx, 1);
@@ -1188,10 +1350,9 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
 
   {
     ExitFunctionLinkerAddress = getCurr<uint64_t>();
-    // {rdi, rsi, rdx}
-    mov(rdi, (uintptr_t)this);
-    mov(rsi, STATE);
-    mov(rdx, rax); // rax is set at the block end
+    // {rdi, rsi}
+    mov(rdi, STATE);
+    mov(rsi, rax); // rax is set at the block end
 
     mov(rax, (uintptr_t)&ExitFunctionLink);
     call(rax);
@@ -1269,8 +1430,7 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
     // XXX: XMM?
 
     // Make sure to adjust the refcounter so we don't clear the cache now
-    mov(rax, reinterpret_cast<uint64_t>(&SignalHandlerRefCounter));
-    add(dword [rax], 1);
+    add(dword [STATE + offsetof(FEXCore::Core::InternalThreadState, SignalHandlerRefCounter)], 1);
 
     // Now push the callback return trampoline to the guest stack
     // Guest will be misaligned because calling a thunk won't correct the guest's stack once we call the callback from the host
@@ -1300,6 +1460,13 @@ void JITCore::CreateCustomDispatch(FEXCore::Core::InternalThreadState *Thread) {
 }
 
 FEXCore::CPU::CPUBackend *CreateJITCore(FEXCore::Context::Context *ctx, FEXCore::Core::InternalThreadState *Thread, bool CompileThread) {
-  return new JITCore(ctx, Thread, AllocateNewCodeBuffer(CompileThread ? JITCore::MAX_CODE_SIZE : JITCore::INITIAL_CODE_SIZE), CompileThread);
+  if (ctx->SharedCache) {
+    auto Region = ctx->SharedCache->AllocateRegion(SharedCodeCache::REGION_SIZE);
+    auto Core = new JITCore(ctx, Thread, CodeBuffer{Region.Ptr, Region.Size}, CompileThread);
+    Core->CodeRegionEpoch = Region.Epoch;
+    return Core;
+  }
+
+  return new JITCore(ctx, Thread, AllocateNewCodeBuffer(ctx, CompileThread ? JITCore::MAX_CODE_SIZE : JITCore::INITIAL_CODE_SIZE), CompileThread);
 }
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Interface/Core/AOTCodeCache.h"
 #include "Interface/Core/LookupCache.h"
 #include "Interface/Core/BlockSamplingData.h"
 
@@ -24,8 +25,8 @@ struct CodeBuffer {
   size_t Size;
 };
 
-CodeBuffer AllocateNewCodeBuffer(size_t Size);
-void FreeCodeBuffer(CodeBuffer Buffer);
+CodeBuffer AllocateNewCodeBuffer(FEXCore::Context::Context *CTX, size_t Size);
+void FreeCodeBuffer(FEXCore::Context::Context *CTX, CodeBuffer Buffer);
 
 }
 
@@ -75,6 +76,9 @@ public:
   bool HandleGuestSignal(int Signal, void *info, void *ucontext, GuestSigAction *GuestAction, stack_t *GuestStack);
   void CopyNecessaryDataForCompileThread(CPUBackend *Original) override;
 
+  std::vector<Relocation> const *GetRelocations() override { return IsRelocatable ? &Relocations : nullptr; }
+  void *RelocateJITObjectCode(uint64_t Entry, uint8_t const *Code, size_t Size, Relocation const *CodeRelocations, size_t NumRelocations) override;
+
 private:
   Label* PendingTargetLabel{};
   FEXCore::Context::Context *CTX;
@@ -123,7 +127,7 @@ private:
   Xbyak::Xmm GetSrc(uint32_t Node);
   Xbyak::Xmm GetDst(uint32_t Node);
 
-  Xbyak::RegExp GenerateModRM(Xbyak::Reg Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale);
+  Xbyak::RegExp GenerateModRM(Xbyak::Reg Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale, int32_t OffsetDisp);
 
   bool IsInlineConstant(const IR::OrderedNodeWrapper& Node, uint64_t* Value = nullptr);
   bool IsInlineEntrypointOffset(const IR::OrderedNodeWrapper& WNode, uint64_t* Value);
@@ -142,7 +146,18 @@ private:
     CurrentCodeBuffer = &CodeBuffers.emplace_back(Buffer);
   }
 
-  static uint64_t ExitFunctionLink(JITCore* code, FEXCore::Core::InternalThreadState *Thread, uint64_t *record);
+  static uint64_t ExitFunctionLink(FEXCore::Core::InternalThreadState *Thread, uint64_t *record);
+
+  /**
+   * @name Shared code cache
+   * @{ */
+  // Picks up the dispatcher that another thread generated
+  void CopyDispatcher(JITCore *Owner);
+  // Moves code emission to a fresh region of the shared code cache
+  void SwitchToNewCodeRegion(size_t MinSize);
+  bool OwnsDispatcher{true};
+  uint64_t CodeRegionEpoch{};
+  /**  @} */
 
   // This is the initial code buffer that we will fall back to
   // In a program without signals and code clearing, we will typically
@@ -165,8 +180,6 @@ private:
 
   uint64_t PauseReturnInstruction{};
 
-  uint32_t SignalHandlerRefCounter{};
-
   struct CompilerSharedData {
     uint64_t SignalHandlerReturnAddress{};
 
@@ -175,6 +188,26 @@ private:
 
   CompilerSharedData ThreadSharedData;
 
+  /**
+   * @name Relocatable code
+   * @{ */
+  // Makes sure there is room for Size bytes of code before emitting a block
+  void EnsureCodeBufferSpace(size_t Size);
+  uint64_t GetThreadPointer(RelocationThreadPointer Pointer);
+  uint64_t GetRelocationValue(RelocationType Type, uint64_t Data);
+  // Emits an imm64 move that always has the full size encoding so it can be patched
+  void MovRelocated(Xbyak::Reg64 const &Reg, RelocationType Type, uint64_t Data);
+  // Emits a 64bit literal that can be patched
+  void LiteralRelocated(RelocationType Type, uint64_t Data);
+  void AddRelocation(RelocationType Type, uint64_t Data);
+
+  std::vector<Relocation> Relocations;
+  // Cleared by anything that bakes in a pointer we can't describe with a relocation
+  bool IsRelocatable{};
+  size_t BlockEntryOffset{};
+  uint64_t RelocationGuestEntry{};
+  /**  @} */
+
   void StoreThreadState(int Signal, void *ucontext);
   void RestoreThreadState(void *ucontext);
   std::stack<uint64_t> SignalFrames;
@@ -200,6 +233,17 @@ private:
 
   void PushRegs();
   void PopRegs();
+
+  /**
+   * @name Block exits
+   * @{ */
+  // Exit that the linker patches to jump straight to the block at NewRIP, GuestRIPLabel is bound to its guest RIP literal
+  void EmitLinkableExit(uint64_t NewRIP, bool IsConstant, Xbyak::Label &GuestRIPLabel);
+  // Exit to a dynamic RIP through the L1 cache, falling back to the dispatcher
+  void EmitLookupExit(Xbyak::Reg RipReg);
+  // Pushes the return address of a call along with a linkable exit to it for GuestReturn to take
+  void PushReturnStack(IR::OrderedNodeWrapper NextRIP);
+  /**  @} */
 #define DEF_OP(x) void Op_##x(FEXCore::IR::IROp_Header *IROp, uint32_t Node)
 
   ///< Unhandled handler
@@ -288,6 +332,7 @@ private:
   DEF_OP(ValidateCode);
   DEF_OP(RemoveCodeEntry);
   DEF_OP(CPUID);
+  DEF_OP(CalculateDeferredFlags);
 
   ///< Conversion ops
   DEF_OP(VInsGPR);
@@ -419,7 +419,7 @@ DEF_OP(StoreFlag) {
   mov(byte [STATE + (offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag)], al);
 }
 
-Xbyak::RegExp JITCore::GenerateModRM(Xbyak::Reg Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale) {
+Xbyak::RegExp JITCore::GenerateModRM(Xbyak::Reg Base, IR::OrderedNodeWrapper Offset, IR::MemOffsetType OffsetType, uint8_t OffsetScale, int32_t OffsetDisp) {
   if (Offset.IsInvalid()) {
     return Base;
   } else {
@@ -433,11 +433,12 @@ Xbyak::RegExp JITCore::GenerateModRM(Xbyak::Reg Base, IR::OrderedNodeWrapper Off
 
     uint64_t Const;
     if (IsInlineConstant(Offset, &Const)) {
-      return Base + Const;
+      return Base + (Const + OffsetDisp);
     } else {
       auto MemOffset = GetSrc<RA_64>(Offset.ID());
 
-      return Base + MemOffset * OffsetScale;
+      // Full SIB form, [Base + Index * Scale + Disp32]
+      return Base + MemOffset * OffsetScale + OffsetDisp;
     }
   }
 }
@@ -447,7 +448,7 @@ DEF_OP(LoadMem) {
 
   Xbyak::Reg MemReg = GetSrc<RA_64>(Op->Addr.ID());
 
-  auto MemPtr = GenerateModRM(MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale);
+  auto MemPtr = GenerateModRM(MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale, Op->OffsetDisp);
 
   if (Op->Class.Val == 0) {
     auto Dst = GetDst<RA_64>(Node);
@@ -515,7 +516,7 @@ DEF_OP(StoreMem) {
 
   Xbyak::Reg MemReg = GetSrc<RA_64>(Op->Addr.ID());
 
-  auto MemPtr = GenerateModRM(MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale);
+  auto MemPtr = GenerateModRM(MemReg, Op->Offset, Op->OffsetType, Op->OffsetScale, Op->OffsetDisp);
 
   if (Op->Class.Val == 0) {
     switch (Op->Size) {
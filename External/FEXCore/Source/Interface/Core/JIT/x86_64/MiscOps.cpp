@@ -37,7 +37,7 @@ DEF_OP(Break) {
       mov(rsp, qword [STATE + offsetof(FEXCore::Core::ThreadState, ReturningStackLocation)]);
 
       // Now we need to jump to the thread stop handler
-      mov(TMP1, ThreadStopHandlerAddress);
+      MovRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_STOP_HANDLER));
       jmp(TMP1);
       break;
     }
@@ -50,7 +50,7 @@ DEF_OP(Break) {
         }
         
         // This jump target needs to be a constant offset here
-        mov(TMP1, ThreadPauseHandlerAddress);
+        MovRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_PAUSE_HANDLER));
         jmp(TMP1);
       }
       else {
@@ -59,7 +59,7 @@ DEF_OP(Break) {
         mov(rsp, qword [STATE + offsetof(FEXCore::Core::ThreadState, ReturningStackLocation)]);
 
         // Now we need to jump to the thread stop handler
-        mov(TMP1, ThreadStopHandlerAddress);
+        MovRelocated(TMP1, RelocationType::THREAD_POINTER, static_cast<uint64_t>(RelocationThreadPointer::THREAD_STOP_HANDLER));
         jmp(TMP1);
       }
     break;
@@ -113,7 +113,7 @@ DEF_OP(Print) {
 
   mov (rdi, GetSrc<RA_64>(Op->Header.Args[0].ID()));
 
-  mov(rax, reinterpret_cast<uintptr_t>(PrintValue));
+  MovRelocated(rax, RelocationType::HOST_IMAGE, GetHostImageOffset(reinterpret_cast<void*>(PrintValue)));
 
   call(rax);
 
@@ -1,10 +1,11 @@
 #include "Interface/Context/Context.h"
 #include "Interface/Core/Core.h"
+#include "Interface/Core/HostMemory.h"
 #include "Interface/Core/LookupCache.h"
 #include <sys/mman.h>
 
 namespace FEXCore {
-LookupCache::LookupCache(FEXCore::Context::Context *CTX)
+BlockCache::BlockCache(FEXCore::Context::Context *CTX)
   : ctx {CTX} {
 
   // Block cache ends up looking like this
@@ -26,23 +27,25 @@ LookupCache::LookupCache(FEXCore::Context::Context *CTX)
   // XXX: We can drop down to 16KB if we store 4byte offsets from the code base
   // We currently limit to 128MB of real memory for caching for the total cache size.
   // Can end up being inefficient if we compile a small number of blocks per page
-  PageMemory = reinterpret_cast<uintptr_t>(mmap(nullptr, CODE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
-  LogMan::Throw::A(PageMemory != -1ULL, "Failed to allocate page memory");
-
-  // L1 Cache
-  L1Pointer = reinterpret_cast<uintptr_t>(mmap(nullptr, L1_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
-  LogMan::Throw::A(L1Pointer != -1ULL, "Failed to allocate L1Pointer");
+  PageMemory = reinterpret_cast<uintptr_t>(HostMemory::Allocate(CODE_SIZE, PROT_READ | PROT_WRITE, GetMemoryPolicy()));
+  LogMan::Throw::A(PageMemory != 0, "Failed to allocate page memory");
 
   VirtualMemSize = ctx->Config.VirtualMemSize;
 }
 
-LookupCache::~LookupCache() {
+BlockCache::~BlockCache() {
   munmap(reinterpret_cast<void*>(PagePointer), ctx->Config.VirtualMemSize / 4096 * 8);
-  munmap(reinterpret_cast<void*>(PageMemory), CODE_SIZE);
-  munmap(reinterpret_cast<void*>(L1Pointer), L1_SIZE);
+  HostMemory::Free(reinterpret_cast<void*>(PageMemory), CODE_SIZE, GetMemoryPolicy());
 }
 
-void LookupCache::HintUsedRange(uint64_t Address, uint64_t Size) {
+HostMemory::Policy BlockCache::GetMemoryPolicy() const {
+  auto Policy = HostMemory::GetPolicy(ctx);
+  // Every thread walks a shared cache, there is no local node for it
+  Policy.NUMALocal &= !ctx->Config.SharedCodeCache;
+  return Policy;
+}
+
+void BlockCache::HintUsedRange(uint64_t Address, uint64_t Size) {
   // Tell the kernel we will definitely need [Address, Address+Size) mapped for the page pointer
   // Page Pointer is allocated per page, so shift by page size
   Address >>= 12;
@@ -50,23 +53,108 @@ void LookupCache::HintUsedRange(uint64_t Address, uint64_t Size) {
   madvise(reinterpret_cast<void*>(PagePointer + Address), Size, MADV_WILLNEED);
 }
 
-void LookupCache::ClearL2Cache() {
+void BlockCache::ClearL2Cache() {
   // Clear out the page memory
   madvise(reinterpret_cast<void*>(PagePointer), ctx->Config.VirtualMemSize / 4096 * 8, MADV_DONTNEED);
-  madvise(reinterpret_cast<void*>(PageMemory), CODE_SIZE, MADV_DONTNEED);
+  HostMemory::Discard(reinterpret_cast<void*>(PageMemory), CODE_SIZE);
   AllocateOffset = 0;
 }
 
-void LookupCache::ClearCache() {
-  // Clear L1
-  madvise(reinterpret_cast<void*>(L1Pointer), L1_SIZE, MADV_DONTNEED);
+void BlockCache::ClearCache() {
   // Clear L2
   ClearL2Cache();
   // All code is gone, remove links
-  BlockLinks.clear();
+  Links.clear();
+  FreeLink = INVALID_LINK;
+  LinkHeads.Clear();
   // All code is gone, clear the block list
-  BlockList.clear();
+  BlockList.Clear();
+}
+
+size_t BlockCache::EraseHostRange(uintptr_t Begin, uintptr_t End) {
+  auto InRange = [Begin, End](uintptr_t HostCode) {
+    return HostCode >= Begin && HostCode < End;
+  };
+
+  // Collect first, erasing shuffles the table around
+  std::vector<uint64_t> Evicted;
+  BlockList.ForEach([&](uint64_t Address, uintptr_t HostCode) {
+    if (InRange(HostCode)) {
+      Evicted.emplace_back(Address);
+    }
+  });
+
+  for (auto Address : Evicted) {
+    Erase(Address);
+  }
+
+  // Drop the links that were patched in to the range
+  // Undoing them later would write to whatever reuses the memory
+  std::vector<uint64_t> Destinations;
+  LinkHeads.ForEach([&](uint64_t Destination, uintptr_t) {
+    Destinations.emplace_back(Destination);
+  });
+
+  for (auto Destination : Destinations) {
+    uint32_t Head = LinkHeads.Find(Destination) - 1;
+    uint32_t NewHead = INVALID_LINK;
+    uint32_t *Prev = &NewHead;
+
+    for (uint32_t Index = Head; Index != INVALID_LINK;) {
+      auto &Link = Links[Index];
+      uint32_t Next = Link.Next;
+      if (InRange(Link.HostLink)) {
+        Link.Next = FreeLink;
+        FreeLink = Index;
+      }
+      else {
+        *Prev = Index;
+        Prev = &Link.Next;
+      }
+      Index = Next;
+    }
+    *Prev = INVALID_LINK;
+
+    if (NewHead == INVALID_LINK) {
+      LinkHeads.Erase(Destination);
+    }
+    else if (NewHead != Head) {
+      LinkHeads.Set(Destination, NewHead + 1);
+    }
+  }
+
+  return Evicted.size();
+}
+
+LookupCache::LookupCache(FEXCore::Context::Context *CTX, std::shared_ptr<BlockCache> SharedBlocks)
+  : Blocks {SharedBlocks ? std::move(SharedBlocks) : std::make_shared<BlockCache>(CTX)}
+  , ctx {CTX} {
+  // L1 Cache
+  L1Pointer = reinterpret_cast<uintptr_t>(HostMemory::Allocate(L1_SIZE, PROT_READ | PROT_WRITE, HostMemory::GetPolicy(ctx)));
+  LogMan::Throw::A(L1Pointer != 0, "Failed to allocate L1Pointer");
+
+  std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+  Blocks->AttachL1(L1Pointer);
+}
+
+LookupCache::~LookupCache() {
+  {
+    std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+    Blocks->DetachL1(L1Pointer);
+  }
+  HostMemory::Free(reinterpret_cast<void*>(L1Pointer), L1_SIZE, HostMemory::GetPolicy(ctx));
 }
 
+void LookupCache::ClearL1Cache() {
+  HostMemory::Discard(reinterpret_cast<void*>(L1Pointer), L1_SIZE);
 }
 
+void LookupCache::ClearCache() {
+  // Clear L1
+  ClearL1Cache();
+  // Clear L2 and the block list
+  std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+  Blocks->ClearCache();
+}
+
+}
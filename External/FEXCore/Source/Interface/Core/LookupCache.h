@@ -1,94 +1,229 @@
 #pragma once
 #include "Interface/Context/Context.h"
+#include "Interface/Core/BlockTable.h"
+#include "Interface/Core/HostMemory.h"
 #include <FEXCore/Utils/LogManager.h>
 
-#include <map>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 namespace FEXCore {
-class LookupCache {
-public:
-
-  struct LookupCacheEntry { 
-    uintptr_t HostCode;
-    uintptr_t GuestCode;
-  };
 
-  LookupCache(FEXCore::Context::Context *CTX);
-  ~LookupCache();
-
-  using LookupCacheIter = uintptr_t;
-  uintptr_t End() { return 0; }
+struct LookupCacheEntry {
+  uintptr_t HostCode;
+  uintptr_t GuestCode;
+};
 
+/**
+ * @brief Undoes a block link
+ *
+ * Plain function pointer plus one argument so links don't need a heap allocation each
+ *
+ * @param HostLink The link site that was patched
+ * @param Arg Whatever the backend needs to restore the link site, usually the linker address
+ */
+using BlockDelinkerFunc = void(*)(uintptr_t HostLink, uintptr_t Arg);
+
+/**
+ * @brief Guest to host block mapping without the per-thread L1
+ *
+ * Owns the L2 page tables, the full block list and the block links.
+ * A BlockCache is either private to a single LookupCache or shared between every thread of the context
+ * when the shared code cache is enabled.
+ *
+ * Mutations must happen with GetLock() held when the cache is shared.
+ * The L2 tables and the block table are read without a lock. Entries are published HostCode first and
+ * invalidated GuestCode first so a racing reader only ever sees a miss.
+ */
+class BlockCache {
+public:
+  BlockCache(FEXCore::Context::Context *CTX);
+  ~BlockCache();
+
+  /**
+   * @brief Finds a block and fills the L2 on a hit
+   *
+   * Must be called with the lock held when the cache is shared
+   */
   uintptr_t FindBlock(uint64_t Address) {
     auto HostCode = FindCodePointerForAddress(Address);
     if (HostCode) {
       return HostCode;
     } else {
-      auto HostCode = BlockList.find(Address);
+      auto HostCode = BlockList.Find(Address);
 
-      if (HostCode != BlockList.end()) {
-        CacheBlockMapping(Address, HostCode->second);
-        return HostCode->second;
-      } else {
-        return 0;
+      if (HostCode) {
+        CacheBlockMapping(Address, HostCode);
       }
+      return HostCode;
+    }
+  }
+
+  /**
+   * @brief Finds a block without taking the lock or touching the L2
+   *
+   * A miss can be spurious if a writer is racing, retry with FindBlock under the lock
+   */
+  uintptr_t FindBlockLockless(uint64_t Address) const {
+    auto HostCode = FindCodePointerForAddress(Address);
+    if (HostCode) {
+      return HostCode;
     }
+    return BlockList.Find(Address);
   }
 
-  void AddBlockMapping(uint64_t Address, void *HostCode) { 
-    auto InsertPoint = BlockList.emplace(Address, (uintptr_t)HostCode);
-    LogMan::Throw::A(InsertPoint.second == true, "Dupplicate block mapping added");
+  /**
+   * @brief Adds a new guest block mapping
+   *
+   * @param AllowExisting If another thread won the race to compile this block then keep the existing mapping
+   *
+   * @return The host code that ends up being mapped for Address
+   */
+  uintptr_t AddBlockMapping(uint64_t Address, uintptr_t HostCode, bool AllowExisting) {
+    auto MappedCode = BlockList.Insert(Address, HostCode);
+    if (MappedCode != HostCode) {
+      LogMan::Throw::A(AllowExisting, "Dupplicate block mapping added");
+      return MappedCode;
+    }
 
     // no need to update L1 or L2, they will get updated on first lookup
+    return HostCode;
   }
 
   void Erase(uint64_t Address) {
-
     // Sever any links to this block
-    auto lower = BlockLinks.lower_bound({Address, 0});
-    auto upper = BlockLinks.upper_bound({Address, UINTPTR_MAX});
-    for (auto it = lower; it != upper; it = BlockLinks.erase(it)) {
-      it->second();
+    if (auto Head = LinkHeads.Find(Address)) {
+      LinkHeads.Erase(Address);
+      for (uint32_t Index = Head - 1; Index != INVALID_LINK;) {
+        auto &Link = Links[Index];
+        Link.Delinker(Link.HostLink, Link.Arg);
+
+        uint32_t Next = Link.Next;
+        Link.Next = FreeLink;
+        FreeLink = Index;
+        Index = Next;
+      }
     }
 
     // Remove from BlockList
-    BlockList.erase(Address);
+    BlockList.Erase(Address);
 
-    // Do L1
-    auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1Pointer)[Address & L1_ENTRIES_MASK];
-    if (L1Entry.GuestCode == Address) {
-      L1Entry.GuestCode = L1Entry.HostCode = 0;
-    }
+    EvictFromLookup(Address);
+  }
 
+  /**
+   * @brief Drops Address from the L2 and every attached L1, leaving the block list and the links alone
+   *
+   * Only the guest side of the entries is cleared, so the owner of a private cache can keep running while another
+   * thread does this. Its next lookup of Address misses and goes through CompileBlock.
+   */
+  void EvictFromLookup(uint64_t Address) {
     // Do full map
+    auto FullAddress = Address;
     Address = Address & (VirtualMemSize -1);
     uint64_t PageOffset = Address & (0x0FFF);
     Address >>= 12;
 
     uintptr_t *Pointers = reinterpret_cast<uintptr_t*>(PagePointer);
-    uint64_t LocalPagePointer = Pointers[Address];
-    if (!LocalPagePointer) {
-      // Page for this code didn't even exist, nothing to do
-      return;
+    uint64_t LocalPagePointer = __atomic_load_n(&Pointers[Address], __ATOMIC_ACQUIRE);
+    if (LocalPagePointer) {
+      // Page exists, just clear the guest side, a racing lookup only ever sees a miss
+      auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
+      if (__atomic_load_n(&BlockPointers[PageOffset].GuestCode, __ATOMIC_RELAXED) == FullAddress) {
+        __atomic_store_n(&BlockPointers[PageOffset].GuestCode, 0, __ATOMIC_RELEASE);
+      }
     }
 
-    // Page exists, just set the offset to zero
-    auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
-    BlockPointers[PageOffset].GuestCode = 0;
-    BlockPointers[PageOffset].HostCode = 0;
+    // Pairs with the fence in LookupCache::FindBlock
+    // Either we see the L1 entry it just filled or it sees that the block is gone
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    // Do every L1 that can see this cache
+    // Only the guest side is cleared since the owning thread may be racing to refill its entry
+    for (auto L1 : AttachedL1) {
+      auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1)[FullAddress & L1_ENTRIES_MASK];
+      if (__atomic_load_n(&L1Entry.GuestCode, __ATOMIC_RELAXED) == FullAddress) {
+        __atomic_store_n(&L1Entry.GuestCode, 0, __ATOMIC_RELEASE);
+      }
+    }
   }
 
+  void AddBlockLink(uint64_t GuestDestination, uintptr_t HostLink, BlockDelinkerFunc Delinker, uintptr_t Arg) {
+    auto Head = LinkHeads.Find(GuestDestination);
+    uint32_t HeadIndex = Head ? Head - 1 : INVALID_LINK;
+
+    // Chains are short, a link site only needs to be tracked once per destination
+    for (uint32_t Index = HeadIndex; Index != INVALID_LINK; Index = Links[Index].Next) {
+      if (Links[Index].HostLink == HostLink) {
+        return;
+      }
+    }
 
-  void AddBlockLink(uint64_t GuestDestination, uintptr_t HostLink, const std::function<void()> &delinker) {
-    BlockLinks.insert({{GuestDestination, HostLink}, delinker});
+    uint32_t NewLink;
+    if (FreeLink != INVALID_LINK) {
+      NewLink = FreeLink;
+      FreeLink = Links[NewLink].Next;
+    } else {
+      NewLink = Links.size();
+      Links.emplace_back();
+    }
+
+    Links[NewLink] = {HostLink, Delinker, Arg, HeadIndex};
+    // Head is stored biased by one since 0 means missing in the table
+    LinkHeads.Set(GuestDestination, NewLink + 1);
   }
 
   void ClearCache();
   void ClearL2Cache();
 
+  /**
+   * @brief Erases every block whose host code is in [Begin, End) and every link site in that range
+   *
+   * Links into the erased blocks are undone. Links out of them are dropped without being touched,
+   * the memory is about to be released.
+   *
+   * @return Number of blocks that were erased
+   */
+  size_t EraseHostRange(uintptr_t Begin, uintptr_t End);
+
   void HintUsedRange(uint64_t Address, uint64_t Size);
 
-  uintptr_t GetL1Pointer() { return L1Pointer; }
+  /**
+   * @name L1 registration
+   * @brief Tracks the L1 caches that sit in front of this cache so Erase can reach all of them
+   * @{ */
+  void AttachL1(uintptr_t L1) {
+    AttachedL1.emplace_back(L1);
+  }
+  void DetachL1(uintptr_t L1) {
+    AttachedL1.erase(std::remove(AttachedL1.begin(), AttachedL1.end(), L1), AttachedL1.end());
+  }
+
+  /**
+   * @brief Hands the host code of every entry in the attached L1s to Func and drops the entries
+   *
+   * Must be called with the lock held. An L1 then only holds what its thread dispatched to since the last drain,
+   * the dispatcher fills blocks that keep running back in from the L2.
+   */
+  template<typename F>
+  void DrainL1(F &&Func) {
+    for (auto L1 : AttachedL1) {
+      auto Entries = reinterpret_cast<LookupCacheEntry*>(L1);
+      for (size_t i = 0; i < L1_ENTRIES; ++i) {
+        if (__atomic_load_n(&Entries[i].GuestCode, __ATOMIC_ACQUIRE)) {
+          Func(__atomic_load_n(&Entries[i].HostCode, __ATOMIC_RELAXED));
+          // Same as EvictFromLookup, the owning thread may be racing to refill it
+          __atomic_store_n(&Entries[i].GuestCode, 0, __ATOMIC_RELEASE);
+        }
+      }
+    }
+  }
+  /**  @} */
+
+  std::recursive_mutex &GetLock() { return BlockCacheMutex; }
+
   uintptr_t GetPagePointer() { return PagePointer; }
   uintptr_t GetVirtualMemorySize() const { return VirtualMemSize; }
 
@@ -96,13 +231,7 @@ public:
   constexpr static size_t L1_ENTRIES_MASK = L1_ENTRIES - 1;
 
 private:
-  void CacheBlockMapping(uint64_t Address, uintptr_t HostCode) { 
-    // Do L1
-    auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1Pointer)[Address & L1_ENTRIES_MASK];
-    if (L1Entry.GuestCode == Address) {
-      L1Entry.GuestCode = L1Entry.HostCode = 0;
-    }
-
+  void CacheBlockMapping(uint64_t Address, uintptr_t HostCode) {
     // Do ful map
     auto FullAddress = Address;
     Address = Address & (VirtualMemSize -1);
@@ -118,10 +247,10 @@ private:
       if (!NewPageBacking) {
         // Couldn't allocate, clear L2 and retry
         ClearL2Cache();
-        CacheBlockMapping(Address, HostCode);
+        CacheBlockMapping(FullAddress, HostCode);
         return;
       }
-      Pointers[Address] = NewPageBacking;
+      __atomic_store_n(&Pointers[Address], NewPageBacking, __ATOMIC_RELEASE);
       LocalPagePointer = NewPageBacking;
     }
 
@@ -129,10 +258,12 @@ private:
     auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
 
     // This silently replaces existing mappings
-    BlockPointers[PageOffset].GuestCode = FullAddress;
     BlockPointers[PageOffset].HostCode = HostCode;
+    __atomic_store_n(&BlockPointers[PageOffset].GuestCode, FullAddress, __ATOMIC_RELEASE);
   }
 
+  HostMemory::Policy GetMemoryPolicy() const;
+
   uintptr_t AllocateBackingForPage() {
     uintptr_t NewBase = AllocateOffset;
     uintptr_t NewEnd = AllocateOffset + SIZE_PER_PAGE;
@@ -147,14 +278,7 @@ private:
     return PageMemory + NewBase;
   }
 
-  uintptr_t FindCodePointerForAddress(uint64_t Address) {
-    
-    // Do L1
-    auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1Pointer)[Address & L1_ENTRIES_MASK];
-    if (L1Entry.GuestCode == Address) {
-      return L1Entry.HostCode;
-    }
-
+  uintptr_t FindCodePointerForAddress(uint64_t Address) const {
     auto FullAddress = Address;
     Address = Address & (VirtualMemSize -1);
 
@@ -170,43 +294,142 @@ private:
     // Find there pointer for the address in the blocks
     auto BlockPointers = reinterpret_cast<LookupCacheEntry*>(LocalPagePointer);
 
-    if (BlockPointers[PageOffset].GuestCode == FullAddress)
-    {
-      L1Entry.GuestCode = FullAddress;
-      return L1Entry.HostCode = BlockPointers[PageOffset].HostCode;
-    }
+    if (__atomic_load_n(&BlockPointers[PageOffset].GuestCode, __ATOMIC_ACQUIRE) == FullAddress)
+      return BlockPointers[PageOffset].HostCode;
     else
       return 0;
   }
 
   uintptr_t PagePointer;
   uintptr_t PageMemory;
-  uintptr_t L1Pointer;
 
-  struct BlockLinkTag {
-    uint64_t GuestDestination;
+  struct BlockLink {
     uintptr_t HostLink;
-
-    bool operator <(const BlockLinkTag& other) const {
-      if (GuestDestination < other.GuestDestination)
-        return true;
-      else if (GuestDestination == other.GuestDestination)
-        return HostLink < other.HostLink;
-      else
-        return false;
-    }
+    BlockDelinkerFunc Delinker;
+    uintptr_t Arg;
+    uint32_t Next;
   };
 
-  std::map<BlockLinkTag, std::function<void()>> BlockLinks;
-  std::map<uint64_t, uint64_t> BlockList;
+  constexpr static uint32_t INVALID_LINK = ~0U;
+
+  // Links are pooled and chained per guest destination, LinkHeads holds the first link index + 1
+  std::vector<BlockLink> Links;
+  uint32_t FreeLink {INVALID_LINK};
+  BlockTable LinkHeads;
+  BlockTable BlockList;
+  std::vector<uintptr_t> AttachedL1;
+  std::recursive_mutex BlockCacheMutex;
 
   constexpr static size_t CODE_SIZE = 128 * 1024 * 1024;
   constexpr static size_t SIZE_PER_PAGE = 4096 * sizeof(LookupCacheEntry);
-  constexpr static size_t L1_SIZE = L1_ENTRIES * sizeof(LookupCacheEntry);
 
   size_t AllocateOffset {};
 
   FEXCore::Context::Context *ctx;
   uint64_t VirtualMemSize{};
 };
+
+/**
+ * @brief Per-thread guest to host lookup
+ *
+ * A direct mapped L1 that is private to the thread, in front of a BlockCache that may be shared.
+ */
+class LookupCache {
+public:
+  using LookupCacheEntry = FEXCore::LookupCacheEntry;
+
+  LookupCache(FEXCore::Context::Context *CTX, std::shared_ptr<BlockCache> SharedBlocks = {});
+  ~LookupCache();
+
+  using LookupCacheIter = uintptr_t;
+  uintptr_t End() { return 0; }
+
+  uintptr_t FindBlock(uint64_t Address) {
+    // Do L1
+    auto &L1Entry = reinterpret_cast<LookupCacheEntry*>(L1Pointer)[Address & L1_ENTRIES_MASK];
+    if (L1Entry.GuestCode == Address) {
+      return L1Entry.HostCode;
+    }
+
+    // Hits don't need the lock
+    // Only fill the L2 when nobody else is holding the lock, the dispatcher will find it in the L1 anyway
+    auto HostCode = Blocks->FindBlockLockless(Address);
+    if (HostCode) {
+      if (Blocks->GetLock().try_lock()) {
+        HostCode = Blocks->FindBlock(Address);
+        Blocks->GetLock().unlock();
+      }
+    } else {
+      // Misses are only authoritative under the lock
+      std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+      HostCode = Blocks->FindBlock(Address);
+    }
+
+    if (HostCode) {
+      L1Entry.HostCode = HostCode;
+      __atomic_store_n(&L1Entry.GuestCode, Address, __ATOMIC_RELEASE);
+
+      // Pairs with the fence in BlockCache::Erase
+      // The block can have been erased after we found it, don't leave it behind in the L1
+      __atomic_thread_fence(__ATOMIC_SEQ_CST);
+      if (Blocks->FindBlockLockless(Address) != HostCode) {
+        __atomic_store_n(&L1Entry.GuestCode, 0, __ATOMIC_RELAXED);
+      }
+    }
+    return HostCode;
+  }
+
+  void AddBlockMapping(uint64_t Address, void *HostCode) {
+    std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+    Blocks->AddBlockMapping(Address, reinterpret_cast<uintptr_t>(HostCode), false);
+  }
+
+  void Erase(uint64_t Address) {
+    std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+    // Our L1 is attached to the BlockCache, which clears it the same way as every other L1
+    // Another thread can be the caller here so it must never touch the HostCode under the dispatcher
+    Blocks->Erase(Address);
+  }
+
+  void EvictFromLookup(uint64_t Address) {
+    std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+    Blocks->EvictFromLookup(Address);
+  }
+
+  void AddBlockLink(uint64_t GuestDestination, uintptr_t HostLink, BlockDelinkerFunc Delinker, uintptr_t Arg) {
+    std::scoped_lock<std::recursive_mutex> lk(Blocks->GetLock());
+    Blocks->AddBlockLink(GuestDestination, HostLink, Delinker, Arg);
+  }
+
+  void ClearCache();
+  void ClearL1Cache();
+  void ClearL2Cache() { Blocks->ClearL2Cache(); }
+
+  void HintUsedRange(uint64_t Address, uint64_t Size) { Blocks->HintUsedRange(Address, Size); }
+
+  BlockCache *GetBlockCache() { return Blocks.get(); }
+  std::recursive_mutex &GetLock() { return Blocks->GetLock(); }
+
+  uintptr_t GetL1Pointer() { return L1Pointer; }
+  uintptr_t GetPagePointer() { return Blocks->GetPagePointer(); }
+  uintptr_t GetVirtualMemorySize() const { return Blocks->GetVirtualMemorySize(); }
+
+  constexpr static size_t L1_ENTRIES = BlockCache::L1_ENTRIES;
+  constexpr static size_t L1_ENTRIES_MASK = BlockCache::L1_ENTRIES_MASK;
+
+  /**
+   * @name Shared code cache epochs this thread has observed
+   * @brief Only meaningful when the BlockCache is shared
+   * @{ */
+  uint64_t SeenEpoch{};
+  uint64_t SeenFlushEpoch{};
+  /**  @} */
+
+private:
+  uintptr_t L1Pointer;
+  std::shared_ptr<BlockCache> Blocks;
+  FEXCore::Context::Context *ctx;
+
+  constexpr static size_t L1_SIZE = L1_ENTRIES * sizeof(LookupCacheEntry);
+};
 }
@@ -167,8 +167,8 @@ void OpDispatchBuilder::RETOp(OpcodeArgs) {
   // Store the new stack pointer
   _StoreContext(GPRClass, GPRSize, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSP]), NewSP);
 
-  // Store the new RIP
-  _ExitFunction(NewRIP);
+  // Store the new RIP, through the return stack if it was predicted
+  _GuestReturn(NewRIP);
   BlockSetRIP = true;
 }
 
@@ -300,6 +300,7 @@ void OpDispatchBuilder::SecondaryALUOp(OpcodeArgs) {
     break;
     case FEXCore::IR::IROps::OP_SUB:
       GenerateFlags_SUB(Op, Result, Dest, Src);
+      SetFlagsOpCMP(Size, Dest, Src);
     break;
     case FEXCore::IR::IROps::OP_MUL:
       GenerateFlags_MUL(Op, Result, _MulH(Dest, Src));
@@ -308,6 +309,7 @@ void OpDispatchBuilder::SecondaryALUOp(OpcodeArgs) {
     case FEXCore::IR::IROps::OP_XOR:
     case FEXCore::IR::IROps::OP_OR: {
       GenerateFlags_Logical(Op, Result, Dest, Src);
+      SetFlagsOpAND(Size, Result);
     break;
     }
     default: break;
@@ -654,6 +656,7 @@ void OpDispatchBuilder::CALLOp(OpcodeArgs) {
   _StoreContext(GPRClass, GPRSize, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSP]), NewSP);
 
   _StoreMem(GPRClass, GPRSize, NewSP, ConstantPCReturn, GPRSize);
+  _GuestCallDirect(ConstantPCReturn);
 
   // Store the RIP
   _ExitFunction(NewRIP); // If we get here then leave the function now
@@ -677,17 +680,157 @@ void OpDispatchBuilder::CALLAbsoluteOp(OpcodeArgs) {
   _StoreContext(GPRClass, GPRSize, offsetof(FEXCore::Core::CPUState, gregs[FEXCore::X86State::REG_RSP]), NewSP);
 
   _StoreMem(GPRClass, Size, NewSP, ConstantPCReturn, Size);
+  _GuestCallIndirect(ConstantPCReturn);
 
   // Store the RIP
   _ExitFunction(JMPPCOffset); // If we get here then leave the function now
 }
 
+void OpDispatchBuilder::SetFlagsOpCMP(uint8_t Size, OrderedNode *Dest, OrderedNode *Src) {
+  if (Size >= 4) {
+    flagsOpSize = Size;
+    flagsOp = FLAGS_OP_CMP;
+    flagsOpDestSigned = flagsOpDest = Dest;
+    flagsOpSrcSigned = flagsOpSrc = Src;
+  } else {
+    flagsOpSize = 4;
+    flagsOp = FLAGS_OP_CMP;
+    flagsOpDestSigned = _Sext(Size * 8, flagsOpDest = Dest);
+    flagsOpSrcSigned = _Sext(Size * 8, flagsOpSrc = Src);
+  }
+}
+
+void OpDispatchBuilder::SetFlagsOpAND(uint8_t Size, OrderedNode *Res) {
+  if (Size >= 4) {
+    flagsOpSize = Size;
+    flagsOp = FLAGS_OP_AND;
+    flagsOpDestSigned = flagsOpDest = Res;
+  } else {
+    flagsOpSize = 4;  // assuming ZEXT semantics here
+    flagsOp = FLAGS_OP_AND;
+    flagsOpDestSigned = _Sext(Size * 8, flagsOpDest = Res);
+  }
+}
+
 OrderedNode *OpDispatchBuilder::SelectCC(uint8_t OP, OrderedNode *TrueValue, OrderedNode *FalseValue) {
   OrderedNode *SrcCond = nullptr;
 
   auto ZeroConst = _Constant(0);
   auto OneConst = _Constant(1);
 
+  // Try folding the flags generation in the select op
+  if (flagsOp == FLAGS_OP_CMP) {
+    switch(OP) {
+      // SGT
+      case 0xF: SrcCond = _Select(FEXCore::IR::COND_SGT, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+      // SLE
+      case 0xE: SrcCond = _Select(FEXCore::IR::COND_SLE, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+      // SGE
+      case 0xD: SrcCond = _Select(FEXCore::IR::COND_SGE, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+      // SL
+      case 0xC: SrcCond = _Select(FEXCore::IR::COND_SLT, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+
+      // not sign
+      //case 0x99: SrcCond = _Select(FEXCore::IR::COND_, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+      // sign
+      //case 0x98: SrcCond = _Select(FEXCore::IR::COND_, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
+
+      // UABove
+      case 0x7: SrcCond = _Select(FEXCore::IR::COND_UGT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+      // UBE
+      case 0x6: SrcCond = _Select(FEXCore::IR::COND_ULE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+      // NE
+      case 0x5: SrcCond = _Select(FEXCore::IR::COND_NEQ, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+      // EQ/Zero
+      case 0x4: SrcCond = _Select(FEXCore::IR::COND_EQ, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+      // UAE
+      case 0x3: SrcCond = _Select(FEXCore::IR::COND_UGE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+      // UBelow
+      case 0x2: SrcCond = _Select(FEXCore::IR::COND_ULT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
+
+      //default: printf("Missed Condition %04X OP_CMP\n", OP); break;
+    }
+  }
+  else if (flagsOp == FLAGS_OP_AND) {
+    // Logical ops clear CF and OF, so every condition left is a compare of the result against zero
+    switch(OP) {
+      // JBE and JE
+      case 0x6:
+      case 0x4: SrcCond = _Select(FEXCore::IR::COND_EQ, flagsOpDest, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      // JA and JNE
+      case 0x7:
+      case 0x5: SrcCond = _Select(FEXCore::IR::COND_NEQ, flagsOpDest, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      // JS and JL
+      case 0x8:
+      case 0xC: SrcCond = _Select(FEXCore::IR::COND_SLT, flagsOpDestSigned, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      // JNS and JGE
+      case 0x9:
+      case 0xD: SrcCond = _Select(FEXCore::IR::COND_SGE, flagsOpDestSigned, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      // JLE
+      case 0xE: SrcCond = _Select(FEXCore::IR::COND_SLE, flagsOpDestSigned, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      // JG
+      case 0xF: SrcCond = _Select(FEXCore::IR::COND_SGT, flagsOpDestSigned, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
+      //default: printf("Missed Condition %04X OP_AND\n", OP); break;
+    }
+  } else if (flagsOp == FLAGS_OP_FCMP) {
+    /*
+      x86:ZCP
+        unordered { 11 1 }
+        greater   { 00 0 }
+        less      { 01 0 }
+        equal     { 10 0 }
+      aarch64: NZCV
+        unordered { 0 01 1 }
+        greater   { 0 01 0 }
+        less      { 1 00 0 }
+        equal     { 0 11 0 }
+    */
+
+   /*
+      eq = 0,   // Z set            Equal.
+      ne = 1,   // Z clear          Not equal.
+      cs = 2,   // C set            Carry set.
+      cc = 3,   // C clear          Carry clear.
+      mi = 4,   // N set            Negative.
+      pl = 5,   // N clear          Positive or zero.
+      vs = 6,   // V set            Overflow.
+      vc = 7,   // V clear          No overflow.
+      hi = 8,   // C set, Z clear   Unsigned higher.
+      ls = 9,   // C clear or Z set Unsigned lower or same.
+      ge = 10,  // N == V           Greater or equal.
+      lt = 11,  // N != V           Less than.
+      gt = 12,  // Z clear, N == V  Greater than.
+      le = 13,  // Z set or N != V  Less then or equal
+   */
+    switch(OP) {
+      case 0x2: // CF == 1 // less or unordered                      // N==1 OR V==1        // lt
+        SrcCond = _Select(FEXCore::IR::COND_FLU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      case 0x3: // CF == 0 // greater or equal (and not unordered)   // N==V                // ge
+        SrcCond = _Select(FEXCore::IR::COND_FGE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      case 0x6: // CF == 1 || ZF == 1 // less or equal or unordered  // Z==1 OR N!=V        // le
+        SrcCond = _Select(FEXCore::IR::COND_FLEU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      case 0x7: // CF == 0 && ZF == 0 // greater (and not unordered) // C==1 AND V=0        // hi
+        SrcCond = _Select(FEXCore::IR::COND_FGT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      case 0xA: // PF = 1 // unordered                               // V==1                // vs
+        SrcCond = _Select(FEXCore::IR::COND_FU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      case 0xB: // PF = 0 // not unordered                           // V==0                // vc
+        SrcCond = _Select(FEXCore::IR::COND_FNU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
+        break;
+      default:
+        // TODO: Add more optimized cases
+        break;
+    }
+  }
+
+  if (SrcCond) {
+    // The flags don't need to be materialized in to RFLAGS for this
+    return SrcCond;
+  }
   switch (OP) {
     case 0x0: { // JO - Jump if OF == 1
       auto Flag = GetRFLAG(FEXCore::X86State::RFLAG_OF_LOC);
@@ -814,100 +957,6 @@ OrderedNode *OpDispatchBuilder::SelectCC(uint8_t OP, OrderedNode *TrueValue, Ord
     default: LogMan::Msg::A("Unknown CC Op: 0x%x\n", OP); return nullptr;
   }
 
-  // Try folding the flags generation in the select op
-  if (flagsOp == FLAGS_OP_CMP) {
-    switch(OP) {
-      // SGT
-      case 0xF: SrcCond = _Select(FEXCore::IR::COND_SGT, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-      // SLE
-      case 0xE: SrcCond = _Select(FEXCore::IR::COND_SLE, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-      // SGE
-      case 0xD: SrcCond = _Select(FEXCore::IR::COND_SGE, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-      // SL
-      case 0xC: SrcCond = _Select(FEXCore::IR::COND_SLT, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-
-      // not sign
-      //case 0x99: SrcCond = _Select(FEXCore::IR::COND_, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-      // sign
-      //case 0x98: SrcCond = _Select(FEXCore::IR::COND_, flagsOpDestSigned, flagsOpSrcSigned, TrueValue, FalseValue, flagsOpSize); break;
-
-      // UABove
-      case 0x7: SrcCond = _Select(FEXCore::IR::COND_UGT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-      // UBE
-      case 0x6: SrcCond = _Select(FEXCore::IR::COND_ULE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-      // NE
-      case 0x5: SrcCond = _Select(FEXCore::IR::COND_NEQ, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-      // EQ/Zero
-      case 0x4: SrcCond = _Select(FEXCore::IR::COND_EQ, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-      // UAE
-      case 0x3: SrcCond = _Select(FEXCore::IR::COND_UGE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-      // UBelow
-      case 0x2: SrcCond = _Select(FEXCore::IR::COND_ULT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize); break;
-
-      //default: printf("Missed Condition %04X OP_CMP\n", OP); break;
-    }
-  }
-  else if (flagsOp == FLAGS_OP_AND) {
-    switch(OP) {
-      case 0x4: SrcCond = _Select(FEXCore::IR::COND_EQ, flagsOpDest, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
-      case 0x5: SrcCond = _Select(FEXCore::IR::COND_NEQ, flagsOpDest, ZeroConst, TrueValue, FalseValue, flagsOpSize); break;
-      //default: printf("Missed Condition %04X OP_AND\n", OP); break;
-    }
-  } else if (flagsOp == FLAGS_OP_FCMP) {
-    /*
-      x86:ZCP
-        unordered { 11 1 }
-        greater   { 00 0 }
-        less      { 01 0 }
-        equal     { 10 0 }
-      aarch64: NZCV
-        unordered { 0 01 1 }
-        greater   { 0 01 0 }
-        less      { 1 00 0 }
-        equal     { 0 11 0 }
-    */
-
-   /*
-      eq = 0,   // Z set            Equal.
-      ne = 1,   // Z clear          Not equal.
-      cs = 2,   // C set            Carry set.
-      cc = 3,   // C clear          Carry clear.
-      mi = 4,   // N set            Negative.
-      pl = 5,   // N clear          Positive or zero.
-      vs = 6,   // V set            Overflow.
-      vc = 7,   // V clear          No overflow.
-      hi = 8,   // C set, Z clear   Unsigned higher.
-      ls = 9,   // C clear or Z set Unsigned lower or same.
-      ge = 10,  // N == V           Greater or equal.
-      lt = 11,  // N != V           Less than.
-      gt = 12,  // Z clear, N == V  Greater than.
-      le = 13,  // Z set or N != V  Less then or equal
-   */
-    switch(OP) {
-      case 0x2: // CF == 1 // less or unordered                      // N==1 OR V==1        // lt
-        SrcCond = _Select(FEXCore::IR::COND_FLU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      case 0x3: // CF == 0 // greater or equal (and not unordered)   // N==V                // ge
-        SrcCond = _Select(FEXCore::IR::COND_FGE, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      case 0x6: // CF == 1 || ZF == 1 // less or equal or unordered  // Z==1 OR N!=V        // le
-        SrcCond = _Select(FEXCore::IR::COND_FLEU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      case 0x7: // CF == 0 && ZF == 0 // greater (and not unordered) // C==1 AND V=0        // hi
-        SrcCond = _Select(FEXCore::IR::COND_FGT, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      case 0xA: // PF = 1 // unordered                               // V==1                // vs
-        SrcCond = _Select(FEXCore::IR::COND_FU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      case 0xB: // PF = 0 // not unordered                           // V==0                // vc
-        SrcCond = _Select(FEXCore::IR::COND_FNU, flagsOpDest, flagsOpSrc, TrueValue, FalseValue, flagsOpSize);
-        break;
-      default:
-        // TODO: Add more optimized cases
-        break;
-    }
-  }
-
   return SrcCond;
 }
 
@@ -1185,17 +1234,7 @@ void OpDispatchBuilder::TESTOp(OpcodeArgs) {
   auto ALUOp = _And(Dest, Src);
   GenerateFlags_Logical(Op, ALUOp, Dest, Src);
 
-  auto Size = GetDstSize(Op);
-
-  if (Size >=4) {
-    flagsOp = FLAGS_OP_AND;
-    flagsOpDest = ALUOp;
-    flagsOpSize = Size;
-  } else {
-    flagsOp = FLAGS_OP_AND;
-    flagsOpDest = ALUOp;
-    flagsOpSize = 4;  // assuming ZEXT semantics here
-  }
+  SetFlagsOpAND(GetDstSize(Op), ALUOp);
 }
 
 void OpDispatchBuilder::MOVSXDOp(OpcodeArgs) {
@@ -1259,17 +1298,7 @@ void OpDispatchBuilder::CMPOp(OpcodeArgs) {
 
   GenerateFlags_SUB(Op, Result, Dest, Src);
 
-  if (Size >= 4) {
-    flagsOpSize = Size;
-    flagsOp = FLAGS_OP_CMP;
-    flagsOpDestSigned = flagsOpDest = Dest;
-    flagsOpSrcSigned = flagsOpSrc = Src;
-  } else {
-    flagsOpSize = 4;
-    flagsOp = FLAGS_OP_CMP;
-    flagsOpDestSigned = _Sext(Size * 8, flagsOpDest = Dest);
-    flagsOpSrcSigned = _Sext(Size * 8, flagsOpSrc = Src);
-  }
+  SetFlagsOpCMP(Size, Dest, Src);
 }
 
 void OpDispatchBuilder::CQOOp(OpcodeArgs) {
@@ -4711,6 +4740,8 @@ void OpDispatchBuilder::StoreResult_WithOpSize(FEXCore::IR::RegisterClassType Cl
   else if (Operand.TypeNone.Type == FEXCore::X86Tables::DecodedOperand::TYPE_GPR) {
     if (Operand.TypeGPR.GPR >= FEXCore::X86State::REG_MM_0) {
       _StoreContext(Class, OpSize, offsetof(FEXCore::Core::CPUState, mm[Operand.TypeGPR.GPR - FEXCore::X86State::REG_MM_0]), Src);
+      // MMX registers alias the x87 stack
+      InvalidateX87Stack();
     }
     else if (Operand.TypeGPR.GPR >= FEXCore::X86State::REG_XMM_0) {
       _StoreContext(Class, OpSize, offsetof(FEXCore::Core::CPUState, xmm[Operand.TypeGPR.GPR - FEXCore::X86State::REG_XMM_0][Operand.TypeGPR.HighBits ? 1 : 0]), Src);
@@ -4841,36 +4872,216 @@ void OpDispatchBuilder::ResetWorkingList() {
   DecodeFailure = false;
   ShouldDump = false;
   CurrentCodeBlock = nullptr;
+  DeferredFlags = {};
+  X87Stack = {};
 }
 
 template<unsigned BitOffset>
 void OpDispatchBuilder::SetRFLAG(OrderedNode *Value) {
-  flagsOp = FLAGS_OP_NONE;
-  _StoreFlag(_Bfe(1, 0, Value), BitOffset);
+  SetRFLAG(Value, BitOffset);
 }
 void OpDispatchBuilder::SetRFLAG(OrderedNode *Value, unsigned BitOffset) {
   flagsOp = FLAGS_OP_NONE;
+  if (IsDeferredFlag(BitOffset)) {
+    // Otherwise calculating the deferred flags later would overwrite this
+    CalculateContextFlags();
+  }
   _StoreFlag(_Bfe(1, 0, Value), BitOffset);
 }
 
 OrderedNode *OpDispatchBuilder::GetRFLAG(unsigned BitOffset) {
+  if (IsDeferredFlag(BitOffset)) {
+    SyncDeferredFlagsBlock();
+    auto Type = DeferredFlags.Type;
+    bool PreservedCF = BitOffset == FEXCore::X86State::RFLAG_CF_LOC &&
+      (Type == FEXCore::CPU::DEFERRED_FLAGS_INC || Type == FEXCore::CPU::DEFERRED_FLAGS_DEC);
+
+    if (PreservedCF) {
+      // INC and DEC made sure CF is in the context already
+    }
+    else if (Type != FEXCore::CPU::DEFERRED_FLAGS_NONE) {
+      return CalculateDeferredFlag(BitOffset);
+    }
+    else {
+      CalculateContextFlags();
+    }
+  }
+
   return _LoadFlag(BitOffset);
 }
 
-constexpr std::array<uint32_t, 17> FlagOffsets = {
-  FEXCore::X86State::RFLAG_CF_LOC,
-  FEXCore::X86State::RFLAG_PF_LOC,
-  FEXCore::X86State::RFLAG_AF_LOC,
-  FEXCore::X86State::RFLAG_ZF_LOC,
-  FEXCore::X86State::RFLAG_SF_LOC,
-  FEXCore::X86State::RFLAG_TF_LOC,
-  FEXCore::X86State::RFLAG_IF_LOC,
-  FEXCore::X86State::RFLAG_DF_LOC,
-  FEXCore::X86State::RFLAG_OF_LOC,
-  FEXCore::X86State::RFLAG_IOPL_LOC,
-  FEXCore::X86State::RFLAG_NT_LOC,
-  FEXCore::X86State::RFLAG_RF_LOC,
-  FEXCore::X86State::RFLAG_VM_LOC,
+bool OpDispatchBuilder::IsDeferredFlag(unsigned BitOffset) {
+  switch (BitOffset) {
+  case FEXCore::X86State::RFLAG_CF_LOC:
+  case FEXCore::X86State::RFLAG_PF_LOC:
+  case FEXCore::X86State::RFLAG_AF_LOC:
+  case FEXCore::X86State::RFLAG_ZF_LOC:
+  case FEXCore::X86State::RFLAG_SF_LOC:
+  case FEXCore::X86State::RFLAG_OF_LOC:
+    return true;
+  default:
+    return false;
+  }
+}
+
+void OpDispatchBuilder::SyncDeferredFlagsBlock() {
+  // Nothing is known about the flags at the start of another block, other than what the context holds
+  if (DeferredFlags.CodeBlock != CurrentCodeBlock) {
+    DeferredFlags = {};
+    DeferredFlags.CodeBlock = CurrentCodeBlock;
+  }
+}
+
+void OpDispatchBuilder::DeferFlags(FEXCore::CPU::DeferredFlagsType Type, uint8_t Size, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
+  SyncDeferredFlagsBlock();
+  flagsOp = FLAGS_OP_NONE;
+
+  if (Type == FEXCore::CPU::DEFERRED_FLAGS_INC || Type == FEXCore::CPU::DEFERRED_FLAGS_DEC) {
+    // CF is left alone, so it needs to be in the context before the last producer gets replaced
+    switch (DeferredFlags.Type) {
+    case FEXCore::CPU::DEFERRED_FLAGS_NONE:
+      CalculateContextFlags();
+    break;
+    case FEXCore::CPU::DEFERRED_FLAGS_INC:
+    case FEXCore::CPU::DEFERRED_FLAGS_DEC:
+    break;
+    default:
+      _StoreFlag(CalculateDeferredFlag(FEXCore::X86State::RFLAG_CF_LOC), FEXCore::X86State::RFLAG_CF_LOC);
+    break;
+    }
+  }
+
+  _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, DeferredFlagsRes), Res);
+  _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, DeferredFlagsSrc1), Src1);
+  _StoreContext(GPRClass, 8, offsetof(FEXCore::Core::CPUState, DeferredFlagsSrc2), Src2);
+  _StoreContext(GPRClass, 1, offsetof(FEXCore::Core::CPUState, DeferredFlagsOp), _Constant(Type));
+  _StoreContext(GPRClass, 1, offsetof(FEXCore::Core::CPUState, DeferredFlagsSize), _Constant(Size));
+
+  DeferredFlags.Type = Type;
+  DeferredFlags.Size = Size;
+  DeferredFlags.Res = Res;
+  DeferredFlags.Src1 = Src1;
+  DeferredFlags.Src2 = Src2;
+  DeferredFlags.Calculated = false;
+}
+
+OrderedNode *OpDispatchBuilder::CalculateDeferredFlag(unsigned BitOffset) {
+  // Must be called with a producer in the current block
+  auto Type = DeferredFlags.Type;
+  auto Res = DeferredFlags.Res;
+  auto Src1 = DeferredFlags.Src1;
+  auto Src2 = DeferredFlags.Src2;
+  uint32_t SignBit = DeferredFlags.Size * 8 - 1;
+
+  bool IsAdd = Type == FEXCore::CPU::DEFERRED_FLAGS_ADD || Type == FEXCore::CPU::DEFERRED_FLAGS_INC;
+  bool IsLogical = Type == FEXCore::CPU::DEFERRED_FLAGS_LOGICAL;
+
+  OrderedNode *Flag{};
+  switch (BitOffset) {
+  case FEXCore::X86State::RFLAG_AF_LOC:
+    if (IsLogical) {
+      // Undefined
+      // Set to zero anyway
+      Flag = _Constant(0);
+    }
+    else {
+      Flag = _Bfe(1, 4, _Xor(_Xor(Src1, Src2), Res));
+    }
+  break;
+  case FEXCore::X86State::RFLAG_SF_LOC:
+    Flag = _Lshr(Res, _Constant(SignBit));
+  break;
+  case FEXCore::X86State::RFLAG_PF_LOC: {
+    auto PopCountOp = _Popcount(_And(Res, _Constant(0xFF)));
+    Flag = _Xor(PopCountOp, _Constant(1));
+  break;
+  }
+  case FEXCore::X86State::RFLAG_ZF_LOC:
+    Flag = _Select(FEXCore::IR::COND_EQ,
+        Res, _Constant(0), _Constant(1), _Constant(0));
+  break;
+  case FEXCore::X86State::RFLAG_CF_LOC:
+    LogMan::Throw::A(Type != FEXCore::CPU::DEFERRED_FLAGS_INC && Type != FEXCore::CPU::DEFERRED_FLAGS_DEC, "INC and DEC don't produce CF");
+    if (IsLogical) {
+      Flag = _Constant(0);
+    }
+    else if (IsAdd) {
+      Flag = _Select(FEXCore::IR::COND_ULT, Res, Src2, _Constant(1), _Constant(0));
+    }
+    else {
+      Flag = _Select(FEXCore::IR::COND_ULT, Src1, Src2, _Constant(1), _Constant(0));
+    }
+  break;
+  case FEXCore::X86State::RFLAG_OF_LOC:
+    if (IsLogical) {
+      Flag = _Constant(0);
+    }
+    else if (IsAdd) {
+      auto XorOp1 = _Xor(_Xor(Src1, Src2), _Constant(~0ULL));
+      auto XorOp2 = _Xor(Res, Src1);
+      Flag = _Bfe(1, SignBit, _And(XorOp1, XorOp2));
+    }
+    else {
+      auto XorOp1 = _Xor(Src1, Src2);
+      auto XorOp2 = _Xor(Res, Src1);
+      Flag = _Bfe(1, SignBit, _And(XorOp1, XorOp2));
+    }
+  break;
+  default: LogMan::Msg::A("Flag %d isn't deferred", BitOffset); break;
+  }
+
+  return _Bfe(1, 0, Flag);
+}
+
+void OpDispatchBuilder::CalculateContextFlags() {
+  SyncDeferredFlagsBlock();
+  auto Type = DeferredFlags.Type;
+
+  if (Type != FEXCore::CPU::DEFERRED_FLAGS_NONE) {
+    // The producer is in this block, store its flags directly
+    // RCLSE removes the ones that get overwritten before anything reads them
+    for (unsigned Flag : {FEXCore::X86State::RFLAG_CF_LOC,
+                          FEXCore::X86State::RFLAG_PF_LOC,
+                          FEXCore::X86State::RFLAG_AF_LOC,
+                          FEXCore::X86State::RFLAG_ZF_LOC,
+                          FEXCore::X86State::RFLAG_SF_LOC,
+                          FEXCore::X86State::RFLAG_OF_LOC}) {
+      if (Flag == FEXCore::X86State::RFLAG_CF_LOC &&
+          (Type == FEXCore::CPU::DEFERRED_FLAGS_INC || Type == FEXCore::CPU::DEFERRED_FLAGS_DEC)) {
+        continue;
+      }
+
+      if (Flag == FEXCore::X86State::RFLAG_PF_LOC && CTX->Config.ABINoPF) {
+        _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
+        continue;
+      }
+
+      _StoreFlag(CalculateDeferredFlag(Flag), Flag);
+    }
+    _StoreContext(GPRClass, 1, offsetof(FEXCore::Core::CPUState, DeferredFlagsOp), _Constant(FEXCore::CPU::DEFERRED_FLAGS_NONE));
+  }
+  else if (!DeferredFlags.Calculated) {
+    _CalculateDeferredFlags();
+  }
+
+  DeferredFlags.Type = FEXCore::CPU::DEFERRED_FLAGS_NONE;
+  DeferredFlags.Calculated = true;
+}
+
+constexpr std::array<uint32_t, 17> FlagOffsets = {
+  FEXCore::X86State::RFLAG_CF_LOC,
+  FEXCore::X86State::RFLAG_PF_LOC,
+  FEXCore::X86State::RFLAG_AF_LOC,
+  FEXCore::X86State::RFLAG_ZF_LOC,
+  FEXCore::X86State::RFLAG_SF_LOC,
+  FEXCore::X86State::RFLAG_TF_LOC,
+  FEXCore::X86State::RFLAG_IF_LOC,
+  FEXCore::X86State::RFLAG_DF_LOC,
+  FEXCore::X86State::RFLAG_OF_LOC,
+  FEXCore::X86State::RFLAG_IOPL_LOC,
+  FEXCore::X86State::RFLAG_NT_LOC,
+  FEXCore::X86State::RFLAG_RF_LOC,
+  FEXCore::X86State::RFLAG_VM_LOC,
   FEXCore::X86State::RFLAG_AC_LOC,
   FEXCore::X86State::RFLAG_VIF_LOC,
   FEXCore::X86State::RFLAG_VIP_LOC,
@@ -4897,7 +5108,7 @@ OrderedNode *OpDispatchBuilder::GetPackedRFLAG(bool Lower8) {
   }
 
   for (int i = 0; i < NumFlags; ++i) {
-    OrderedNode *Flag = _LoadFlag(FlagOffsets[i]);
+    OrderedNode *Flag = GetRFLAG(FlagOffsets[i]);
     Flag = _Bfe(4, 32, 0, Flag);
     Flag = _Lshl(Flag, _Constant(FlagOffsets[i]));
     Original = _Or(Original, Flag);
@@ -5044,126 +5255,11 @@ void OpDispatchBuilder::GenerateFlags_SBB(FEXCore::X86Tables::DecodedOp Op, Orde
 }
 
 void OpDispatchBuilder::GenerateFlags_SUB(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, bool UpdateCF) {
-  // AF
-  {
-    OrderedNode *AFRes = _Xor(_Xor(Src1, Src2), Res);
-    AFRes = _Bfe(1, 4, AFRes);
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  if (!CTX->Config.ABINoPF) {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  } else {
-    _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
-  }
-
-  // ZF
-  {
-    auto ZeroConst = _Constant(0);
-    auto OneConst = _Constant(1);
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Res, ZeroConst, OneConst, ZeroConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-
-  // CF
-  if (UpdateCF) {
-    auto ZeroConst = _Constant(0);
-    auto OneConst = _Constant(1);
-
-    auto SelectOp = _Select(FEXCore::IR::COND_ULT,
-        Src1, Src2, OneConst, ZeroConst);
-
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(SelectOp);
-  }
-  // OF
-  {
-    auto XorOp1 = _Xor(Src1, Src2);
-    auto XorOp2 = _Xor(Res, Src1);
-    OrderedNode *FinalAnd = _And(XorOp1, XorOp2);
-
-    FinalAnd = _Bfe(1, GetSrcSize(Op) * 8 - 1, FinalAnd);
-
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(FinalAnd);
-  }
+  DeferFlags(UpdateCF ? FEXCore::CPU::DEFERRED_FLAGS_SUB : FEXCore::CPU::DEFERRED_FLAGS_DEC, GetSrcSize(Op), Res, Src1, Src2);
 }
 
 void OpDispatchBuilder::GenerateFlags_ADD(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, bool UpdateCF) {
-  // AF
-  {
-    OrderedNode *AFRes = _Xor(_Xor(Src1, Src2), Res);
-    AFRes = _Bfe(1, 4, AFRes);
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(AFRes);
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  if (!CTX->Config.ABINoPF) {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  } else {
-    _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
-  }
-
-  // ZF
-  {
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Res, _Constant(0), _Constant(1), _Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-  // CF
-  if (UpdateCF) {
-    auto SelectOp = _Select(FEXCore::IR::COND_ULT, Res, Src2, _Constant(1), _Constant(0));
-
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(SelectOp);
-  }
-
-  // OF
-  {
-    auto NegOne = _Constant(~0ULL);
-    auto XorOp1 = _Xor(_Xor(Src1, Src2), NegOne);
-    auto XorOp2 = _Xor(Res, Src1);
-
-    OrderedNode *AndOp1 = _And(XorOp1, XorOp2);
-
-    switch (GetSrcSize(Op)) {
-    case 1:
-      AndOp1 = _Bfe(1, 7, AndOp1);
-    break;
-    case 2:
-      AndOp1 = _Bfe(1, 15, AndOp1);
-    break;
-    case 4:
-      AndOp1 = _Bfe(1, 31, AndOp1);
-    break;
-    case 8:
-      AndOp1 = _Bfe(1, 63, AndOp1);
-    break;
-    default: LogMan::Msg::A("Unknown BFESize: %d", GetSrcSize(Op)); break;
-    }
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(AndOp1);
-  }
+  DeferFlags(UpdateCF ? FEXCore::CPU::DEFERRED_FLAGS_ADD : FEXCore::CPU::DEFERRED_FLAGS_INC, GetSrcSize(Op), Res, Src1, Src2);
 }
 
 void OpDispatchBuilder::GenerateFlags_MUL(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *High) {
@@ -5213,43 +5309,7 @@ void OpDispatchBuilder::GenerateFlags_UMUL(FEXCore::X86Tables::DecodedOp Op, Ord
 }
 
 void OpDispatchBuilder::GenerateFlags_Logical(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2) {
-  // AF
-  {
-    // Undefined
-    // Set to zero anyway
-    SetRFLAG<FEXCore::X86State::RFLAG_AF_LOC>(_Constant(0));
-  }
-
-  // SF
-  {
-    auto SignBitConst = _Constant(GetSrcSize(Op) * 8 - 1);
-
-    auto LshrOp = _Lshr(Res, SignBitConst);
-    SetRFLAG<FEXCore::X86State::RFLAG_SF_LOC>(LshrOp);
-  }
-
-  // PF
-  if (!CTX->Config.ABINoPF) {
-    auto EightBitMask = _Constant(0xFF);
-    auto PopCountOp = _Popcount(_And(Res, EightBitMask));
-    auto XorOp = _Xor(PopCountOp, _Constant(1));
-    SetRFLAG<FEXCore::X86State::RFLAG_PF_LOC>(XorOp);
-  } else {
-    _InvalidateFlags(1UL << FEXCore::X86State::RFLAG_PF_LOC);
-  }
-
-  // ZF
-  {
-    auto SelectOp = _Select(FEXCore::IR::COND_EQ,
-        Res, _Constant(0), _Constant(1), _Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_ZF_LOC>(SelectOp);
-  }
-
-  // CF/OF
-  {
-    SetRFLAG<FEXCore::X86State::RFLAG_CF_LOC>(_Constant(0));
-    SetRFLAG<FEXCore::X86State::RFLAG_OF_LOC>(_Constant(0));
-  }
+  DeferFlags(FEXCore::CPU::DEFERRED_FLAGS_LOGICAL, GetSrcSize(Op), Res, Src1, Src2);
 }
 
 #define COND_FLAG_SET(cond, flag, newflag) \
@@ -5783,11 +5843,13 @@ void OpDispatchBuilder::ALUOp(OpcodeArgs) {
     break;
     case FEXCore::IR::IROps::OP_SUB:
       GenerateFlags_SUB(Op, Result, Dest, Src);
+      SetFlagsOpCMP(Size, Dest, Src);
     break;
     case FEXCore::IR::IROps::OP_AND:
     case FEXCore::IR::IROps::OP_XOR:
     case FEXCore::IR::IROps::OP_OR: {
       GenerateFlags_Logical(Op, Result, Dest, Src);
+      SetFlagsOpAND(Size, Result);
     break;
     }
     default: break;
@@ -6322,105 +6384,260 @@ void OpDispatchBuilder::VFCMPOp(OpcodeArgs) {
   StoreResult(FPRClass, Op, Result, -1);
 }
 
-OrderedNode *OpDispatchBuilder::GetX87Top() {
+void OpDispatchBuilder::ResetX87Stack(OrderedNode *Base) {
+  X87Stack = {};
+  X87Stack.Block = GetCurrentBlock();
+  X87Stack.Base = Base;
+}
+
+void OpDispatchBuilder::SyncX87Stack() {
   // Yes, we are storing 3 bits in a single flag register.
   // Deal with it
-  return _LoadContext(1, offsetof(FEXCore::Core::CPUState, flags) + FEXCore::X86State::X87FLAG_TOP_LOC, GPRClass);
+  if (X87Stack.Block != GetCurrentBlock()) {
+    ResetX87Stack(_LoadContext(1, offsetof(FEXCore::Core::CPUState, flags) + FEXCore::X86State::X87FLAG_TOP_LOC, GPRClass));
+  }
+}
+
+OrderedNode *OpDispatchBuilder::GetX87Slot(uint8_t Slot) {
+  if (!X87Stack.Slots[Slot]) {
+    X87Stack.Slots[Slot] = Slot == 0 ? X87Stack.Base :
+      _And(_Add(X87Stack.Base, _Constant(Slot)), _Constant(7));
+  }
+  return X87Stack.Slots[Slot];
+}
+
+OrderedNode *OpDispatchBuilder::GetX87Top() {
+  SyncX87Stack();
+  return GetX87Slot(X87Stack.Offset);
 }
 
 void OpDispatchBuilder::SetX87Top(OrderedNode *Value) {
   _StoreContext(GPRClass, 1, offsetof(FEXCore::Core::CPUState, flags) + FEXCore::X86State::X87FLAG_TOP_LOC, Value);
+  ResetX87Stack(Value);
 }
 
-template<size_t width>
-void OpDispatchBuilder::FLD(OpcodeArgs) {
+void OpDispatchBuilder::AdjustX87Top(int8_t Delta) {
+  SyncX87Stack();
+  X87Stack.Offset = (X87Stack.Offset + Delta) & 7;
+  _StoreContext(GPRClass, 1, offsetof(FEXCore::Core::CPUState, flags) + FEXCore::X86State::X87FLAG_TOP_LOC, GetX87Slot(X87Stack.Offset));
+}
 
-  // Update TOP
-  auto orig_top = GetX87Top();
-  auto mask = _Constant(7);
+OrderedNode *OpDispatchBuilder::LoadX87Stack(uint8_t Offset) {
+  SyncX87Stack();
+  uint8_t Slot = (X87Stack.Offset + Offset) & 7;
+  if (!X87Stack.Values[Slot]) {
+    uint8_t Size = CTX->Config.X87ReducedPrecision ? 8 : 16;
+    X87Stack.Values[Slot] = _LoadContextIndexed(GetX87Slot(Slot), Size, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  }
+  return X87Stack.Values[Slot];
+}
+
+void OpDispatchBuilder::StoreX87Stack(uint8_t Offset, OrderedNode *Value) {
+  SyncX87Stack();
+  uint8_t Slot = (X87Stack.Offset + Offset) & 7;
+  uint8_t Size = CTX->Config.X87ReducedPrecision ? 8 : 16;
+  _StoreContextIndexed(Value, GetX87Slot(Slot), Size, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  X87Stack.Values[Slot] = Value;
+}
+
+OrderedNode *OpDispatchBuilder::LoadX87StackF80(uint8_t Offset) {
+  auto Value = LoadX87Stack(Offset);
+  if (CTX->Config.X87ReducedPrecision) {
+    return _F80CVTTo(Value, 8);
+  }
+  return Value;
+}
+
+void OpDispatchBuilder::StoreX87StackF80(uint8_t Offset, OrderedNode *Value) {
+  if (CTX->Config.X87ReducedPrecision) {
+    Value = _F80CVT(Value, 8);
+  }
+  StoreX87Stack(Offset, Value);
+}
+
+OrderedNode *OpDispatchBuilder::X87CVTTo(OrderedNode *Value, uint8_t Size) {
+  if (CTX->Config.X87ReducedPrecision) {
+    switch (Size) {
+      case 4: return _Float_FToF(Value, 4, 8);
+      case 8: return Value;
+      default: return _F80CVT(Value, 8);
+    }
+  }
 
+  if (Size == 4 || Size == 8) {
+    return _F80CVTTo(Value, Size);
+  }
+  return Value;
+}
+
+OrderedNode *OpDispatchBuilder::X87CVTToInt(OrderedNode *Value, uint8_t Size) {
+  if (CTX->Config.X87ReducedPrecision) {
+    if (Size != 8) {
+      Value = _Sext(Size * 8, Value);
+    }
+    return _Float_FromGPR_S(Value, 8, 8);
+  }
+
+  return _F80CVTToInt(Value, Size);
+}
+
+OrderedNode *OpDispatchBuilder::X87CVT(OrderedNode *Value, uint8_t Size) {
+  if (CTX->Config.X87ReducedPrecision) {
+    switch (Size) {
+      case 4: return _Float_FToF(Value, 8, 4);
+      case 8: return Value;
+      default: return _F80CVTTo(Value, 8);
+    }
+  }
+
+  if (Size == 4 || Size == 8) {
+    return _F80CVT(Value, Size);
+  }
+  return Value;
+}
+
+OrderedNode *OpDispatchBuilder::X87CVTInt(OrderedNode *Value, bool Truncate, uint8_t Size) {
+  if (CTX->Config.X87ReducedPrecision) {
+    // Rounds with the host rounding mode, FCW rounding control isn't tracked here
+    // 16bit results are truncated by the store
+    if (Truncate) {
+      return _Float_ToGPR_ZS(Value, 8);
+    }
+    return _Float_ToGPR_S(Value, 8);
+  }
+
+  return _F80CVTInt(Value, Truncate, Size);
+}
+
+OrderedNode *OpDispatchBuilder::X87ALUOp(FEXCore::IR::IROps IROp, OrderedNode *Src1, OrderedNode *Src2) {
+  if (CTX->Config.X87ReducedPrecision) {
+    switch (IROp) {
+      case IR::OP_F80ADD: return _VFAdd(Src1, Src2, 8, 8);
+      case IR::OP_F80SUB: return _VFSub(Src1, Src2, 8, 8);
+      case IR::OP_F80MUL: return _VFMul(Src1, Src2, 8, 8);
+      case IR::OP_F80DIV: return _VFDiv(Src1, Src2, 8, 8);
+      default: LogMan::Msg::A("Unhandled x87 ALU op: %d", IROp); return nullptr;
+    }
+  }
+
+  auto Result = _F80Add(Src1, Src2);
+  // Overwrite the op
+  Result.first->Header.Op = IROp;
+  return Result;
+}
+
+OrderedNode *OpDispatchBuilder::X87Cmp(OrderedNode *Src1, OrderedNode *Src2, uint32_t Flags) {
+  if (CTX->Config.X87ReducedPrecision) {
+    return _FCmp(Src1, Src2, 8, Flags);
+  }
+  return _F80Cmp(Src1, Src2, Flags);
+}
+
+/**
+ * @brief Converts the bits of an 80bit constant to the nearest double
+ *
+ * Only used for the FLD constants, which are all normal numbers
+ */
+static constexpr uint64_t F80ConstantToDouble(uint64_t Mantissa, uint32_t SignExponent) {
+  uint64_t Sign = static_cast<uint64_t>(SignExponent >> 15) << 63;
+  if (Mantissa == 0) {
+    return Sign;
+  }
+
+  uint64_t Exponent = (SignExponent & 0x7FFF) - 16383 + 1023;
+  // Drop the explicit integer bit, then round the 63bit fraction to 52bits to nearest even
+  uint64_t Fraction = Mantissa << 1;
+  uint64_t Result = Fraction >> 12;
+  uint64_t Remainder = Fraction & 0xFFF;
+  if (Remainder > 0x800 || (Remainder == 0x800 && (Result & 1))) {
+    // Carrying in to the exponent is correct here
+    ++Result;
+  }
+  return Sign | ((Exponent << 52) + Result);
+}
+
+static_assert(F80ConstantToDouble(0x8000'0000'0000'0000ULL, 0x3FFF) == 0x3FF0'0000'0000'0000ULL);
+static_assert(F80ConstantToDouble(0xC90F'DAA2'2168'C235ULL, 0x4000) == 0x4009'21FB'5444'2D18ULL);
+
+template<size_t width>
+void OpDispatchBuilder::FLD(OpcodeArgs) {
   size_t read_width = (width == 80) ? 16 : width / 8;
 
-  OrderedNode *data{};
+  OrderedNode *converted{};
 
   if (Op->Src[0].TypeNone.Type != 0) {
     // Read from memory
-    data = LoadSource_WithOpSize(FPRClass, Op, Op->Src[0], read_width, Op->Flags, -1);
+    auto data = LoadSource_WithOpSize(FPRClass, Op, Op->Src[0], read_width, Op->Flags, -1);
+    // Convert to the stack format
+    converted = X87CVTTo(data, width / 8);
   }
   else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    data = _And(_Add(orig_top, offset), mask);
-    data = _LoadContextIndexed(data, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  }
-  OrderedNode *converted = data;
-
-  // Convert to 80bit float
-  if (width == 32 || width == 64) {
-      converted = _F80CVTTo(data, width / 8);
+    converted = LoadX87Stack(Op->OP & 7);
   }
 
-  auto top = _And(_Sub(orig_top, _Constant(1)), mask);
-  SetX87Top(top);
+  // Update TOP
+  AdjustX87Top(-1);
   // Write to ST[TOP]
-  _StoreContextIndexed(converted, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  //_StoreContext(converted, 16, offsetof(FEXCore::Core::CPUState, mm[7][0]));
+  StoreX87Stack(0, converted);
 }
 
 void OpDispatchBuilder::FBLD(OpcodeArgs) {
 
   // Update TOP
-  auto orig_top = GetX87Top();
-  auto mask = _Constant(7);
-  auto top = _And(_Sub(orig_top, _Constant(1)), mask);
-  SetX87Top(top);
+  AdjustX87Top(-1);
 
   // Read from memory
   OrderedNode *data = LoadSource_WithOpSize(FPRClass, Op, Op->Src[0], 16, Op->Flags, -1);
   OrderedNode *converted = _F80BCDLoad(data);
-  _StoreContextIndexed(converted, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, converted);
 }
 
 void OpDispatchBuilder::FBSTP(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto data = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto data = LoadX87StackF80(0);
 
   OrderedNode *converted = _F80BCDStore(data);
 
 	StoreResult_WithOpSize(FPRClass, Op, Op->Dest, converted, 10, 1);
 
-	auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-	SetX87Top(top);
+  AdjustX87Top(1);
 }
 
 template<uint64_t Lower, uint32_t Upper>
 void OpDispatchBuilder::FLD_Const(OpcodeArgs) {
   // Update TOP
-  auto orig_top = GetX87Top();
-  auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
+  AdjustX87Top(-1);
 
-  auto low = _Constant(Lower);
-  auto high = _Constant(Upper);
-  OrderedNode *data = _VCastFromGPR(16, 8, low);
-  data = _VInsGPR(16, 8, data, high, 1);
+  OrderedNode *data{};
+  if (CTX->Config.X87ReducedPrecision) {
+    data = _VCastFromGPR(_Constant(F80ConstantToDouble(Lower, Upper)), 8, 8);
+  }
+  else {
+    auto low = _Constant(Lower);
+    auto high = _Constant(Upper);
+    data = _VCastFromGPR(16, 8, low);
+    data = _VInsGPR(16, 8, data, high, 1);
+  }
   // Write to ST[TOP]
-  _StoreContextIndexed(data, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, data);
 }
 
 void OpDispatchBuilder::FILD(OpcodeArgs) {
 
   // Update TOP
-  auto orig_top = GetX87Top();
-  auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
+  AdjustX87Top(-1);
 
   size_t read_width = GetSrcSize(Op);
 
   // Read from memory
   auto data = LoadSource_WithOpSize(GPRClass, Op, Op->Src[0], read_width, Op->Flags, -1);
 
+  if (CTX->Config.X87ReducedPrecision) {
+    StoreX87Stack(0, X87CVTToInt(data, read_width));
+    return;
+  }
+
   auto zero = _Constant(0);
 
   // Sign extend to 64bits
@@ -6444,25 +6661,23 @@ void OpDispatchBuilder::FILD(OpcodeArgs) {
   converted = _VInsElement(16, 8, 1, 0, converted, _VCastFromGPR(16, 8, upper));
 
   // Write to ST[TOP]
-  _StoreContextIndexed(converted, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, converted);
 }
 
 template<size_t width>
 void OpDispatchBuilder::FST(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto data = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto data = LoadX87Stack(0);
   if (width == 80) {
-    StoreResult_WithOpSize(FPRClass, Op, Op->Dest, data, 10, 1);
+    StoreResult_WithOpSize(FPRClass, Op, Op->Dest, X87CVT(data, 10), 10, 1);
   }
   else if (width == 32 || width == 64) {
-    auto result = _F80CVT(data, width / 8);
+    auto result = X87CVT(data, width / 8);
     StoreResult_WithOpSize(FPRClass, Op, Op->Dest, result, width / 8, 1);
   }
 
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
 }
 
@@ -6471,256 +6686,241 @@ void OpDispatchBuilder::FIST(OpcodeArgs) {
 
   auto Size = GetSrcSize(Op);
 
-  auto orig_top = GetX87Top();
-  OrderedNode *data = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  data = _F80CVTInt(data, Truncate, Size);
+  OrderedNode *data = LoadX87Stack(0);
+  data = X87CVTInt(data, Truncate, Size);
 
   StoreResult_WithOpSize(GPRClass, Op, Op->Dest, data, Size, 1);
 
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
 }
 
 template <size_t width, bool Integer, OpDispatchBuilder::OpResult ResInST0>
 void OpDispatchBuilder::FADD(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode *StackLocation = top;
+  uint8_t StackLocation = 0;
 
   OrderedNode *arg{};
   OrderedNode *b{};
 
-  auto mask = _Constant(7);
-
   if (Op->Src[0].TypeNone.Type != 0) {
     // Memory arg
     if (width == 16 || width == 32 || width == 64) {
       if (Integer) {
         arg = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTToInt(arg, width / 8);
+        b = X87CVTToInt(arg, width / 8);
       }
       else {
         arg = LoadSource(FPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTTo(arg, width / 8);
+        b = X87CVTTo(arg, width / 8);
       }
     }
   } else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    arg = _And(_Add(top, offset), mask);
     if (ResInST0 == OpResult::RES_STI) {
-      StackLocation = arg;
+      StackLocation = Op->OP & 7;
     }
-    b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    b = LoadX87Stack(Op->OP & 7);
   }
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  auto result = _F80Add(a, b);
+  auto a = LoadX87Stack(0);
+  auto result = X87ALUOp(IR::OP_F80ADD, a, b);
+
+  // Write to ST[TOP]
+  StoreX87Stack(StackLocation, result);
 
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), mask);
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
-
-  // Write to ST[TOP]
-  _StoreContextIndexed(result, StackLocation, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
 }
 
 template<size_t width, bool Integer, OpDispatchBuilder::OpResult ResInST0>
 void OpDispatchBuilder::FMUL(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode *StackLocation = top;
+  uint8_t StackLocation = 0;
   OrderedNode *arg{};
   OrderedNode *b{};
 
-  auto mask = _Constant(7);
-
   if (Op->Src[0].TypeNone.Type != 0) {
     // Memory arg
 
     if (width == 16 || width == 32 || width == 64) {
       if (Integer) {
         arg = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTToInt(arg, width / 8);
+        b = X87CVTToInt(arg, width / 8);
       }
       else {
         arg = LoadSource(FPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTTo(arg, width / 8);
+        b = X87CVTTo(arg, width / 8);
       }
     }
   } else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    arg = _And(_Add(top, offset), mask);
     if (ResInST0 == OpResult::RES_STI) {
-      StackLocation = arg;
+      StackLocation = Op->OP & 7;
     }
 
-    b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    b = LoadX87Stack(Op->OP & 7);
   }
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
+
+  auto result = X87ALUOp(IR::OP_F80MUL, a, b);
 
-  auto result = _F80Mul(a, b);
+  // Write to ST[TOP]
+  StoreX87Stack(StackLocation, result);
 
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), mask);
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
-
-  // Write to ST[TOP]
-  _StoreContextIndexed(result, StackLocation, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
 }
 
 template<size_t width, bool Integer, bool reverse, OpDispatchBuilder::OpResult ResInST0>
 void OpDispatchBuilder::FDIV(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode *StackLocation = top;
+  uint8_t StackLocation = 0;
   OrderedNode *arg{};
   OrderedNode *b{};
 
-  auto mask = _Constant(7);
-
   if (Op->Src[0].TypeNone.Type != 0) {
     // Memory arg
 
     if (width == 16 || width == 32 || width == 64) {
       if (Integer) {
         arg = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTToInt(arg, width / 8);
+        b = X87CVTToInt(arg, width / 8);
       }
       else {
         arg = LoadSource(FPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTTo(arg, width / 8);
+        b = X87CVTTo(arg, width / 8);
       }
     }
   } else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    arg = _And(_Add(top, offset), mask);
     if (ResInST0 == OpResult::RES_STI) {
-      StackLocation = arg;
+      StackLocation = Op->OP & 7;
     }
 
-    b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    b = LoadX87Stack(Op->OP & 7);
   }
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
   OrderedNode *result{};
   if (reverse) {
-    result = _F80Div(b, a);
+    result = X87ALUOp(IR::OP_F80DIV, b, a);
   }
   else {
-    result = _F80Div(a, b);
+    result = X87ALUOp(IR::OP_F80DIV, a, b);
   }
 
+  // Write to ST[TOP]
+  StoreX87Stack(StackLocation, result);
+
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), mask);
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
-
-  // Write to ST[TOP]
-  _StoreContextIndexed(result, StackLocation, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
 }
 
 template<size_t width, bool Integer, bool reverse, OpDispatchBuilder::OpResult ResInST0>
 void OpDispatchBuilder::FSUB(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode *StackLocation = top;
+  uint8_t StackLocation = 0;
   OrderedNode *arg{};
   OrderedNode *b{};
 
-  auto mask = _Constant(7);
-
   if (Op->Src[0].TypeNone.Type != 0) {
     // Memory arg
 
     if (width == 16 || width == 32 || width == 64) {
       if (Integer) {
         arg = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTToInt(arg, width / 8);
+        b = X87CVTToInt(arg, width / 8);
       }
       else {
         arg = LoadSource(FPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTTo(arg, width / 8);
+        b = X87CVTTo(arg, width / 8);
       }
     }
   } else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    arg = _And(_Add(top, offset), mask);
     if (ResInST0 == OpResult::RES_STI) {
-      StackLocation = arg;
+      StackLocation = Op->OP & 7;
     }
-    b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    b = LoadX87Stack(Op->OP & 7);
   }
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
   OrderedNode *result{};
   if (reverse) {
-    result = _F80Sub(b, a);
+    result = X87ALUOp(IR::OP_F80SUB, b, a);
   }
   else {
-    result = _F80Sub(a, b);
+    result = X87ALUOp(IR::OP_F80SUB, a, b);
   }
 
+  // Write to ST[TOP]
+  StoreX87Stack(StackLocation, result);
+
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), mask);
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
-
-  // Write to ST[TOP]
-  _StoreContextIndexed(result, StackLocation, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
 }
 
 void OpDispatchBuilder::FCHS(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
-  auto low = _Constant(0);
-  auto high = _Constant(0b1'000'0000'0000'0000);
-  OrderedNode *data = _VCastFromGPR(16, 8, low);
-  data = _VInsGPR(16, 8, data, high, 1);
+  OrderedNode *result{};
+  if (CTX->Config.X87ReducedPrecision) {
+    OrderedNode *data = _VCastFromGPR(_Constant(1ULL << 63), 8, 8);
+    result = _VXor(a, data, 8, 8);
+  }
+  else {
+    auto low = _Constant(0);
+    auto high = _Constant(0b1'000'0000'0000'0000);
+    OrderedNode *data = _VCastFromGPR(16, 8, low);
+    data = _VInsGPR(16, 8, data, high, 1);
 
-  auto result = _VXor(a, data, 16, 1);
+    result = _VXor(a, data, 16, 1);
+  }
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, result);
 }
 
 void OpDispatchBuilder::FABS(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
-  auto low = _Constant(~0ULL);
-  auto high = _Constant(0b0'111'1111'1111'1111);
-  OrderedNode *data = _VCastFromGPR(16, 8, low);
-  data = _VInsGPR(16, 8, data, high, 1);
+  OrderedNode *result{};
+  if (CTX->Config.X87ReducedPrecision) {
+    OrderedNode *data = _VCastFromGPR(_Constant(~(1ULL << 63)), 8, 8);
+    result = _VAnd(a, data, 8, 8);
+  }
+  else {
+    auto low = _Constant(~0ULL);
+    auto high = _Constant(0b0'111'1111'1111'1111);
+    OrderedNode *data = _VCastFromGPR(16, 8, low);
+    data = _VInsGPR(16, 8, data, high, 1);
 
-  auto result = _VAnd(a, data, 16, 1);
+    result = _VAnd(a, data, 16, 1);
+  }
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, result);
 }
 
 void OpDispatchBuilder::FTST(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
   auto low = _Constant(0);
   OrderedNode *data = _VCastFromGPR(16, 8, low);
 
-  OrderedNode *Res = _F80Cmp(a, data,
+  OrderedNode *Res = X87Cmp(a, data,
     (1 << FCMP_FLAG_EQ) |
     (1 << FCMP_FLAG_LT) |
     (1 << FCMP_FLAG_UNORDERED));
@@ -6739,29 +6939,25 @@ void OpDispatchBuilder::FTST(OpcodeArgs) {
 
 void OpDispatchBuilder::FRNDINT(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
 
   auto result = _F80Round(a);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, result);
 }
 
 void OpDispatchBuilder::FXTRACT(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
-
-  auto a = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
+  AdjustX87Top(-1);
 
   auto exp = _F80XTRACT_EXP(a);
   auto sig = _F80XTRACT_SIG(a);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(exp, orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  _StoreContextIndexed(sig, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(1, exp);
+  StoreX87StackF80(0, sig);
 }
 
 void OpDispatchBuilder::FNINIT(OpcodeArgs) {
@@ -6776,9 +6972,6 @@ void OpDispatchBuilder::FNINIT(OpcodeArgs) {
 template<size_t width, bool Integer, OpDispatchBuilder::FCOMIFlags whichflags, bool poptwice>
 void OpDispatchBuilder::FCOMI(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto mask = _Constant(7);
-
   OrderedNode *arg{};
   OrderedNode *b{};
 
@@ -6787,23 +6980,21 @@ void OpDispatchBuilder::FCOMI(OpcodeArgs) {
     if (width == 16 || width == 32 || width == 64) {
       if (Integer) {
         arg = LoadSource(GPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTToInt(arg, width / 8);
+        b = X87CVTToInt(arg, width / 8);
       }
       else {
         arg = LoadSource(FPRClass, Op, Op->Src[0], Op->Flags, -1);
-        b = _F80CVTTo(arg, width / 8);
+        b = X87CVTTo(arg, width / 8);
       }
     }
   } else {
     // Implicit arg
-    auto offset = _Constant(Op->OP & 7);
-    arg = _And(_Add(top, offset), mask);
-    b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    b = LoadX87Stack(Op->OP & 7);
   }
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
-  OrderedNode *Res = _F80Cmp(a, b,
+  OrderedNode *Res = X87Cmp(a, b,
     (1 << FCMP_FLAG_EQ) |
     (1 << FCMP_FLAG_LT) |
     (1 << FCMP_FLAG_UNORDERED));
@@ -6828,79 +7019,64 @@ void OpDispatchBuilder::FCOMI(OpcodeArgs) {
 
 
   if (poptwice) {
-    top = _And(_Add(top, _Constant(2)), mask);
-    SetX87Top(top);
+    AdjustX87Top(2);
   }
   else if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), mask);
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
 }
 
 void OpDispatchBuilder::FXCH(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode* arg;
-
-  auto mask = _Constant(7);
-
   // Implicit arg
-  auto offset = _Constant(Op->OP & 7);
-  arg = _And(_Add(top, offset), mask);
+  uint8_t offset = Op->OP & 7;
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  auto b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
+  auto b = LoadX87Stack(offset);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(b, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  _StoreContextIndexed(a, arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, b);
+  StoreX87Stack(offset, a);
 }
 
 void OpDispatchBuilder::FST(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  OrderedNode* arg;
-
-  auto mask = _Constant(7);
-
   // Implicit arg
-  auto offset = _Constant(Op->OP & 7);
-  arg = _And(_Add(top, offset), mask);
+  uint8_t offset = Op->OP & 7;
 
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(a, arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(offset, a);
 
   if ((Op->TableInfo->Flags & X86Tables::InstFlags::FLAGS_POP) != 0) {
-    top = _And(_Add(top, _Constant(1)), _Constant(7));
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
 }
 
 template<FEXCore::IR::IROps IROp>
 void OpDispatchBuilder::X87UnaryOp(OpcodeArgs) {
 
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  if (IROp == IR::OP_F80SQRT && CTX->Config.X87ReducedPrecision) {
+    auto a = LoadX87Stack(0);
+    StoreX87Stack(0, _VFSqrt(a, 8, 8));
+    return;
+  }
+
+  auto a = LoadX87StackF80(0);
 
   auto result = _F80Round(a);
   // Overwrite the op
   result.first->Header.Op = IROp;
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, result);
 }
 
 template<FEXCore::IR::IROps IROp>
 void OpDispatchBuilder::X87BinaryOp(OpcodeArgs) {
-  auto top = GetX87Top();
-
-  auto mask = _Constant(7);
-  OrderedNode *st1 = _And(_Add(top, _Constant(1)), mask);
-
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  st1 = _LoadContextIndexed(st1, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
+  auto st1 = LoadX87StackF80(1);
 
   auto result = _F80Add(a, st1);
   // Overwrite the op
@@ -6912,47 +7088,38 @@ void OpDispatchBuilder::X87BinaryOp(OpcodeArgs) {
   }
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, result);
 }
 
 template<bool Inc>
 void OpDispatchBuilder::X87ModifySTP(OpcodeArgs) {
-  auto orig_top = GetX87Top();
   if (Inc) {
-    auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-    SetX87Top(top);
+    AdjustX87Top(1);
   }
   else {
-    auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-    SetX87Top(top);
+    AdjustX87Top(-1);
   }
 }
 
 void OpDispatchBuilder::X87SinCos(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
-
-  auto a = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
+  AdjustX87Top(-1);
 
   auto sin = _F80SIN(a);
   auto cos = _F80COS(a);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(sin, orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  _StoreContextIndexed(cos, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(1, sin);
+  StoreX87StackF80(0, cos);
 }
 
 void OpDispatchBuilder::X87FYL2X(OpcodeArgs) {
   bool Plus1 = Op->OP == 0x01F9; // FYL2XP
 
-  auto orig_top = GetX87Top();
-  auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
-
-  OrderedNode *st0 = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  OrderedNode *st1 = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  OrderedNode *st0 = LoadX87StackF80(0);
+  OrderedNode *st1 = LoadX87StackF80(1);
+  AdjustX87Top(1);
 
   if (Plus1) {
     auto low = _Constant(0x8000'0000'0000'0000);
@@ -6965,16 +7132,13 @@ void OpDispatchBuilder::X87FYL2X(OpcodeArgs) {
   auto result = _F80FYL2X(st0, st1);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, result);
 }
 
 void OpDispatchBuilder::X87TAN(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto top = _And(_Sub(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
-
-  auto a = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
+  AdjustX87Top(-1);
 
   auto result = _F80TAN(a);
 
@@ -6984,23 +7148,20 @@ void OpDispatchBuilder::X87TAN(OpcodeArgs) {
   data = _VInsGPR(16, 8, data, high, 1);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  _StoreContextIndexed(data, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(1, result);
+  StoreX87StackF80(0, data);
 }
 
 void OpDispatchBuilder::X87ATAN(OpcodeArgs) {
 
-  auto orig_top = GetX87Top();
-  auto top = _And(_Add(orig_top, _Constant(1)), _Constant(7));
-  SetX87Top(top);
-
-  auto a = _LoadContextIndexed(orig_top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  OrderedNode *st1 = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87StackF80(0);
+  OrderedNode *st1 = LoadX87StackF80(1);
+  AdjustX87Top(1);
 
   auto result = _F80ATAN(st1, a);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(0, result);
 }
 
 void OpDispatchBuilder::X87LDENV(OpcodeArgs) {
@@ -7238,18 +7399,15 @@ void OpDispatchBuilder::X87FNSAVE(OpcodeArgs) {
 
   OrderedNode *ST0Location = _Add(Mem, _Constant(Size * 7));
 
-  auto OneConst = _Constant(1);
-  auto SevenConst = _Constant(7);
   auto TenConst = _Constant(10);
   for (int i = 0; i < 7; ++i) {
-    auto data = _LoadContextIndexed(Top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    auto data = LoadX87StackF80(i);
     _StoreMem(FPRClass, 16, ST0Location, data, 1);
     ST0Location = _Add(ST0Location, TenConst);
-    Top = _And(_Add(Top, OneConst), SevenConst);
   }
 
   // The final st(7) needs a bit of special handling here
-  auto data = _LoadContextIndexed(Top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto data = LoadX87StackF80(7);
   // ST7 broken in to two parts
   // Lower 64bits [63:0]
   // upper 16 bits [79:64]
@@ -7286,8 +7444,6 @@ void OpDispatchBuilder::X87FRSTOR(OpcodeArgs) {
 
   OrderedNode *ST0Location = _Add(Mem, _Constant(Size * 7));
 
-  auto OneConst = _Constant(1);
-  auto SevenConst = _Constant(7);
   auto TenConst = _Constant(10);
 
   auto low = _Constant(~0ULL);
@@ -7300,10 +7456,9 @@ void OpDispatchBuilder::X87FRSTOR(OpcodeArgs) {
     // Mask off the top bits
     Reg = _VAnd(16, 16, Reg, Mask);
 
-    _StoreContextIndexed(Reg, Top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+    StoreX87StackF80(i, Reg);
 
     ST0Location = _Add(ST0Location, TenConst);
-    Top = _And(_Add(Top, OneConst), SevenConst);
   }
 
   // The final st(7) needs a bit of special handling here
@@ -7315,16 +7470,22 @@ void OpDispatchBuilder::X87FRSTOR(OpcodeArgs) {
   ST0Location = _Add(ST0Location, _Constant(8));
   OrderedNode *RegHigh = _LoadMem(FPRClass, 2, ST0Location, 1);
   Reg = _VInsElement(16, 2, 4, 0, Reg, RegHigh);
-  _StoreContextIndexed(Reg, Top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87StackF80(7, Reg);
 }
 
 void OpDispatchBuilder::X87FXAM(OpcodeArgs) {
-  auto top = GetX87Top();
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  OrderedNode *Result = _VExtractToGPR(16, 8, a, 1);
+  auto a = LoadX87Stack(0);
+  OrderedNode *Result{};
 
   // Extract the sign bit
-  Result = _Lshr(Result, _Constant(15));
+  if (CTX->Config.X87ReducedPrecision) {
+    Result = _VExtractToGPR(8, 8, a, 0);
+    Result = _Lshr(Result, _Constant(63));
+  }
+  else {
+    Result = _VExtractToGPR(16, 8, a, 1);
+    Result = _Lshr(Result, _Constant(15));
+  }
   SetRFLAG<FEXCore::X86State::X87FLAG_C1_LOC>(Result);
 
   // Claim this is a normal number
@@ -7410,21 +7571,13 @@ void OpDispatchBuilder::X87FCMOV(OpcodeArgs) {
   OrderedNode *VecCond = _VCastFromGPR(16, 8, SrcCond);
   VecCond = _VInsGPR(16, 8, VecCond, SrcCond, 1);
 
-  auto top = GetX87Top();
-  OrderedNode* arg;
-
-  auto mask = _Constant(7);
-
   // Implicit arg
-  auto offset = _Constant(Op->OP & 7);
-  arg = _And(_Add(top, offset), mask);
-
-  auto a = _LoadContextIndexed(top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
-  auto b = _LoadContextIndexed(arg, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  auto a = LoadX87Stack(0);
+  auto b = LoadX87Stack(Op->OP & 7);
   auto Result = _VBSL(VecCond, b, a);
 
   // Write to ST[TOP]
-  _StoreContextIndexed(Result, top, 16, offsetof(FEXCore::Core::CPUState, mm[0][0]), 16, FPRClass);
+  StoreX87Stack(0, Result);
 }
 
 void OpDispatchBuilder::FXSaveOp(OpcodeArgs) {
@@ -7514,7 +7667,14 @@ void OpDispatchBuilder::FXSaveOp(OpcodeArgs) {
   // If OSFXSR bit in CR4 is not set than FXSAVE /may/ not save the XMM registers
   // This is implementation dependent
   for (unsigned i = 0; i < 8; ++i) {
-    OrderedNode *MMReg = _LoadContext(16, offsetof(FEXCore::Core::CPUState, mm[i]), FPRClass);
+    OrderedNode *MMReg{};
+    if (CTX->Config.X87ReducedPrecision) {
+      // Registers hold doubles, the save area is always 80bit
+      MMReg = _F80CVTTo(_LoadContext(8, offsetof(FEXCore::Core::CPUState, mm[i]), FPRClass), 8);
+    }
+    else {
+      MMReg = _LoadContext(16, offsetof(FEXCore::Core::CPUState, mm[i]), FPRClass);
+    }
     OrderedNode *MemLocation = _Add(Mem, _Constant(i * 16 + 32));
 
     _StoreMem(FPRClass, 16, MemLocation, MMReg, 16);
@@ -7556,8 +7716,14 @@ void OpDispatchBuilder::FXRStoreOp(OpcodeArgs) {
   for (unsigned i = 0; i < 8; ++i) {
     OrderedNode *MemLocation = _Add(Mem, _Constant(i * 16 + 32));
     auto MMReg = _LoadMem(FPRClass, 16, MemLocation, 16);
-    _StoreContext(FPRClass, 16, offsetof(FEXCore::Core::CPUState, mm[i]), MMReg);
+    if (CTX->Config.X87ReducedPrecision) {
+      _StoreContext(FPRClass, 8, offsetof(FEXCore::Core::CPUState, mm[i]), _F80CVT(MMReg, 8));
+    }
+    else {
+      _StoreContext(FPRClass, 16, offsetof(FEXCore::Core::CPUState, mm[i]), MMReg);
+    }
   }
+  InvalidateX87Stack();
   for (unsigned i = 0; i < 16; ++i) {
     OrderedNode *MemLocation = _Add(Mem, _Constant(i * 16 + 160));
     auto XMMReg = _LoadMem(FPRClass, 16, MemLocation, 16);
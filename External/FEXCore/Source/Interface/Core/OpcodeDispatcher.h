@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Interface/Core/DeferredFlags.h"
 #include "Interface/Core/Frontend.h"
 #include "Interface/Context/Context.h"
 
@@ -11,6 +12,7 @@
 
 #include <FEXCore/Utils/LogManager.h>
 
+#include <array>
 #include <cstdint>
 #include <functional>
 #include <map>
@@ -26,8 +28,8 @@ friend class FEXCore::IR::PassManager;
 
 enum {
   FLAGS_OP_NONE,  // must rely on x86 flags
-  FLAGS_OP_CMP,   // flags were set by a CMP between flagsOpDest/flagsOpDestSigned and flagsOpSrc/flagsOpSrcSigned with flagsOpSize size
-  FLAGS_OP_AND,   // flags were set by an AND/TEST, flagsOpDest contains the resulting value of flagsOpSize size
+  FLAGS_OP_CMP,   // flags were set by a CMP/SUB between flagsOpDest/flagsOpDestSigned and flagsOpSrc/flagsOpSrcSigned with flagsOpSize size
+  FLAGS_OP_AND,   // flags were set by an AND/TEST/OR/XOR, flagsOpDest/flagsOpDestSigned contains the resulting value of flagsOpSize size
   FLAGS_OP_FCMP,  // flags were set by a ucomis* / comis*
 };
 
@@ -68,6 +70,8 @@ public:
 
   void StartNewBlock() {
     flagsOp = FLAGS_OP_NONE;
+    // Other paths can jump here, the last producer is only known from the context
+    DeferredFlags = {};
   }
 
   bool FinishOp(uint64_t NextRIP, bool LastOp) {
@@ -499,7 +503,36 @@ private:
   void SetRFLAG(OrderedNode *Value, unsigned BitOffset);
   OrderedNode *GetRFLAG(unsigned BitOffset);
 
+  /**
+   * @name Deferred flags
+   * @brief ADD, SUB, INC, DEC and logical ops only record themselves instead of calculating their flags
+   *
+   * The producer is stored to the context right away, RCLSE removes the stores of every producer but the last one in a block.
+   * Reads after a producer in the same block calculate just that flag from its SSA values.
+   * Anything else calculates the context's deferred flags first with CalculateDeferredFlags.
+   * @{ */
+  struct DeferredFlagsState {
+    FEXCore::CPU::DeferredFlagsType Type {FEXCore::CPU::DEFERRED_FLAGS_NONE}; ///< Producer in the current block
+    uint8_t Size{};
+    OrderedNode *Res{};
+    OrderedNode *Src1{};
+    OrderedNode *Src2{};
+    bool Calculated{}; ///< The context flags are up to date
+    OrderedNode *CodeBlock{}; ///< IR block the state was built up in
+  };
+  DeferredFlagsState DeferredFlags;
+
+  static bool IsDeferredFlag(unsigned BitOffset);
+  void SyncDeferredFlagsBlock();
+  void DeferFlags(FEXCore::CPU::DeferredFlagsType Type, uint8_t Size, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2);
+  OrderedNode *CalculateDeferredFlag(unsigned BitOffset);
+  void CalculateContextFlags();
+  /**  @} */
+
   OrderedNode *SelectCC(uint8_t OP, OrderedNode *TrueValue, OrderedNode *FalseValue);
+  // Lets SelectCC compare the sources of the last flag producer directly instead of going through RFLAGS
+  void SetFlagsOpCMP(uint8_t Size, OrderedNode *Dest, OrderedNode *Src);
+  void SetFlagsOpAND(uint8_t Size, OrderedNode *Res);
 
   void GenerateFlags_ADC(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, OrderedNode *CF);
   void GenerateFlags_SBB(FEXCore::X86Tables::DecodedOp Op, OrderedNode *Res, OrderedNode *Src1, OrderedNode *Src2, OrderedNode *CF);
@@ -521,6 +554,26 @@ private:
 
   OrderedNode * GetX87Top();
   void SetX87Top(OrderedNode *Value);
+  void AdjustX87Top(int8_t Delta);
+
+  // ST(i) accessors, Offset is relative to the current TOP
+  // Values are in the stack format, 80bit or double with X87ReducedPrecision
+  OrderedNode *LoadX87Stack(uint8_t Offset);
+  void StoreX87Stack(uint8_t Offset, OrderedNode *Value);
+  // Same but always in the 80bit format, for ops that only exist as softfloat
+  OrderedNode *LoadX87StackF80(uint8_t Offset);
+  void StoreX87StackF80(uint8_t Offset, OrderedNode *Value);
+  // Call when something other than the x87 accessors writes TOP or mm[]
+  void InvalidateX87Stack() { X87Stack.Block = nullptr; }
+
+  // Conversions between memory operands and the stack format
+  OrderedNode *X87CVTTo(OrderedNode *Value, uint8_t Size);
+  OrderedNode *X87CVTToInt(OrderedNode *Value, uint8_t Size);
+  OrderedNode *X87CVT(OrderedNode *Value, uint8_t Size);
+  OrderedNode *X87CVTInt(OrderedNode *Value, bool Truncate, uint8_t Size);
+  // IROp is one of F80ADD, F80SUB, F80MUL or F80DIV
+  OrderedNode *X87ALUOp(FEXCore::IR::IROps IROp, OrderedNode *Src1, OrderedNode *Src2);
+  OrderedNode *X87Cmp(OrderedNode *Src1, OrderedNode *Src2, uint32_t Flags);
 
   bool DestIsLockedMem(FEXCore::X86Tables::DecodedOp Op) {
     return Op->Dest.TypeNone.Type !=FEXCore::X86Tables::DecodedOperand::TYPE_GPR && (Op->Flags & FEXCore::X86Tables::DecodeFlags::FLAG_LOCK);
@@ -536,18 +589,39 @@ private:
   bool Multiblock{};
   uint64_t Entry;
 
+  /**
+   * @brief x87 stack state while emitting a block
+   *
+   * TOP is loaded once at the first x87 access in a block and every later push and pop is an offset from it,
+   * so ST(i) resolves to a fixed slot without reloading TOP. Values stored to a slot are forwarded to later loads
+   * so they can live in registers. Stores still go to the context immediately, nothing needs to be flushed.
+   * Only valid inside the IR block it was built in.
+   */
+  struct {
+    OrderedNode *Block{};
+    OrderedNode *Base{};
+    uint8_t Offset{};
+    std::array<OrderedNode*, 8> Slots{};
+    std::array<OrderedNode*, 8> Values{};
+  } X87Stack;
+
+  void ResetX87Stack(OrderedNode *Base);
+  void SyncX87Stack();
+  // Slot is relative to the block's base TOP, not the current TOP
+  OrderedNode *GetX87Slot(uint8_t Slot);
+
   OrderedNode* _StoreMemAutoTSO(FEXCore::IR::RegisterClassType Class, uint8_t Size, OrderedNode *ssa0, OrderedNode *ssa1, uint8_t Align = 1) {
     if (CTX->Config.TSOEnabled)
-    	return _StoreMemTSO(ssa0, ssa1, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1);
+    	return _StoreMemTSO(ssa0, ssa1, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1, 0);
     else
-      return _StoreMem(ssa0, ssa1, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1);
+      return _StoreMem(ssa0, ssa1, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1, 0);
   }
 
   OrderedNode* _LoadMemAutoTSO(FEXCore::IR::RegisterClassType Class, uint8_t Size, OrderedNode *ssa0, uint8_t Align = 1) {
     if (CTX->Config.TSOEnabled)
-      return _LoadMemTSO(ssa0, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1);
+      return _LoadMemTSO(ssa0, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1, 0);
     else
-      return _LoadMem(ssa0, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1);
+      return _LoadMem(ssa0, Invalid(), Size, Align, Class, MEM_OFFSET_SXTX, 1, 0);
   }
 
 
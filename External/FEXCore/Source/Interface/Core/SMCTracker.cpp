@@ -0,0 +1,292 @@
+#include "Interface/Context/Context.h"
+#include "Interface/Core/SMCTracker.h"
+
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sched.h>
+#include <signal.h>
+#include <string>
+#include <sys/mman.h>
+
+namespace FEXCore {
+  SMCTracker::SMCTracker(FEXCore::Context::Context *ctx)
+    : CTX {ctx} {
+  }
+
+  void SMCTracker::ProtectRange(uint64_t Start, uint64_t Length) {
+    uintptr_t End = Start + std::max<uint64_t>(Length, 1);
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    for (uintptr_t Page = Start & PAGE_MASK; Page < End; Page += PAGE_SIZE) {
+      if (Page == 0) {
+        // Can't be a key of the page table
+        continue;
+      }
+
+      auto it = Pages.find(Page);
+      PageEntry *Entry = it != Pages.end() ? it->second : AllocatePage(Page);
+      if (WaitForPage(Entry) != UNPROTECTED) {
+        continue;
+      }
+
+      int GuestProt = Entry->GuestProt.load(std::memory_order_relaxed);
+      if (GuestProt & PROT_WRITE) {
+        if (mprotect(reinterpret_cast<void*>(Page), PAGE_SIZE, GuestProt & ~PROT_WRITE) == 0) {
+          // Only published once the page is read only, a store that faults before this just retries
+          Entry->State.store(PROTECTED, std::memory_order_release);
+        }
+        else {
+          LogMan::Msg::D("Couldn't write protect code page 0x%lx", Page);
+        }
+      }
+    }
+  }
+
+  bool SMCTracker::InvalidatedSince(uint64_t Start, uint64_t Length, uint64_t Generation) {
+    if (GetGeneration() == Generation) {
+      return false;
+    }
+
+    uintptr_t End = Start + std::max<uint64_t>(Length, 1);
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    for (auto it = Pages.lower_bound(Start & PAGE_MASK); it != Pages.end() && it->first < End; ++it) {
+      if (it->second->InvalidatedAt.load(std::memory_order_acquire) > Generation) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool SMCTracker::NeedsCodeChecks(uint64_t Start, uint64_t Length) const {
+    uintptr_t End = Start + std::max<uint64_t>(Length, 1);
+    for (uintptr_t Page = Start & PAGE_MASK; Page < End; Page += PAGE_SIZE) {
+      auto Entry = FindPage(Page);
+      if (Entry && Entry->State.load(std::memory_order_acquire) == CHECKED) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  bool SMCTracker::HandleWriteFault(FEXCore::Core::InternalThreadState *Thread, void *Info) {
+    siginfo_t *SigInfo = static_cast<siginfo_t*>(Info);
+    if (SigInfo->si_code != SEGV_ACCERR) {
+      return false;
+    }
+
+    uintptr_t Page = reinterpret_cast<uintptr_t>(SigInfo->si_addr) & PAGE_MASK;
+
+    // Runs in the signal handler, nothing below takes Lock
+    auto Entry = FindPage(Page);
+    if (!Entry || !(Entry->GuestProt.load(std::memory_order_acquire) & PROT_WRITE)) {
+      // The guest isn't allowed to write here, it gets the fault
+      return false;
+    }
+
+    // If the page isn't protected any more another thread got here first and the store can just be retried
+    Unprotect(Entry, Page);
+    return true;
+  }
+
+  void SMCTracker::PrepareHostWrite(uintptr_t Base, uintptr_t Length) {
+    uintptr_t End = Base + Length;
+    for (uintptr_t Page = Base & PAGE_MASK; Page < End; Page += PAGE_SIZE) {
+      auto Entry = FindPage(Page);
+      if (Entry && (Entry->GuestProt.load(std::memory_order_acquire) & PROT_WRITE)) {
+        Unprotect(Entry, Page);
+      }
+    }
+  }
+
+  SMCTracker::PageEntry *SMCTracker::FindPage(uintptr_t Page) const {
+    if (Page == 0) {
+      return nullptr;
+    }
+
+    // A miss that races a writer can be spurious, look again until the table held still
+    while (true) {
+      uint64_t Sequence = TableSequence.load(std::memory_order_acquire);
+      if (Sequence & 1) {
+        continue;
+      }
+
+      auto Entry = reinterpret_cast<PageEntry*>(PageTable.Find(Page));
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (Entry || TableSequence.load(std::memory_order_relaxed) == Sequence) {
+        // The entry can have been recycled for another page since
+        return Entry && Entry->Page.load(std::memory_order_acquire) == Page ? Entry : nullptr;
+      }
+    }
+  }
+
+  void SMCTracker::Unprotect(PageEntry *Entry, uintptr_t Page) {
+    PageState Expected = PROTECTED;
+    if (!Entry->State.compare_exchange_strong(Expected, UNPROTECTING, std::memory_order_acq_rel)) {
+      return;
+    }
+
+    // Give the write access back first so the store goes through once we return
+    mprotect(reinterpret_cast<void*>(Page), PAGE_SIZE, Entry->GuestProt.load(std::memory_order_acquire));
+    Entry->InvalidatedAt.store(Generation.fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_release);
+
+    // Data sharing the page with code faults on every store, stop protecting a page that keeps doing that
+    bool BackOff = Entry->WriteFaults.fetch_add(1, std::memory_order_relaxed) + 1 >= MAX_WRITE_FAULTS;
+    Entry->State.store(BackOff ? CHECKED : UNPROTECTED, std::memory_order_release);
+
+    // Blocks compiled from here on check their code if we backed off
+    CTX->InvalidateGuestCodeRange(Page, PAGE_SIZE);
+  }
+
+  SMCTracker::PageState SMCTracker::WaitForPage(PageEntry *Entry) {
+    // A fault handler only holds a page for an mprotect
+    PageState State;
+    while ((State = Entry->State.load(std::memory_order_acquire)) == UNPROTECTING) {
+      sched_yield();
+    }
+    return State;
+  }
+
+  SMCTracker::PageEntry *SMCTracker::AllocatePage(uintptr_t Page) {
+    // Must be called with Lock held
+    PageEntry *Entry;
+    if (!FreePages.empty()) {
+      Entry = FreePages.back();
+      FreePages.pop_back();
+    }
+    else {
+      Entry = &PagePool.emplace_back();
+    }
+
+    Entry->State.store(UNPROTECTED, std::memory_order_relaxed);
+    Entry->GuestProt.store(GetGuestProtection(Page), std::memory_order_relaxed);
+    Entry->InvalidatedAt.store(0, std::memory_order_relaxed);
+    Entry->WriteFaults.store(0, std::memory_order_relaxed);
+    Entry->Page.store(Page, std::memory_order_release);
+
+    Pages[Page] = Entry;
+    TableSequence.fetch_add(1, std::memory_order_acq_rel);
+    PageTable.Set(Page, reinterpret_cast<uintptr_t>(Entry));
+    TableSequence.fetch_add(1, std::memory_order_acq_rel);
+    return Entry;
+  }
+
+  void SMCTracker::MemoryMapped(uintptr_t Base, uintptr_t Length, int Prot) {
+    uintptr_t End = Base + Length;
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    ForgetMappings(Base, End);
+    Mappings[Base] = {End, Prot};
+    RemovePages(Base, End);
+  }
+
+  void SMCTracker::MemoryProtected(uintptr_t Base, uintptr_t Length, int Prot) {
+    uintptr_t End = Base + Length;
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    ForgetMappings(Base, End);
+    Mappings[Base] = {End, Prot};
+
+    for (auto it = Pages.lower_bound(Base & PAGE_MASK); it != Pages.end() && it->first < End; ++it) {
+      auto Entry = it->second;
+      bool Raced = Entry->State.load(std::memory_order_acquire) == UNPROTECTING;
+      Entry->GuestProt.store(Prot, std::memory_order_release);
+
+      // The guest's mprotect replaced our protection, a backed off page stays that way
+      PageState State = WaitForPage(Entry);
+      if (Raced) {
+        // The fault handler put back the protection from before the guest's mprotect
+        mprotect(reinterpret_cast<void*>(it->first), PAGE_SIZE, Prot);
+      }
+      if (State == PROTECTED) {
+        Entry->State.store(UNPROTECTED, std::memory_order_release);
+      }
+      Entry->InvalidatedAt.store(Generation.fetch_add(1, std::memory_order_acq_rel) + 1, std::memory_order_release);
+    }
+  }
+
+  void SMCTracker::MemoryUnmapped(uintptr_t Base, uintptr_t Length) {
+    uintptr_t End = Base + Length;
+
+    std::scoped_lock<std::mutex> lk(Lock);
+    ForgetMappings(Base, End);
+    RemovePages(Base, End);
+  }
+
+  void SMCTracker::RemovePages(uintptr_t Base, uintptr_t End) {
+    // Must be called with Lock held
+    auto it = Pages.lower_bound(Base & PAGE_MASK);
+    while (it != Pages.end() && it->first < End) {
+      auto Entry = it->second;
+      WaitForPage(Entry);
+      Entry->Page.store(0, std::memory_order_release);
+
+      TableSequence.fetch_add(1, std::memory_order_acq_rel);
+      PageTable.Erase(it->first);
+      TableSequence.fetch_add(1, std::memory_order_acq_rel);
+
+      FreePages.emplace_back(Entry);
+      it = Pages.erase(it);
+    }
+  }
+
+  int SMCTracker::GetGuestProtection(uintptr_t Page) {
+    // Must be called with Lock held
+    auto Find = [this](uintptr_t Address) -> MappingEntry const* {
+      auto it = Mappings.upper_bound(Address);
+      if (it == Mappings.begin()) {
+        return nullptr;
+      }
+      --it;
+      return Address < it->second.End ? &it->second : nullptr;
+    };
+
+    auto Mapping = Find(Page);
+    if (!Mapping) {
+      LoadMappings();
+      Mapping = Find(Page);
+    }
+
+    return Mapping ? Mapping->Prot : PROT_NONE;
+  }
+
+  void SMCTracker::LoadMappings() {
+    // Must be called with Lock held
+    // Only pages without an entry are looked up, so our own protection changes never show up here
+    Mappings.clear();
+
+    std::ifstream MapsFile("/proc/self/maps");
+    std::string Line;
+    while (std::getline(MapsFile, Line)) {
+      uintptr_t Begin, End;
+      char Perms[5]{};
+      if (sscanf(Line.c_str(), "%lx-%lx %4s", &Begin, &End, Perms) != 3) {
+        continue;
+      }
+
+      int Prot = PROT_NONE;
+      Prot |= Perms[0] == 'r' ? PROT_READ : 0;
+      Prot |= Perms[1] == 'w' ? PROT_WRITE : 0;
+      Prot |= Perms[2] == 'x' ? PROT_EXEC : 0;
+      Mappings[Begin] = {End, Prot};
+    }
+  }
+
+  void SMCTracker::ForgetMappings(uintptr_t Base, uintptr_t End) {
+    // Must be called with Lock held
+    // Partially overlapped mappings are dropped as a whole and loaded again when needed
+    auto it = Mappings.upper_bound(Base);
+    if (it != Mappings.begin() && std::prev(it)->second.End > Base) {
+      --it;
+    }
+
+    while (it != Mappings.end() && it->first < End) {
+      it = Mappings.erase(it);
+    }
+  }
+}
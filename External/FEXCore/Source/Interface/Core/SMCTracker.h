@@ -0,0 +1,145 @@
+#pragma once
+
+#include "Interface/Core/BlockTable.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace FEXCore {
+namespace Context {
+  struct Context;
+}
+namespace Core {
+  struct InternalThreadState;
+}
+
+/**
+ * @brief Page granular self modifying code detection
+ *
+ * Every guest page that has translated code on it is write protected on the host once the first block on it is
+ * compiled. A guest store to the page then faults, the fault handler gives the guest its write access back and
+ * invalidates only the blocks that overlap that page. Code that isn't modified runs without any checks.
+ *
+ * A page that keeps faulting is most likely data sharing a page with code. After MAX_WRITE_FAULTS it isn't protected
+ * any more and the blocks on it validate their guest code inline instead, until the page is mapped again.
+ *
+ * The protection the guest asked for is tracked so we know which faults are ours. Mappings the frontend never told
+ * us about are looked up in /proc/self/maps.
+ *
+ * Modifications are seen on the next entry of the block, a block that modifies itself keeps running the old code
+ * until it exits. The kernel can't fault in to our handler, so the frontend calls PrepareHostWrite before syscalls
+ * that fill guest buffers. A syscall that writes in to a protected page without that returns EFAULT.
+ */
+class SMCTracker final {
+public:
+  SMCTracker(FEXCore::Context::Context *CTX);
+
+  /**
+   * @brief Snapshot to pass to InvalidatedSince, taken before a block is decoded
+   */
+  uint64_t GetGeneration() const { return Generation.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Write protects the guest pages a block was decoded from
+   *
+   * Must be done before the block is published
+   */
+  void ProtectRange(uint64_t Start, uint64_t Length);
+
+  /**
+   * @brief Was one of the pages of this range written to since Generation
+   *
+   * Catches stores from other threads that race with a compile, the block was decoded from the old code
+   */
+  bool InvalidatedSince(uint64_t Start, uint64_t Length, uint64_t Generation);
+
+  /**
+   * @brief Does code in this range have to validate itself inline because its pages aren't protected
+   *
+   * Lock free
+   */
+  bool NeedsCodeChecks(uint64_t Start, uint64_t Length) const;
+
+  /**
+   * @brief SIGSEGV handler
+   *
+   * Lock free apart from the block invalidation, see BlockRangeIndex::Invalidate
+   *
+   * @return true if the fault was a guest store to one of our write protected pages
+   */
+  bool HandleWriteFault(FEXCore::Core::InternalThreadState *Thread, void *Info);
+
+  /**
+   * @brief Gives protected pages in the range their write access back before the host writes them
+   *
+   * Same as a guest store faulting on each of them
+   */
+  void PrepareHostWrite(uintptr_t Base, uintptr_t Length);
+
+  /**
+   * @name Guest memory map changes
+   * @brief Blocks in the range are invalidated by the caller
+   * @{ */
+  void MemoryMapped(uintptr_t Base, uintptr_t Length, int Prot);
+  void MemoryProtected(uintptr_t Base, uintptr_t Length, int Prot);
+  void MemoryUnmapped(uintptr_t Base, uintptr_t Length);
+  /**  @} */
+
+private:
+  enum PageState : uint8_t {
+    UNPROTECTED,
+    PROTECTED,
+    // A fault handler is giving the write access back
+    UNPROTECTING,
+    // Backed off, blocks check their code inline
+    CHECKED,
+  };
+
+  // Read by the fault handler without the lock, entries are recycled but never freed
+  struct PageEntry {
+    std::atomic<uintptr_t> Page{};
+    std::atomic<int> GuestProt{};
+    std::atomic<PageState> State{UNPROTECTED};
+    std::atomic<uint64_t> InvalidatedAt{};
+    std::atomic<uint32_t> WriteFaults{};
+  };
+
+  struct MappingEntry {
+    uintptr_t End;
+    int Prot;
+  };
+
+  PageEntry *FindPage(uintptr_t Page) const;
+  void Unprotect(PageEntry *Entry, uintptr_t Page);
+  PageState WaitForPage(PageEntry *Entry);
+
+  PageEntry *AllocatePage(uintptr_t Page);
+  int GetGuestProtection(uintptr_t Page);
+  void LoadMappings();
+  void ForgetMappings(uintptr_t Base, uintptr_t End);
+  void RemovePages(uintptr_t Base, uintptr_t End);
+
+  constexpr static uintptr_t PAGE_SIZE = 4096;
+  constexpr static uintptr_t PAGE_MASK = ~(PAGE_SIZE - 1);
+  constexpr static uint32_t MAX_WRITE_FAULTS = 16;
+
+  FEXCore::Context::Context *CTX;
+
+  std::mutex Lock;
+  // Ordered view of the tracked pages for the range walks, only used with Lock held
+  std::map<uintptr_t, PageEntry*> Pages;
+  // Same pages for the lock free lookups, TableSequence is odd while it is being written
+  BlockTable PageTable;
+  std::atomic<uint64_t> TableSequence{};
+  std::deque<PageEntry> PagePool;
+  std::vector<PageEntry*> FreePages;
+  // Guest protection of known mappings, only used for pages that don't have an entry yet
+  std::map<uintptr_t, MappingEntry> Mappings;
+
+  std::atomic<uint64_t> Generation{};
+};
+}
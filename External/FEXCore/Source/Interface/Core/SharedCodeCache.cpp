@@ -0,0 +1,277 @@
+#include "Interface/Context/Context.h"
+#include "Interface/Core/HostMemory.h"
+#include "Interface/Core/InternalThreadState.h"
+#include "Interface/Core/LookupCache.h"
+#include "Interface/Core/SharedCodeCache.h"
+
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <sys/mman.h>
+
+namespace FEXCore {
+SharedCodeCache::SharedCodeCache(FEXCore::Context::Context *CTX)
+  : CTX {CTX}
+  , Blocks {std::make_shared<BlockCache>(CTX)} {
+  // Reserve the full range up front so every region can be identified with a single range check
+  // Slots get their permissions when they are handed out
+  // Regions are aligned to their size so each one can be backed by a single huge page
+  uint8_t *Reserved = static_cast<uint8_t*>(mmap(nullptr, RESERVED_SIZE + REGION_SIZE, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+  LogMan::Throw::A(Reserved != reinterpret_cast<uint8_t*>(~0ULL), "Couldn't reserve shared code cache");
+
+  Base = reinterpret_cast<uint8_t*>((reinterpret_cast<uintptr_t>(Reserved) + REGION_SIZE - 1) & ~(REGION_SIZE - 1));
+  if (Base != Reserved) {
+    munmap(Reserved, Base - Reserved);
+  }
+  munmap(Base + RESERVED_SIZE, (Reserved + REGION_SIZE) - Base);
+
+  Slots.resize(NUM_SLOTS);
+  Referenced = std::make_unique<std::atomic_bool[]>(NUM_SLOTS);
+}
+
+SharedCodeCache::~SharedCodeCache() {
+  munmap(Base, RESERVED_SIZE);
+}
+
+SharedCodeCache::CodeRegion SharedCodeCache::AllocateRegion(size_t MinSize) {
+  size_t Count = std::max<size_t>(1, (MinSize + REGION_SIZE - 1) / REGION_SIZE);
+  LogMan::Throw::A(Count * REGION_SIZE <= MAX_CODE_SIZE, "Requested code region is larger than the code cache");
+
+  // Lock order is always block cache then regions
+  std::scoped_lock<std::recursive_mutex> blk(Blocks->GetLock());
+
+  {
+    std::scoped_lock<std::mutex> lk(RegionLock);
+    if (LiveSlots + Count > MAX_LIVE_SLOTS && !EvictColdRegions(Count)) {
+      // Everything left is open for emission, need to retire everything before handing out more
+      FlushLocked();
+    }
+
+    ReclaimRetired();
+
+    // First fit search for Count contiguous free slots
+    for (size_t i = 0; i + Count <= NUM_SLOTS; ++i) {
+      size_t Found = 0;
+      while (Found < Count && Slots[i + Found].State == SlotState::FREE) {
+        ++Found;
+      }
+
+      if (Found != Count) {
+        i += Found;
+        continue;
+      }
+
+      uint8_t *Ptr = Base + i * REGION_SIZE;
+      size_t Size = Count * REGION_SIZE;
+      if (mprotect(Ptr, Size, PROT_READ | PROT_WRITE | PROT_EXEC) != 0) {
+        ERROR_AND_DIE("Couldn't commit shared code region");
+      }
+
+      // Code is shared between every thread, so it only gets huge pages and not a NUMA node
+      auto Policy = HostMemory::GetPolicy(CTX);
+      Policy.NUMALocal = false;
+      HostMemory::Advise(Ptr, Size, Policy);
+
+      for (size_t j = 0; j < Count; ++j) {
+        Slots[i + j].State = SlotState::LIVE;
+        Slots[i + j].Count = 0;
+        // New code is about to be run, give it a full turn of the clock
+        Referenced[i + j].store(true, std::memory_order_relaxed);
+      }
+      Slots[i].Count = Count;
+      Slots[i].Open = true;
+      LiveSlots += Count;
+
+      return {Ptr, Size, GetFlushEpoch()};
+    }
+  }
+
+  // Every slot is either live or waiting on a thread that hasn't reached a quiescent point
+  ERROR_AND_DIE("Shared code cache exhausted, retired code is still in use");
+  return {};
+}
+
+void SharedCodeCache::CloseRegion(uint8_t *Ptr, uint64_t RegionEpoch) {
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  // A flush already closed it, the slots may even belong to someone else by now
+  if (RegionEpoch != GetFlushEpoch()) {
+    return;
+  }
+
+  Slots[(Ptr - Base) / REGION_SIZE].Open = false;
+}
+
+void SharedCodeCache::Flush() {
+  std::scoped_lock<std::recursive_mutex> blk(Blocks->GetLock());
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  FlushLocked();
+}
+
+void SharedCodeCache::FlushLocked() {
+  // Must be called with the block cache lock and RegionLock held
+  // Nothing may be published to retired code, clear the block cache before anyone sees the new epoch
+  Blocks->ClearCache();
+
+  uint64_t NewEpoch = Epoch.load(std::memory_order_relaxed) + 1;
+  for (auto &Slot : Slots) {
+    if (Slot.State == SlotState::LIVE) {
+      Slot.State = SlotState::RETIRED;
+      Slot.Open = false;
+      Slot.RetiredEpoch = NewEpoch;
+    }
+  }
+  LiveSlots = 0;
+
+  // Threads check the flush epoch after seeing the new epoch
+  FlushEpoch.fetch_add(1, std::memory_order_release);
+  Epoch.store(NewEpoch, std::memory_order_release);
+}
+
+bool SharedCodeCache::EvictColdRegions(size_t NeededSlots) {
+  // Must be called with the block cache lock and RegionLock held
+  size_t Target = std::min(NeededSlots + EVICTION_SLACK_SLOTS, MAX_LIVE_SLOTS);
+  uint64_t NewEpoch = Epoch.load(std::memory_order_relaxed) + 1;
+  size_t EvictedRegions{};
+  size_t EvictedBlocks{};
+
+  // Blocks entered through the L1 or L2 never get to Touch, what the threads dispatched to since the last sweep
+  // is still sitting in their L1s
+  Blocks->DrainL1([this](uintptr_t HostCode) {
+    Touch(HostCode);
+  });
+
+  // Two turns at most, the first one may only be clearing referenced bits
+  for (size_t Step = 0; Step < NUM_SLOTS * 2 && LiveSlots + Target > MAX_LIVE_SLOTS; ) {
+    size_t i = ClockHand;
+    auto &Slot = Slots[i];
+    size_t Count = std::max<size_t>(Slot.Count, 1);
+    ClockHand = (i + Count) % NUM_SLOTS;
+    Step += Count;
+
+    // Skip the tails of larger allocations, the clock can land in them after slots were reused
+    if (Slot.State != SlotState::LIVE || Slot.Count == 0 || Slot.Open) {
+      continue;
+    }
+
+    bool WasReferenced = false;
+    for (size_t j = 0; j < Count; ++j) {
+      WasReferenced |= Referenced[i + j].exchange(false, std::memory_order_relaxed);
+    }
+
+    if (WasReferenced) {
+      continue;
+    }
+
+    // Erasing unlinks the blocks and drops them from every L1
+    // Threads that are inside of the code keep running it until they reach a quiescent point
+    uintptr_t Begin = reinterpret_cast<uintptr_t>(Base + i * REGION_SIZE);
+    EvictedBlocks += Blocks->EraseHostRange(Begin, Begin + Count * REGION_SIZE);
+
+    for (size_t j = 0; j < Count; ++j) {
+      Slots[i + j].State = SlotState::RETIRED;
+      Slots[i + j].RetiredEpoch = NewEpoch;
+    }
+    LiveSlots -= Count;
+    ++EvictedRegions;
+  }
+
+  if (EvictedRegions) {
+    LogMan::Msg::D("Evicted %ld code regions with %ld blocks", EvictedRegions, EvictedBlocks);
+    Epoch.store(NewEpoch, std::memory_order_release);
+  }
+
+  return LiveSlots + NeededSlots <= MAX_LIVE_SLOTS;
+}
+
+bool SharedCodeCache::IsLiveCode(uintptr_t Address) {
+  if (!IsCodeAddress(Address)) {
+    return false;
+  }
+
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  return Slots[(Address - reinterpret_cast<uintptr_t>(Base)) / REGION_SIZE].State == SlotState::LIVE;
+}
+
+uintptr_t SharedCodeCache::AddBlockMapping(uint64_t Address, uintptr_t HostCode) {
+  std::scoped_lock<std::recursive_mutex> blk(Blocks->GetLock());
+  if (!IsLiveCode(HostCode)) {
+    // A flush happened while this was compiling
+    // The code remains valid until this thread reaches a quiescent point so it can still run once
+    return HostCode;
+  }
+
+  return Blocks->AddBlockMapping(Address, HostCode, true);
+}
+
+bool SharedCodeCache::ReplaceBlockMapping(uint64_t Address, uintptr_t OldHostCode, uintptr_t NewHostCode) {
+  std::scoped_lock<std::recursive_mutex> blk(Blocks->GetLock());
+  if (!IsLiveCode(NewHostCode) || Blocks->FindBlock(Address) != OldHostCode) {
+    return false;
+  }
+
+  // Erase unlinks the old code and drops it from every L1
+  // Threads that are inside of it keep running it, it isn't released until a flush retires it
+  Blocks->Erase(Address);
+  Blocks->AddBlockMapping(Address, NewHostCode, false);
+  return true;
+}
+
+void SharedCodeCache::RegisterThread(FEXCore::Core::InternalThreadState *Thread) {
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  // A new thread has no code in flight, so it has already seen everything
+  Thread->LookupCache->SeenEpoch = GetEpoch();
+  Thread->LookupCache->SeenFlushEpoch = GetFlushEpoch();
+  ThreadEpochs[Thread] = Thread->LookupCache->SeenEpoch;
+}
+
+void SharedCodeCache::UnregisterThread(FEXCore::Core::InternalThreadState *Thread) {
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  ThreadEpochs.erase(Thread);
+  ReclaimRetired();
+}
+
+void SharedCodeCache::QuiescentPoint(FEXCore::Core::InternalThreadState *Thread) {
+  uint64_t CurrentEpoch = GetEpoch();
+  if (Thread->LookupCache->SeenEpoch == CurrentEpoch) {
+    return;
+  }
+
+  // Evicted blocks were already dropped from every L1, only a flush leaves retired code behind in it
+  uint64_t CurrentFlushEpoch = GetFlushEpoch();
+  if (Thread->LookupCache->SeenFlushEpoch != CurrentFlushEpoch) {
+    Thread->LookupCache->ClearL1Cache();
+    Thread->LookupCache->SeenFlushEpoch = CurrentFlushEpoch;
+  }
+  Thread->LookupCache->SeenEpoch = CurrentEpoch;
+
+  // Predicted returns can point in to any retired region
+  Thread->Returns.Clear();
+
+  std::scoped_lock<std::mutex> lk(RegionLock);
+  ThreadEpochs[Thread] = CurrentEpoch;
+  ReclaimRetired();
+}
+
+void SharedCodeCache::ReclaimRetired() {
+  // Must be called with RegionLock held
+  uint64_t MinEpoch = GetEpoch();
+  for (auto &[Thread, SeenEpoch] : ThreadEpochs) {
+    MinEpoch = std::min(MinEpoch, SeenEpoch);
+  }
+
+  for (size_t i = 0; i < NUM_SLOTS;) {
+    auto &Slot = Slots[i];
+    size_t Count = std::max<size_t>(Slot.Count, 1);
+    if (Slot.State == SlotState::RETIRED && Slot.RetiredEpoch <= MinEpoch) {
+      uint8_t *Ptr = Base + i * REGION_SIZE;
+      madvise(Ptr, Count * REGION_SIZE, MADV_DONTNEED);
+      mprotect(Ptr, Count * REGION_SIZE, PROT_NONE);
+      for (size_t j = 0; j < Count; ++j) {
+        Slots[i + j] = {};
+      }
+    }
+    i += Count;
+  }
+}
+
+}
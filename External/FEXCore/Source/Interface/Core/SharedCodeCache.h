@@ -0,0 +1,189 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdint.h>
+#include <vector>
+
+namespace FEXCore {
+namespace Context {
+  struct Context;
+}
+namespace Core {
+  struct InternalThreadState;
+}
+namespace CPU {
+  class CPUBackend;
+}
+class BlockCache;
+
+/**
+ * @brief Process wide code cache shared between every guest thread of a context
+ *
+ * When enabled all JIT threads publish their blocks to a single BlockCache and emit code in to
+ * regions carved out of a single reserved virtual range. Each thread keeps its own L1 and code region
+ * so the fast path never takes a lock.
+ *
+ * Freeing code is epoch based. Going over the code budget evicts cold regions: their blocks are erased and
+ * unlinked, and the regions are retired. Only if nothing can be evicted does a flush retire every live region
+ * and clear the shared block cache. Retired regions are only released once every registered thread has passed
+ * a quiescent point in the dispatcher, which is also where the thread drops its L1 after a flush.
+ *
+ * Eviction is a clock sweep over the live regions. A region is referenced when it is allocated, whenever one
+ * of its blocks is found through the block cache or gets linked to, and when a sweep finds one of its blocks in a
+ * thread's L1. Sweeps drain the L1s so they only show what was dispatched to since the previous one.
+ * The sweep gives referenced regions a second chance and evicts the rest, so the hot set survives while code that
+ * hasn't run since the last sweep is recompiled from the IR cache if it is needed again.
+ * Regions a thread is still emitting in to are never evicted.
+ */
+class SharedCodeCache final {
+public:
+  SharedCodeCache(FEXCore::Context::Context *CTX);
+  ~SharedCodeCache();
+
+  struct CodeRegion {
+    uint8_t *Ptr;
+    size_t Size;
+    uint64_t Epoch; ///< Flush epoch, the region is retired once the cache is flushed past this
+  };
+
+  /**
+   * @brief Allocates a new region of executable memory that at least fits MinSize
+   *
+   * Evicts cold regions if the live regions would go over the code budget
+   * The region stays open for emission until it is passed to CloseRegion
+   */
+  CodeRegion AllocateRegion(size_t MinSize);
+
+  /**
+   * @brief The thread is done emitting in to this region, it can be evicted from now on
+   */
+  void CloseRegion(uint8_t *Ptr, uint64_t RegionEpoch);
+
+  /**
+   * @brief Retires all live code and clears the shared block cache
+   */
+  void Flush();
+
+  /**
+   * @brief Marks the region holding this code as recently used
+   *
+   * Lock free, a single relaxed store
+   */
+  void Touch(uintptr_t HostCode) {
+    if (IsCodeAddress(HostCode)) {
+      Referenced[(HostCode - reinterpret_cast<uintptr_t>(Base)) / REGION_SIZE].store(true, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Moves forward every time code is retired, by a flush or by eviction
+   */
+  uint64_t GetEpoch() const { return Epoch.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Only moves forward on a flush, everything from an older flush epoch is gone
+   */
+  uint64_t GetFlushEpoch() const { return FlushEpoch.load(std::memory_order_acquire); }
+
+  /**
+   * @brief Is this address inside of a region that hasn't been retired
+   */
+  bool IsLiveCode(uintptr_t Address);
+
+  /**
+   * @brief Is this address anywhere in the shared code range, live or retired
+   *
+   * Lock free so it is safe to use from signal handlers
+   */
+  bool IsCodeAddress(uintptr_t Address) const {
+    return (Address - reinterpret_cast<uintptr_t>(Base)) < RESERVED_SIZE;
+  }
+
+  /**
+   * @brief Publishes a block to every thread
+   *
+   * @return The host code that ends up mapped for Address. Another thread may have won the race.
+   * If the code was retired by a flush while being compiled then it is returned without being published.
+   */
+  uintptr_t AddBlockMapping(uint64_t Address, uintptr_t HostCode);
+
+  /**
+   * @brief Swaps the code of a published block for a recompiled version
+   *
+   * Nothing changes if Address isn't mapped to OldHostCode anymore, the block was invalidated or flushed while
+   * NewHostCode was compiling.
+   *
+   * @return true if NewHostCode is now mapped
+   */
+  bool ReplaceBlockMapping(uint64_t Address, uintptr_t OldHostCode, uintptr_t NewHostCode);
+
+  /**
+   * @name Thread tracking
+   * @{ */
+  void RegisterThread(FEXCore::Core::InternalThreadState *Thread);
+  void UnregisterThread(FEXCore::Core::InternalThreadState *Thread);
+  /**
+   * @brief Called by a thread when it has no code from this cache on its stack
+   */
+  void QuiescentPoint(FEXCore::Core::InternalThreadState *Thread);
+  /**  @} */
+
+  std::shared_ptr<BlockCache> GetBlockCache() { return Blocks; }
+
+  /**
+   * @name Shared dispatcher
+   * @brief The first JIT core generates the dispatcher, the rest reuse it
+   * @{ */
+  std::mutex DispatcherLock;
+  FEXCore::CPU::CPUBackend *DispatcherOwner{};
+  /**  @} */
+
+  constexpr static size_t REGION_SIZE = 2 * 1024 * 1024;
+  constexpr static size_t MAX_CODE_SIZE = 256 * 1024 * 1024;
+
+private:
+  // Reserve more than the budget so retired regions can wait for slow threads
+  constexpr static size_t RESERVED_SIZE = MAX_CODE_SIZE * 4;
+  constexpr static size_t NUM_SLOTS = RESERVED_SIZE / REGION_SIZE;
+  constexpr static size_t MAX_LIVE_SLOTS = MAX_CODE_SIZE / REGION_SIZE;
+  // Evict a bit more than needed so the next few allocations don't have to sweep again
+  constexpr static size_t EVICTION_SLACK_SLOTS = MAX_LIVE_SLOTS / 16;
+
+  enum class SlotState : uint8_t {
+    FREE,
+    LIVE,
+    RETIRED,
+  };
+
+  struct Slot {
+    SlotState State{SlotState::FREE};
+    // A thread is still emitting code in to this allocation, only valid on the first slot
+    bool Open{};
+    // Number of slots in this allocation, only valid on the first slot
+    uint32_t Count{};
+    uint64_t RetiredEpoch{};
+  };
+
+  void FlushLocked();
+  bool EvictColdRegions(size_t NeededSlots);
+  void ReclaimRetired();
+
+  FEXCore::Context::Context *CTX;
+  std::shared_ptr<BlockCache> Blocks;
+
+  uint8_t *Base{};
+  std::mutex RegionLock;
+  std::vector<Slot> Slots;
+  size_t LiveSlots{};
+  size_t ClockHand{};
+  std::unique_ptr<std::atomic_bool[]> Referenced;
+
+  std::atomic<uint64_t> Epoch{};
+  std::atomic<uint64_t> FlushEpoch{};
+  std::map<FEXCore::Core::InternalThreadState*, uint64_t> ThreadEpochs;
+};
+}
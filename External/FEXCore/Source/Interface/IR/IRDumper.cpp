@@ -146,7 +146,7 @@ static void PrintArg(std::stringstream *out, [[maybe_unused]] IRListView const*
   }
 }
 
-void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationData *RAData) {
+void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationData *RAData, std::vector<uint32_t> const *EliminatedNodes) {
   auto HeaderOp = IR->GetHeader();
 
   int8_t CurrentIndent = 0;
@@ -163,6 +163,7 @@ void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationDa
   *out << "%ssa" << HeaderOp->Blocks.ID() << ", ";
   *out << "#" << std::dec << HeaderOp->BlockCount << std::endl;
 
+  size_t BlockIndex = 0;
   for (auto [BlockNode, BlockHeader] : IR->GetBlocks()) {
     {
       auto BlockIROp = BlockHeader->C<FEXCore::IR::IROp_CodeBlock>();
@@ -175,6 +176,13 @@ void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationDa
     }
 
     ++CurrentIndent;
+
+    if (EliminatedNodes && BlockIndex < EliminatedNodes->size()) {
+      AddIndent();
+      *out << "; Value numbering eliminated " << std::dec << EliminatedNodes->at(BlockIndex) << " nodes" << std::endl;
+    }
+    ++BlockIndex;
+
     for (auto [CodeNode, IROp] : IR->GetCode(BlockNode)) {
       uint32_t ID = IR->GetID(CodeNode);
 
@@ -117,6 +117,15 @@ class IRParser: public FEXCore::IR::IREmitter {
     return {DecodeFailure::DECODE_OKAY, Result};
   }
 
+  template<>
+  std::pair<DecodeFailure, int32_t> DecodeValue(std::string &Arg) {
+    if (Arg.at(0) != '#') return {DecodeFailure::DECODE_INVALIDCHAR, 0};
+
+    int32_t Result = (int32_t)strtoull(&Arg.at(1), nullptr, 0);
+    if (errno == ERANGE) return {DecodeFailure::DECODE_INVALIDRANGE, 0};
+    return {DecodeFailure::DECODE_OKAY, Result};
+  }
+
   template<>
   std::pair<DecodeFailure, int64_t> DecodeValue(std::string &Arg) {
     if (Arg.at(0) != '#') return {DecodeFailure::DECODE_INVALIDCHAR, 0};
@@ -1,17 +1,23 @@
 #include "Interface/IR/PassManager.h"
 #include "Interface/IR/Passes.h"
 #include "Interface/IR/Passes/RegisterAllocationPass.h"
+#include "Interface/IR/Passes/ValueNumberingPass.h"
 
 #include <FEXCore/Config/Config.h>
 
 namespace FEXCore::IR {
 
-void PassManager::AddDefaultPasses(bool InlineConstants, bool StaticRegisterAllocation) {
+void PassManager::AddDefaultPasses(bool InlineConstants, bool StaticRegisterAllocation, bool Optimize) {
   FEXCore::Config::Value<bool> DisablePasses{FEXCore::Config::CONFIG_DEBUG_DISABLE_OPTIMIZATION_PASSES, false};
 
-  if (!DisablePasses()) {
-    InsertPass(CreateContextLoadStoreElimination());
+  if (Optimize && !DisablePasses()) {
+    InsertPass(CreateContextLoadStoreElimination(InlineConstants && StaticRegisterAllocation));
     InsertPass(CreateDeadStoreElimination());
+    // Before ConstProp gives every user its own inline constant
+    VNPass = CreateValueNumberingPass();
+    InsertPass(VNPass);
+    InsertPass(CreateAddressModeFolding());
+    InsertPass(CreateLoopInvariantCodeMotion(InlineConstants && StaticRegisterAllocation));
     InsertPass(CreatePassDeadCodeElimination());
     InsertPass(CreateConstProp(InlineConstants));
 
@@ -44,8 +50,10 @@ void PassManager::AddDefaultValidationPasses() {
 #endif
 }
 
-void PassManager::InsertRegisterAllocationPass(bool OptimizeSRA) {
-    RAPass = IR::CreateRegisterAllocationPass(CompactionPass, OptimizeSRA);
+void PassManager::InsertRegisterAllocationPass(bool OptimizeSRA, bool LinearScan) {
+    RAPass = LinearScan ?
+      IR::CreateLinearScanRegisterAllocationPass(CompactionPass, OptimizeSRA) :
+      IR::CreateRegisterAllocationPass(CompactionPass, OptimizeSRA);
     InsertPass(RAPass);
 }
 
@@ -14,6 +14,7 @@ class SyscallHandler;
 namespace FEXCore::IR {
 class OpDispatchBuilder;
 class SyscallOptimization;
+class ValueNumberingPass;
 
 using ShouldExitHandler = std::function<void(void)>;
 
@@ -33,14 +34,14 @@ protected:
 class PassManager final {
   friend class SyscallOptimization;
 public:
-  void AddDefaultPasses(bool InlineConstants, bool StaticRegisterAllocation);
+  void AddDefaultPasses(bool InlineConstants, bool StaticRegisterAllocation, bool Optimize = true);
   void AddDefaultValidationPasses();
   void InsertPass(Pass *Pass) {
     Pass->RegisterPassManager(this);
     Passes.emplace_back(Pass);
   }
 
-  void InsertRegisterAllocationPass(bool OptimizeSRA);
+  void InsertRegisterAllocationPass(bool OptimizeSRA, bool LinearScan = false);
 
   bool Run(IREmitter *IREmit);
 
@@ -56,6 +57,10 @@ public:
     return reinterpret_cast<IR::RegisterAllocationPass*>(RAPass);
   }
 
+  IR::ValueNumberingPass *GetValueNumberingPass() {
+    return VNPass;
+  }
+
   void RegisterSyscallHandler(FEXCore::HLE::SyscallHandler *Handler) {
     SyscallHandler = Handler;
   }
@@ -67,6 +72,7 @@ protected:
 private:
   Pass *RAPass{};
   FEXCore::IR::Pass *CompactionPass{};
+  IR::ValueNumberingPass *VNPass{};
 
   std::vector<std::unique_ptr<Pass>> Passes;
 
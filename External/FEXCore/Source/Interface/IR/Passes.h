@@ -1,18 +1,29 @@
 #pragma once
 
+#include <cstddef>
+
 namespace FEXCore::IR {
 class Pass;
 class RegisterAllocationPass;
 class RegisterAllocationData;
+class ValueNumberingPass;
+
+// Values live across blocks are global to the RA, which can't spill them
+constexpr size_t MaxCrossBlockGPRs = 4;
+constexpr size_t MaxCrossBlockFPRs = 4;
 
 FEXCore::IR::Pass* CreateConstProp(bool InlineConstants);
-FEXCore::IR::Pass* CreateContextLoadStoreElimination();
+FEXCore::IR::Pass* CreateAddressModeFolding();
+FEXCore::IR::Pass* CreateLoopInvariantCodeMotion(bool StaticRegisterAllocation);
+FEXCore::IR::Pass* CreateContextLoadStoreElimination(bool StaticRegisterAllocation);
 FEXCore::IR::Pass* CreateSyscallOptimization();
 FEXCore::IR::Pass* CreateDeadFlagCalculationEliminination();
 FEXCore::IR::Pass* CreateDeadStoreElimination();
 FEXCore::IR::Pass* CreatePassDeadCodeElimination();
+FEXCore::IR::ValueNumberingPass* CreateValueNumberingPass();
 FEXCore::IR::Pass* CreateIRCompaction();
 FEXCore::IR::RegisterAllocationPass* CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA);
+FEXCore::IR::RegisterAllocationPass* CreateLinearScanRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA);
 FEXCore::IR::Pass* CreateStaticRegisterAllocationPass();
 
 namespace Validation {
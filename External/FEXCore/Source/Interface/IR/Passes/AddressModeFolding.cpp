@@ -0,0 +1,199 @@
+#if defined(_M_ARM_64)
+#include "aarch64/assembler-aarch64.h"
+#endif
+
+#include "Interface/IR/PassManager.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <tuple>
+#include <utility>
+
+namespace FEXCore::IR {
+
+#ifdef _M_X86_64
+static bool IsMemoryScale(uint64_t Scale, uint8_t AccessSize) {
+  return Scale  == 1 || Scale  == 2 || Scale  == 4 || Scale  == 8;
+}
+// ModRM carries a full disp32
+static bool IsMemoryDisp(int64_t Disp) {
+  return Disp >= INT32_MIN && Disp <= INT32_MAX;
+}
+#elif defined(_M_ARM_64)
+static bool IsMemoryScale(uint64_t Scale, uint8_t AccessSize) {
+  return Scale  == AccessSize;
+}
+// No base + index + imm form, the backend folds it in to the base with a single add or sub
+static bool IsMemoryDisp(int64_t Disp) {
+  return Disp >= INT32_MIN && Disp <= INT32_MAX && vixl::aarch64::Assembler::IsImmAddSub(Disp < 0 ? -Disp : Disp);
+}
+#else
+#error No addressing mode heuristics for this target
+#endif
+
+/**
+ * @brief Folds the address arithmetic OpcodeDispatcher emits for x86 addressing modes in to the memory ops
+ *
+ * Matches Base + Index * Scale + Disp, where the Index * Scale is a Mul or Lshl by a constant,
+ * and moves each part in to the Addr, Offset, OffsetScale and OffsetDisp of LoadMem and StoreMem
+ * so the backends can emit a single native addressing mode.
+ * The Adds left behind are cleaned up by DCE if nothing else uses them.
+ */
+class AddressModeFolding final : public FEXCore::IR::Pass {
+public:
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  struct AddressMode {
+    OrderedNode *Base;
+    OrderedNode *Index;
+    MemOffsetType OffsetType;
+    uint8_t OffsetScale;
+    int32_t OffsetDisp;
+  };
+
+  static std::tuple<MemOffsetType, uint8_t, OrderedNode*, OrderedNode*> MemExtendedAddressing(IREmitter *IREmit, uint8_t AccessSize, IROp_Header* AddressHeader);
+  static bool FoldAddress(IREmitter *IREmit, uint8_t AccessSize, OrderedNodeWrapper Addr, AddressMode *Mode);
+};
+
+std::tuple<MemOffsetType, uint8_t, OrderedNode*, OrderedNode*> AddressModeFolding::MemExtendedAddressing(IREmitter *IREmit, uint8_t AccessSize, IROp_Header* AddressHeader) {
+
+  // OpcodeDispatcher puts the scaled index first, but either side can hold it
+  for (uint8_t i = 0; i < 2; ++i) {
+    auto Src0Header = IREmit->GetOpHeader(AddressHeader->Args[i]);
+    auto BaseArg = AddressHeader->Args[i ^ 1];
+    if (Src0Header->Size == 8) {
+      //Try to optimize: Base + MUL(Offset, Scale)
+      if (Src0Header->Op == OP_MUL) {
+        uint64_t Scale;
+        if (IREmit->IsValueConstant(Src0Header->Args[1], &Scale)) {
+          if (IsMemoryScale(Scale, AccessSize)) {
+            // remove mul as it can be folded to the mem op
+            return { MEM_OFFSET_SXTX, (uint8_t)Scale, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+          } else if (Scale == 1) {
+            // remove nop mul
+            return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+          }
+        }
+      }
+      //Try to optimize: Base + LSHL(Offset, Scale)
+      else if (Src0Header->Op == OP_LSHL) {
+        uint64_t Constant2;
+        if (IREmit->IsValueConstant(Src0Header->Args[1], &Constant2)) {
+          uint64_t Scale = 1<<Constant2;
+          if (IsMemoryScale(Scale, AccessSize)) {
+            // remove shift as it can be folded to the mem op
+            return { MEM_OFFSET_SXTX, Scale, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+          } else if (Scale == 1) {
+            // remove nop shift
+            return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+          }
+        }
+      }
+#if defined(_M_ARM_64) // x86 can't sext or zext on mem ops
+      //Try to optimize: Base + (u32)Offset
+      else if (Src0Header->Op == OP_BFE) {
+        auto Bfe = Src0Header->C<IROp_Bfe>();
+        if (Bfe->lsb == 0 && Bfe->Width == 32) {
+          //todo: arm can also scale here
+          return { MEM_OFFSET_UXTW, 1, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+        }
+      }
+      //Try to optimize: Base + (s32)Offset
+      else if (Src0Header->Op == OP_SBFE) {
+        auto Sbfe = Src0Header->C<IROp_Sbfe>();
+        if (Sbfe->lsb == 0 && Sbfe->Width == 32) {
+          //todo: arm can also scale here
+          return { MEM_OFFSET_SXTW, 1, IREmit->UnwrapNode(BaseArg), IREmit->UnwrapNode(Src0Header->Args[0]) };
+        }
+      }
+#endif
+    }
+  }
+
+  // no match anywhere, just add
+  return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(AddressHeader->Args[0]), IREmit->UnwrapNode(AddressHeader->Args[1]) };
+}
+
+bool AddressModeFolding::FoldAddress(IREmitter *IREmit, uint8_t AccessSize, OrderedNodeWrapper Addr, AddressMode *Mode) {
+  auto AddressHeader = IREmit->GetOpHeader(Addr);
+  if (AddressHeader->Op != OP_ADD || AddressHeader->Size != 8) {
+    return false;
+  }
+
+  // Try to peel the displacement off first: (Base + Index * Scale) + Disp
+  for (uint8_t i = 0; i < 2; ++i) {
+    uint64_t Disp;
+    if (!IREmit->IsValueConstant(AddressHeader->Args[i], &Disp)) {
+      continue;
+    }
+
+    auto InnerHeader = IREmit->GetOpHeader(AddressHeader->Args[i ^ 1]);
+    if (InnerHeader->Op == OP_ADD && InnerHeader->Size == 8 && IsMemoryDisp(Disp)) {
+      auto [OffsetType, OffsetScale, Base, Index] = MemExtendedAddressing(IREmit, AccessSize, InnerHeader);
+
+      // Keep the constant side of an unscaled add as the base so the index stays a register
+      if (OffsetType == MEM_OFFSET_SXTX && OffsetScale == 1 && IREmit->IsValueConstant(IREmit->WrapNode(Index))) {
+        std::swap(Base, Index);
+      }
+
+      // Constant + Constant is better off as an immediate offset, leave that to ConstProp
+      if (!IREmit->IsValueConstant(IREmit->WrapNode(Index))) {
+        *Mode = { Base, Index, OffsetType, OffsetScale, static_cast<int32_t>(Disp) };
+        return true;
+      }
+    }
+    break;
+  }
+
+  // Base + Index * Scale, or Base + Constant which ConstProp turns in to an immediate offset
+  auto [OffsetType, OffsetScale, Base, Index] = MemExtendedAddressing(IREmit, AccessSize, AddressHeader);
+  *Mode = { Base, Index, OffsetType, OffsetScale, 0 };
+  return true;
+}
+
+bool AddressModeFolding::Run(IREmitter *IREmit) {
+  bool Changed = false;
+  auto CurrentIR = IREmit->ViewIR();
+
+  for (auto [CodeNode, IROp] : CurrentIR.GetAllCode()) {
+    AddressMode Mode;
+
+    if (IROp->Op == OP_LOADMEM) {
+      auto Op = IROp->CW<IR::IROp_LoadMem>();
+
+      if (Op->Offset.IsInvalid() && FoldAddress(IREmit, Op->Size, Op->Addr, &Mode)) {
+        Op->OffsetType = Mode.OffsetType;
+        Op->OffsetScale = Mode.OffsetScale;
+        Op->OffsetDisp = Mode.OffsetDisp;
+        IREmit->ReplaceNodeArgument(CodeNode, 0, Mode.Base);
+        IREmit->ReplaceNodeArgument(CodeNode, 1, Mode.Index);
+
+        Changed = true;
+      }
+    }
+    else if (IROp->Op == OP_STOREMEM) {
+      auto Op = IROp->CW<IR::IROp_StoreMem>();
+
+      if (Op->Offset.IsInvalid() && FoldAddress(IREmit, Op->Size, Op->Addr, &Mode)) {
+        Op->OffsetType = Mode.OffsetType;
+        Op->OffsetScale = Mode.OffsetScale;
+        Op->OffsetDisp = Mode.OffsetDisp;
+        IREmit->ReplaceNodeArgument(CodeNode, 0, Mode.Base);
+        IREmit->ReplaceNodeArgument(CodeNode, 2, Mode.Index);
+
+        Changed = true;
+      }
+    }
+  }
+
+  return Changed;
+}
+
+FEXCore::IR::Pass* CreateAddressModeFolding() {
+  return new AddressModeFolding{};
+}
+
+}
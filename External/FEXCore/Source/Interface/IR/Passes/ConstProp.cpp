@@ -37,16 +37,10 @@ uint64_t getMask(IROp_Header* Op) {
 // very lazy heuristics
 static bool IsImmLogical(uint64_t imm, unsigned width) { return imm < 0x8000'0000; }
 static bool IsImmAddSub(uint64_t imm) { return imm < 0x8000'0000; }
-static bool IsMemoryScale(uint64_t Scale, uint8_t AccessSize) {
-  return Scale  == 1 || Scale  == 2 || Scale  == 4 || Scale  == 8;
-}
 #elif defined(_M_ARM_64)
 //aarch64 heuristics
 static bool IsImmLogical(uint64_t imm, unsigned width) { if (width < 32) width = 32; return vixl::aarch64::Assembler::IsImmLogical(imm, width); }
 static bool IsImmAddSub(uint64_t imm) { return vixl::aarch64::Assembler::IsImmAddSub(imm); }
-static bool IsMemoryScale(uint64_t Scale, uint8_t AccessSize) {
-  return Scale  == AccessSize;
-}
 #else
 #error No inline constant heuristics for this target
 #endif
@@ -61,61 +55,6 @@ static bool IsImmMemory(uint64_t imm, uint8_t AccessSize) {
   }
 }
 
-std::tuple<MemOffsetType, uint8_t, OrderedNode*, OrderedNode*> MemExtendedAddressing(IREmitter *IREmit, uint8_t AccessSize,  IROp_Header* AddressHeader) {
-
-  auto Src0Header = IREmit->GetOpHeader(AddressHeader->Args[0]);
-  if (Src0Header->Size == 8) {
-    //Try to optimize: Base + MUL(Offset, Scale)
-    if (Src0Header->Op == OP_MUL) {
-      uint64_t Scale;
-      if (IREmit->IsValueConstant(Src0Header->Args[1], &Scale)) {
-        if (IsMemoryScale(Scale, AccessSize)) {
-          // remove mul as it can be folded to the mem op
-          return { MEM_OFFSET_SXTX, (uint8_t)Scale, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-        } else if (Scale == 1) {
-          // remove nop mul
-          return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-        }
-      }
-    }
-    //Try to optimize: Base + LSHL(Offset, Scale)
-    else if (Src0Header->Op == OP_LSHL) {
-      uint64_t Constant2;
-      if (IREmit->IsValueConstant(Src0Header->Args[1], &Constant2)) {
-        uint64_t Scale = 1<<Constant2;
-        if (IsMemoryScale(Scale, AccessSize)) {
-          // remove shift as it can be folded to the mem op
-          return { MEM_OFFSET_SXTX, Scale, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-        } else if (Scale == 1) {
-          // remove nop shift
-          return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-        }
-      }
-    }
-#if defined(_M_ARM_64) // x86 can't sext or zext on mem ops
-    //Try to optimize: Base + (u32)Offset
-    else if (Src0Header->Op == OP_BFE) {
-      auto Bfe = Src0Header->C<IROp_Bfe>();
-      if (Bfe->lsb == 0 && Bfe->Width == 32) {
-        //todo: arm can also scale here
-        return { MEM_OFFSET_UXTW, 1, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-      }
-    }
-    //Try to optimize: Base + (s32)Offset
-    else if (Src0Header->Op == OP_SBFE) {
-      auto Sbfe = Src0Header->C<IROp_Sbfe>();
-      if (Sbfe->lsb == 0 && Sbfe->Width == 32) {
-        //todo: arm can also scale here
-        return { MEM_OFFSET_SXTW, 1, IREmit->UnwrapNode(AddressHeader->Args[1]), IREmit->UnwrapNode(Src0Header->Args[0]) };
-      }
-    }
-#endif
-  }
-
-  // no match anywhere, just add
-  return { MEM_OFFSET_SXTX, 1, IREmit->UnwrapNode(AddressHeader->Args[0]), IREmit->UnwrapNode(AddressHeader->Args[1]) };
-}
-
 OrderedNodeWrapper RemoveUselessMasking(IREmitter *IREmit, OrderedNodeWrapper src, uint64_t mask) {
   #if 1 // HOTFIX: We need to clear up the meaning of opsize and dest size. See #594
     return src;
@@ -481,41 +420,6 @@ bool ConstProp::Run(IREmitter *IREmit) {
     }
 */
 
-    case OP_LOADMEM: {
-      auto Op = IROp->CW<IR::IROp_LoadMem>();
-      auto AddressHeader = IREmit->GetOpHeader(Op->Header.Args[0]);
-
-      if (AddressHeader->Op == OP_ADD && AddressHeader->Size == 8) {
-
-        auto [OffsetType, OffsetScale, Arg0, Arg1] = MemExtendedAddressing(IREmit, Op->Size, AddressHeader);
-
-        Op->OffsetType = OffsetType;
-        Op->OffsetScale = OffsetScale;
-        IREmit->ReplaceNodeArgument(CodeNode, 0, Arg0);
-        IREmit->ReplaceNodeArgument(CodeNode, 1, Arg1);
-
-        Changed = true;
-      }
-      break;
-    }
-
-    case OP_STOREMEM: {
-      auto Op = IROp->CW<IR::IROp_StoreMem>();
-      auto AddressHeader = IREmit->GetOpHeader(Op->Header.Args[0]);
-
-      if (AddressHeader->Op == OP_ADD && AddressHeader->Size == 8) {
-        auto [OffsetType, OffsetScale, Arg0, Arg1] = MemExtendedAddressing(IREmit, Op->Size, AddressHeader);
-
-        Op->OffsetType = OffsetType;
-        Op->OffsetScale = OffsetScale;
-        IREmit->ReplaceNodeArgument(CodeNode, 0, Arg0);
-        IREmit->ReplaceNodeArgument(CodeNode, 2, Arg1);
-
-        Changed = true;
-      }
-      break;
-    }
-
     case OP_ADD: {
       auto Op = IROp->C<IR::IROp_Add>();
       uint64_t Constant1{};
@@ -843,22 +747,25 @@ bool ConstProp::Run(IREmitter *IREmit) {
         }
 
         case OP_EXITFUNCTION:
+        // Calls link to their return site, which needs the return address inline the same way
+        case OP_GUESTCALLDIRECT:
+        case OP_GUESTCALLINDIRECT:
         {
-          auto Op = IROp->C<IR::IROp_ExitFunction>();
+          auto RIP = IROp->Args[0];
 
           uint64_t Constant{};
-          if (IREmit->IsValueConstant(Op->NewRIP, &Constant)) {
+          if (IREmit->IsValueConstant(RIP, &Constant)) {
             
-            IREmit->SetWriteCursor(CurrentIR.GetNode(Op->NewRIP));
+            IREmit->SetWriteCursor(CurrentIR.GetNode(RIP));
 
             IREmit->ReplaceNodeArgument(CodeNode, 0, IREmit->_InlineConstant(Constant));
 
             Changed = true;
           } else {
-            auto NewRIP = IREmit->GetOpHeader(Op->NewRIP);
+            auto NewRIP = IREmit->GetOpHeader(RIP);
             if (NewRIP->Op == OP_ENTRYPOINTOFFSET) {
               auto EO = NewRIP->C<IR::IROp_EntrypointOffset>();
-              IREmit->SetWriteCursor(CurrentIR.GetNode(Op->NewRIP));
+              IREmit->SetWriteCursor(CurrentIR.GetNode(RIP));
 
               IREmit->ReplaceNodeArgument(CodeNode, 0, IREmit->_InlineEntrypointOffset(EO->Offset, EO->Header.Size));
               Changed = true;
@@ -3,6 +3,10 @@
 #include "Interface/Core/OpcodeDispatcher.h"
 #include <FEXCore/Core/CoreState.h>
 
+#include <algorithm>
+#include <bitset>
+#include <unordered_set>
+
 namespace {
   struct ContextMemberClassification {
     size_t Offset;
@@ -26,6 +30,7 @@ namespace {
     uint8_t AccessSize;
     FEXCore::IR::OrderedNode *Node;
     FEXCore::IR::OrderedNode *StoreNode;
+    bool Incoming; ///< Node was inherited from every predecessor block
   };
 
   struct ContextInfo {
@@ -33,7 +38,7 @@ namespace {
     std::vector<ContextMemberInfo> ClassificationInfo;
   };
 
-  constexpr static std::array<LastAccessType, 15> DefaultAccess = {
+  constexpr static std::array<LastAccessType, 17> DefaultAccess = {
     ACCESS_NONE,
     ACCESS_NONE,
     ACCESS_INVALID, // PAD
@@ -49,6 +54,8 @@ namespace {
     ACCESS_NONE,
     ACCESS_NONE,
     ACCESS_NONE,
+    ACCESS_INVALID, // PAD
+    ACCESS_NONE,
   };
 
   static void ClassifyContextStruct(ContextInfo *ContextClassificationInfo) {
@@ -201,6 +208,32 @@ namespace {
       FEXCore::IR::InvalidClass,
     });
 
+    ContextClassification->emplace_back(ContextMemberInfo {
+      ContextMemberClassification {
+        offsetof(FEXCore::Core::CPUState, FCW) + sizeof(FEXCore::Core::CPUState::FCW),
+        sizeof(uint16_t) + sizeof(uint32_t),
+      },
+      DefaultAccess[15], ///< NOP padding
+      FEXCore::IR::InvalidClass,
+    });
+
+    // Deferred flags
+    auto AddDeferredMember = [&](size_t Offset, uint8_t Size) {
+      ContextClassification->emplace_back(ContextMemberInfo {
+        ContextMemberClassification {
+          Offset,
+          Size,
+        },
+        DefaultAccess[16],
+        FEXCore::IR::InvalidClass,
+      });
+    };
+    AddDeferredMember(offsetof(FEXCore::Core::CPUState, DeferredFlagsRes), sizeof(FEXCore::Core::CPUState::DeferredFlagsRes));
+    AddDeferredMember(offsetof(FEXCore::Core::CPUState, DeferredFlagsSrc1), sizeof(FEXCore::Core::CPUState::DeferredFlagsSrc1));
+    AddDeferredMember(offsetof(FEXCore::Core::CPUState, DeferredFlagsSrc2), sizeof(FEXCore::Core::CPUState::DeferredFlagsSrc2));
+    AddDeferredMember(offsetof(FEXCore::Core::CPUState, DeferredFlagsOp), sizeof(FEXCore::Core::CPUState::DeferredFlagsOp));
+    AddDeferredMember(offsetof(FEXCore::Core::CPUState, DeferredFlagsSize), sizeof(FEXCore::Core::CPUState::DeferredFlagsSize));
+
     size_t ClassifiedStructSize{};
     ContextClassificationInfo->Lookup.reserve(sizeof(FEXCore::Core::CPUState));
     for (auto &it : *ContextClassification) {
@@ -228,6 +261,7 @@ namespace {
       ContextClassification->at(Offset).AccessRegClass = FEXCore::IR::InvalidClass;
       ContextClassification->at(Offset).AccessOffset = 0;
       ContextClassification->at(Offset).StoreNode = nullptr;
+      ContextClassification->at(Offset).Incoming = false;
     };
     size_t Offset = 0;
     SetAccess(Offset++, DefaultAccess[0]);
@@ -263,35 +297,79 @@ namespace {
     }
 
     SetAccess(Offset++, DefaultAccess[14]);
+    SetAccess(Offset++, DefaultAccess[15]);
+
+    for (size_t i = 0; i < 5; ++i) {
+      SetAccess(Offset++, DefaultAccess[16]);
+    }
   }
 
+  static bool IsStaticRegisterMember(size_t Offset) {
+    return (Offset >= offsetof(FEXCore::Core::CPUState, gregs[0]) && Offset < offsetof(FEXCore::Core::CPUState, gregs[16])) ||
+           (Offset >= offsetof(FEXCore::Core::CPUState, xmm[0][0]) && Offset < offsetof(FEXCore::Core::CPUState, xmm[16][0]));
+  }
+
+  static bool IsFlagMember(size_t Offset) {
+    return Offset >= offsetof(FEXCore::Core::CPUState, flags[0]) && Offset < offsetof(FEXCore::Core::CPUState, flags[48]);
+  }
+
+  // One bit per classified context member
+  using ContextMemberSet = std::bitset<256>;
+
   struct BlockInfo {
     std::vector<FEXCore::IR::OrderedNode *> Predecessors;
     std::vector<FEXCore::IR::OrderedNode *> Successors;
-    ContextInfo IncomingClassifiedStruct;
-    ContextInfo OutgoingClassifiedStruct;
+    std::vector<ContextMemberInfo> OutgoingAccesses;
+    bool Visited{};
+
+    ContextMemberSet LiveIn;
+    ContextMemberSet LiveOut;
+    ContextMemberSet Uses;    ///< Members read before being overwritten
+    ContextMemberSet Defines; ///< Members fully overwritten before being read
+  };
+
+  enum LivenessAccessType {
+    LIVENESS_READ,          ///< Member is read
+    LIVENESS_WRITE,         ///< Member is fully overwritten
+    LIVENESS_PARTIAL_WRITE, ///< Member is partially overwritten
+    LIVENESS_ALL,           ///< Something outside of the IR can observe the whole context
   };
 
 class RCLSE final : public FEXCore::IR::Pass {
 public:
-  RCLSE() {
+  RCLSE(bool StaticRegisterAllocation)
+    : SkipStaticRegisters {StaticRegisterAllocation} {
     ClassifyContextStruct(&ClassifiedStruct);
+    LogMan::Throw::A(ClassifiedStruct.ClassificationInfo.size() <= ContextMemberSet().size(), "Too many context members for liveness tracking");
     DCE.reset(FEXCore::IR::CreatePassDeadCodeElimination());
   }
   bool Run(FEXCore::IR::IREmitter *IREmit) override;
 private:
   std::unique_ptr<FEXCore::IR::Pass> DCE;
 
+  // SRA already keeps these in host registers across blocks
+  bool SkipStaticRegisters;
+
   ContextInfo ClassifiedStruct;
   std::unordered_map<FEXCore::IR::OrderedNodeWrapper::NodeOffsetType, BlockInfo> OffsetToBlockMap;
+  bool Multiblock;
+
+  std::unordered_set<FEXCore::IR::OrderedNode *> PromotedNodes;
+  size_t PromotedGPRs;
+  size_t PromotedFPRs;
 
   ContextMemberInfo *FindMemberInfo(ContextInfo *ClassifiedInfo, uint32_t Offset, uint8_t Size);
   ContextMemberInfo *RecordAccess(ContextMemberInfo *Info, FEXCore::IR::RegisterClassType RegClass, uint32_t Offset, uint8_t Size, LastAccessType AccessType, FEXCore::IR::OrderedNode *Node, FEXCore::IR::OrderedNode *StoreNode = nullptr);
   ContextMemberInfo *RecordAccess(ContextInfo *ClassifiedInfo, FEXCore::IR::RegisterClassType RegClass, uint32_t Offset, uint8_t Size, LastAccessType AccessType, FEXCore::IR::OrderedNode *Node, FEXCore::IR::OrderedNode *StoreNode = nullptr);
   void CalculateControlFlowInfo(FEXCore::IR::IREmitter *IREmit);
+  void CalculateIncomingAccesses(FEXCore::IR::IREmitter *IREmit, ContextInfo *LocalInfo, BlockInfo *Block);
+  bool PromoteAcrossBlocks(FEXCore::IR::OrderedNode *Node, FEXCore::IR::RegisterClassType Class);
+
+  template<typename Func>
+  void VisitLivenessAccesses(FEXCore::IR::IROp_Header *IROp, Func Visit);
 
-  // Block local Passes
   bool RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit);
+  bool DeadStoreElimination(FEXCore::IR::IREmitter *IREmit);
 };
 
 ContextMemberInfo *RCLSE::FindMemberInfo(ContextInfo *ContextClassificationInfo, uint32_t Offset, uint8_t Size) {
@@ -315,6 +393,7 @@ ContextMemberInfo *RCLSE::RecordAccess(ContextMemberInfo *Info, FEXCore::IR::Reg
   Info->AccessOffset = Offset;
   Info->AccessSize = Size;
   Info->Node = Node;
+  Info->Incoming = false;
   if (StoreNode != nullptr)
     Info->StoreNode = StoreNode;
   return Info;
@@ -376,6 +455,88 @@ void RCLSE::CalculateControlFlowInfo(FEXCore::IR::IREmitter *IREmit) {
   }
 }
 
+void RCLSE::CalculateIncomingAccesses(FEXCore::IR::IREmitter *IREmit, ContextInfo *LocalInfo, BlockInfo *Block) {
+  using namespace FEXCore;
+  using namespace FEXCore::IR;
+
+  ResetClassificationAccesses(LocalInfo);
+
+  if (Block->Predecessors.empty()) {
+    return;
+  }
+
+  // Only inherit values once every incoming edge has been walked
+  // Loop headers see their back-edge late, so nothing is carried around a loop
+  auto CurrentIR = IREmit->ViewIR();
+  std::vector<BlockInfo*> Predecessors;
+  for (auto Pred : Block->Predecessors) {
+    auto PredBlock = &OffsetToBlockMap.at(CurrentIR.GetID(Pred));
+    if (!PredBlock->Visited) {
+      return;
+    }
+    Predecessors.emplace_back(PredBlock);
+  }
+
+  auto &Members = LocalInfo->ClassificationInfo;
+  for (size_t i = 0; i < Members.size(); ++i) {
+    auto const &First = Predecessors[0]->OutgoingAccesses[i];
+    if (First.Accessed != ACCESS_WRITE && First.Accessed != ACCESS_READ) {
+      continue;
+    }
+
+    if (SkipStaticRegisters && IsStaticRegisterMember(First.Class.Offset)) {
+      continue;
+    }
+
+    if (CurrentIR.GetOp<IROp_Header>(First.Node)->Op == OP_INLINECONSTANT) {
+      continue;
+    }
+
+    // Stores can implicitly truncate, only carry values that match the member exactly
+    if (!IsFlagMember(First.Class.Offset) && IREmit->GetOpSize(First.Node) != First.AccessSize) {
+      continue;
+    }
+
+    bool Matches = std::all_of(Predecessors.begin() + 1, Predecessors.end(), [&](BlockInfo *Pred) {
+      auto const &Other = Pred->OutgoingAccesses[i];
+      return (Other.Accessed == ACCESS_WRITE || Other.Accessed == ACCESS_READ) &&
+             Other.AccessRegClass == First.AccessRegClass &&
+             Other.AccessOffset == First.AccessOffset &&
+             Other.AccessSize == First.AccessSize &&
+             Other.Node == First.Node;
+    });
+
+    if (!Matches) {
+      continue;
+    }
+
+    // Treat it as a read so we never remove a store that lives in another block
+    Members[i].Accessed = ACCESS_READ;
+    Members[i].AccessRegClass = First.AccessRegClass;
+    Members[i].AccessOffset = First.AccessOffset;
+    Members[i].AccessSize = First.AccessSize;
+    Members[i].Node = First.Node;
+    Members[i].StoreNode = nullptr;
+    Members[i].Incoming = true;
+  }
+}
+
+bool RCLSE::PromoteAcrossBlocks(FEXCore::IR::OrderedNode *Node, FEXCore::IR::RegisterClassType Class) {
+  if (PromotedNodes.contains(Node)) {
+    return true;
+  }
+
+  size_t &Promoted = Class == FEXCore::IR::FPRClass ? PromotedFPRs : PromotedGPRs;
+  size_t MaxPromoted = Class == FEXCore::IR::FPRClass ? FEXCore::IR::MaxCrossBlockFPRs : FEXCore::IR::MaxCrossBlockGPRs;
+  if (Promoted >= MaxPromoted) {
+    return false;
+  }
+
+  ++Promoted;
+  PromotedNodes.insert(Node);
+  return true;
+}
+
 /**
  * @brief This pass removes redundant pairs of storecontext and loadcontext ops
  *
@@ -419,13 +580,22 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
   auto CurrentIR = IREmit->ViewIR();
   auto OriginalWriteCursor = IREmit->GetWriteCursor();
 
-  // XXX: Walk the list and calculate the control flow
-
   ContextInfo &LocalInfo = ClassifiedStruct;
 
+  for (auto &[ID, Block] : OffsetToBlockMap) {
+    Block.Visited = false;
+  }
+
   for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    BlockInfo *CurrentBlock{};
 
-    ResetClassificationAccesses(&LocalInfo);
+    if (Multiblock) {
+      CurrentBlock = &OffsetToBlockMap.at(CurrentIR.GetID(BlockNode));
+      CalculateIncomingAccesses(IREmit, &LocalInfo, CurrentBlock);
+    }
+    else {
+      ResetClassificationAccesses(&LocalInfo);
+    }
 
     for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
       if (IROp->Op == OP_STORECONTEXT) {
@@ -461,6 +631,7 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
         LastAccessType LastAccess = Info->Accessed;
         OrderedNode *LastNode = Info->Node;
         OrderedNode *LastStoreNode = Info->StoreNode;
+        bool LastIncoming = Info->Incoming;
         RecordAccess(Info, Op->Class, Op->Offset, IROp->Size, ACCESS_READ, CodeNode);
 
         if ((LastAccess == ACCESS_WRITE || LastAccess == ACCESS_PARTIAL_WRITE) &&
@@ -535,7 +706,8 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
                  LastClass == Op->Class &&
                  LastOffset == Op->Offset &&
                  LastSize == IROp->Size &&
-                 (Info->Accessed == ACCESS_READ || Info->Accessed == ACCESS_PARTIAL_READ)) {
+                 (Info->Accessed == ACCESS_READ || Info->Accessed == ACCESS_PARTIAL_READ) &&
+                 (!LastIncoming || PromoteAcrossBlocks(LastNode, LastClass))) {
           // Did we read and then read again?
           IREmit->ReplaceAllUsesWith(CodeNode, LastNode);
           RecordAccess(Info, Op->Class, Op->Offset, IROp->Size, ACCESS_READ, LastNode);
@@ -583,6 +755,7 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
         auto Info = FindMemberInfo(&LocalInfo, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag, 1);
         LastAccessType LastAccess = Info->Accessed;
         OrderedNode *LastNode = Info->Node;
+        bool LastIncoming = Info->Incoming;
 
         if (LastAccess == ACCESS_WRITE) { // 1 byte so always a full write
           // If the last store matches this load value then we can replace the loaded value with the previous valid one
@@ -591,17 +764,29 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
           RecordAccess(Info, FEXCore::IR::GPRClass, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag, 1, ACCESS_READ, LastNode);
           Changed = true;
         }
-        else if (LastAccess == ACCESS_READ) {
+        else if (LastAccess == ACCESS_READ &&
+                 (!LastIncoming || PromoteAcrossBlocks(LastNode, FEXCore::IR::GPRClass))) {
           IREmit->ReplaceAllUsesWith(CodeNode, LastNode);
           RecordAccess(Info, FEXCore::IR::GPRClass, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag, 1, ACCESS_READ, LastNode);
           Changed = true;
         }
       }
       else if (IROp->Op == OP_STORECONTEXTINDEXED ||
-               IROp->Op == OP_LOADCONTEXTINDEXED) {
+               IROp->Op == OP_LOADCONTEXTINDEXED ||
+               IROp->Op == OP_CALCULATEDEFERREDFLAGS) {
         // We can't track through these
         ResetClassificationAccesses(&LocalInfo);
       }
+      else if (IROp->Op == OP_SYSCALL ||
+               IROp->Op == OP_THUNK) {
+        // These can read or modify the context behind our back, so stores before them must stay
+        ResetClassificationAccesses(&LocalInfo);
+      }
+    }
+
+    if (CurrentBlock) {
+      CurrentBlock->OutgoingAccesses = LocalInfo.ClassificationInfo;
+      CurrentBlock->Visited = true;
     }
   }
 
@@ -610,17 +795,234 @@ bool RCLSE::RedundantStoreLoadElimination(FEXCore::IR::IREmitter *IREmit) {
   return Changed;
 }
 
+template<typename Func>
+void RCLSE::VisitLivenessAccesses(FEXCore::IR::IROp_Header *IROp, Func Visit) {
+  using namespace FEXCore;
+  using namespace FEXCore::IR;
+
+  auto MemberIndex = [this](ContextMemberInfo *Info) -> size_t {
+    return Info - ClassifiedStruct.ClassificationInfo.data();
+  };
+
+  auto SpansMembers = [](ContextMemberInfo *Info, uint32_t Offset, uint8_t Size) {
+    return (Offset + Size) > (Info->Class.Offset + Info->Class.Size);
+  };
+
+  switch (IROp->Op) {
+    case OP_LOADCONTEXT: {
+      auto Op = IROp->C<IR::IROp_LoadContext>();
+      auto Info = FindMemberInfo(&ClassifiedStruct, Op->Offset, IROp->Size);
+      if (SpansMembers(Info, Op->Offset, IROp->Size)) {
+        Visit(LIVENESS_ALL, 0);
+      }
+      else {
+        Visit(LIVENESS_READ, MemberIndex(Info));
+      }
+      break;
+    }
+    case OP_STORECONTEXT: {
+      auto Op = IROp->C<IR::IROp_StoreContext>();
+      auto Info = FindMemberInfo(&ClassifiedStruct, Op->Offset, IROp->Size);
+      if (SpansMembers(Info, Op->Offset, IROp->Size)) {
+        Visit(LIVENESS_ALL, 0);
+      }
+      else {
+        Visit(IROp->Size == Info->Class.Size ? LIVENESS_WRITE : LIVENESS_PARTIAL_WRITE, MemberIndex(Info));
+      }
+      break;
+    }
+    case OP_LOADFLAG: {
+      auto Op = IROp->C<IR::IROp_LoadFlag>();
+      Visit(LIVENESS_READ, MemberIndex(FindMemberInfo(&ClassifiedStruct, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag, 1)));
+      break;
+    }
+    case OP_STOREFLAG: {
+      auto Op = IROp->C<IR::IROp_StoreFlag>();
+      Visit(LIVENESS_WRITE, MemberIndex(FindMemberInfo(&ClassifiedStruct, offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag, 1)));
+      break;
+    }
+    case OP_INVALIDATEFLAGS: {
+      auto Op = IROp->C<IR::IROp_InvalidateFlags>();
+      // Invalidated flags are undefined, nothing can depend on the previous value
+      for (unsigned F = 0; F < 32; F++) {
+        if (Op->Flags & (1ULL << F)) {
+          Visit(LIVENESS_WRITE, MemberIndex(FindMemberInfo(&ClassifiedStruct, offsetof(FEXCore::Core::CPUState, flags[0]) + F, 1)));
+        }
+      }
+      break;
+    }
+    // Side effects that never look at the context
+    case OP_DUMMY:
+    case OP_BEGINBLOCK:
+    case OP_ENDBLOCK:
+    case OP_JUMP:
+    case OP_CONDJUMP:
+    case OP_FENCE:
+    case OP_SETROUNDINGMODE:
+    case OP_F80LOADFCW:
+    case OP_PRINT:
+    case OP_STOREMEM:
+    case OP_STOREMEMTSO:
+    case OP_VSTOREMEMELEMENT:
+    case OP_CAS:
+    case OP_CASPAIR:
+    case OP_ATOMICADD:
+    case OP_ATOMICSUB:
+    case OP_ATOMICAND:
+    case OP_ATOMICOR:
+    case OP_ATOMICXOR:
+    case OP_ATOMICSWAP:
+    case OP_ATOMICFETCHADD:
+    case OP_ATOMICFETCHSUB:
+    case OP_ATOMICFETCHAND:
+    case OP_ATOMICFETCHOR:
+    case OP_ATOMICFETCHXOR:
+      break;
+    default:
+      // Exits, syscalls, thunks and indexed accesses can observe anything
+      if (IR::HasSideEffects(IROp->Op)) {
+        Visit(LIVENESS_ALL, 0);
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Removes context stores that are overwritten on every path before anything can read them
+ *
+ * Liveness of each context member is calculated over the whole function. A store is dead when
+ * the member is overwritten later in the block, or when it isn't live out of the block.
+ * Blocks without successors leave the function, so everything is live out of them.
+ */
+bool RCLSE::DeadStoreElimination(FEXCore::IR::IREmitter *IREmit) {
+  using namespace FEXCore;
+  using namespace FEXCore::IR;
+
+  bool Changed = false;
+  auto CurrentIR = IREmit->ViewIR();
+
+  std::vector<std::pair<OrderedNode*, BlockInfo*>> Blocks;
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    BlockInfo *Block = &OffsetToBlockMap.at(CurrentIR.GetID(BlockNode));
+    ContextMemberSet Decided;
+
+    Block->Uses.reset();
+    Block->Defines.reset();
+    Block->LiveIn.reset();
+    Block->LiveOut.reset();
+
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+      VisitLivenessAccesses(IROp, [&](LivenessAccessType Access, size_t Member) {
+        if (Access == LIVENESS_ALL) {
+          Block->Uses |= ~Decided;
+          Decided.set();
+        }
+        else if (!Decided[Member] && Access != LIVENESS_PARTIAL_WRITE) {
+          (Access == LIVENESS_READ ? Block->Uses : Block->Defines).set(Member);
+          Decided.set(Member);
+        }
+      });
+    }
+
+    Blocks.emplace_back(BlockNode, Block);
+  }
+
+  // Walking backwards converges quickly, loops need a few extra rounds
+  bool LivenessChanged = true;
+  while (LivenessChanged) {
+    LivenessChanged = false;
+
+    for (auto it = Blocks.rbegin(); it != Blocks.rend(); ++it) {
+      BlockInfo *Block = it->second;
+      ContextMemberSet LiveOut;
+
+      if (Block->Successors.empty()) {
+        LiveOut.set();
+      }
+
+      for (auto Successor : Block->Successors) {
+        LiveOut |= OffsetToBlockMap.at(CurrentIR.GetID(Successor)).LiveIn;
+      }
+
+      ContextMemberSet LiveIn = Block->Uses | (LiveOut & ~Block->Defines);
+
+      if (LiveIn != Block->LiveIn || LiveOut != Block->LiveOut) {
+        Block->LiveIn = LiveIn;
+        Block->LiveOut = LiveOut;
+        LivenessChanged = true;
+      }
+    }
+  }
+
+  std::vector<std::pair<size_t, OrderedNode*>> PendingStores;
+
+  for (auto [BlockNode, Block] : Blocks) {
+    PendingStores.clear();
+
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+      bool IsStore = IROp->Op == OP_STORECONTEXT || IROp->Op == OP_STOREFLAG;
+
+      VisitLivenessAccesses(IROp, [&](LivenessAccessType Access, size_t Member) {
+        if (Access == LIVENESS_ALL) {
+          PendingStores.clear();
+          return;
+        }
+
+        auto FirstStore = std::stable_partition(PendingStores.begin(), PendingStores.end(), [Member](auto const &Store) {
+          return Store.first != Member;
+        });
+
+        if (Access == LIVENESS_WRITE) {
+          // Fully overwritten before anything could read it
+          for (auto Store = FirstStore; Store != PendingStores.end(); ++Store) {
+            IREmit->Remove(Store->second);
+            Changed = true;
+          }
+        }
+
+        if (Access != LIVENESS_PARTIAL_WRITE) {
+          PendingStores.erase(FirstStore, PendingStores.end());
+        }
+
+        if (IsStore) {
+          PendingStores.emplace_back(Member, CodeNode);
+        }
+      });
+    }
+
+    for (auto [Member, StoreNode] : PendingStores) {
+      if (!Block->LiveOut[Member]) {
+        IREmit->Remove(StoreNode);
+        Changed = true;
+      }
+    }
+  }
+
+  return Changed;
+}
+
 bool RCLSE::Run(FEXCore::IR::IREmitter *IREmit) {
-  // XXX: We don't do cross-block optimizations yet
-  //CalculateControlFlowInfo(IREmit);
+  CalculateControlFlowInfo(IREmit);
+  Multiblock = OffsetToBlockMap.size() > 1;
+
+  PromotedNodes.clear();
+  PromotedGPRs = 0;
+  PromotedFPRs = 0;
+
   bool Changed = false;
-  
+
   // Run up to 5 times
   for( int i = 0; i < 5 && RedundantStoreLoadElimination(IREmit); i++) {
     Changed = true;
     DCE->Run(IREmit);
   }
 
+  if (Multiblock && DeadStoreElimination(IREmit)) {
+    Changed = true;
+    DCE->Run(IREmit);
+  }
+
   return Changed;
 }
 
@@ -628,8 +1030,8 @@ bool RCLSE::Run(FEXCore::IR::IREmitter *IREmit) {
 
 namespace FEXCore::IR {
 
-FEXCore::IR::Pass* CreateContextLoadStoreElimination() {
-  return new RCLSE{};
+FEXCore::IR::Pass* CreateContextLoadStoreElimination(bool StaticRegisterAllocation) {
+  return new RCLSE{StaticRegisterAllocation};
 }
 
 }
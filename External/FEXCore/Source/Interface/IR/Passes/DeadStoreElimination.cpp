@@ -1,6 +1,8 @@
 #include "Interface/IR/PassManager.h"
 #include "Interface/Core/OpcodeDispatcher.h"
 
+#include <FEXCore/Core/X86Enums.h>
+
 namespace FEXCore::IR {
 
 constexpr int PropagationRounds = 5;
@@ -154,6 +156,16 @@ bool DeadStoreElimination::Run(IREmitter *IREmit) {
           auto& BlockInfo = InfoMap[BlockNode];
 
           BlockInfo.flag.reads |= 1UL << Op->Flag;
+        } else if (IROp->Op == OP_CALCULATEDEFERREDFLAGS) {
+          auto& BlockInfo = InfoMap[BlockNode];
+
+          // Without a deferred producer the flags are left alone, so stores before this stay live
+          BlockInfo.flag.reads |= (1UL << FEXCore::X86State::RFLAG_CF_LOC) |
+                                  (1UL << FEXCore::X86State::RFLAG_PF_LOC) |
+                                  (1UL << FEXCore::X86State::RFLAG_AF_LOC) |
+                                  (1UL << FEXCore::X86State::RFLAG_ZF_LOC) |
+                                  (1UL << FEXCore::X86State::RFLAG_SF_LOC) |
+                                  (1UL << FEXCore::X86State::RFLAG_OF_LOC);
         } else if (IROp->Op == OP_STORECONTEXT) {
           auto Op = IROp->C<IR::IROp_StoreContext>();
 
@@ -149,7 +149,8 @@ bool IRValidation::Run(IREmitter *IREmit) {
       NodeIsLive.Set(ID);
 
       switch (IROp->Op) {
-        case IR::OP_EXITFUNCTION: {
+        case IR::OP_EXITFUNCTION:
+        case IR::OP_GUESTRETURN: {
           CurrentBlock->HasExit = true;
         break;
         }
@@ -238,6 +239,7 @@ bool IRValidation::Run(IREmitter *IREmit) {
         auto Op = GetOp(CodeCurrent);
         switch (Op) {
           case OP_EXITFUNCTION:
+          case OP_GUESTRETURN:
           case OP_JUMP:
           case OP_CONDJUMP:
           case OP_BREAK:
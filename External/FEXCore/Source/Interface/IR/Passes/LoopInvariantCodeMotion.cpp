@@ -0,0 +1,596 @@
+#include "Interface/IR/Passes.h"
+#include "Interface/IR/PassManager.h"
+#include <FEXCore/Core/CoreState.h>
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+  constexpr uint32_t NoBlock = ~0U;
+
+  struct ContextRange {
+    uint32_t Offset;
+    uint32_t Size;
+
+    bool Overlaps(ContextRange const &rhs) const {
+      return Offset < (rhs.Offset + rhs.Size) && rhs.Offset < (Offset + Size);
+    }
+  };
+
+  bool IsStaticRegisterMember(size_t Offset) {
+    return (Offset >= offsetof(FEXCore::Core::CPUState, gregs[0]) && Offset < offsetof(FEXCore::Core::CPUState, gregs[16])) ||
+           (Offset >= offsetof(FEXCore::Core::CPUState, xmm[0][0]) && Offset < offsetof(FEXCore::Core::CPUState, xmm[16][0]));
+  }
+
+  struct LoopInfo {
+    uint32_t Header;
+    std::vector<bool> Body; ///< Indexed by block, true for every block of the natural loop
+    size_t NumBlocks;
+  };
+}
+
+namespace FEXCore::IR {
+
+/**
+ * @brief Hoists loop invariant values out of the loops of a multiblock function
+ *
+ * Loops are found from the backedges of the CFG, branches to a block that dominates the branch.
+ * Pure ops whose arguments are all defined outside of the loop, and context loads of members
+ * nothing in the loop writes to, are moved to a preheader that runs once before the loop is entered.
+ *
+ * Anything hoisted is live across blocks, which the RA can't spill, so the hoisted values share
+ * the same per function budget as the values RCLSE promotes across blocks.
+ */
+class LoopInvariantCodeMotion final : public FEXCore::IR::Pass {
+public:
+  LoopInvariantCodeMotion(bool StaticRegisterAllocation)
+    : SkipStaticRegisters {StaticRegisterAllocation} {
+  }
+
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  bool SkipStaticRegisters;
+
+  std::vector<OrderedNode*> Blocks;          ///< Blocks in layout order
+  std::vector<OrderedNode*> Terminators;     ///< Jump or CondJump ending each block, if any
+  std::vector<std::vector<uint32_t>> Successors;
+  std::vector<std::vector<uint32_t>> Predecessors;
+  std::vector<std::vector<bool>> Dominators;
+  std::unordered_map<OrderedNode*, uint32_t> BlockIndex;
+  std::vector<uint32_t> NodeBlock;           ///< Block each SSA value is defined in
+  std::vector<std::vector<OrderedNode*>> Users;
+
+  void Analyze(IRListView *CurrentIR);
+  std::vector<LoopInfo> FindLoops() const;
+  bool HoistLoop(IREmitter *IREmit, IRListView *CurrentIR, LoopInfo const &Loop);
+  OrderedNode *GetPreheader(IREmitter *IREmit, IRListView *CurrentIR, LoopInfo const &Loop);
+
+  static bool IsHoistable(IROps Op);
+  static RegisterClassType GetClass(IROp_Header const *IROp);
+};
+
+bool LoopInvariantCodeMotion::IsHoistable(IROps Op) {
+  switch (Op) {
+    // Structural ops
+    case OP_IRHEADER:
+    case OP_CODEBLOCK:
+    case OP_PHI:
+    case OP_PHIVALUE:
+    // Only cheap to keep next to their user
+    case OP_CONSTANT:
+    case OP_INLINECONSTANT:
+    case OP_INLINEENTRYPOINTOFFSET:
+    case OP_ENTRYPOINTOFFSET:
+    case OP_VECTORZERO:
+    case OP_VECTORIMM:
+    // Movs are only emitted to give the RA a fresh value
+    case OP_MOV:
+    // Only exist after RA
+    case OP_LOADREGISTER:
+    case OP_FILLREGISTER:
+    // Return a different result every time
+    case OP_CYCLECOUNTER:
+    case OP_CPUID:
+    case OP_GETHOSTFLAG:
+    case OP_GETROUNDINGMODE:
+    // Guest memory can be written by other threads, spin loops rely on reloading it
+    case OP_LOADMEM:
+    case OP_LOADMEMTSO:
+    case OP_VLOADMEMELEMENT:
+    case OP_LOADCONTEXTINDEXED:
+    // Can fault, and must only do so if the loop would have run them
+    case OP_DIV:
+    case OP_UDIV:
+    case OP_REM:
+    case OP_UREM:
+    case OP_LDIV:
+    case OP_LUDIV:
+    case OP_LREM:
+    case OP_LUREM:
+      return false;
+    default:
+      return !IR::HasSideEffects(Op);
+  }
+}
+
+RegisterClassType LoopInvariantCodeMotion::GetClass(IROp_Header const *IROp) {
+  RegisterClassType Class = IR::GetRegClass(IROp->Op);
+  if (Class != ComplexClass) {
+    return Class;
+  }
+
+  switch (IROp->Op) {
+    case OP_LOADCONTEXT:
+      return IROp->C<IROp_LoadContext>()->Class;
+    case OP_LOADCONTEXTINDEXED:
+      return IROp->C<IROp_LoadContextIndexed>()->Class;
+    case OP_LOADMEM:
+    case OP_LOADMEMTSO:
+      return IROp->C<IROp_LoadMem>()->Class;
+    default:
+      return GPRClass;
+  }
+}
+
+void LoopInvariantCodeMotion::Analyze(IRListView *CurrentIR) {
+  Blocks.clear();
+  Terminators.clear();
+  BlockIndex.clear();
+
+  NodeBlock.assign(CurrentIR->GetSSACount(), NoBlock);
+  Users.assign(CurrentIR->GetSSACount(), {});
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR->GetBlocks()) {
+    uint32_t Index = Blocks.size();
+    BlockIndex[BlockNode] = Index;
+    Blocks.emplace_back(BlockNode);
+    Terminators.emplace_back(nullptr);
+
+    for (auto [CodeNode, IROp] : CurrentIR->GetCode(BlockNode)) {
+      NodeBlock[CurrentIR->GetID(CodeNode)] = Index;
+
+      if (IROp->Op == OP_JUMP || IROp->Op == OP_CONDJUMP) {
+        Terminators[Index] = CodeNode;
+      }
+
+      uint8_t NumArgs = IR::GetArgs(IROp->Op);
+      for (uint8_t i = 0; i < NumArgs; ++i) {
+        if (!IROp->Args[i].IsInvalid()) {
+          Users[IROp->Args[i].ID()].emplace_back(CodeNode);
+        }
+      }
+    }
+  }
+
+  size_t NumBlocks = Blocks.size();
+  Successors.assign(NumBlocks, {});
+  Predecessors.assign(NumBlocks, {});
+
+  for (uint32_t i = 0; i < NumBlocks; ++i) {
+    if (!Terminators[i]) {
+      continue;
+    }
+
+    auto IROp = CurrentIR->GetOp<IROp_Header>(Terminators[i]);
+    auto AddEdge = [&](OrderedNodeWrapper Target) {
+      uint32_t To = BlockIndex.at(CurrentIR->GetNode(Target));
+      if (std::find(Successors[i].begin(), Successors[i].end(), To) == Successors[i].end()) {
+        Successors[i].emplace_back(To);
+        Predecessors[To].emplace_back(i);
+      }
+    };
+
+    if (IROp->Op == OP_JUMP) {
+      AddEdge(IROp->C<IROp_Jump>()->Target);
+    }
+    else {
+      AddEdge(IROp->C<IROp_CondJump>()->TrueBlock);
+      AddEdge(IROp->C<IROp_CondJump>()->FalseBlock);
+    }
+  }
+
+  // Iterative dominators, the first block is the entry
+  Dominators.assign(NumBlocks, std::vector<bool>(NumBlocks, true));
+  Dominators[0].assign(NumBlocks, false);
+  Dominators[0][0] = true;
+
+  bool Changed = true;
+  while (Changed) {
+    Changed = false;
+    for (uint32_t i = 1; i < NumBlocks; ++i) {
+      std::vector<bool> Dom(NumBlocks, !Predecessors[i].empty());
+      for (auto Pred : Predecessors[i]) {
+        for (uint32_t j = 0; j < NumBlocks; ++j) {
+          Dom[j] = Dom[j] && Dominators[Pred][j];
+        }
+      }
+      Dom[i] = true;
+
+      if (Dom != Dominators[i]) {
+        Dominators[i] = std::move(Dom);
+        Changed = true;
+      }
+    }
+  }
+}
+
+std::vector<LoopInfo> LoopInvariantCodeMotion::FindLoops() const {
+  std::vector<LoopInfo> Loops;
+  size_t NumBlocks = Blocks.size();
+
+  for (uint32_t From = 0; From < NumBlocks; ++From) {
+    for (auto Header : Successors[From]) {
+      if (!Dominators[From][Header]) {
+        continue;
+      }
+
+      // Loops sharing a header are merged in to one
+      auto Loop = std::find_if(Loops.begin(), Loops.end(), [Header](LoopInfo const &Loop) { return Loop.Header == Header; });
+      if (Loop == Loops.end()) {
+        Loop = Loops.insert(Loops.end(), LoopInfo{Header, std::vector<bool>(NumBlocks, false), 1});
+        Loop->Body[Header] = true;
+      }
+
+      // Everything that reaches the backedge without going through the header
+      std::vector<uint32_t> WorkList;
+      if (!Loop->Body[From]) {
+        Loop->Body[From] = true;
+        ++Loop->NumBlocks;
+        WorkList.emplace_back(From);
+      }
+
+      while (!WorkList.empty()) {
+        uint32_t Block = WorkList.back();
+        WorkList.pop_back();
+
+        for (auto Pred : Predecessors[Block]) {
+          if (!Loop->Body[Pred]) {
+            Loop->Body[Pred] = true;
+            ++Loop->NumBlocks;
+            WorkList.emplace_back(Pred);
+          }
+        }
+      }
+    }
+  }
+
+  // Inner loops first so their invariants can keep moving outwards
+  std::stable_sort(Loops.begin(), Loops.end(), [](LoopInfo const &lhs, LoopInfo const &rhs) {
+    return lhs.NumBlocks < rhs.NumBlocks;
+  });
+
+  return Loops;
+}
+
+OrderedNode *LoopInvariantCodeMotion::GetPreheader(IREmitter *IREmit, IRListView *CurrentIR, LoopInfo const &Loop) {
+  uintptr_t ListBegin = CurrentIR->GetListData();
+  OrderedNode *HeaderBlock = Blocks[Loop.Header];
+
+  std::vector<uint32_t> OutsidePreds;
+  for (auto Pred : Predecessors[Loop.Header]) {
+    if (!Loop.Body[Pred]) {
+      OutsidePreds.emplace_back(Pred);
+    }
+  }
+
+  // The entry block is also entered from the dispatcher, so it always needs a new block
+  if (Loop.Header != 0 && OutsidePreds.size() == 1) {
+    auto IROp = CurrentIR->GetOp<IROp_Header>(Terminators[OutsidePreds[0]]);
+    if (IROp->Op == OP_JUMP) {
+      return Terminators[OutsidePreds[0]];
+    }
+  }
+
+  OrderedNode *Preheader;
+  if (Loop.Header == 0) {
+    Preheader = IREmit->CreateCodeNode();
+    HeaderBlock->prepend(ListBegin, Preheader);
+    IREmit->ReplaceNodeArgument(CurrentIR->GetHeaderNode(), 0, Preheader);
+  }
+  else {
+    Preheader = IREmit->CreateNewCodeBlockAfter(Blocks[Loop.Header - 1]);
+  }
+  CurrentIR->GetHeader()->BlockCount++;
+
+  IREmit->SetCurrentCodeBlock(Preheader);
+  auto Jump = IREmit->_Jump(HeaderBlock);
+
+  for (auto Pred : OutsidePreds) {
+    auto Terminator = Terminators[Pred];
+    auto IROp = CurrentIR->GetOp<IROp_Header>(Terminator);
+    uint8_t NumArgs = IR::GetArgs(IROp->Op);
+    for (uint8_t i = 0; i < NumArgs; ++i) {
+      if (CurrentIR->GetNode(IROp->Args[i]) == HeaderBlock) {
+        IREmit->ReplaceNodeArgument(Terminator, i, Preheader);
+      }
+    }
+  }
+
+  return Jump;
+}
+
+bool LoopInvariantCodeMotion::HoistLoop(IREmitter *IREmit, IRListView *CurrentIR, LoopInfo const &Loop) {
+  size_t NumBlocks = Blocks.size();
+
+  // Find everything in the loop that could change the context
+  std::vector<ContextRange> Writes;
+  bool WritesAll = false;
+
+  for (uint32_t Block = 0; Block < NumBlocks; ++Block) {
+    if (!Loop.Body[Block]) {
+      continue;
+    }
+
+    for (auto [CodeNode, IROp] : CurrentIR->GetCode(Blocks[Block])) {
+      switch (IROp->Op) {
+        case OP_BEGINBLOCK:
+        case OP_ENDBLOCK:
+        case OP_JUMP:
+        case OP_CONDJUMP:
+        case OP_EXITFUNCTION:
+        case OP_STOREMEM:
+        case OP_STOREMEMTSO:
+        case OP_VSTOREMEMELEMENT:
+        case OP_FENCE:
+        case OP_CAS:
+        case OP_CASPAIR:
+        case OP_ATOMICADD:
+        case OP_ATOMICSUB:
+        case OP_ATOMICAND:
+        case OP_ATOMICOR:
+        case OP_ATOMICXOR:
+        case OP_ATOMICSWAP:
+        case OP_ATOMICFETCHADD:
+        case OP_ATOMICFETCHSUB:
+        case OP_ATOMICFETCHAND:
+        case OP_ATOMICFETCHOR:
+        case OP_ATOMICFETCHXOR:
+          break;
+
+        case OP_STORECONTEXT: {
+          auto Op = IROp->C<IROp_StoreContext>();
+          Writes.emplace_back(ContextRange{Op->Offset, IROp->Size});
+          break;
+        }
+        case OP_STOREFLAG: {
+          auto Op = IROp->C<IROp_StoreFlag>();
+          Writes.emplace_back(ContextRange{static_cast<uint32_t>(offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag), 1});
+          break;
+        }
+
+        // Float ops can't move across a change of the rounding or precision
+        case OP_SETROUNDINGMODE:
+        case OP_F80LOADFCW:
+          return false;
+
+        default:
+          // Syscalls, thunks, indexed stores and flag invalidation
+          if (IR::HasSideEffects(IROp->Op)) {
+            WritesAll = true;
+          }
+          break;
+      }
+    }
+  }
+
+  auto IsContextInvariant = [&](ContextRange const &Range) {
+    if (WritesAll) {
+      return false;
+    }
+    return std::none_of(Writes.begin(), Writes.end(), [&Range](ContextRange const &Write) { return Write.Overlaps(Range); });
+  };
+
+  auto IsOutside = [&](OrderedNodeWrapper Arg) {
+    uint32_t Block = NodeBlock[Arg.ID()];
+    return Block == NoBlock || !Loop.Body[Block];
+  };
+
+  // Walk the loop in layout order, anything using a value that comes later in the layout stays put
+  std::unordered_set<OrderedNode*> Invariant;
+  std::vector<OrderedNode*> Candidates;
+
+  for (uint32_t Block = 0; Block < NumBlocks; ++Block) {
+    if (!Loop.Body[Block]) {
+      continue;
+    }
+
+    for (auto [CodeNode, IROp] : CurrentIR->GetCode(Blocks[Block])) {
+      if (!IROp->HasDest || GetClass(IROp) == GPRPairClass) {
+        continue;
+      }
+
+      if (IROp->Op == OP_LOADCONTEXT) {
+        auto Op = IROp->C<IROp_LoadContext>();
+        if (SkipStaticRegisters && IsStaticRegisterMember(Op->Offset)) {
+          continue;
+        }
+        if (!IsContextInvariant(ContextRange{Op->Offset, IROp->Size})) {
+          continue;
+        }
+      }
+      else if (IROp->Op == OP_LOADFLAG) {
+        auto Op = IROp->C<IROp_LoadFlag>();
+        if (!IsContextInvariant(ContextRange{static_cast<uint32_t>(offsetof(FEXCore::Core::CPUState, flags[0]) + Op->Flag), 1})) {
+          continue;
+        }
+      }
+      else if (!IsHoistable(IROp->Op)) {
+        continue;
+      }
+
+      bool ArgsInvariant = true;
+      uint8_t NumArgs = IR::GetArgs(IROp->Op);
+      for (uint8_t i = 0; i < NumArgs && ArgsInvariant; ++i) {
+        auto Arg = IROp->Args[i];
+        if (Arg.IsInvalid() || IsOutside(Arg)) {
+          continue;
+        }
+
+        auto ArgNode = CurrentIR->GetNode(Arg);
+        ArgsInvariant = Invariant.contains(ArgNode) || CurrentIR->GetOp<IROp_Header>(ArgNode)->Op == OP_CONSTANT;
+      }
+
+      if (ArgsInvariant) {
+        Invariant.insert(CodeNode);
+        Candidates.emplace_back(CodeNode);
+      }
+    }
+  }
+
+  if (Candidates.empty()) {
+    return false;
+  }
+
+  // Values that already live across blocks take up part of the budget
+  auto CountCrossBlock = [&](std::unordered_set<OrderedNode*> const &Hoisted, size_t *GPRs, size_t *FPRs) {
+    *GPRs = 0;
+    *FPRs = 0;
+
+    for (auto [BlockNode, BlockHeader] : CurrentIR->GetBlocks()) {
+      for (auto [CodeNode, IROp] : CurrentIR->GetCode(BlockNode)) {
+        if (!IROp->HasDest || IROp->Op == OP_CONSTANT) {
+          continue;
+        }
+
+        uint32_t ID = CurrentIR->GetID(CodeNode);
+        bool IsHoisted = Hoisted.contains(CodeNode);
+        bool CrossBlock = std::any_of(Users[ID].begin(), Users[ID].end(), [&](OrderedNode *User) {
+          if (IsHoisted) {
+            return !Hoisted.contains(User);
+          }
+          return NodeBlock[CurrentIR->GetID(User)] != NodeBlock[ID];
+        });
+
+        if (CrossBlock) {
+          ++(GetClass(IROp) == FPRClass ? *FPRs : *GPRs);
+        }
+      }
+    }
+  };
+
+  // Pick the values the loop uses along with what computes them, while they fit in the budget
+  std::unordered_set<OrderedNode*> Hoisted;
+
+  for (auto Root : Candidates) {
+    if (Hoisted.contains(Root)) {
+      continue;
+    }
+
+    uint32_t RootID = CurrentIR->GetID(Root);
+    bool UsedByLoop = std::any_of(Users[RootID].begin(), Users[RootID].end(), [&](OrderedNode *User) {
+      return !Invariant.contains(User);
+    });
+    if (!UsedByLoop) {
+      continue;
+    }
+
+    std::unordered_set<OrderedNode*> Tentative = Hoisted;
+    std::vector<OrderedNode*> WorkList{Root};
+    while (!WorkList.empty()) {
+      auto Node = WorkList.back();
+      WorkList.pop_back();
+      if (!Tentative.insert(Node).second) {
+        continue;
+      }
+
+      auto IROp = CurrentIR->GetOp<IROp_Header>(Node);
+      uint8_t NumArgs = IR::GetArgs(IROp->Op);
+      for (uint8_t i = 0; i < NumArgs; ++i) {
+        if (IROp->Args[i].IsInvalid()) {
+          continue;
+        }
+        auto ArgNode = CurrentIR->GetNode(IROp->Args[i]);
+        if (Invariant.contains(ArgNode)) {
+          WorkList.emplace_back(ArgNode);
+        }
+      }
+    }
+
+    size_t GPRs, FPRs;
+    CountCrossBlock(Tentative, &GPRs, &FPRs);
+    if (GPRs <= MaxCrossBlockGPRs && FPRs <= MaxCrossBlockFPRs) {
+      Hoisted = std::move(Tentative);
+    }
+  }
+
+  if (Hoisted.empty()) {
+    return false;
+  }
+
+  uintptr_t ListBegin = CurrentIR->GetListData();
+  auto Terminator = GetPreheader(IREmit, CurrentIR, Loop);
+
+  // Constants stay in the loop for their other users, hoisted ops get their own copy
+  std::unordered_map<OrderedNode*, OrderedNode*> Constants;
+
+  for (auto Node : Candidates) {
+    if (!Hoisted.contains(Node)) {
+      continue;
+    }
+
+    auto IROp = CurrentIR->GetOp<IROp_Header>(Node);
+    uint8_t NumArgs = IR::GetArgs(IROp->Op);
+    for (uint8_t i = 0; i < NumArgs; ++i) {
+      auto Arg = IROp->Args[i];
+      if (Arg.IsInvalid() || IsOutside(Arg)) {
+        continue;
+      }
+
+      auto ArgNode = CurrentIR->GetNode(Arg);
+      auto ArgOp = CurrentIR->GetOp<IROp_Header>(ArgNode);
+      if (ArgOp->Op != OP_CONSTANT) {
+        continue;
+      }
+
+      auto [It, Inserted] = Constants.try_emplace(ArgNode, nullptr);
+      if (Inserted) {
+        IREmit->SetWriteCursor(CurrentIR->GetNode(Terminator->Header.Previous));
+        It->second = IREmit->_Constant(ArgOp->Size * 8, ArgOp->C<IROp_Constant>()->Constant);
+      }
+      IREmit->ReplaceNodeArgument(Node, i, It->second);
+    }
+
+    Node->Unlink(ListBegin);
+    Terminator->prepend(ListBegin, Node);
+  }
+
+  return true;
+}
+
+bool LoopInvariantCodeMotion::Run(IREmitter *IREmit) {
+  bool Changed = false;
+  std::unordered_set<OrderedNode*> Visited;
+
+  // Hoisting can add blocks, so the CFG is rebuilt after every loop
+  for (;;) {
+    auto CurrentIR = IREmit->ViewIR();
+    Analyze(&CurrentIR);
+
+    auto Loops = FindLoops();
+    auto Loop = std::find_if(Loops.begin(), Loops.end(), [&](LoopInfo const &Loop) {
+      return !Visited.contains(Blocks[Loop.Header]);
+    });
+
+    if (Loop == Loops.end()) {
+      break;
+    }
+
+    Visited.insert(Blocks[Loop->Header]);
+    Changed |= HoistLoop(IREmit, &CurrentIR, *Loop);
+  }
+
+  return Changed;
+}
+
+FEXCore::IR::Pass* CreateLoopInvariantCodeMotion(bool StaticRegisterAllocation) {
+  return new LoopInvariantCodeMotion{StaticRegisterAllocation};
+}
+
+}
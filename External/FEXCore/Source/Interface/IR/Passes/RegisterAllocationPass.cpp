@@ -3,6 +3,7 @@
 #include "Interface/IR/Passes.h"
 #include "Interface/Core/OpcodeDispatcher.h"
 
+#include <algorithm>
 #include <iterator>
 #include <unordered_set>
 
@@ -206,7 +207,8 @@ namespace {
 
   void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount);
 
-  RegisterGraph *AllocateRegisterGraph(uint32_t ClassCount) {
+  // Allocators that don't build an interference graph can skip allocating the nodes for it
+  RegisterGraph *AllocateRegisterGraph(uint32_t ClassCount, bool InterferenceNodes = true) {
     RegisterGraph *Graph = new RegisterGraph{};
 
     // Allocate the register set
@@ -214,7 +216,9 @@ namespace {
     Graph->Set.Classes.resize(ClassCount);
 
     // Allocate default nodes
-    ResetRegisterGraph(Graph, DEFAULT_NODE_COUNT);
+    if (InterferenceNodes) {
+      ResetRegisterGraph(Graph, DEFAULT_NODE_COUNT);
+    }
     return Graph;
   }
 
@@ -250,11 +254,8 @@ namespace {
     delete Graph;
   }
 
-  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount) {
+  void ResetAllocationData(RegisterGraph *Graph, uint64_t NodeCount) {
     NodeCount = AlignUp(NodeCount, sizeof(uint64_t));
-    Graph->Nodes.clear();
-    Graph->Nodes.resize(NodeCount);
-    Graph->VisitedNodePredecessors.clear();
     Graph->AllocData.reset();
     Graph->AllocData.reset((FEXCore::IR::RegisterAllocationData*)malloc(FEXCore::IR::RegisterAllocationData::Size(NodeCount)));
     memset(&Graph->AllocData->Map[0], INVALID_REGCLASS.Raw, NodeCount);
@@ -263,6 +264,14 @@ namespace {
     Graph->NodeCount = NodeCount;
   }
 
+  void ResetRegisterGraph(RegisterGraph *Graph, uint64_t NodeCount) {
+    NodeCount = AlignUp(NodeCount, sizeof(uint64_t));
+    Graph->Nodes.clear();
+    Graph->Nodes.resize(NodeCount);
+    Graph->VisitedNodePredecessors.clear();
+    ResetAllocationData(Graph, NodeCount);
+  }
+
   void SetNodeClass(RegisterGraph *Graph, uint32_t Node, FEXCore::IR::RegisterClassType Class) {
     Graph->AllocData->Map[Node].Class = Class.Val;
   }
@@ -357,6 +366,25 @@ namespace {
     return FEXCore::IR::InvalidClass;
   };
 
+  constexpr uint32_t DEFAULT_REMAT_COST = 1000;
+
+  uint32_t GetRematCost(FEXCore::IR::IROps Op) {
+    using namespace FEXCore;
+    switch (Op) {
+      case IR::OP_CONSTANT: return 1;
+      case IR::OP_LOADFLAG:
+      case IR::OP_LOADCONTEXT: return 10;
+      case IR::OP_LOADREGISTER: return 10;
+      case IR::OP_LOADMEM:
+      case IR::OP_LOADMEMTSO:
+        return 100;
+      case IR::OP_FILLREGISTER: return DEFAULT_REMAT_COST + 1;
+      // We want PHI to be very expensive to spill
+      case IR::OP_PHI: return DEFAULT_REMAT_COST * 10;
+      default: return DEFAULT_REMAT_COST;
+    }
+  }
+
   // Walk the IR and set the node classes
   void FindNodeClasses(RegisterGraph *Graph, FEXCore::IR::IRListView *IR) {
     for (auto [CodeNode, IROp] : IR->GetAllCode()) {
@@ -413,16 +441,10 @@ namespace FEXCore::IR {
       BlockInterferences GlobalBlockInterferences;
 
       void CalculateLiveRange(FEXCore::IR::IRListView *IR);
-      void OptimizeStaticRegisters(FEXCore::IR::IRListView *IR);
       void CalculateBlockInterferences(FEXCore::IR::IRListView *IR);
       void CalculateBlockNodeInterference(FEXCore::IR::IRListView *IR);
       void CalculateNodeInterference(FEXCore::IR::IRListView *IR);
       void AllocateVirtualRegisters();
-      void CalculatePredecessors(FEXCore::IR::IRListView *IR);
-      void RecursiveLiveRangeExpansion(FEXCore::IR::IRListView *IR, uint32_t Node, uint32_t DefiningBlockID, LiveRange *LiveRange, const std::unordered_set<uint32_t> &Predecessors, std::unordered_set<uint32_t> &VisitedPredecessors);
-
-      FEXCore::IR::AllNodesIterator FindFirstUse(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End);
-      FEXCore::IR::AllNodesIterator FindLastUseBefore(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End);
 
       uint32_t FindNodeToSpill(IREmitter *IREmit, RegisterNode *RegisterNode, uint32_t CurrentLocation, LiveRange const *OpLiveRange, int32_t RematCost = -1);
       uint32_t FindSpillSlot(uint32_t Node, FEXCore::IR::RegisterClassType RegisterClass);
@@ -470,7 +492,25 @@ namespace FEXCore::IR {
     return std::move(Graph->AllocData);
   }
 
-  void ConstrainedRAPass::RecursiveLiveRangeExpansion(FEXCore::IR::IRListView *IR, uint32_t Node, uint32_t DefiningBlockID, LiveRange *LiveRange, const std::unordered_set<uint32_t> &Predecessors, std::unordered_set<uint32_t> &VisitedPredecessors) {
+  static void CalculatePredecessors(RegisterGraph *Graph, FEXCore::IR::IRListView *IR) {
+    Graph->BlockPredecessors.clear();
+
+    for (auto [BlockNode, BlockIROp] : IR->GetBlocks()) {
+      auto CodeBlock = BlockIROp->C<IROp_CodeBlock>();
+
+      auto IROp = IR->GetNode(IR->GetNode(CodeBlock->Last)->Header.Previous)->Op(IR->GetData());
+      if (IROp->Op == OP_JUMP) {
+        auto Op = IROp->C<IROp_Jump>();
+        Graph->BlockPredecessors[Op->Target.ID()].insert(IR->GetID(BlockNode));
+      } else if (IROp->Op == OP_CONDJUMP) {
+        auto Op = IROp->C<IROp_CondJump>();
+        Graph->BlockPredecessors[Op->TrueBlock.ID()].insert(IR->GetID(BlockNode));
+        Graph->BlockPredecessors[Op->FalseBlock.ID()].insert(IR->GetID(BlockNode));
+      }
+    }
+  }
+
+  static void RecursiveLiveRangeExpansion(RegisterGraph *Graph, FEXCore::IR::IRListView *IR, uint32_t Node, uint32_t DefiningBlockID, LiveRange *LiveRange, const std::unordered_set<uint32_t> &Predecessors, std::unordered_set<uint32_t> &VisitedPredecessors) {
     for (auto PredecessorId: Predecessors) {
       if (DefiningBlockID != PredecessorId && !VisitedPredecessors.contains(PredecessorId)) {
         // do the magic
@@ -488,7 +528,7 @@ namespace FEXCore::IR {
         LiveRange->Begin = std::min(LiveRange->Begin, Op->Last.ID());
         LiveRange->End = std::max(LiveRange->End, Op->Last.ID());
 
-        RecursiveLiveRangeExpansion(IR, Node, DefiningBlockID, LiveRange, Graph->BlockPredecessors[PredecessorId], VisitedPredecessors);
+        RecursiveLiveRangeExpansion(Graph, IR, Node, DefiningBlockID, LiveRange, Graph->BlockPredecessors[PredecessorId], VisitedPredecessors);
       }
     }
   }
@@ -499,8 +539,6 @@ namespace FEXCore::IR {
     LiveRanges.clear();
     LiveRanges.resize(Nodes);
 
-    constexpr uint32_t DEFAULT_REMAT_COST = 1000;
-
     for (auto [BlockNode, BlockHeader] : IR->GetBlocks()) {
       uint32_t BlockNodeID = IR->GetID(BlockNode);
       for (auto [CodeNode, IROp] : IR->GetCode(BlockNode)) {
@@ -515,20 +553,7 @@ namespace FEXCore::IR {
         }
 
         // Calculate remat cost
-        switch (IROp->Op) {
-          case IR::OP_CONSTANT: LiveRanges[Node].RematCost = 1; break;
-          case IR::OP_LOADFLAG:
-          case IR::OP_LOADCONTEXT: LiveRanges[Node].RematCost = 10; break;
-          case IR::OP_LOADREGISTER: LiveRanges[Node].RematCost = 10; break;
-          case IR::OP_LOADMEM:
-          case IR::OP_LOADMEMTSO:
-            LiveRanges[Node].RematCost = 100;
-            break;
-          case IR::OP_FILLREGISTER: LiveRanges[Node].RematCost = DEFAULT_REMAT_COST + 1; break;
-          // We want PHI to be very expensive to spill
-          case IR::OP_PHI: LiveRanges[Node].RematCost = DEFAULT_REMAT_COST * 10; break;
-          default: LiveRanges[Node].RematCost = DEFAULT_REMAT_COST; break;
-        }
+        LiveRanges[Node].RematCost = GetRematCost(IROp->Op);
 
         // Set this node's block ID
         Graph->Nodes[Node].Head.BlockID = BlockNodeID;
@@ -557,7 +582,7 @@ namespace FEXCore::IR {
             LiveRanges[ArgNode].RematCost = -1;
 
             // Include any blocks this value passes through in the live range
-            RecursiveLiveRangeExpansion(IR, ArgNode, ArgNodeBlockID, &LiveRanges[ArgNode], Graph->BlockPredecessors[BlockNodeID], Graph->VisitedNodePredecessors[ArgNode]);
+            RecursiveLiveRangeExpansion(Graph, IR, ArgNode, ArgNodeBlockID, &LiveRanges[ArgNode], Graph->BlockPredecessors[BlockNodeID], Graph->VisitedNodePredecessors[ArgNode]);
           }
         }
 
@@ -583,7 +608,8 @@ namespace FEXCore::IR {
     }
   }
 
-  void ConstrainedRAPass::OptimizeStaticRegisters(FEXCore::IR::IRListView *IR) {
+  // Shared by the allocators, needs the live ranges with their Global flag already calculated
+  static void OptimizeStaticRegisters(RegisterGraph *Graph, std::vector<LiveRange> &LiveRanges, FEXCore::IR::IRListView *IR) {
 
     // Helpers
 
@@ -1018,7 +1044,7 @@ namespace FEXCore::IR {
     }
   }
 
-  FEXCore::IR::AllNodesIterator ConstrainedRAPass::FindFirstUse(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End) {
+  static FEXCore::IR::AllNodesIterator FindFirstUse(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End) {
     using namespace FEXCore::IR;
     uint32_t SearchID = IREmit->ViewIR().GetID(Node);
 
@@ -1044,7 +1070,7 @@ namespace FEXCore::IR {
     return AllNodesIterator::Invalid();
   }
 
-  FEXCore::IR::AllNodesIterator ConstrainedRAPass::FindLastUseBefore(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End) {
+  static FEXCore::IR::AllNodesIterator FindLastUseBefore(FEXCore::IR::IREmitter *IREmit, FEXCore::IR::OrderedNode* Node, FEXCore::IR::AllNodesIterator Begin, FEXCore::IR::AllNodesIterator End) {
     auto CurrentIR = IREmit->ViewIR();
     uint32_t SearchID = CurrentIR.GetID(Node);
 
@@ -1466,7 +1492,7 @@ namespace FEXCore::IR {
     FindNodeClasses(Graph, &IR);
     CalculateLiveRange(&IR);
     if (OptimizeSRA)
-      OptimizeStaticRegisters(&IR);
+      OptimizeStaticRegisters(Graph, LiveRanges, &IR);
 
     // Linear forward scan based interference calculation is faster for smaller blocks
     // Smarter block based interference calculation is faster for larger blocks
@@ -1483,24 +1509,6 @@ namespace FEXCore::IR {
   }
 
 
-  void ConstrainedRAPass::CalculatePredecessors(FEXCore::IR::IRListView *IR) {
-    Graph->BlockPredecessors.clear();
-
-    for (auto [BlockNode, BlockIROp] : IR->GetBlocks()) {
-      auto CodeBlock = BlockIROp->C<IROp_CodeBlock>();
-
-      auto IROp = IR->GetNode(IR->GetNode(CodeBlock->Last)->Header.Previous)->Op(IR->GetData());
-      if (IROp->Op == OP_JUMP) {
-        auto Op = IROp->C<IROp_Jump>();
-        Graph->BlockPredecessors[Op->Target.ID()].insert(IR->GetID(BlockNode));
-      } else if (IROp->Op == OP_CONDJUMP) {
-        auto Op = IROp->C<IROp_CondJump>();
-        Graph->BlockPredecessors[Op->TrueBlock.ID()].insert(IR->GetID(BlockNode));
-        Graph->BlockPredecessors[Op->FalseBlock.ID()].insert(IR->GetID(BlockNode));
-      }
-    }
-  }
-
   bool ConstrainedRAPass::Run(IREmitter *IREmit) {
     bool Changed = false;
 
@@ -1511,7 +1519,7 @@ namespace FEXCore::IR {
     SpillSlotCount = 0;
     Graph->SpillStack.clear();
 
-    CalculatePredecessors(&IR);
+    CalculatePredecessors(Graph, &IR);
 
     while (1) {
       HadFullRA = true;
@@ -1537,4 +1545,349 @@ namespace FEXCore::IR {
   FEXCore::IR::RegisterAllocationPass* CreateRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA) {
     return new ConstrainedRAPass{CompactionPass, OptimizeSRA};
   }
+
+  /**
+   * @brief Linear scan allocator for when compile time matters more than code quality
+   *
+   * Uses the same live ranges, register set and conflicts as ConstrainedRAPass but never builds an interference graph.
+   * Intervals are walked once in order of their start and get the first register not conflicting with an active interval.
+   * When nothing is free the active interval with the furthest end is spilled, constants are rematerialized instead.
+   * All spill decisions of a scan are applied together before rescanning, rather than one spill per full allocation.
+   */
+  class LinearScanRAPass final : public RegisterAllocationPass {
+    public:
+      LinearScanRAPass(FEXCore::IR::Pass* _CompactionPass, bool OptimizeSRA);
+      ~LinearScanRAPass();
+      bool Run(IREmitter *IREmit) override;
+
+      void AllocateRegisterSet(uint32_t RegisterCount, uint32_t ClassCount) override;
+      void AddRegisters(FEXCore::IR::RegisterClassType Class, uint32_t RegisterCount) override;
+      void AddRegisterConflict(FEXCore::IR::RegisterClassType ClassConflict, uint32_t RegConflict, FEXCore::IR::RegisterClassType Class, uint32_t Reg) override;
+
+      RegisterAllocationData* GetAllocationData() override;
+      std::unique_ptr<RegisterAllocationData, RegisterAllocationDataDeleter> PullAllocationData() override;
+    private:
+      struct SpillDecision {
+        uint32_t Node; ///< Node that gets spilled or rematerialized
+        uint32_t SpillPoint; ///< Node that needed its register
+      };
+
+      RegisterGraph *Graph;
+      FEXCore::IR::Pass* CompactionPass;
+      bool OptimizeSRA;
+
+      std::vector<LiveRange> LiveRanges;
+      std::vector<uint32_t> NodeBlockIDs;
+      std::vector<uint32_t> Intervals;
+      std::vector<uint32_t> Active;
+      std::vector<SpillDecision> Spills;
+
+      void CalculateLiveRange(FEXCore::IR::IRListView *IR);
+      uint32_t GetActiveConflicts(FEXCore::IR::RegisterClassType Class);
+      uint32_t FindNodeToSpill(FEXCore::IR::IRListView *IR, uint32_t Node, FEXCore::IR::RegisterClassType Class);
+      void AllocateVirtualRegisters(FEXCore::IR::IRListView *IR);
+      void SpillRegisters(FEXCore::IR::IREmitter *IREmit);
+  };
+
+  LinearScanRAPass::LinearScanRAPass(FEXCore::IR::Pass* _CompactionPass, bool _OptimizeSRA)
+    : CompactionPass {_CompactionPass}, OptimizeSRA(_OptimizeSRA) {
+  }
+
+  LinearScanRAPass::~LinearScanRAPass() {
+    FreeRegisterGraph(Graph);
+  }
+
+  void LinearScanRAPass::AllocateRegisterSet(uint32_t RegisterCount, uint32_t ClassCount) {
+    LogMan::Throw::A(RegisterCount <= INVALID_REG, "Up to %d regs supported", INVALID_REG);
+    LogMan::Throw::A(ClassCount <= INVALID_CLASS, "Up to %d classes supported", INVALID_CLASS);
+
+    // No interference graph, so no need for the graph nodes
+    Graph = AllocateRegisterGraph(ClassCount, false);
+
+    // Add identity conflicts
+    for (uint32_t Class = 0; Class < INVALID_CLASS; Class++) {
+      for (uint32_t Reg = 0; Reg < INVALID_REG; Reg++) {
+        AddRegisterConflict(RegisterClassType{Class}, Reg, RegisterClassType{Class}, Reg);
+      }
+    }
+  }
+
+  void LinearScanRAPass::AddRegisters(FEXCore::IR::RegisterClassType Class, uint32_t RegisterCount) {
+    LogMan::Throw::A(RegisterCount <= INVALID_REG, "Up to %d regs supported", INVALID_REG);
+
+    AllocatePhysicalRegisters(Graph, Class, RegisterCount);
+  }
+
+  void LinearScanRAPass::AddRegisterConflict(FEXCore::IR::RegisterClassType ClassConflict, uint32_t RegConflict, FEXCore::IR::RegisterClassType Class, uint32_t Reg) {
+    VirtualAddRegisterConflict(Graph, ClassConflict, RegConflict, Class, Reg);
+  }
+
+  RegisterAllocationData* LinearScanRAPass::GetAllocationData() {
+    return Graph->AllocData.get();
+  }
+
+  std::unique_ptr<RegisterAllocationData, RegisterAllocationDataDeleter> LinearScanRAPass::PullAllocationData() {
+    return std::move(Graph->AllocData);
+  }
+
+  void LinearScanRAPass::CalculateLiveRange(FEXCore::IR::IRListView *IR) {
+    using namespace FEXCore;
+    size_t Nodes = IR->GetSSACount();
+    LiveRanges.clear();
+    LiveRanges.resize(Nodes);
+    NodeBlockIDs.clear();
+    NodeBlockIDs.resize(Nodes, ~0U);
+
+    for (auto [BlockNode, BlockHeader] : IR->GetBlocks()) {
+      uint32_t BlockNodeID = IR->GetID(BlockNode);
+      for (auto [CodeNode, IROp] : IR->GetCode(BlockNode)) {
+        uint32_t Node = IR->GetID(CodeNode);
+
+        if (IROp->HasDest) {
+          LogMan::Throw::A(LiveRanges[Node].Begin == ~0U, "Node begin already defined?");
+          LiveRanges[Node].Begin = Node;
+          // Default to ending right where after it starts
+          LiveRanges[Node].End = Node + 1;
+        }
+
+        LiveRanges[Node].RematCost = GetRematCost(IROp->Op);
+        NodeBlockIDs[Node] = BlockNodeID;
+
+        LogMan::Throw::A(IROp->Op != IR::OP_PHI, "Phi nodes not supported");
+
+        uint8_t NumArgs = IR::GetArgs(IROp->Op);
+        for (uint8_t i = 0; i < NumArgs; ++i) {
+          if (IROp->Args[i].IsInvalid()) continue;
+          if (IR->GetOp<IROp_Header>(IROp->Args[i])->Op == OP_INLINECONSTANT) continue;
+          if (IR->GetOp<IROp_Header>(IROp->Args[i])->Op == OP_INLINEENTRYPOINTOFFSET) continue;
+          if (IR->GetOp<IROp_Header>(IROp->Args[i])->Op == OP_IRHEADER) continue;
+          uint32_t ArgNode = IROp->Args[i].ID();
+          LogMan::Throw::A(LiveRanges[ArgNode].Begin != ~0U, "%%ssa%d used by %%ssa%d before defined?", ArgNode, Node);
+
+          auto ArgNodeBlockID = NodeBlockIDs[ArgNode];
+          if (ArgNodeBlockID == BlockNodeID) {
+            LiveRanges[ArgNode].End = Node;
+          } else {
+            LiveRanges[ArgNode].Global = true;
+
+            LiveRanges[ArgNode].Begin = std::min(LiveRanges[ArgNode].Begin, Node);
+            LiveRanges[ArgNode].End = std::max(LiveRanges[ArgNode].End, Node);
+
+            // Can't spill this range, it is MB
+            LiveRanges[ArgNode].RematCost = -1;
+
+            RecursiveLiveRangeExpansion(Graph, IR, ArgNode, ArgNodeBlockID, &LiveRanges[ArgNode], Graph->BlockPredecessors[BlockNodeID], Graph->VisitedNodePredecessors[ArgNode]);
+          }
+        }
+      }
+    }
+  }
+
+  uint32_t LinearScanRAPass::GetActiveConflicts(FEXCore::IR::RegisterClassType Class) {
+    uint32_t RegisterConflicts = 0;
+    for (auto ActiveNode : Active) {
+      RegisterConflicts |= GetConflicts(Graph, Graph->AllocData->Map[ActiveNode], Class);
+    }
+    return RegisterConflicts;
+  }
+
+  uint32_t LinearScanRAPass::FindNodeToSpill(FEXCore::IR::IRListView *IR, uint32_t Node, FEXCore::IR::RegisterClassType Class) {
+    auto [CodeNode, IROp] = IR->at(Node)();
+    uint8_t NumArgs = IR::GetArgs(IROp->Op);
+
+    uint32_t Candidate = ~0U;
+    bool CandidateIsConstant = false;
+
+    for (auto ActiveNode : Active) {
+      auto const &ActiveRange = LiveRanges[ActiveNode];
+
+      // Multiblock ranges are never spilled
+      if (ActiveRange.RematCost == ~0U) {
+        continue;
+      }
+
+      // Spilling this won't free anything that we can use
+      if (!(GetConflicts(Graph, Graph->AllocData->Map[ActiveNode], Class) & Graph->Set.Classes[Class].CountMask)) {
+        continue;
+      }
+
+      // The current op still needs its arguments in registers
+      bool IsArg = false;
+      for (uint8_t i = 0; i < NumArgs; ++i) {
+        if (IROp->Args[i].ID() == ActiveNode) {
+          IsArg = true;
+          break;
+        }
+      }
+
+      if (IsArg) {
+        continue;
+      }
+
+      // Spill the range that ends the furthest away, constants win ties since they are just rematerialized
+      // Preferring constants outright ping-pongs when two constants feed the same op
+      auto [ActiveCodeNode, ActiveIROp] = IR->at(ActiveNode)();
+      bool IsConstant = ActiveIROp->Op == OP_CONSTANT;
+      if (Candidate == ~0U ||
+          ActiveRange.End > LiveRanges[Candidate].End ||
+          (ActiveRange.End == LiveRanges[Candidate].End && IsConstant && !CandidateIsConstant)) {
+        Candidate = ActiveNode;
+        CandidateIsConstant = IsConstant;
+      }
+    }
+
+    return Candidate;
+  }
+
+  void LinearScanRAPass::AllocateVirtualRegisters(FEXCore::IR::IRListView *IR) {
+    Intervals.clear();
+    for (uint32_t i = 0; i < LiveRanges.size(); ++i) {
+      if (LiveRanges[i].Begin != ~0U && Graph->AllocData->Map[i] != INVALID_REGCLASS) {
+        Intervals.emplace_back(i);
+      }
+    }
+
+    // Multiblock ranges can begin before their definition
+    std::sort(Intervals.begin(), Intervals.end(), [this](uint32_t a, uint32_t b) {
+      return LiveRanges[a].Begin < LiveRanges[b].Begin ||
+        (LiveRanges[a].Begin == LiveRanges[b].Begin && a < b);
+    });
+
+    Active.clear();
+    Spills.clear();
+
+    for (auto Node : Intervals) {
+      auto &Range = LiveRanges[Node];
+      auto &CurrentRegAndClass = Graph->AllocData->Map[Node];
+
+      // Ranges are half open, a value whose last use is here can share its register with the result
+      std::erase_if(Active, [&](uint32_t ActiveNode) {
+        return LiveRanges[ActiveNode].End <= Range.Begin;
+      });
+
+      if (!Range.PrefferedRegister.IsInvalid()) {
+        CurrentRegAndClass = Range.PrefferedRegister;
+        Active.emplace_back(Node);
+        continue;
+      }
+
+      FEXCore::IR::RegisterClassType RegClass = FEXCore::IR::RegisterClassType{CurrentRegAndClass.Class};
+      RegisterClass *RAClass = &Graph->Set.Classes[RegClass];
+
+      uint32_t FreeRegisters = (~GetActiveConflicts(RegClass)) & RAClass->CountMask;
+      while (FreeRegisters == 0) {
+        uint32_t SpillNode = FindNodeToSpill(IR, Node, RegClass);
+        LogMan::Throw::A(SpillNode != ~0U, "At %%ssa%d couldn't find a node to spill", Node);
+
+        Spills.emplace_back(SpillDecision{SpillNode, Node});
+        std::erase(Active, SpillNode);
+        FreeRegisters = (~GetActiveConflicts(RegClass)) & RAClass->CountMask;
+      }
+
+      CurrentRegAndClass = PhysicalRegister(RegClass, ffs(FreeRegisters) - 1);
+      Active.emplace_back(Node);
+    }
+
+    HadFullRA = Spills.empty();
+  }
+
+  void LinearScanRAPass::SpillRegisters(FEXCore::IR::IREmitter *IREmit) {
+    using namespace FEXCore;
+
+    auto LastCursor = IREmit->GetWriteCursor();
+
+    // Node IDs stay stable until compaction, so every decision from the scan can be applied in one go
+    for (auto const &Spill : Spills) {
+      auto IR = IREmit->ViewIR();
+      auto [CodeNode, IROp] = IR.at(Spill.SpillPoint)();
+      auto [SpillOrderedNode, SpillIROp] = IR.at(Spill.Node)();
+
+      if (SpillIROp->Op == IR::OP_CONSTANT) {
+        // Constants get rematerialized just before their next use
+        auto ConstantIROp = SpillIROp->C<IR::IROp_Constant>();
+        auto FirstUseLocation = FindFirstUse(IREmit, SpillOrderedNode, IR.at(CodeNode), NodeIterator::Invalid());
+        LogMan::Throw::A(FirstUseLocation != IR::NodeIterator::Invalid(), "At %%ssa%d Spilling Op %%ssa%d but Failure to find op use", Spill.SpillPoint, Spill.Node);
+
+        --FirstUseLocation;
+        auto [FirstUseOrderedNode, _] = FirstUseLocation();
+        IREmit->SetWriteCursor(FirstUseOrderedNode);
+        auto FilledConstant = IREmit->_Constant(ConstantIROp->Constant);
+        IREmit->ReplaceUsesWithAfter(SpillOrderedNode, FilledConstant, FirstUseLocation);
+        continue;
+      }
+
+      FEXCore::IR::RegisterClassType SpillRegClass = FEXCore::IR::RegisterClassType{Graph->AllocData->Map[Spill.Node].Class};
+      // Slots are never shared, spill slot ranges would go stale with the compaction between scans
+      uint32_t SpillSlot = SpillSlotCount++;
+
+      // Spill after the last use before the spill point, or right after the definition if there is none
+      auto LastUseIterator = FindLastUseBefore(IREmit, SpillOrderedNode, NodeIterator::Invalid(), IR.at(CodeNode));
+      if (LastUseIterator != AllNodesIterator::Invalid()) {
+        auto [LastUseNode, LastUseIROp] = LastUseIterator();
+        IREmit->SetWriteCursor(LastUseNode);
+      } else {
+        IREmit->SetWriteCursor(SpillOrderedNode);
+      }
+
+      auto SpillOp = IREmit->_SpillRegister(SpillOrderedNode, SpillSlot, SpillRegClass);
+      SpillOp.first->Header.Size = SpillIROp->Size;
+      SpillOp.first->Header.ElementSize = SpillIROp->ElementSize;
+
+      // Fill just before the first use past the spill
+      auto FirstIter = IR.at(SpillOp.Node);
+      ++FirstIter;
+      auto FirstUseLocation = FindFirstUse(IREmit, SpillOrderedNode, FirstIter, NodeIterator::Invalid());
+      LogMan::Throw::A(FirstUseLocation != NodeIterator::Invalid(), "At %%ssa%d Spilling Op %%ssa%d but Failure to find op use", Spill.SpillPoint, Spill.Node);
+
+      --FirstUseLocation;
+      auto [FirstUseOrderedNode, _] = FirstUseLocation();
+      IREmit->SetWriteCursor(FirstUseOrderedNode);
+
+      auto FilledNode = IREmit->_FillRegister(SpillSlot, SpillRegClass);
+      FilledNode.first->Header.Size = SpillIROp->Size;
+      FilledNode.first->Header.ElementSize = SpillIROp->ElementSize;
+      IREmit->ReplaceUsesWithAfter(SpillOrderedNode, FilledNode, FirstUseLocation);
+    }
+
+    IREmit->SetWriteCursor(LastCursor);
+  }
+
+  bool LinearScanRAPass::Run(IREmitter *IREmit) {
+    bool Changed = false;
+
+    SpillSlotCount = 0;
+
+    while (1) {
+      auto IR = IREmit->ViewIR();
+
+      // Block IDs change with every compaction
+      CalculatePredecessors(Graph, &IR);
+
+      ResetAllocationData(Graph, IR.GetSSACount());
+      Graph->VisitedNodePredecessors.clear();
+      FindNodeClasses(Graph, &IR);
+      CalculateLiveRange(&IR);
+      if (OptimizeSRA)
+        OptimizeStaticRegisters(Graph, LiveRanges, &IR);
+
+      AllocateVirtualRegisters(&IR);
+
+      if (HadFullRA) {
+        break;
+      }
+
+      SpillRegisters(IREmit);
+      Changed = true;
+      // We need to rerun compaction after spilling
+      CompactionPass->Run(IREmit);
+    }
+
+    Graph->AllocData->SpillSlotCount = SpillSlotCount;
+
+    return Changed;
+  }
+
+  FEXCore::IR::RegisterAllocationPass* CreateLinearScanRegisterAllocationPass(FEXCore::IR::Pass* CompactionPass, bool OptimizeSRA) {
+    return new LinearScanRAPass{CompactionPass, OptimizeSRA};
+  }
 }
@@ -0,0 +1,297 @@
+#include "Interface/IR/PassManager.h"
+#include "Interface/IR/Passes/ValueNumberingPass.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/Utils/LogManager.h>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+  // Largest IR op plus the two state epochs appended to it
+  // OP_LAST has no struct and a placeholder size, leave it out
+  constexpr size_t MaxKeySize = *std::max_element(FEXCore::IR::IRSizes.begin(), FEXCore::IR::IRSizes.begin() + FEXCore::IR::OP_LAST) + sizeof(uint32_t) * 2;
+  static_assert(MaxKeySize <= UINT8_MAX, "Value keys store their size in a byte");
+
+  /**
+   * @brief The raw bytes of an IR op with its arguments already forwarded to their leaders
+   *
+   * Ops are zeroed on allocation and packed, so two ops compute the same value when their bytes match
+   */
+  struct ValueKey {
+    uint8_t Size;
+    std::array<uint8_t, MaxKeySize> Data;
+
+    bool operator==(ValueKey const &rhs) const {
+      return Size == rhs.Size && memcmp(Data.data(), rhs.Data.data(), Size) == 0;
+    }
+  };
+
+  struct ValueKeyHash {
+    size_t operator()(ValueKey const &Key) const {
+      return std::hash<std::string_view>{}(std::string_view(reinterpret_cast<char const*>(Key.Data.data()), Key.Size));
+    }
+  };
+
+  enum ValueClass {
+    VALUE_NONE,    ///< Can't be numbered
+    VALUE_PURE,    ///< Result only depends on the arguments
+    VALUE_CONTEXT, ///< Reads the guest context
+    VALUE_MEMORY,  ///< Reads guest memory
+  };
+}
+
+namespace FEXCore::IR {
+
+/**
+ * @brief Block local value numbering
+ *
+ * Replaces any node that computes a value already computed earlier in the same block.
+ * Context and memory loads are numbered together with the number of stores seen before them,
+ * so a load is only reused while nothing could have written to what it read.
+ *
+ * Values aren't reused across blocks since the register allocator can't spill those.
+ */
+class ValueNumbering final : public ValueNumberingPass {
+public:
+  bool Run(IREmitter *IREmit) override;
+
+private:
+  std::unordered_map<ValueKey, OrderedNode*, ValueKeyHash> Values;
+  std::vector<OrderedNode*> Leaders;
+
+  uint32_t ContextEpoch{};
+  uint32_t MemoryEpoch{};
+  uint32_t ControlEpoch{};
+
+  static ValueClass Classify(IROp_Header const *IROp);
+  static bool IsCommutative(IROps Op);
+  void InvalidateState(IROp_Header const *IROp);
+  void BuildKey(IROp_Header const *IROp, ValueClass Class, ValueKey *Key) const;
+};
+
+ValueClass ValueNumbering::Classify(IROp_Header const *IROp) {
+  if (!IROp->HasDest || IR::HasSideEffects(IROp->Op)) {
+    return VALUE_NONE;
+  }
+
+  switch (IROp->Op) {
+    // Structural ops
+    case OP_IRHEADER:
+    case OP_CODEBLOCK:
+    case OP_PHI:
+    case OP_PHIVALUE:
+    // Inline constants are folded in to their single user by ConstProp
+    case OP_INLINECONSTANT:
+    case OP_INLINEENTRYPOINTOFFSET:
+    // Movs are only emitted to give the RA a fresh value
+    case OP_MOV:
+    // Only exist after RA
+    case OP_LOADREGISTER:
+    case OP_FILLREGISTER:
+    // Return a different result every time
+    case OP_CYCLECOUNTER:
+    case OP_CPUID:
+    // TSO loads order against other threads
+    case OP_LOADMEMTSO:
+      return VALUE_NONE;
+
+    case OP_LOADCONTEXT:
+    case OP_LOADCONTEXTINDEXED:
+    case OP_LOADFLAG:
+      return VALUE_CONTEXT;
+
+    case OP_LOADMEM:
+    case OP_VLOADMEMELEMENT:
+      return VALUE_MEMORY;
+
+    default:
+      return VALUE_PURE;
+  }
+}
+
+bool ValueNumbering::IsCommutative(IROps Op) {
+  switch (Op) {
+    case OP_ADD:
+    case OP_MUL:
+    case OP_UMUL:
+    case OP_MULH:
+    case OP_UMULH:
+    case OP_OR:
+    case OP_AND:
+    case OP_XOR:
+    case OP_VAND:
+    case OP_VOR:
+    case OP_VXOR:
+    case OP_VADD:
+    case OP_VUQADD:
+    case OP_VSQADD:
+    case OP_VUMIN:
+    case OP_VSMIN:
+    case OP_VUMAX:
+    case OP_VSMAX:
+    case OP_VUMUL:
+    case OP_VSMUL:
+    case OP_VCMPEQ:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void ValueNumbering::InvalidateState(IROp_Header const *IROp) {
+  switch (IROp->Op) {
+    case OP_BEGINBLOCK:
+    case OP_ENDBLOCK:
+      break;
+
+    case OP_STORECONTEXT:
+    case OP_STORECONTEXTINDEXED:
+    case OP_STOREFLAG:
+    case OP_INVALIDATEFLAGS:
+    case OP_CALCULATEDEFERREDFLAGS:
+      ++ContextEpoch;
+      break;
+
+    case OP_STOREMEM:
+    case OP_STOREMEMTSO:
+    case OP_VSTOREMEMELEMENT:
+    case OP_FENCE:
+    case OP_CAS:
+    case OP_CASPAIR:
+    case OP_ATOMICADD:
+    case OP_ATOMICSUB:
+    case OP_ATOMICAND:
+    case OP_ATOMICOR:
+    case OP_ATOMICXOR:
+    case OP_ATOMICSWAP:
+    case OP_ATOMICFETCHADD:
+    case OP_ATOMICFETCHSUB:
+    case OP_ATOMICFETCHAND:
+    case OP_ATOMICFETCHOR:
+    case OP_ATOMICFETCHXOR:
+      ++MemoryEpoch;
+      break;
+
+    // Changes the rounding and precision every float op depends on
+    case OP_SETROUNDINGMODE:
+    case OP_F80LOADFCW:
+      ++ControlEpoch;
+      break;
+
+    default:
+      // Syscalls, thunks, calls and exits can do anything
+      ++ContextEpoch;
+      ++MemoryEpoch;
+      ++ControlEpoch;
+      break;
+  }
+}
+
+void ValueNumbering::BuildKey(IROp_Header const *IROp, ValueClass Class, ValueKey *Key) const {
+  size_t OpSize = IR::GetSize(IROp->Op);
+  memcpy(Key->Data.data(), IROp, OpSize);
+
+  if (IsCommutative(IROp->Op)) {
+    auto Args = reinterpret_cast<IROp_Header*>(Key->Data.data())->Args;
+    if (Args[0].NodeOffset > Args[1].NodeOffset) {
+      std::swap(Args[0], Args[1]);
+    }
+  }
+
+  // Float ops depend on the rounding mode, so everything is numbered in the current control state
+  std::array<uint32_t, 2> Epochs{ControlEpoch, 0};
+  if (Class == VALUE_CONTEXT) {
+    Epochs[1] = ContextEpoch;
+  }
+  else if (Class == VALUE_MEMORY) {
+    Epochs[1] = MemoryEpoch;
+  }
+
+  memcpy(&Key->Data[OpSize], Epochs.data(), sizeof(Epochs));
+  Key->Size = OpSize + sizeof(Epochs);
+}
+
+bool ValueNumbering::Run(IREmitter *IREmit) {
+  auto CurrentIR = IREmit->ViewIR();
+  uintptr_t ListBegin = CurrentIR.GetListData();
+
+  EliminatedNodeCounts.clear();
+  Leaders.assign(CurrentIR.GetSSACount(), nullptr);
+
+  std::vector<OrderedNode*> Eliminated;
+  bool NeedsFixup = false;
+
+  for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+    uint32_t NumEliminated = 0;
+    Values.clear();
+
+    for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+      // Forward arguments to their leaders first so chains of redundant ops collapse in one walk
+      uint8_t NumArgs = IR::GetArgs(IROp->Op);
+      for (uint8_t i = 0; i < NumArgs; ++i) {
+        auto Leader = Leaders[IROp->Args[i].ID()];
+        if (Leader) {
+          IREmit->ReplaceNodeArgument(CodeNode, i, Leader);
+        }
+      }
+
+      auto Class = Classify(IROp);
+      if (Class == VALUE_NONE) {
+        if (IR::HasSideEffects(IROp->Op)) {
+          InvalidateState(IROp);
+        }
+        continue;
+      }
+
+      ValueKey Key;
+      BuildKey(IROp, Class, &Key);
+
+      auto [It, Inserted] = Values.try_emplace(Key, CodeNode);
+      if (!Inserted) {
+        Leaders[CurrentIR.GetID(CodeNode)] = It->second;
+        Eliminated.emplace_back(CodeNode);
+        ++NumEliminated;
+      }
+    }
+
+    EliminatedNodeCounts.emplace_back(NumEliminated);
+  }
+
+  // A use that was walked before its definition (through a backwards branch) still points at the old node
+  for (auto Node : Eliminated) {
+    NeedsFixup |= Node->GetUses() != 0;
+  }
+
+  if (NeedsFixup) {
+    for (auto [BlockNode, BlockHeader] : CurrentIR.GetBlocks()) {
+      for (auto [CodeNode, IROp] : CurrentIR.GetCode(BlockNode)) {
+        uint8_t NumArgs = IR::GetArgs(IROp->Op);
+        for (uint8_t i = 0; i < NumArgs; ++i) {
+          auto Leader = Leaders[IROp->Args[i].ID()];
+          if (Leader) {
+            IREmit->ReplaceNodeArgument(CodeNode, i, Leader);
+          }
+        }
+      }
+    }
+  }
+
+  for (auto Node : Eliminated) {
+    LogMan::Throw::A(Node->GetUses() == 0, "Eliminated %%ssa%d still has uses", Node->Wrapped(ListBegin).ID());
+    IREmit->Remove(Node);
+  }
+
+  return !Eliminated.empty();
+}
+
+FEXCore::IR::ValueNumberingPass* CreateValueNumberingPass() {
+  return new ValueNumbering{};
+}
+
+}
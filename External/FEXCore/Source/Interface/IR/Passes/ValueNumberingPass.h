@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Interface/IR/PassManager.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace FEXCore::IR {
+
+class ValueNumberingPass : public FEXCore::IR::Pass {
+  public:
+    /**
+     * @brief Returns how many nodes the last run eliminated from each block
+     *
+     * Indexed by the order the blocks appear in the IR, which survives IR compaction
+     */
+    std::vector<uint32_t> const *GetEliminatedNodeCounts() const { return &EliminatedNodeCounts; }
+
+  protected:
+    std::vector<uint32_t> EliminatedNodeCounts;
+};
+
+}
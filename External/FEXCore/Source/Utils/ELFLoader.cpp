@@ -3,8 +3,12 @@
 #include <FEXCore/Utils/LogManager.h>
 #include <cstring>
 #include <elf.h>
+#include <fcntl.h>
 #include <fstream>
 #include <stdint.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
 namespace ELFLoader {
@@ -76,7 +80,8 @@ ELFContainer::ELFContainer(std::string const &Filename, std::string const &RootF
     // If we we are dynamic application then we have an interpreter program header
     // We need to load that ELF instead if it exists
     // We are no longer dynamic since we are executing the interpreter
-    const char *RawString{};
+    // Copied out since loading the interpreter unmaps the file the path lives in
+    std::string RawString{};
     if (Mode == MODE_32BIT) {
       RawString = &RawFile.at(InterpreterHeader._32->p_offset);
     }
@@ -118,28 +123,47 @@ ELFContainer::~ELFContainer() {
   Symbols.clear();
   ProgramHeaders.clear();
   SectionHeaders.clear();
-  RawFile.clear();
+  UnmapFile();
 }
 
-bool ELFContainer::LoadELF(std::string const &Filename) {
-  std::fstream ELFFile;
-  size_t FileSize{0};
-  ELFFile.open(Filename, std::fstream::in | std::fstream::binary);
+void ELFContainer::UnmapFile() {
+  if (RawFile.Data) {
+    munmap(RawFile.Data, RawFile.Size);
+    RawFile = {};
+  }
 
-  if (!ELFFile.is_open())
-    return false;
+  CloseFD();
+}
 
-  LogMan::Throw::A(ELFFile.is_open(), "Failed to open file");
+void ELFContainer::CloseFD() {
+  if (FD != -1) {
+    close(FD);
+    FD = -1;
+  }
+}
 
-  ELFFile.seekg(0, ELFFile.end);
-  FileSize = ELFFile.tellg();
-  ELFFile.seekg(0, ELFFile.beg);
+bool ELFContainer::LoadELF(std::string const &Filename) {
+  int NewFD = open(Filename.c_str(), O_RDONLY | O_CLOEXEC);
+  if (NewFD == -1)
+    return false;
 
-  RawFile.resize(FileSize);
+  struct stat Stat{};
+  if (fstat(NewFD, &Stat) == -1 || Stat.st_size == 0) {
+    close(NewFD);
+    return false;
+  }
 
-  ELFFile.read(&RawFile.at(0), FileSize);
+  // Writable so it behaves like the copy it replaces, private so nothing ever goes back to the file
+  void *Data = mmap(nullptr, Stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, NewFD, 0);
+  if (Data == MAP_FAILED) {
+    close(NewFD);
+    return false;
+  }
 
-  ELFFile.close();
+  // Loading the interpreter replaces the program, the FD is only kept around until its segments are mapped
+  UnmapFile();
+  RawFile = {static_cast<char*>(Data), static_cast<size_t>(Stat.st_size)};
+  FD = NewFD;
 
   InterpreterHeader._64 = nullptr;
 
@@ -277,6 +301,92 @@ void ELFContainer::WriteLoadableSections(MemoryWriter Writer, uint64_t Offset) {
   }
 }
 
+void ELFContainer::MapLoadableSections(SegmentMapper Mapper, MemoryWriter Writer, uint64_t Offset) {
+  struct Segment {
+    uint64_t FileOffset;
+    uint64_t Physical;
+    uint64_t FileSize;
+    uint64_t MemorySize;
+  };
+
+  std::vector<Segment> Segments;
+  for (uint32_t i = 0; i < ProgramHeaders.size(); ++i) {
+    if (Mode == MODE_32BIT) {
+      Elf32_Phdr const *hdr = ProgramHeaders.at(i)._32;
+      if (hdr->p_type == PT_LOAD) {
+        Segments.emplace_back(Segment{hdr->p_offset, hdr->p_paddr, hdr->p_filesz, hdr->p_memsz});
+      }
+    }
+    else {
+      Elf64_Phdr const *hdr = ProgramHeaders.at(i)._64;
+      if (hdr->p_type == PT_LOAD) {
+        Segments.emplace_back(Segment{hdr->p_offset, hdr->p_paddr, hdr->p_filesz, hdr->p_memsz});
+      }
+    }
+  }
+
+  // A page shared between two segments would get clobbered by the second mapping
+  // PT_LOAD is sorted by address so only neighbours need checking
+  SegmentsMapped = FD != -1;
+  for (size_t i = 1; i < Segments.size() && SegmentsMapped; ++i) {
+    uint64_t PreviousEnd = AlignUp(Segments[i - 1].Physical + Segments[i - 1].MemorySize, 4096);
+    if (Segments[i].Physical < PreviousEnd) {
+      SegmentsMapped = false;
+    }
+  }
+
+  if (!SegmentsMapped) {
+    WriteLoadableSections(Writer, Offset);
+    CloseFD();
+    return;
+  }
+
+  for (auto &Segment : Segments) {
+    if (Segment.FileSize == 0) {
+      // Pure bss, the reserved region is already zero
+      continue;
+    }
+
+    if (!Mapper(FD, Segment.FileOffset, Offset + Segment.Physical, Segment.FileSize, Segment.MemorySize)) {
+      Writer(&RawFile.at(Segment.FileOffset), Offset + Segment.Physical, Segment.FileSize);
+    }
+  }
+
+  // PT_TLS is always inside of a PT_LOAD so its initialization image is already in place
+
+  // The mappings hold their own reference to the file
+  CloseFD();
+}
+
+void ELFContainer::ProtectLoadableSections(MemoryProtector Protector, uint64_t Offset) {
+  if (!SegmentsMapped) {
+    return;
+  }
+
+  auto ToProt = [](uint32_t Flags) {
+    return ((Flags & PF_R) ? PROT_READ : 0) |
+           ((Flags & PF_W) ? PROT_WRITE : 0) |
+           ((Flags & PF_X) ? PROT_EXEC : 0);
+  };
+
+  for (uint32_t i = 0; i < ProgramHeaders.size(); ++i) {
+    if (Mode == MODE_32BIT) {
+      Elf32_Phdr const *hdr = ProgramHeaders.at(i)._32;
+      if (hdr->p_type == PT_LOAD) {
+        uint64_t Begin = AlignDown(Offset + hdr->p_paddr, 4096);
+        Protector(Begin, AlignUp(Offset + hdr->p_paddr + hdr->p_memsz, 4096) - Begin, ToProt(hdr->p_flags));
+      }
+    }
+    else {
+      Elf64_Phdr const *hdr = ProgramHeaders.at(i)._64;
+      if (hdr->p_type == PT_LOAD) {
+        uint64_t Begin = AlignDown(Offset + hdr->p_paddr, 4096);
+        Protector(Begin, AlignUp(Offset + hdr->p_paddr + hdr->p_memsz, 4096) - Begin, ToProt(hdr->p_flags));
+      }
+    }
+  }
+}
+
 ELFSymbol const *ELFContainer::GetSymbol(char const *Name) {
   auto Sym = SymbolMap.find(Name);
   if (Sym == SymbolMap.end())
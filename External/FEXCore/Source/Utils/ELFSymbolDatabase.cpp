@@ -275,6 +275,24 @@ void ELFSymbolDatabase::WriteLoadableSections(::ELFLoader::ELFContainer::MemoryW
   HandleRelocations();
 }
 
+void ELFSymbolDatabase::MapLoadableSections(::ELFLoader::ELFContainer::SegmentMapper Mapper, ::ELFLoader::ELFContainer::MemoryWriter Writer, ::ELFLoader::ELFContainer::MemoryProtector Protector) {
+  File->MapLoadableSections(Mapper, Writer, LocalInfo.GuestBase);
+
+  for (size_t i = 0; i < DynamicELFInfo.size(); ++i) {
+    auto ELF = DynamicELFInfo[i]->Container;
+
+    ELF->MapLoadableSections(Mapper, Writer, DynamicELFInfo[i]->GuestBase);
+  }
+
+  // Relocations can land in read only segments, protections go on after
+  HandleRelocations();
+
+  File->ProtectLoadableSections(Protector, LocalInfo.GuestBase);
+  for (size_t i = 0; i < DynamicELFInfo.size(); ++i) {
+    DynamicELFInfo[i]->Container->ProtectLoadableSections(Protector, DynamicELFInfo[i]->GuestBase);
+  }
+}
+
 void ELFSymbolDatabase::HandleRelocations() {
   auto SymbolGetter = [this](char const *SymbolName, uint8_t Table) -> ELFLoader::ELFSymbol* {
     SymbolTableType &TablePtr = SymbolMap;
@@ -35,7 +35,16 @@ namespace FEXCore::Config {
     CONFIG_APP_FILENAME,
     CONFIG_DEBUG_DISABLE_OPTIMIZATION_PASSES,
     CONFIG_AOTIR_GENERATE,
-    CONFIG_AOTIR_LOAD
+    CONFIG_AOTIR_LOAD,
+    CONFIG_SHARED_CODE_CACHE,
+    CONFIG_AOTCODE_GENERATE,
+    CONFIG_AOTCODE_LOAD,
+    CONFIG_COMPILE_THREADS,
+    CONFIG_TIER_UP_THRESHOLD,
+    CONFIG_HUGEPAGES,
+    CONFIG_NUMA_LOCAL,
+    CONFIG_REGISTER_ALLOCATOR,
+    CONFIG_X87_REDUCED_PRECISION,
   };
 
   enum ConfigCore {
@@ -44,6 +53,26 @@ namespace FEXCore::Config {
     CONFIG_CUSTOM,
   };
 
+  // Full stays 1 so configs from when this was a bool keep working
+  enum ConfigSMCChecks {
+    CONFIG_SMC_NONE,
+    CONFIG_SMC_FULL,
+    CONFIG_SMC_MTRACK,
+  };
+
+  enum ConfigHugePages {
+    CONFIG_HUGEPAGES_NONE,
+    CONFIG_HUGEPAGES_THP,
+    CONFIG_HUGEPAGES_HUGETLB,
+  };
+
+  // Tiered uses linear scan for the quick compile of guest threads and the graph allocator for tier up
+  enum ConfigRegisterAllocator {
+    CONFIG_RA_GRAPH,
+    CONFIG_RA_LINEAR_SCAN,
+    CONFIG_RA_TIERED,
+  };
+
   void SetConfig(FEXCore::Context::Context *CTX, ConfigOption Option, uint64_t Config);
   void SetConfig(FEXCore::Context::Context *CTX, ConfigOption Option, std::string const &Config);
   uint64_t GetConfig(FEXCore::Context::Context *CTX, ConfigOption Option);
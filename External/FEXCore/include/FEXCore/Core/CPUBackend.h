@@ -1,6 +1,7 @@
 #pragma once
 #include <stdint.h>
 #include <string>
+#include <vector>
 
 namespace FEXCore {
 
@@ -19,6 +20,7 @@ namespace CPU {
 class InterpreterCore;
 class JITCore;
 class LLVMCore;
+struct Relocation;
 
   class CPUBackend {
   public:
@@ -76,14 +78,54 @@ class LLVMCore;
     }
 
     virtual void ClearCache() {}
+
+    using CodeDeleter = void(*)(void *CodePtr);
+
+    /**
+     * @brief How to free code returned by CompileCode that points in to its IR
+     *
+     * The block's LocalIREntry owns that code so it can't outlive the IR
+     *
+     * @return nullptr if the code lives in the backend's own code buffer
+     */
+    virtual CodeDeleter GetCodeDeleter() { return nullptr; }
+
     virtual void CopyNecessaryDataForCompileThread(CPUBackend *Original) {}
 
+    /**
+     * @brief Relocations of the code returned by the last CompileCode
+     *
+     * @return nullptr if the backend doesn't support relocatable code or the last block can't be relocated
+     */
+    virtual std::vector<Relocation> const *GetRelocations() { return nullptr; }
+
+    /**
+     * @brief Copies previously captured host code in to the code buffer and relocates it for the current thread
+     *
+     * @param Entry - Guest RIP the code is being placed for
+     * @param Code - Host code as returned by CompileCode in an earlier run
+     * @param Relocations - Relocations from GetRelocations in that same run
+     *
+     * @return The executable copy or nullptr if the code can't be used
+     */
+    virtual void *RelocateJITObjectCode(uint64_t Entry, uint8_t const *Code, size_t Size, Relocation const *Relocations, size_t NumRelocations) { return nullptr; }
+
+    /**
+     * @brief Makes the following CompileCode calls emit a decrement of Counter at the block entry
+     *
+     * Used by tiered compilation to find hot blocks. Backends that don't support it just ignore the counter.
+     *
+     * @param Counter - nullptr to stop counting
+     */
+    void SetBlockEntryCounter(int32_t *Counter) { BlockEntryCounter = Counter; }
+
     using AsmDispatch = __attribute__((naked)) void(*)(FEXCore::Core::InternalThreadState *Thread);
     using JITCallback = __attribute__((naked)) void(*)(FEXCore::Core::InternalThreadState *Thread, uint64_t RIP);
 
     JITCallback CallbackPtr{};
   protected:
     AsmDispatch DispatchPtr{};
+    int32_t *BlockEntryCounter{};
   };
 
 }
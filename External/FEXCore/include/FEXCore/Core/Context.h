@@ -236,6 +236,49 @@ namespace FEXCore::Context {
 
   void AddNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, uintptr_t Offset, const std::string& Name);
   void RemoveNamedRegion(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length);
-  void SetAOTIRLoader(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::istream>(const std::string&)> CacheReader);
+
+  /**
+   * @name Guest memory map changes
+   * @brief The frontend reports successful guest mmap, mprotect and munmap calls so the core can keep track of code pages
+   *
+   * The host syscall and its report are bracketed by GuestMemoryChangeBegin and GuestMemoryChangeEnd, background
+   * compiles don't read guest code in between
+   * @{ */
+  void GuestMemoryChangeBegin(FEXCore::Context::Context *CTX);
+  void GuestMemoryChangeEnd(FEXCore::Context::Context *CTX);
+  void GuestMemoryMapped(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, int Prot);
+  void GuestMemoryProtected(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length, int Prot);
+  void GuestMemoryUnmapped(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length);
+  /**  @} */
+
+  /**
+   * @brief The host kernel is about to write guest memory for a syscall
+   *
+   * Code pages in the range that are write protected for SMC detection get their write access back first, the
+   * kernel can't fault in to our handler and would fail the syscall with EFAULT instead
+   */
+  void PrepareGuestMemoryHostWrite(FEXCore::Context::Context *CTX, uintptr_t Base, uintptr_t Length);
+
+  /**
+   * @brief Throws away every translation of guest code in the range
+   *
+   * Only the blocks that overlap the range are erased, the rest of the code cache stays
+   */
+  void InvalidateGuestCodeRange(FEXCore::Context::Context *CTX, uint64_t Base, uint64_t Length);
+
+  /**
+   * @brief Sets the function that opens the AOTIR cache file of a module
+   *
+   * The callback returns a readable fd or -1, FEXCore closes it after mapping the file
+   */
+  void SetAOTIRLoader(FEXCore::Context::Context *CTX, std::function<int(const std::string&)> CacheReader);
   bool WriteAOTIR(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter);
+
+  /**
+   * @brief Sets the function that opens the host code cache file of a module
+   *
+   * The callback returns a readable fd or -1, FEXCore closes it after mapping the file
+   */
+  void SetAOTCodeLoader(FEXCore::Context::Context *CTX, std::function<int(const std::string&)> CacheReader);
+  bool WriteAOTCode(FEXCore::Context::Context *CTX, std::function<std::unique_ptr<std::ostream>(const std::string&)> CacheWriter);
 }
@@ -23,6 +23,15 @@ namespace FEXCore::Core {
       uint32_t base;
     } gdt[32];
     uint16_t FCW;
+    uint16_t : 16;
+    uint32_t : 32; // Ensures the deferred flags are aligned
+
+    // Last arithmetic flag producer whose flags haven't been calculated in to flags yet
+    uint64_t DeferredFlagsRes;
+    uint64_t DeferredFlagsSrc1;
+    uint64_t DeferredFlagsSrc2;
+    uint8_t DeferredFlagsOp;   ///< FEXCore::CPU::DeferredFlagsType, zero when flags is up to date
+    uint8_t DeferredFlagsSize; ///< Operand size in bytes
   };
   static_assert(offsetof(CPUState, xmm) % 16 == 0, "xmm needs to be 128bit aligned!");
 
@@ -48,6 +48,8 @@ namespace Core {
      * @brief Registers a signal handler for the host to handle a signal
      *
      * It's a process level signal handler so one must be careful
+     * Handlers of the same signal are chained, the last one registered runs first and the signal falls through to
+     * the older ones until one returns true
      */
     virtual void RegisterHostSignalHandler(int Signal, HostSignalDelegatorFunction Func) = 0;
     virtual void RegisterFrontendHostSignalHandler(int Signal, HostSignalDelegatorFunction Func) = 0;
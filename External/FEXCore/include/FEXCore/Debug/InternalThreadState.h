@@ -67,8 +67,45 @@ namespace FEXCore::Core {
     std::unique_ptr<FEXCore::IR::IRListView, FEXCore::IR::IRListViewDeleter> IR;
     std::unique_ptr<FEXCore::IR::RegisterAllocationData, FEXCore::IR::RegisterAllocationDataDeleter> RAData;
     std::unique_ptr<FEXCore::Core::DebugData> DebugData;
+    // Backend code that points in to the IR, declared last so it is freed first. See CPUBackend::GetCodeDeleter
+    std::unique_ptr<void, void(*)(void*)> Code {nullptr, nullptr};
   };
 
+  /**
+   * @brief Prediction of where the guest's returns land in host code
+   *
+   * Calls push their guest return address along with the linked exit to it in the calling block.
+   * A return that pops a matching guest address jumps to that exit instead of looking up the address.
+   * The guest stack is the only source of truth, a mismatch or wrapping around just costs a lookup.
+   *
+   * Entries point in to host code, so they need to be dropped whenever code is freed.
+   */
+  struct ReturnStack {
+    constexpr static size_t SIZE = 64;
+    constexpr static size_t MASK = SIZE - 1;
+    constexpr static uint64_t INVALID_GUEST_RIP = ~0ULL;
+
+    struct Entry {
+      uint64_t GuestRIP {INVALID_GUEST_RIP};
+      uintptr_t HostCode{};
+    };
+
+    /**
+     * @brief Drops every prediction
+     *
+     * Only the guest side is cleared, so running code never sees a half cleared entry
+     */
+    void Clear() {
+      for (auto &Entry : Entries) {
+        Entry.GuestRIP = INVALID_GUEST_RIP;
+      }
+    }
+
+    Entry Entries[SIZE];
+    uint64_t Top{}; ///< Index of the last push, wraps around
+  };
+  static_assert(sizeof(ReturnStack::Entry) == 16, "The JITs index entries with a shift");
+
   struct InternalThreadState {
     FEXCore::Core::ThreadState State;
 
@@ -84,6 +121,16 @@ namespace FEXCore::Core {
     std::unique_ptr<FEXCore::CPU::CPUBackend> CPUBackend;
     std::unique_ptr<FEXCore::LookupCache> LookupCache;
 
+    /**
+     * @name JIT thread data
+     * @brief Loaded by generated code through the state register so that code can be shared between threads
+     * @{ */
+    uintptr_t L1Pointer{}; ///< This thread's L1 lookup cache
+    uint32_t SignalHandlerRefCounter{}; ///< Nesting depth of signals and callbacks running on this thread
+    ReturnStack Returns; ///< Guest calls that haven't returned yet
+    /**  @} */
+
+    FEXCore::IR::IRStorage IRStorage; ///< Backs the IR in LocalIRCache, declared first so it outlives the cache
     std::unordered_map<uint64_t, LocalIREntry> LocalIRCache;
 
     std::unique_ptr<FEXCore::Frontend::Decoder> FrontendDecoder;
@@ -96,6 +143,7 @@ namespace FEXCore::Core {
     uint32_t CompileBlockReentrantRefCount{};
     std::shared_ptr<FEXCore::CompileService> CompileService;
     bool IsCompileService{false};
+    bool Recycled{false}; ///< Taken from the idle threads, the compiler state and code are already warm
   };
   static_assert(offsetof(InternalThreadState, State) == 0, "InternalThreadState must have State be the first object");
   static_assert(std::is_standard_layout<InternalThreadState>::value, "This needs to be standard layout");
@@ -5,6 +5,7 @@
 #include <string.h>
 #include <sstream>
 #include <tuple>
+#include <vector>
 
 namespace FEXCore::IR {
 class RegisterAllocationPass;
@@ -465,7 +466,8 @@ public:
 class IRListView;
 class IREmitter;
 
-void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationData *RAData);
+// EliminatedNodes optionally holds the per-block counts from value numbering, printed as comments
+void Dump(std::stringstream *out, IRListView const* IR, IR::RegisterAllocationData *RAData, std::vector<uint32_t> const *EliminatedNodes = nullptr);
 IREmitter* Parse(std::istream *in);
 
 template<typename Type>
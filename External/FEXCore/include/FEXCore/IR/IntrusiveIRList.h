@@ -3,13 +3,14 @@
 #include "FEXCore/IR/IR.h"
 #include <FEXCore/Utils/LogManager.h>
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
 #include <cstring>
+#include <new>
+#include <sys/mman.h>
 #include <tuple>
 #include <vector>
-#include <istream>
-#include <ostream>
 
 namespace FEXCore::IR {
 /**
@@ -25,11 +26,13 @@ class IntrusiveAllocator final {
     IntrusiveAllocator(IntrusiveAllocator &&) = delete;
     IntrusiveAllocator(size_t Size)
       : MemorySize {Size} {
-      Data = reinterpret_cast<uintptr_t>(malloc(Size));
+      // Only reserve the range, pages become resident as the IR grows in to them
+      Data = reinterpret_cast<uintptr_t>(mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0));
+      LogMan::Throw::A(reinterpret_cast<void*>(Data) != MAP_FAILED, "Couldn't reserve IntrusiveAllocator memory");
     }
 
     ~IntrusiveAllocator() {
-      free(reinterpret_cast<void*>(Data));
+      munmap(reinterpret_cast<void*>(Data), MemorySize);
     }
 
     bool CheckSize(size_t Size) {
@@ -51,7 +54,14 @@ class IntrusiveAllocator final {
 
     uintptr_t const Begin() const { return Data; }
 
-    void Reset() { CurrentOffset = 0; }
+    void Reset() {
+      if (CurrentOffset > RESIDENT_SIZE) {
+        // An unusually large list touched more than we normally need, hand those pages back
+        uintptr_t TrimEnd = (Data + CurrentOffset + 4095) & ~4095ULL;
+        madvise(reinterpret_cast<void*>(Data + RESIDENT_SIZE), TrimEnd - (Data + RESIDENT_SIZE), MADV_DONTNEED);
+      }
+      CurrentOffset = 0;
+    }
 
     void CopyData(IntrusiveAllocator const &rhs) {
       CurrentOffset = rhs.CurrentOffset;
@@ -59,11 +69,124 @@ class IntrusiveAllocator final {
     }
 
   private:
+    // Working set that is kept resident between lists
+    constexpr static size_t RESIDENT_SIZE = 1024 * 1024;
+
     size_t CurrentOffset {0};
     size_t MemorySize;
     uintptr_t Data;
 };
 
+/**
+ * @brief Chunked storage for IR lists that are kept around after compiling, like the IR caches
+ *
+ * Copies are bump allocated out of shared chunks instead of doing a malloc each.
+ * Every chunk counts the lists living in it, once the last one is deleted the chunk is either kept
+ * in a small per-thread pool for reuse or unmapped, so clearing a cache returns whole chunks at once.
+ * Lists may be deleted from a different thread than the one that allocated them.
+ */
+class IRStorage final {
+  public:
+    struct Chunk {
+      std::atomic<uint32_t> Refs;
+      size_t Size;
+    };
+
+    IRStorage() = default;
+    IRStorage(IRStorage &&) = delete;
+
+    ~IRStorage() {
+      if (Current) {
+        Release(Current);
+      }
+    }
+
+    /**
+     * @brief Allocates Size bytes, the caller owns a reference to Owner that it needs to Release
+     */
+    void *Allocate(size_t Size, Chunk **Owner) {
+      Size = (Size + 15) & ~15ULL;
+
+      if (Size > MAX_SHARED_ALLOCATION) {
+        // Too large to share a chunk
+        auto Large = MapChunk(HEADER_SIZE + Size);
+        Large->Refs.store(1, std::memory_order_relaxed);
+        *Owner = Large;
+        return reinterpret_cast<uint8_t*>(Large) + HEADER_SIZE;
+      }
+
+      if (!Current || (CurrentOffset + Size) > CHUNK_SIZE) {
+        if (Current) {
+          Release(Current);
+        }
+
+        auto &Pool = GetPool();
+        if (Pool.Chunks.empty()) {
+          Current = MapChunk(CHUNK_SIZE);
+        }
+        else {
+          Current = Pool.Chunks.back();
+          Pool.Chunks.pop_back();
+        }
+
+        // Our own reference, dropped once we move on to the next chunk
+        Current->Refs.store(1, std::memory_order_relaxed);
+        CurrentOffset = HEADER_SIZE;
+      }
+
+      void *Ptr = reinterpret_cast<uint8_t*>(Current) + CurrentOffset;
+      CurrentOffset += Size;
+      Current->Refs.fetch_add(1, std::memory_order_relaxed);
+      *Owner = Current;
+      return Ptr;
+    }
+
+    static void Release(Chunk *Ptr) {
+      if (Ptr->Refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+        return;
+      }
+
+      auto &Pool = GetPool();
+      if (Ptr->Size == CHUNK_SIZE && Pool.Chunks.size() < MAX_POOLED_CHUNKS) {
+        Pool.Chunks.emplace_back(Ptr);
+      }
+      else {
+        munmap(Ptr, Ptr->Size);
+      }
+    }
+
+  private:
+    constexpr static size_t CHUNK_SIZE = 1024 * 1024;
+    constexpr static size_t HEADER_SIZE = (sizeof(Chunk) + 15) & ~15ULL;
+    constexpr static size_t MAX_SHARED_ALLOCATION = CHUNK_SIZE / 4;
+    constexpr static size_t MAX_POOLED_CHUNKS = 4;
+
+    struct ChunkPool {
+      std::vector<Chunk*> Chunks;
+      ~ChunkPool() {
+        for (auto Ptr : Chunks) {
+          munmap(Ptr, Ptr->Size);
+        }
+      }
+    };
+
+    static ChunkPool &GetPool() {
+      thread_local ChunkPool Pool;
+      return Pool;
+    }
+
+    static Chunk *MapChunk(size_t Size) {
+      void *Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      LogMan::Throw::A(Ptr != MAP_FAILED, "Couldn't allocate IR storage");
+      auto NewChunk = new (Ptr) Chunk{};
+      NewChunk->Size = Size;
+      return NewChunk;
+    }
+
+    Chunk *Current{};
+    size_t CurrentOffset{};
+};
+
 class IRListView final {
 public:
   IRListView() = delete;
@@ -86,6 +209,19 @@ public:
     }
   }
 
+  /**
+   * @brief Copies the IR in to one allocation out of Storage
+   */
+  IRListView(IntrusiveAllocator *Data, IntrusiveAllocator *List, IRStorage *Storage) : IsCopy(true) {
+    DataSize = Data->Size();
+    ListSize = List->Size();
+
+    IRData = Storage->Allocate(DataSize + ListSize, &StorageChunk);
+    ListData = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(IRData) + DataSize);
+    memcpy(IRData, reinterpret_cast<void*>(Data->Begin()), DataSize);
+    memcpy(ListData, reinterpret_cast<void*>(List->Begin()), ListSize);
+  }
+
   IRListView(IRListView *Old, bool _IsCopy) : IsCopy(_IsCopy) {
     DataSize = Old->DataSize;
     ListSize = Old->ListSize;
@@ -100,30 +236,23 @@ public:
     }
   }
 
-  IRListView(std::istream& stream) : IsCopy(true) {
-    stream.read((char*)&DataSize, sizeof(DataSize));
-    stream.read((char*)&ListSize, sizeof(ListSize));
-    
-    IRData = malloc(DataSize + ListSize);
-    ListData = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(IRData) + DataSize);
-    stream.read((char*)IRData, DataSize);
-    stream.read((char*)ListData, ListSize);
+  /**
+   * @brief Views IR that is owned by someone else, like a mapped AOTIR cache file
+   */
+  IRListView(void *_IRData, size_t _DataSize, void *_ListData, size_t _ListSize)
+    : IRData(_IRData), ListData(_ListData), DataSize(_DataSize), ListSize(_ListSize), IsCopy(false) {
   }
 
   ~IRListView() {
-    if (IsCopy) {
+    if (StorageChunk) {
+      IRStorage::Release(StorageChunk);
+    }
+    else if (IsCopy) {
       free (IRData);
       // ListData is just offset from IRData
     }
   }
 
-  void Serialize(std::ostream& stream) {
-    stream.write((char*)&DataSize, sizeof(DataSize));
-    stream.write((char*)&ListSize, sizeof(ListSize));
-    stream.write((char*)IRData, DataSize);
-    stream.write((char*)ListData, ListSize);
-  }
-
   IRListView *CreateCopy() {
     return new IRListView(this, true);
   }
@@ -284,6 +413,7 @@ private:
   size_t DataSize;
   size_t ListSize;
   bool IsCopy;
+  IRStorage::Chunk *StorageChunk{};
 };
 
 struct IRListViewDeleter {
@@ -3,6 +3,7 @@
 #include <elf.h>
 #include <functional>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <tuple>
 #include <unordered_map>
@@ -62,6 +63,19 @@ public:
   using MemoryWriter = std::function<void(void *, uint64_t, uint64_t)>;
   void WriteLoadableSections(MemoryWriter Writer, uint64_t Offset = 0);
 
+  // FD, File offset, Physical, File size, Memory size
+  // Returns false if the segment couldn't be mapped and has to be copied in instead
+  using SegmentMapper = std::function<bool(int, uint64_t, uint64_t, uint64_t, uint64_t)>;
+  // Physical, Size, Protection
+  using MemoryProtector = std::function<void(uint64_t, uint64_t, int)>;
+
+  // Maps PT_LOAD segments from the file so pages stay shared with the page cache until written
+  // Copies everything in with the Writer instead if any two segments share a page
+  void MapLoadableSections(SegmentMapper Mapper, MemoryWriter Writer, uint64_t Offset = 0);
+
+  // Applies the segment protections once relocations are written, only after a successful MapLoadableSections
+  void ProtectLoadableSections(MemoryProtector Protector, uint64_t Offset = 0);
+
   ELFSymbol const *GetSymbol(char const *Name);
   ELFSymbol const *GetSymbol(uint64_t Address);
 
@@ -120,7 +134,26 @@ private:
   void PrintInitArray() const;
   void PrintDynamicTable() const;
 
-  std::vector<char> RawFile;
+  // The file is mapped rather than read so parsing only faults in the headers and tables it looks at
+  struct MappedFile {
+    char *Data{};
+    size_t Size{};
+
+    char &at(size_t Offset) const {
+      if (Offset >= Size) {
+        throw std::out_of_range("ELF offset is past the end of the file");
+      }
+      return Data[Offset];
+    }
+  };
+
+  void UnmapFile();
+  void CloseFD();
+
+  MappedFile RawFile;
+  int FD{-1};
+  bool SegmentsMapped{false};
+
   union {
     Elf32_Ehdr _32;
     Elf64_Ehdr _64;
@@ -13,6 +13,7 @@ public:
 
   void MapMemoryRegions(std::function<void*(uint64_t, uint64_t, bool)> Mapper);
   void WriteLoadableSections(::ELFLoader::ELFContainer::MemoryWriter Writer);
+  void MapLoadableSections(::ELFLoader::ELFContainer::SegmentMapper Mapper, ::ELFLoader::ELFContainer::MemoryWriter Writer, ::ELFLoader::ELFContainer::MemoryProtector Protector);
 
   uint64_t DefaultRIP() const;
 
@@ -66,10 +66,56 @@ namespace FEX::ArgLoader {
           .help("Number of physical hardware threads to tell the process we have")
           .set_default(1);
 
+      CPUGroup.add_option("--shared-code-cache")
+        .dest("SharedCodeCache")
+        .action("store_true")
+        .help("Shares compiled code between all guest threads. JIT only")
+        .set_default(false);
+
+      CPUGroup.add_option("--compile-threads")
+        .dest("CompileThreads")
+        .help("Number of background threads that recompile hot blocks with full optimizations. Needs --shared-code-cache")
+        .set_default(0);
+
+      CPUGroup.add_option("--tier-up-threshold")
+        .dest("TierUpThreshold")
+        .help("Number of times a block has to run before it gets recompiled in the background")
+        .set_default(1000);
+
+      CPUGroup.add_option("--huge-pages")
+        .dest("HugePages")
+        .help("Back JIT code and lookup tables with 2MB pages. thp uses transparent huge pages, hugetlb reserved hugetlbfs pages")
+        .choices({"none", "thp", "hugetlb"})
+        .set_default("none");
+
+      CPUGroup.add_option("--numa-local")
+        .dest("NUMALocal")
+        .action("store_true")
+        .help("Places each thread's JIT code and lookup tables on its local NUMA node")
+        .set_default(false);
+
+      CPUGroup.add_option("--register-allocator")
+        .dest("RegisterAllocator")
+        .help("JIT register allocator. linear compiles faster at the cost of code quality, tiered uses it only until blocks tier up")
+        .choices({"graph", "linear", "tiered"})
+        .set_default("graph");
+
+      CPUGroup.add_option("--x87-reduced-precision")
+        .dest("X87ReducedPrecision")
+        .action("store_true")
+        .help("Runs x87 math as 64bit doubles with host FP instructions. Much faster, but loses the 80bit precision and range")
+        .set_default(false);
+
+      CPUGroup.add_option("--smc-checks")
+        .dest("SMCChecksMode")
+        .help("How to detect self modifying code. mtrack write protects code pages, full checks code before execution and is slow")
+        .choices({"none", "mtrack", "full"})
+        .set_default("none");
+
       CPUGroup.add_option("--smc-full-checks")
         .dest("SMCChecks")
         .action("store_true")
-        .help("Checks code for modification before execution. Slow.")
+        .help("Same as --smc-checks=full")
         .set_default(false);
 
       CPUGroup.add_option("--unsafe-no-tso")
@@ -126,6 +172,18 @@ namespace FEX::ArgLoader {
         .action("store_true")
         .set_default(false);
 
+      EmulationGroup.add_option("--aotcode-capture")
+        .dest("AOTCodeCapture")
+        .help("Captures relocatable host code and generates an AOT code cache for the loaded executable and libs. JIT only")
+        .action("store_true")
+        .set_default(false);
+
+      EmulationGroup.add_option("--aotcode-load")
+        .dest("AOTCodeLoad")
+        .help("Loads an AOT code cache for the loaded executable. JIT only")
+        .action("store_true")
+        .set_default(false);
+
       Parser.add_option_group(EmulationGroup);
     }
     {
@@ -228,10 +286,57 @@ namespace FEX::ArgLoader {
         Set(FEXCore::Config::ConfigOption::CONFIG_TSO_ENABLED, std::to_string(TSOEnabled));
       }
 
-      if (Options.is_set_by_user("SMCChecks")) {
+      if (Options.is_set_by_user("SMCChecksMode")) {
+        auto SMCChecks = Options["SMCChecksMode"];
+        if (SMCChecks == "none")
+          Set(FEXCore::Config::ConfigOption::CONFIG_SMC_CHECKS, "0");
+        else if (SMCChecks == "full")
+          Set(FEXCore::Config::ConfigOption::CONFIG_SMC_CHECKS, "1");
+        else if (SMCChecks == "mtrack")
+          Set(FEXCore::Config::ConfigOption::CONFIG_SMC_CHECKS, "2");
+      }
+      else if (Options.is_set_by_user("SMCChecks")) {
         bool SMCChecks = Options.get("SMCChecks");
         Set(FEXCore::Config::ConfigOption::CONFIG_SMC_CHECKS, std::to_string(SMCChecks));
       }
+      if (Options.is_set_by_user("SharedCodeCache")) {
+        bool SharedCodeCache = Options.get("SharedCodeCache");
+        Set(FEXCore::Config::ConfigOption::CONFIG_SHARED_CODE_CACHE, std::to_string(SharedCodeCache));
+      }
+      if (Options.is_set_by_user("CompileThreads")) {
+        uint32_t CompileThreads = Options.get("CompileThreads");
+        Set(FEXCore::Config::ConfigOption::CONFIG_COMPILE_THREADS, std::to_string(CompileThreads));
+      }
+      if (Options.is_set_by_user("TierUpThreshold")) {
+        uint32_t TierUpThreshold = Options.get("TierUpThreshold");
+        Set(FEXCore::Config::ConfigOption::CONFIG_TIER_UP_THRESHOLD, std::to_string(TierUpThreshold));
+      }
+      if (Options.is_set_by_user("HugePages")) {
+        auto HugePages = Options["HugePages"];
+        if (HugePages == "none")
+          Set(FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES, "0");
+        else if (HugePages == "thp")
+          Set(FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES, "1");
+        else if (HugePages == "hugetlb")
+          Set(FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES, "2");
+      }
+      if (Options.is_set_by_user("NUMALocal")) {
+        bool NUMALocal = Options.get("NUMALocal");
+        Set(FEXCore::Config::ConfigOption::CONFIG_NUMA_LOCAL, std::to_string(NUMALocal));
+      }
+      if (Options.is_set_by_user("RegisterAllocator")) {
+        auto RegisterAllocator = Options["RegisterAllocator"];
+        if (RegisterAllocator == "graph")
+          Set(FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR, "0");
+        else if (RegisterAllocator == "linear")
+          Set(FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR, "1");
+        else if (RegisterAllocator == "tiered")
+          Set(FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR, "2");
+      }
+      if (Options.is_set_by_user("X87ReducedPrecision")) {
+        bool X87ReducedPrecision = Options.get("X87ReducedPrecision");
+        Set(FEXCore::Config::ConfigOption::CONFIG_X87_REDUCED_PRECISION, std::to_string(X87ReducedPrecision));
+      }
       if (Options.is_set_by_user("AbiLocalFlags")) {
         bool AbiLocalFlags = Options.get("AbiLocalFlags");
         Set(FEXCore::Config::ConfigOption::CONFIG_ABI_LOCAL_FLAGS, std::to_string(AbiLocalFlags));
@@ -271,6 +376,16 @@ namespace FEX::ArgLoader {
         bool AOTIRLoad = Options.get("AOTIRLoad");
         Set(FEXCore::Config::ConfigOption::CONFIG_AOTIR_LOAD, std::to_string(AOTIRLoad));
       }
+
+      if (Options.is_set_by_user("AOTCodeCapture")) {
+        bool AOTCodeCapture = Options.get("AOTCodeCapture");
+        Set(FEXCore::Config::ConfigOption::CONFIG_AOTCODE_GENERATE, std::to_string(AOTCodeCapture));
+      }
+
+      if (Options.is_set_by_user("AOTCodeLoad")) {
+        bool AOTCodeLoad = Options.get("AOTCodeLoad");
+        Set(FEXCore::Config::ConfigOption::CONFIG_AOTCODE_LOAD, std::to_string(AOTCodeLoad));
+      }
     }
 
     {
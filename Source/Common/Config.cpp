@@ -190,6 +190,15 @@ namespace FEX::Config {
     {FEXCore::Config::ConfigOption::CONFIG_DEBUG_DISABLE_OPTIMIZATION_PASSES, "O0"},
     {FEXCore::Config::ConfigOption::CONFIG_AOTIR_GENERATE,       "AOTIRCapture"},
     {FEXCore::Config::ConfigOption::CONFIG_AOTIR_LOAD,           "AOTIRLoad"},
+    {FEXCore::Config::ConfigOption::CONFIG_SHARED_CODE_CACHE,    "SharedCodeCache"},
+    {FEXCore::Config::ConfigOption::CONFIG_AOTCODE_GENERATE,     "AOTCodeCapture"},
+    {FEXCore::Config::ConfigOption::CONFIG_AOTCODE_LOAD,         "AOTCodeLoad"},
+    {FEXCore::Config::ConfigOption::CONFIG_COMPILE_THREADS,      "CompileThreads"},
+    {FEXCore::Config::ConfigOption::CONFIG_TIER_UP_THRESHOLD,    "TierUpThreshold"},
+    {FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES,            "HugePages"},
+    {FEXCore::Config::ConfigOption::CONFIG_NUMA_LOCAL,           "NUMALocal"},
+    {FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR,   "RegisterAllocator"},
+    {FEXCore::Config::ConfigOption::CONFIG_X87_REDUCED_PRECISION, "X87ReducedPrecision"},
   }};
 
 
@@ -239,6 +248,15 @@ namespace FEX::Config {
     {"O0",            FEXCore::Config::ConfigOption::CONFIG_DEBUG_DISABLE_OPTIMIZATION_PASSES},
     {"AOTIRCapture",   FEXCore::Config::ConfigOption::CONFIG_AOTIR_GENERATE},
     {"AOTIRLoad",       FEXCore::Config::ConfigOption::CONFIG_AOTIR_LOAD},
+    {"SharedCodeCache", FEXCore::Config::ConfigOption::CONFIG_SHARED_CODE_CACHE},
+    {"AOTCodeCapture",  FEXCore::Config::ConfigOption::CONFIG_AOTCODE_GENERATE},
+    {"AOTCodeLoad",     FEXCore::Config::ConfigOption::CONFIG_AOTCODE_LOAD},
+    {"CompileThreads",  FEXCore::Config::ConfigOption::CONFIG_COMPILE_THREADS},
+    {"TierUpThreshold", FEXCore::Config::ConfigOption::CONFIG_TIER_UP_THRESHOLD},
+    {"HugePages",       FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES},
+    {"NUMALocal",       FEXCore::Config::ConfigOption::CONFIG_NUMA_LOCAL},
+    {"RegisterAllocator", FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR},
+    {"X87ReducedPrecision", FEXCore::Config::ConfigOption::CONFIG_X87_REDUCED_PRECISION},
   }};
 
   void OptionMapper::MapNameToOption(const char *ConfigName, const char *ConfigString) {
@@ -311,7 +329,7 @@ namespace FEX::Config {
       }
     };
 
-    static const std::array<std::pair<std::string, FEXCore::Config::ConfigOption>, 20> ConfigLookup = {{
+    static const std::array<std::pair<std::string, FEXCore::Config::ConfigOption>, 29> ConfigLookup = {{
       {"FEX_CORE",          FEXCore::Config::ConfigOption::CONFIG_DEFAULTCORE},
       {"FEX_MAXINST",       FEXCore::Config::ConfigOption::CONFIG_MAXBLOCKINST},
       {"FEX_SINGLESTEP",    FEXCore::Config::ConfigOption::CONFIG_SINGLESTEP},
@@ -332,6 +350,15 @@ namespace FEX::Config {
       {"FEX_DUMP_GPRS",     FEXCore::Config::ConfigOption::CONFIG_DUMP_GPRS},
       {"FEX_AOT_GENERATE",  FEXCore::Config::ConfigOption::CONFIG_AOTIR_GENERATE},
       {"FEX_AOT_LOAD",      FEXCore::Config::ConfigOption::CONFIG_AOTIR_LOAD},
+      {"FEX_SHAREDCODECACHE", FEXCore::Config::ConfigOption::CONFIG_SHARED_CODE_CACHE},
+      {"FEX_AOTCODE_GENERATE", FEXCore::Config::ConfigOption::CONFIG_AOTCODE_GENERATE},
+      {"FEX_AOTCODE_LOAD",  FEXCore::Config::ConfigOption::CONFIG_AOTCODE_LOAD},
+      {"FEX_COMPILE_THREADS", FEXCore::Config::ConfigOption::CONFIG_COMPILE_THREADS},
+      {"FEX_TIER_UP_THRESHOLD", FEXCore::Config::ConfigOption::CONFIG_TIER_UP_THRESHOLD},
+      {"FEX_HUGEPAGES",     FEXCore::Config::ConfigOption::CONFIG_HUGEPAGES},
+      {"FEX_NUMA_LOCAL",    FEXCore::Config::ConfigOption::CONFIG_NUMA_LOCAL},
+      {"FEX_REGISTER_ALLOCATOR", FEXCore::Config::ConfigOption::CONFIG_REGISTER_ALLOCATOR},
+      {"FEX_X87_REDUCED_PRECISION", FEXCore::Config::ConfigOption::CONFIG_X87_REDUCED_PRECISION},
     }};
 
     std::optional<std::string_view> Value;
@@ -12,6 +12,7 @@
 #include <FEXCore/Utils/LogManager.h>
 
 #include <cstdint>
+#include <fcntl.h>
 #include <filesystem>
 #include <string>
 #include <unistd.h>
@@ -205,11 +206,20 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::Value<std::string> OutputLog{FEXCore::Config::CONFIG_OUTPUTLOG, "stderr"};
   FEXCore::Config::Value<std::string> DumpIR{FEXCore::Config::CONFIG_DUMPIR, "no"};
   FEXCore::Config::Value<bool> TSOEnabledConfig{FEXCore::Config::CONFIG_TSO_ENABLED, true};
-  FEXCore::Config::Value<bool> SMCChecksConfig{FEXCore::Config::CONFIG_SMC_CHECKS, false};
+  FEXCore::Config::Value<uint8_t> SMCChecksConfig{FEXCore::Config::CONFIG_SMC_CHECKS, FEXCore::Config::CONFIG_SMC_NONE};
   FEXCore::Config::Value<bool> ABILocalFlags{FEXCore::Config::CONFIG_ABI_LOCAL_FLAGS, false};
   FEXCore::Config::Value<bool> AbiNoPF{FEXCore::Config::CONFIG_ABI_NO_PF, false};
   FEXCore::Config::Value<bool> AOTIRCapture{FEXCore::Config::CONFIG_AOTIR_GENERATE, false};
   FEXCore::Config::Value<bool> AOTIRLoad{FEXCore::Config::CONFIG_AOTIR_LOAD, false};
+  FEXCore::Config::Value<bool> SharedCodeCache{FEXCore::Config::CONFIG_SHARED_CODE_CACHE, false};
+  FEXCore::Config::Value<bool> AOTCodeCapture{FEXCore::Config::CONFIG_AOTCODE_GENERATE, false};
+  FEXCore::Config::Value<bool> AOTCodeLoad{FEXCore::Config::CONFIG_AOTCODE_LOAD, false};
+  FEXCore::Config::Value<uint64_t> CompileThreads{FEXCore::Config::CONFIG_COMPILE_THREADS, 0};
+  FEXCore::Config::Value<uint64_t> TierUpThreshold{FEXCore::Config::CONFIG_TIER_UP_THRESHOLD, 1000};
+  FEXCore::Config::Value<uint8_t> HugePages{FEXCore::Config::CONFIG_HUGEPAGES, FEXCore::Config::CONFIG_HUGEPAGES_NONE};
+  FEXCore::Config::Value<bool> NUMALocal{FEXCore::Config::CONFIG_NUMA_LOCAL, false};
+  FEXCore::Config::Value<uint8_t> RegisterAllocator{FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, FEXCore::Config::CONFIG_RA_GRAPH};
+  FEXCore::Config::Value<bool> X87ReducedPrecision{FEXCore::Config::CONFIG_X87_REDUCED_PRECISION, false};
 
   ::SilentLog = SilentLog();
 
@@ -266,6 +276,15 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::Set(FEXCore::Config::CONFIG_IS64BIT_MODE, Loader.Is64BitMode() ? "1" : "0");
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_AOTIR_GENERATE, AOTIRCapture());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_AOTIR_LOAD, AOTIRLoad());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_SHARED_CODE_CACHE, SharedCodeCache());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_AOTCODE_GENERATE, AOTCodeCapture());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_AOTCODE_LOAD, AOTCodeLoad());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_COMPILE_THREADS, CompileThreads());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_TIER_UP_THRESHOLD, TierUpThreshold());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_HUGEPAGES, HugePages());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_NUMA_LOCAL, NUMALocal());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, RegisterAllocator());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_X87_REDUCED_PRECISION, X87ReducedPrecision());
 
   std::unique_ptr<FEX::HLE::SignalDelegator> SignalDelegation = std::make_unique<FEX::HLE::SignalDelegator>();
   std::unique_ptr<FEX::HLE::SyscallHandler> SyscallHandler{
@@ -297,10 +316,16 @@ int main(int argc, char **argv, char **const envp) {
     LogMan::Msg::I("Warning: AOTIR is experimental, and might lead to crashes. Capture doesn't work with programs that fork.");
   }
 
-  FEXCore::Context::SetAOTIRLoader(CTX, [](const std::string &fileid) -> std::unique_ptr<std::istream> {
+  FEXCore::Context::SetAOTIRLoader(CTX, [](const std::string &fileid) -> int {
     auto filepath = std::filesystem::path(getenv("HOME")) / ".fex-emu" / "aotir" / fileid;
 
-    return std::make_unique<std::ifstream>(filepath, std::ios::in | std::ios::binary);
+    return open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
+  });
+
+  FEXCore::Context::SetAOTCodeLoader(CTX, [](const std::string &fileid) -> int {
+    auto filepath = std::filesystem::path(getenv("HOME")) / ".fex-emu" / "aotcode" / fileid;
+
+    return open(filepath.c_str(), O_RDONLY | O_CLOEXEC);
   });
 
   FEXCore::Context::RunUntilExit(CTX);
@@ -310,10 +335,11 @@ int main(int argc, char **argv, char **const envp) {
 
     auto WroteCache = FEXCore::Context::WriteAOTIR(CTX, [](const std::string& fileid) -> std::unique_ptr<std::ostream> {
       auto filepath = std::filesystem::path(getenv("HOME")) / ".fex-emu" / "aotir" / fileid;
+      // Other instances may have the old file mapped, unlink it instead of truncating it under them
+      std::error_code ec;
+      std::filesystem::remove(filepath, ec);
       auto AOTWrite = std::make_unique<std::ofstream>(filepath, std::ios::out | std::ios::binary);
       if (*AOTWrite) {
-        std::filesystem::resize_file(filepath, 0);
-        AOTWrite->seekp(0);
         LogMan::Msg::I("AOTIR: Storing %s", fileid.c_str());
       } else {
         LogMan::Msg::I("AOTIR: Failed to store %s", fileid.c_str());
@@ -328,6 +354,30 @@ int main(int argc, char **argv, char **const envp) {
     }
   }
 
+  if (AOTCodeCapture()) {
+    std::filesystem::create_directories(std::filesystem::path(getenv("HOME")) / ".fex-emu" / "aotcode");
+
+    auto WroteCache = FEXCore::Context::WriteAOTCode(CTX, [](const std::string& fileid) -> std::unique_ptr<std::ostream> {
+      auto filepath = std::filesystem::path(getenv("HOME")) / ".fex-emu" / "aotcode" / fileid;
+      // Other instances may have the old file mapped, unlink it instead of truncating it under them
+      std::error_code ec;
+      std::filesystem::remove(filepath, ec);
+      auto AOTWrite = std::make_unique<std::ofstream>(filepath, std::ios::out | std::ios::binary);
+      if (*AOTWrite) {
+        LogMan::Msg::I("AOTCode: Storing %s", fileid.c_str());
+      } else {
+        LogMan::Msg::I("AOTCode: Failed to store %s", fileid.c_str());
+      }
+      return AOTWrite;
+    });
+
+    if (WroteCache) {
+      LogMan::Msg::I("AOTCode Cache Stored");
+    } else {
+      LogMan::Msg::E("AOTCode Cache Store Failed");
+    }
+  }
+
   auto ProgramStatus = FEXCore::Context::GetProgramStatus(CTX);
 
   SyscallHandler.reset();
@@ -3,6 +3,7 @@
 #include "Common/MathUtils.h"
 
 #include <FEXCore/Core/CodeLoader.h>
+#include <algorithm>
 #include <array>
 #include <bitset>
 #include <cassert>
@@ -716,7 +717,37 @@ public:
     auto ELFLoaderWrapper = [&](void const *Data, uint64_t Addr, uint64_t Size) -> void {
       memcpy(reinterpret_cast<void*>(Addr), Data, Size);
     };
-    DB.WriteLoadableSections(ELFLoaderWrapper);
+
+    auto DoFileMap = [](int FD, uint64_t FileOffset, uint64_t Addr, uint64_t FileSize, uint64_t MemSize) -> bool {
+      // The file offset and the address have to sit at the same offset in their page
+      uint64_t PageOffset = Addr % 4096;
+      if (FileOffset % 4096 != PageOffset) {
+        return false;
+      }
+
+      // Writable until relocations are done, the segment protections are applied after
+      void *Result = mmap(reinterpret_cast<void*>(Addr - PageOffset), FileSize + PageOffset, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE, FD, FileOffset - PageOffset);
+      if (Result == MAP_FAILED) {
+        return false;
+      }
+
+      // The last file page carries whatever follows the segment in the file, clear the part that is bss
+      // bss past that page is still the zeroed anonymous reservation
+      if (MemSize > FileSize) {
+        uint64_t FileEnd = Addr + FileSize;
+        uint64_t ClearEnd = std::min(AlignUp(FileEnd, 4096), Addr + MemSize);
+        memset(reinterpret_cast<void*>(FileEnd), 0, ClearEnd - FileEnd);
+      }
+      return true;
+    };
+
+    auto DoMProtect = [](uint64_t Addr, uint64_t Size, int Prot) -> void {
+      if (mprotect(reinterpret_cast<void*>(Addr), Size, Prot) != 0) {
+        LogMan::Msg::D("Couldn't protect ELF segment at 0x%lx", Addr);
+      }
+    };
+
+    DB.MapLoadableSections(DoFileMap, ELFLoaderWrapper, DoMProtect);
   }
 
   char const *FindSymbolNameInRange(uint64_t Address) override {
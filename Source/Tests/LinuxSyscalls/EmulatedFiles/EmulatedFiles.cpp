@@ -1,5 +1,14 @@
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <fcntl.h>
 #include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <FEXCore/Utils/LogManager.h>
 #include "FEXCore/Core/CodeLoader.h"
@@ -574,40 +583,125 @@ namespace FEX::EmulatedFile {
     return cpu_stream.str();
   }
 
+  // Sealed so a cached copy can be handed out to every open without anyone changing it
+  // The name only shows up in /proc/self/fd, a guest path could be longer than memfd_create allows
+  static int32_t CreateSealedFile(std::string const &Content) {
+    int32_t FD = memfd_create("FEX-emu", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (FD == -1) {
+      return -1;
+    }
+
+    size_t Written = 0;
+    while (Written < Content.size()) {
+      ssize_t Result = write(FD, Content.data() + Written, Content.size() - Written);
+      if (Result == -1) {
+        close(FD);
+        return -1;
+      }
+      Written += Result;
+    }
+
+    if (fcntl(FD, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) == -1) {
+      close(FD);
+      return -1;
+    }
+
+    lseek(FD, 0, SEEK_SET);
+    return FD;
+  }
+
+  // Cached memfds live at the top of the FD range, out of the way of the low numbers the guest gets handed
+  // Capped so a huge limit doesn't grow the FD table for nothing
+  static int32_t MoveToHighFD(int32_t FD) {
+    constexpr rlim_t MAX_HIGH_FD = 4096;
+    constexpr rlim_t RESERVED_FDS = 64;
+
+    struct rlimit Limit{};
+    if (getrlimit(RLIMIT_NOFILE, &Limit) != 0) {
+      return FD;
+    }
+
+    rlim_t Top = std::min(Limit.rlim_cur, MAX_HIGH_FD);
+    if (Top <= RESERVED_FDS) {
+      return FD;
+    }
+
+    int32_t HighFD = fcntl(FD, F_DUPFD_CLOEXEC, static_cast<int>(Top - RESERVED_FDS));
+    if (HighFD == -1) {
+      return FD;
+    }
+
+    close(FD);
+    return HighFD;
+  }
+
+  // Same layout as the kernel, 32bit groups with the highest first
+  static std::string GenerateCPUMask(uint64_t CPUCores) {
+    std::string Mask;
+    uint64_t Groups = (CPUCores + 31) / 32;
+    for (uint64_t Group = Groups; Group-- > 0;) {
+      uint64_t Bits = std::min<uint64_t>(CPUCores - Group * 32, 32);
+      uint32_t Value = Bits == 32 ? ~0U : ((1U << Bits) - 1);
+      char Chunk[16];
+      snprintf(Chunk, sizeof(Chunk), Group == Groups - 1 ? "%x" : ",%08x", Value);
+      Mask += Chunk;
+    }
+    return Mask;
+  }
+
+  // A dup would share the file offset between opens, reopening through procfs gets a new one
+  static int32_t ReopenFile(int32_t FD, int32_t flags) {
+    char FDPath[32];
+    snprintf(FDPath, sizeof(FDPath), "/proc/self/fd/%d", FD);
+    return ::open(FDPath, O_RDONLY | (flags & O_CLOEXEC));
+  }
+
   EmulatedFDManager::EmulatedFDManager(FEXCore::Context::Context *ctx)
     : CTX {ctx} {
-    FDReadCreators["/proc/cpuinfo"] = [&](FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode) -> int32_t {
-      FILE *fp = tmpfile();
-      fwrite((void*)&cpu_info.at(0), sizeof(uint8_t), cpu_info.size(), fp);
-      fseek(fp, 0, SEEK_SET);
-      int32_t f = fileno(fp);
-      return f;
-    };
+    RegisterStaticFile("/proc/cpuinfo", [this]() -> std::optional<std::string> {
+      return cpu_info;
+    });
 
-    FDReadCreators["/proc/sys/kernel/osrelease"] = [&](FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode) -> int32_t {
-      FILE *fp = tmpfile();
+    RegisterStaticFile("/proc/sys/kernel/osrelease", []() -> std::optional<std::string> {
       const char kernel_version[] = "5.0.0\0";
-      fwrite(kernel_version, sizeof(uint8_t), strlen(kernel_version) + 1, fp);
-      fseek(fp, 0, SEEK_SET);
-      int32_t f = fileno(fp);
-      return f;
-    };
+      return std::string(kernel_version, strlen(kernel_version) + 1);
+    });
 
-    auto NumCPUCores = [&](FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode) -> int32_t {
-      FILE *fp = tmpfile();
-      fwrite((void*)&cpus_online.at(0), sizeof(uint8_t), cpus_online.size(), fp);
-      fseek(fp, 0, SEEK_SET);
-      int32_t f = fileno(fp);
-      return f;
+    auto NumCPUCores = [this]() -> std::optional<std::string> {
+      return cpus_online;
     };
 
-    FDReadCreators["/sys/devices/system/cpu/online"] = NumCPUCores;
-    FDReadCreators["/sys/devices/system/cpu/present"] = NumCPUCores;
+    RegisterStaticFile("/sys/devices/system/cpu/online", NumCPUCores);
+    RegisterStaticFile("/sys/devices/system/cpu/present", NumCPUCores);
 
     string procAuxv = string("/proc/") + std::to_string(getpid()) + string("/auxv");
 
-    FDReadCreators[procAuxv] = &EmulatedFDManager::ProcAuxv;
-    FDReadCreators["/proc/self/auxv"] = &EmulatedFDManager::ProcAuxv;
+    RegisterStaticFile(procAuxv, &EmulatedFDManager::ProcAuxv);
+    RegisterStaticFile("/proc/self/auxv", &EmulatedFDManager::ProcAuxv);
+
+    // The rest of the status changes as the guest runs, only the affinity has to match the emulated cores
+    auto ProcStatus = [this]() -> std::optional<std::string> {
+      std::ifstream Input("/proc/self/status");
+      if (!Input.is_open()) {
+        return std::nullopt;
+      }
+
+      std::ostringstream Output;
+      std::string Line;
+      while (std::getline(Input, Line)) {
+        if (Line.rfind("Cpus_allowed:", 0) == 0) {
+          Line = "Cpus_allowed:\t" + GenerateCPUMask(ThreadsConfig());
+        }
+        else if (Line.rfind("Cpus_allowed_list:", 0) == 0) {
+          Line = "Cpus_allowed_list:\t" + cpus_online;
+        }
+        Output << Line << "\n";
+      }
+      return Output.str();
+    };
+
+    RegisterDynamicFile(string("/proc/") + std::to_string(getpid()) + string("/status"), ProcStatus);
+    RegisterDynamicFile("/proc/self/status", ProcStatus);
 
     cpus_online = "0";
     uint64_t CPUCores = ThreadsConfig();
@@ -619,39 +713,165 @@ namespace FEX::EmulatedFile {
   }
 
   EmulatedFDManager::~EmulatedFDManager() {
+    for (auto &File : CachedFiles) {
+      if (File->FD == -1) {
+        continue;
+      }
+
+      // Same as on open, the guest might have closed our FD and something else has the number now
+      struct stat Stat{};
+      if (fstat(File->FD, &Stat) == 0 && Stat.st_dev == File->Dev && Stat.st_ino == File->Inode) {
+        close(File->FD);
+      }
+    }
   }
 
-  int32_t EmulatedFDManager::OpenAt(int dirfs, const char *pathname, int flags, uint32_t mode) {
+  void EmulatedFDManager::AddEmulatedRoot(std::string const &Path) {
+    std::string Root = Path.substr(0, Path.find('/', 1) + 1);
+    if (std::find(EmulatedRoots.begin(), EmulatedRoots.end(), Root) == EmulatedRoots.end()) {
+      EmulatedRoots.emplace_back(Root);
+    }
+
+    // A path that resolved to nothing before might be this file now
+    std::unique_lock lk(ResolvedPathsLock);
+    ResolvedPaths.clear();
+  }
+
+  void EmulatedFDManager::RegisterStaticFile(std::string const &Path, ContentFunc Generator) {
+    auto File = CachedFiles.emplace_back(std::make_unique<CachedFile>()).get();
+
+    FDReadCreators[Path] = [File, Generator](FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode) -> int32_t {
+      std::scoped_lock<std::mutex> lk(File->Lock);
+
+      if (File->FD != -1) {
+        int32_t f = ReopenFile(File->FD, flags);
+
+        struct stat Stat{};
+        if (f != -1 && fstat(f, &Stat) == 0 && Stat.st_dev == File->Dev && Stat.st_ino == File->Inode) {
+          return f;
+        }
+
+        if (f != -1) {
+          close(f);
+        }
+
+        // The guest closed it and the number got reused, it isn't ours to close anymore
+        File->FD = -1;
+      }
+
+      auto Content = Generator();
+      if (!Content) {
+        return -1;
+      }
+
+      int32_t CachedFD = CreateSealedFile(*Content);
+      if (CachedFD == -1) {
+        return -1;
+      }
+      CachedFD = MoveToHighFD(CachedFD);
+
+      struct stat Stat{};
+      if (fstat(CachedFD, &Stat) != 0) {
+        close(CachedFD);
+        return -1;
+      }
+      File->FD = CachedFD;
+      File->Dev = Stat.st_dev;
+      File->Inode = Stat.st_ino;
+
+      return ReopenFile(CachedFD, flags);
+    };
+
+    AddEmulatedRoot(Path);
+  }
+
+  void EmulatedFDManager::RegisterDynamicFile(std::string const &Path, ContentFunc Generator) {
+    FDReadCreators[Path] = [Generator](FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode) -> int32_t {
+      auto Content = Generator();
+      if (!Content) {
+        return -1;
+      }
+
+      // Nothing keeps this one, the guest owns the only FD
+      int32_t f = CreateSealedFile(*Content);
+      if (f != -1 && !(flags & O_CLOEXEC)) {
+        fcntl(f, F_SETFD, 0);
+      }
+      return f;
+    };
+
+    AddEmulatedRoot(Path);
+  }
+
+  EmulatedFDManager::FDReadStringFunc const *EmulatedFDManager::ResolvePath(const char *pathname) {
+    // Exact match is the common case and needs no syscalls
+    auto Creator = FDReadCreators.find(pathname);
+    if (Creator != FDReadCreators.end()) {
+      return &Creator->second;
+    }
+
+    auto IsInEmulatedRoot = [this](std::string_view Path) {
+      return std::any_of(EmulatedRoots.begin(), EmulatedRoots.end(), [Path](std::string const &Root) {
+        return Path.compare(0, Root.size(), Root) == 0;
+      });
+    };
+
+    // procfs and sysfs don't get renamed under us, paths inside of them resolve the same every time
+    // Apart from the per process directories, their cwd, root and fd links move
+    bool Cacheable = IsInEmulatedRoot(pathname) &&
+      strncmp(pathname, "/proc/self/", 11) != 0 &&
+      strncmp(pathname, "/proc/thread-self/", 18) != 0 &&
+      !(strncmp(pathname, "/proc/", 6) == 0 && isdigit(pathname[6]));
+    if (Cacheable) {
+      std::shared_lock lk(ResolvedPathsLock);
+      auto it = ResolvedPaths.find(pathname);
+      if (it != ResolvedPaths.end()) {
+        return it->second;
+      }
+    }
+
+    // Anything else can still be a symlink in to them, resolve first and only then check where it ended up
     std::error_code ec;
-    bool exists = std::filesystem::exists(pathname, ec);
+    string cpath = std::filesystem::canonical(pathname, ec);
     if (ec) {
-      return -1;
+      cpath = std::filesystem::path(pathname).lexically_normal(); // *Note: this doesn't transform to absolute
+    }
+
+    FDReadStringFunc const *Result{};
+    if (IsInEmulatedRoot(cpath)) {
+      Creator = FDReadCreators.find(cpath);
+      if (Creator != FDReadCreators.end()) {
+        Result = &Creator->second;
+      }
     }
-    string cpath = exists ? std::filesystem::canonical(pathname)
-      : std::filesystem::path(pathname).lexically_normal(); // *Note: this doesn't transform to absolute
 
-    auto Creator = FDReadCreators.find(cpath);
-    if (Creator == FDReadCreators.end()) {
+    if (Cacheable) {
+      std::unique_lock lk(ResolvedPathsLock);
+      if (ResolvedPaths.size() >= 4096) {
+        ResolvedPaths.clear();
+      }
+      ResolvedPaths.emplace(pathname, Result);
+    }
+    return Result;
+  }
+
+  int32_t EmulatedFDManager::OpenAt(int dirfs, const char *pathname, int flags, uint32_t mode) {
+    auto Creator = ResolvePath(pathname);
+    if (!Creator) {
       return -1;
     }
 
-    return Creator->second(CTX, dirfs, pathname, flags, mode);
+    return (*Creator)(CTX, dirfs, pathname, flags, mode);
   }
 
-  int32_t EmulatedFDManager::ProcAuxv(FEXCore::Context::Context* ctx, int32_t fd, const char* pathname, int32_t flags, mode_t mode)
-  {
+  std::optional<std::string> EmulatedFDManager::ProcAuxv() {
     uint64_t auxvBase=0, auxvSize=0;
     FEX::HLE::_SyscallHandler->GetCodeLoader()->GetAuxv(auxvBase, auxvSize);
     if (!auxvBase) {
       LogMan::Msg::D("Failed to get Auxv stack address");
-      return -1;
+      return std::nullopt;
     }
 
-    FILE* fp = tmpfile();
-    fwrite((void*)auxvBase, 1, auxvSize, fp);
-    fseek(fp, 0, SEEK_SET);
-    int32_t f = fileno(fp);
-    return f;
+    return std::string(reinterpret_cast<char const*>(auxvBase), auxvSize);
   }
 }
-
@@ -3,9 +3,15 @@
 
 #include <cstdint>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
+#include <sys/types.h>
+#include <vector>
 
 namespace FEXCore {
   class FD;
@@ -21,14 +27,46 @@ namespace FEX::EmulatedFile {
       ~EmulatedFDManager();
       int32_t OpenAt(int dirfs, const char *pathname, int flags, uint32_t mode);
 
+      // Generates the contents of an emulated file, nullopt fails the open so it falls through to the host file
+      using ContentFunc = std::function<std::optional<std::string>()>;
+
+      // Files are served from sealed memfds so nothing touches the disk
+      // These must be registered before the guest starts opening files
+      // Static content is generated on the first open and every open after shares the same memfd
+      void RegisterStaticFile(std::string const &Path, ContentFunc Generator);
+      // Dynamic content is regenerated on every open, for views like /proc/self/status that change as the guest runs
+      void RegisterDynamicFile(std::string const &Path, ContentFunc Generator);
+
     private:
       FEXCore::Context::Context *CTX;
       std::string cpus_online{};
       std::string cpu_info{};
+
+      struct CachedFile {
+        std::mutex Lock;
+        // Kept at the top of the FD range, see MoveToHighFD
+        int32_t FD{-1};
+        // The guest can close the memfd out from under us, these tell if the FD is still ours
+        dev_t Dev{};
+        ino_t Inode{};
+      };
+      std::vector<std::unique_ptr<CachedFile>> CachedFiles;
+      void AddEmulatedRoot(std::string const &Path);
+
       using FDReadStringFunc = std::function<int32_t(FEXCore::Context::Context *ctx, int32_t fd, const char *pathname, int32_t flags, mode_t mode)>;
       std::unordered_map<std::string, FDReadStringFunc> FDReadCreators;
 
-      static int32_t ProcAuxv(FEXCore::Context::Context* ctx, int32_t fd, const char* pathname, int32_t flags, mode_t mode);
+      // Top level directories holding emulated files, eg "/proc/"
+      // A path has to canonicalize to one of these to be emulated
+      std::vector<std::string> EmulatedRoots;
+
+      // Guest path inside of an emulated root to what it canonicalized to, nullptr if that isn't emulated
+      // Paths outside of them are resolved on every open, a symlink there can change what it points to
+      std::shared_mutex ResolvedPathsLock;
+      std::unordered_map<std::string, FDReadStringFunc const*> ResolvedPaths;
+      FDReadStringFunc const *ResolvePath(const char *pathname);
+
+      static std::optional<std::string> ProcAuxv();
       FEXCore::Config::Value<uint64_t> ThreadsConfig{FEXCore::Config::CONFIG_EMULATED_CPU_CORES, 1};
   };
 }
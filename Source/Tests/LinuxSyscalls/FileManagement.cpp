@@ -1,7 +1,10 @@
 #include "Tests/LinuxSyscalls/FileManagement.h"
 
 #include <FEXCore/Utils/LogManager.h>
+#include <cerrno>
 #include <cstring>
+#include <climits>
+#include <mutex>
 #include <fcntl.h>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
@@ -17,6 +20,9 @@
 
 namespace FEX::HLE {
 
+// Bounds the miss cache when something walks a huge tree
+constexpr size_t MAX_ROOTFS_MISSES = 16384;
+
 FileManager::FileManager(FEXCore::Context::Context *ctx)
   : EmuFD {ctx} {
     // calculate the non-self link to exe
@@ -43,6 +49,148 @@ std::string FileManager::GetEmulatedPath(const char *pathname) {
   return RootFSPath + pathname;
 }
 
+// Where a path is on the host with the symlinks in its existing part resolved, the last name is never followed
+// Parts that don't exist are appended as they are. Empty if one of them is a dangling symlink,
+// creating its target would make the path appear somewhere else
+static std::string GetHostLocation(int dirfd, std::string Path) {
+  if (Path.empty()) {
+    return {};
+  }
+
+  if (Path[0] != '/') {
+    char Base[PATH_MAX];
+    if (dirfd == AT_FDCWD) {
+      if (!getcwd(Base, sizeof(Base))) {
+        return {};
+      }
+    }
+    else {
+      char FDPath[32];
+      snprintf(FDPath, sizeof(FDPath), "/proc/self/fd/%d", dirfd);
+      auto Length = ::readlink(FDPath, Base, sizeof(Base) - 1);
+      if (Length == -1) {
+        return {};
+      }
+      Base[Length] = 0;
+    }
+    Path = std::string(Base) + "/" + Path;
+  }
+
+  while (Path.size() > 1 && Path.back() == '/') {
+    Path.pop_back();
+  }
+
+  std::string Remainder;
+  while (Path.size() > 1) {
+    auto Slash = Path.find_last_of('/');
+    Remainder = Path.substr(Slash) + Remainder;
+    Path.resize(std::max<size_t>(Slash, 1));
+
+    char Resolved[PATH_MAX];
+    if (realpath(Path.c_str(), Resolved)) {
+      return (strcmp(Resolved, "/") == 0 ? "" : std::string(Resolved)) + Remainder;
+    }
+
+    struct stat Buf{};
+    if (::lstat(Path.c_str(), &Buf) == 0 && S_ISLNK(Buf.st_mode)) {
+      return {};
+    }
+  }
+
+  return Remainder;
+}
+
+bool FileManager::IsRootFSMiss(std::string const &Path) {
+  std::shared_lock lk(RootFSMissesLock);
+  return RootFSMisses.find(Path) != RootFSMisses.end();
+}
+
+void FileManager::AddRootFSMiss(std::string const &Path, bool Follow, uint64_t Generation) {
+  if (Follow) {
+    // A dangling symlink misses when followed but its target lives somewhere else
+    struct stat Buf{};
+    if (::lstat(Path.c_str(), &Buf) == 0 ||
+        (errno != ENOENT && errno != ENOTDIR)) {
+      return;
+    }
+  }
+
+  auto Location = GetHostLocation(AT_FDCWD, Path);
+  if (Location.empty()) {
+    return;
+  }
+
+  std::unique_lock lk(RootFSMissesLock);
+  if (PathsGeneration.load() != Generation) {
+    // Something was created since the lookup missed, it might have been this
+    return;
+  }
+
+  if (RootFSMisses.size() >= MAX_ROOTFS_MISSES) {
+    RootFSMisses.clear();
+    RootFSMissLocations.clear();
+  }
+
+  if (RootFSMisses.emplace(Path, Location).second) {
+    RootFSMissLocations.emplace(Location, Path);
+  }
+}
+
+void FileManager::ForgetRootFSMisses(std::string const &Location) {
+  // Must be called with RootFSMissesLock held
+  auto it = RootFSMissLocations.lower_bound(Location);
+  while (it != RootFSMissLocations.end() && it->first.compare(0, Location.size(), Location) == 0) {
+    // Only the path itself and what is below it, not siblings that share the prefix
+    if (it->first.size() == Location.size() || it->first[Location.size()] == '/') {
+      RootFSMisses.erase(it->second);
+      it = RootFSMissLocations.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
+void FileManager::PathsChanged(int dirfd, const char *pathname) {
+  auto Location = GetHostLocation(dirfd, pathname ? pathname : "");
+
+  std::unique_lock lk(RootFSMissesLock);
+  PathsGeneration.fetch_add(1);
+  if (Location.empty()) {
+    // Can't tell where it went
+    RootFSMisses.clear();
+    RootFSMissLocations.clear();
+  }
+  else {
+    ForgetRootFSMisses(Location);
+  }
+}
+
+void FileManager::PathsChanged() {
+  std::unique_lock lk(RootFSMissesLock);
+  PathsGeneration.fetch_add(1);
+  RootFSMisses.clear();
+  RootFSMissLocations.clear();
+}
+
+template<typename Func>
+uint64_t FileManager::WithRootFSFallback(const char *pathname, bool Follow, Func &&Op) {
+  auto Path = GetEmulatedPath(pathname);
+  if (!Path.empty() && !IsRootFSMiss(Path)) {
+    uint64_t Generation = PathsGeneration.load();
+    uint64_t Result = Op(Path.c_str());
+    if (Result != -1) {
+      return Result;
+    }
+
+    if (errno == ENOENT || errno == ENOTDIR) {
+      AddRootFSMiss(Path, Follow, Generation);
+    }
+  }
+
+  return Op(pathname);
+}
+
 uint64_t FileManager::Open(const char *pathname, [[maybe_unused]] int flags, [[maybe_unused]] uint32_t mode) {
   return ::open(pathname, flags, mode);
 }
@@ -53,46 +201,27 @@ uint64_t FileManager::Close(int fd) {
 }
 
 uint64_t FileManager::Stat(const char *pathname, void *buf) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::stat(Path.c_str(), reinterpret_cast<struct stat*>(buf));
-    if (Result != -1)
-      return Result;
-  }
-  return ::stat(pathname, reinterpret_cast<struct stat*>(buf));
+  return WithRootFSFallback(pathname, true, [buf](const char *Path) -> uint64_t {
+    return ::stat(Path, reinterpret_cast<struct stat*>(buf));
+  });
 }
 
 uint64_t FileManager::Lstat(const char *path, void *buf) {
-  auto Path = GetEmulatedPath(path);
-  if (!Path.empty()) {
-    uint64_t Result = ::lstat(Path.c_str(), reinterpret_cast<struct stat*>(buf));
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::lstat(path, reinterpret_cast<struct stat*>(buf));
+  return WithRootFSFallback(path, false, [buf](const char *Path) -> uint64_t {
+    return ::lstat(Path, reinterpret_cast<struct stat*>(buf));
+  });
 }
 
 uint64_t FileManager::Access(const char *pathname, [[maybe_unused]] int mode) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::access(Path.c_str(), mode);
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::access(pathname, mode);
+  return WithRootFSFallback(pathname, true, [mode](const char *Path) -> uint64_t {
+    return ::access(Path, mode);
+  });
 }
 
 uint64_t FileManager::FAccessat(int dirfd, const char *pathname, int mode) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::syscall(SYS_faccessat, dirfd, Path.c_str(), mode);
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::syscall(SYS_faccessat, dirfd, pathname, mode);
+  return WithRootFSFallback(pathname, true, [dirfd, mode](const char *Path) -> uint64_t {
+    return ::syscall(SYS_faccessat, dirfd, Path, mode);
+  });
 }
 
 uint64_t FileManager::Readlink(const char *pathname, char *buf, size_t bufsiz) {
@@ -102,25 +231,15 @@ uint64_t FileManager::Readlink(const char *pathname, char *buf, size_t bufsiz) {
     return std::min(bufsiz, App.size());
   }
 
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::readlink(Path.c_str(), buf, bufsiz);
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::readlink(pathname, buf, bufsiz);
+  return WithRootFSFallback(pathname, false, [buf, bufsiz](const char *Path) -> uint64_t {
+    return ::readlink(Path, buf, bufsiz);
+  });
 }
 
 uint64_t FileManager::Chmod(const char *pathname, mode_t mode) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::chmod(Path.c_str(), mode);
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::chmod(pathname, mode);
+  return WithRootFSFallback(pathname, true, [mode](const char *Path) -> uint64_t {
+    return ::chmod(Path, mode);
+  });
 }
 
 uint64_t FileManager::Readlinkat(int dirfd, const char *pathname, char *buf, size_t bufsiz) {
@@ -130,14 +249,9 @@ uint64_t FileManager::Readlinkat(int dirfd, const char *pathname, char *buf, siz
     return std::min(bufsiz, App.size());
   }
 
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::readlinkat(dirfd, Path.c_str(), buf, bufsiz);
-    if (Result != -1)
-      return Result;
-  }
-
-  return ::readlinkat(dirfd, pathname, buf, bufsiz);
+  return WithRootFSFallback(pathname, false, [dirfd, buf, bufsiz](const char *Path) -> uint64_t {
+    return ::readlinkat(dirfd, Path, buf, bufsiz);
+  });
 }
 
 uint64_t FileManager::Openat([[maybe_unused]] int dirfs, const char *pathname, int flags, uint32_t mode) {
@@ -145,13 +259,27 @@ uint64_t FileManager::Openat([[maybe_unused]] int dirfs, const char *pathname, i
 
   fd = EmuFD.OpenAt(dirfs, pathname, flags, mode);
   if (fd == -1) {
-    auto Path = GetEmulatedPath(pathname);
-    if (!Path.empty()) {
-      fd = ::openat(dirfs, Path.c_str(), flags, mode);
+    if (flags & O_CREAT) {
+      // Creating a file can fill in a cached miss, relative paths and symlinks included
+      auto Path = GetEmulatedPath(pathname);
+      if (!Path.empty()) {
+        fd = ::openat(dirfs, Path.c_str(), flags, mode);
+      }
+
+      if (fd != -1) {
+        PathsChanged(dirfs, Path.c_str());
+      }
+      else {
+        fd = ::openat(dirfs, pathname, flags, mode);
+        if (fd != -1)
+          PathsChanged(dirfs, pathname);
+      }
+    }
+    else {
+      fd = WithRootFSFallback(pathname, !(flags & O_NOFOLLOW), [dirfs, flags, mode](const char *Path) -> uint64_t {
+        return ::openat(dirfs, Path, flags, mode);
+      });
     }
-
-    if (fd == -1)
-      fd = ::openat(dirfs, pathname, flags, mode);
   }
 
   if (fd != -1)
@@ -161,55 +289,45 @@ uint64_t FileManager::Openat([[maybe_unused]] int dirfs, const char *pathname, i
 }
 
 uint64_t FileManager::Statx(int dirfd, const char *pathname, int flags, uint32_t mask, struct statx *statxbuf) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::statx(dirfd, Path.c_str(), flags, mask, statxbuf);
-    if (Result != -1)
-      return Result;
-  }
-  return ::statx(dirfd, pathname, flags, mask, statxbuf);
+  return WithRootFSFallback(pathname, !(flags & AT_SYMLINK_NOFOLLOW), [dirfd, flags, mask, statxbuf](const char *Path) -> uint64_t {
+    return ::statx(dirfd, Path, flags, mask, statxbuf);
+  });
 }
 
 uint64_t FileManager::Mknod(const char *pathname, mode_t mode, dev_t dev) {
   auto Path = GetEmulatedPath(pathname);
+  uint64_t Result = -1;
   if (!Path.empty()) {
-    uint64_t Result = ::mknod(Path.c_str(), mode, dev);
-    if (Result != -1)
+    Result = ::mknod(Path.c_str(), mode, dev);
+    if (Result != -1) {
+      PathsChanged(AT_FDCWD, Path.c_str());
       return Result;
+    }
   }
-  return ::mknod(pathname, mode, dev);
+
+  Result = ::mknod(pathname, mode, dev);
+  if (Result != -1) {
+    PathsChanged(AT_FDCWD, pathname);
+  }
+  return Result;
 }
 
 uint64_t FileManager::Statfs(const char *path, void *buf) {
-  auto Path = GetEmulatedPath(path);
-  if (!Path.empty()) {
-    uint64_t Result = ::statfs(Path.c_str(), reinterpret_cast<struct statfs*>(buf));
-    if (Result != -1)
-      return Result;
-  }
-  return ::statfs(path, reinterpret_cast<struct statfs*>(buf));
+  return WithRootFSFallback(path, true, [buf](const char *Path) -> uint64_t {
+    return ::statfs(Path, reinterpret_cast<struct statfs*>(buf));
+  });
 }
 
 uint64_t FileManager::NewFSStatAt(int dirfd, const char *pathname, struct stat *buf, int flag) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::fstatat(dirfd, Path.c_str(), buf, flag);
-    if (Result != -1) {
-      return Result;
-    }
-  }
-  return ::fstatat(dirfd, pathname, buf, flag);
+  return WithRootFSFallback(pathname, !(flag & AT_SYMLINK_NOFOLLOW), [dirfd, buf, flag](const char *Path) -> uint64_t {
+    return ::fstatat(dirfd, Path, buf, flag);
+  });
 }
 
 uint64_t FileManager::NewFSStatAt64(int dirfd, const char *pathname, struct stat64 *buf, int flag) {
-  auto Path = GetEmulatedPath(pathname);
-  if (!Path.empty()) {
-    uint64_t Result = ::fstatat64(dirfd, Path.c_str(), buf, flag);
-    if (Result != -1) {
-      return Result;
-    }
-  }
-  return ::fstatat64(dirfd, pathname, buf, flag);
+  return WithRootFSFallback(pathname, !(flag & AT_SYMLINK_NOFOLLOW), [dirfd, buf, flag](const char *Path) -> uint64_t {
+    return ::fstatat64(dirfd, Path, buf, flag);
+  });
 }
 
 std::string *FileManager::FindFDName(int fd) {
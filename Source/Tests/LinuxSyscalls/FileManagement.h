@@ -1,5 +1,8 @@
 #pragma once
+#include <atomic>
 #include <cstdint>
+#include <map>
+#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -42,6 +45,12 @@ public:
 
   std::string *FindFDName(int fd);
 
+  // Syscalls that create or rename paths without going through here
+  // A cached rootfs miss at or below the new path could exist now
+  void PathsChanged(int dirfd, const char *pathname);
+  // Everything can resolve differently, like after a chroot
+  void PathsChanged();
+
 private:
   FEX::EmulatedFile::EmulatedFDManager EmuFD;
 
@@ -49,6 +58,22 @@ private:
   std::string PidSelfPath;
   std::string GetEmulatedPath(const char *pathname);
 
+  // Tries the rootfs path first and the host path if that fails, skipping the rootfs when it is known to miss
+  template<typename Func>
+  uint64_t WithRootFSFallback(const char *pathname, bool Follow, Func &&Op);
+
+  // Rootfs paths that failed with ENOENT or ENOTDIR, so misses don't cost two syscalls every time
+  // Each one maps to where it would be on the host with symlinks resolved, a change at or above that drops it
+  // Changes made by other processes aren't seen
+  std::shared_mutex RootFSMissesLock;
+  std::unordered_map<std::string, std::string> RootFSMisses;
+  std::multimap<std::string, std::string> RootFSMissLocations;
+  // Moves on every change so a miss that raced with one isn't cached
+  std::atomic<uint64_t> PathsGeneration{};
+  bool IsRootFSMiss(std::string const &Path);
+  void AddRootFSMiss(std::string const &Path, bool Follow, uint64_t Generation);
+  void ForgetRootFSMisses(std::string const &Location);
+
   FEXCore::Config::Value<std::string> Filename{FEXCore::Config::CONFIG_APP_FILENAME, ""};
   FEXCore::Config::Value<std::string> LDPath{FEXCore::Config::CONFIG_ROOTFSPATH, ""};
 };
@@ -85,10 +85,11 @@ namespace FEX::HLE {
       LogMan::Msg::E("[%d] Thread has received a signal and hasn't registered itself with the delegate! Programming error!", gettid());
     }
     else {
-      if (Handler.Handler &&
-          Handler.Handler(Thread, Signal, Info, UContext)) {
-        // If the host handler handled the fault then we can continue now
-        return;
+      for (size_t i = Handler.HandlerCount.load(std::memory_order_acquire); i > 0; --i) {
+        if (Handler.Handlers[i - 1](Thread, Signal, Info, UContext)) {
+          // If the host handler handled the fault then we can continue now
+          return;
+        }
       }
 
       if (Handler.FrontendHandler &&
@@ -416,7 +417,11 @@ namespace FEX::HLE {
     // Linux signal handlers are per-process rather than per thread
     // Multiple threads could be calling in to this
     std::lock_guard<std::mutex> lk(HostDelegatorMutex);
-    HostHandlers[Signal].Handler = Func;
+    auto &Handler = HostHandlers[Signal];
+    size_t Count = Handler.HandlerCount.load(std::memory_order_relaxed);
+    LogMan::Throw::A(Count < MAX_HOST_HANDLERS, "Too many host handlers for signal %d", Signal);
+    Handler.Handlers[Count] = Func;
+    Handler.HandlerCount.store(Count + 1, std::memory_order_release);
     InstallHostThunk(Signal);
   }
 
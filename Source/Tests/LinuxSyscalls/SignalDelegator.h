@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <mutex>
@@ -81,6 +82,8 @@ namespace FEX::HLE {
     void SetCurrentSignal(uint32_t Signal) override;
 
   private:
+    constexpr static size_t MAX_HOST_HANDLERS = 4;
+
     enum DefaultBehaviour {
       DEFAULT_TERM,
       // Core dump based signals are supposed to have a coredump appear
@@ -93,7 +96,9 @@ namespace FEX::HLE {
       std::atomic<bool> Installed{};
       struct sigaction HostAction{};
       struct sigaction OldAction{};
-      FEXCore::HostSignalDelegatorFunction Handler{};
+      // Chained, the last one registered runs first. Slots are filled before the count is bumped
+      std::array<FEXCore::HostSignalDelegatorFunction, MAX_HOST_HANDLERS> Handlers{};
+      std::atomic<size_t> HandlerCount{};
       FEXCore::HostSignalDelegatorFunction FrontendHandler{};
       FEXCore::HostSignalDelegatorFunctionForGuest GuestHandler{};
       FEXCore::GuestSigAction GuestAction{};
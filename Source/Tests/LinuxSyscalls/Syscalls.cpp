@@ -5,7 +5,9 @@
 #include "Tests/LinuxSyscalls/x64/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
 
+#include <FEXCore/Core/Context.h>
 #include <FEXCore/Core/X86Enums.h>
+#include <FEXCore/Debug/InternalThreadState.h>
 #include <fcntl.h>
 #include <limits.h>
 #include <linux/futex.h>
@@ -18,6 +20,7 @@
 #include <sys/utsname.h>
 #include <sys/shm.h>
 #include <sys/syscall.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace FEX::HLE {
@@ -50,7 +53,10 @@ uint64_t SyscallHandler::HandleBRK(FEXCore::Core::InternalThreadState *Thread, v
 
         uint64_t RemainingSize = DataSpaceMaxSize - NewSizeAligned;
         // We have pages we can unmap
+        FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
         munmap(reinterpret_cast<void*>(DataSpace + NewSizeAligned), RemainingSize);
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, DataSpace + NewSizeAligned, RemainingSize);
+        FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
         DataSpaceMaxSize = NewSizeAligned;
       }
       else if (NewSize > DataSpaceMaxSize) {
@@ -76,6 +82,7 @@ uint64_t SyscallHandler::HandleBRK(FEXCore::Core::InternalThreadState *Thread, v
           return DataSpace + DataSpaceSize;
         }
         else {
+          FEXCore::Context::GuestMemoryMapped(Thread->CTX, NewBRK, AllocateNewSize, PROT_READ | PROT_WRITE);
           // Increase our BRK size
           DataSpaceMaxSize += AllocateNewSize;
         }
@@ -148,6 +155,17 @@ uint64_t SyscallHandler::HandleSyscall(FEXCore::Core::InternalThreadState *Threa
   return Result;
 }
 
+void PrepareKernelWrite(FEXCore::Core::InternalThreadState *Thread, const struct iovec *iov, int iovcnt) {
+  if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+    // The kernel rejects these before writing anything
+    return;
+  }
+
+  for (int i = 0; i < iovcnt; ++i) {
+    FEXCore::Context::PrepareGuestMemoryHostWrite(Thread->CTX, reinterpret_cast<uintptr_t>(iov[i].iov_base), iov[i].iov_len);
+  }
+}
+
 #ifdef DEBUG_STRACE
 void SyscallHandler::Strace(FEXCore::HLE::SyscallArguments *Args, uint64_t Ret) {
   auto &Def = Definitions[Args->Argument[0]];
@@ -143,6 +143,9 @@ FEX::HLE::SyscallHandler *CreateHandler(FEXCore::Context::OperatingMode Mode,
   );
 uint64_t HandleSyscall(SyscallHandler *Handler, FEXCore::Core::InternalThreadState *Thread, FEXCore::HLE::SyscallArguments *Args);
 
+// The kernel can't fault in to the SMC handler, code pages in the guest buffers it fills need their write access back first
+void PrepareKernelWrite(FEXCore::Core::InternalThreadState *Thread, const struct iovec *iov, int iovcnt);
+
 #define SYSCALL_ERRNO() do { if (Result == -1) return -errno; return Result; } while(0)
 #define SYSCALL_ERRNO_NULL() do { if (Result == 0) return -errno; return Result; } while(0)
 
@@ -1,6 +1,8 @@
 #include "Tests/LinuxSyscalls/Syscalls.h"
 #include "Tests/LinuxSyscalls/x64/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Debug/InternalThreadState.h>
 
 #include <fcntl.h>
 #include <stdint.h>
@@ -38,6 +40,7 @@ namespace FEX::HLE {
 
   void RegisterFD() {
     REGISTER_SYSCALL_IMPL(read, [](FEXCore::Core::InternalThreadState *Thread, int fd, void *buf, size_t count) -> uint64_t {
+      FEXCore::Context::PrepareGuestMemoryHostWrite(Thread->CTX, reinterpret_cast<uintptr_t>(buf), count);
       uint64_t Result = ::read(fd, buf, count);
       SYSCALL_ERRNO();
     });
@@ -82,6 +85,7 @@ namespace FEX::HLE {
     });
 
     REGISTER_SYSCALL_IMPL(pread64, [](FEXCore::Core::InternalThreadState *Thread, int fd, void *buf, size_t count, off_t offset) -> uint64_t {
+      FEXCore::Context::PrepareGuestMemoryHostWrite(Thread->CTX, reinterpret_cast<uintptr_t>(buf), count);
       uint64_t Result = ::pread64(fd, buf, count, offset);
       SYSCALL_ERRNO();
     });
@@ -180,11 +184,17 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(mkdirat, [](FEXCore::Core::InternalThreadState *Thread, int dirfd, const char *pathname, mode_t mode) -> uint64_t {
       uint64_t Result = ::mkdirat(dirfd, pathname, mode);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(dirfd, pathname);
+      }
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL(mknodat, [](FEXCore::Core::InternalThreadState *Thread, int dirfd, const char *pathname, mode_t mode, dev_t dev) -> uint64_t {
       uint64_t Result = ::mknodat(dirfd, pathname, mode, dev);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(dirfd, pathname);
+      }
       SYSCALL_ERRNO();
     });
 
@@ -200,16 +210,25 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(renameat, [](FEXCore::Core::InternalThreadState *Thread, int olddirfd, const char *oldpath, int newdirfd, const char *newpath) -> uint64_t {
       uint64_t Result = ::renameat(olddirfd, oldpath, newdirfd, newpath);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(newdirfd, newpath);
+      }
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL(linkat, [](FEXCore::Core::InternalThreadState *Thread, int olddirfd, const char *oldpath, int newdirfd, const char *newpath, int flags) -> uint64_t {
       uint64_t Result = ::linkat(olddirfd, oldpath, newdirfd, newpath, flags);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(newdirfd, newpath);
+      }
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL(symlinkat, [](FEXCore::Core::InternalThreadState *Thread, const char *target, int newdirfd, const char *linkpath) -> uint64_t {
       uint64_t Result = ::symlinkat(target, newdirfd, linkpath);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(newdirfd, linkpath);
+      }
       SYSCALL_ERRNO();
     });
 
@@ -277,6 +296,12 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(renameat2, [](FEXCore::Core::InternalThreadState *Thread, int olddirfd, const char *oldpath, int newdirfd, const char *newpath, unsigned int flags) -> uint64_t {
       uint64_t Result = ::renameat2(olddirfd, oldpath, newdirfd, newpath, flags);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(newdirfd, newpath);
+        if (flags & RENAME_EXCHANGE) {
+          FEX::HLE::_SyscallHandler->FM.PathsChanged(olddirfd, oldpath);
+        }
+      }
       SYSCALL_ERRNO();
     });
 
@@ -33,11 +33,17 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(rename, [](FEXCore::Core::InternalThreadState *Thread, const char *oldpath, const char *newpath) -> uint64_t {
       uint64_t Result = ::rename(oldpath, newpath);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(AT_FDCWD, newpath);
+      }
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL(mkdir, [](FEXCore::Core::InternalThreadState *Thread, const char *pathname, mode_t mode) -> uint64_t {
       uint64_t Result = ::mkdir(pathname, mode);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(AT_FDCWD, pathname);
+      }
       SYSCALL_ERRNO();
     });
 
@@ -48,6 +54,9 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(link, [](FEXCore::Core::InternalThreadState *Thread, const char *oldpath, const char *newpath) -> uint64_t {
       uint64_t Result = ::link(oldpath, newpath);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(AT_FDCWD, newpath);
+      }
       SYSCALL_ERRNO();
     });
 
@@ -58,6 +67,9 @@ namespace FEX::HLE {
 
     REGISTER_SYSCALL_IMPL(symlink, [](FEXCore::Core::InternalThreadState *Thread, const char *target, const char *linkpath) -> uint64_t {
       uint64_t Result = ::symlink(target, linkpath);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(AT_FDCWD, linkpath);
+      }
       SYSCALL_ERRNO();
     });
 
@@ -119,13 +131,19 @@ namespace FEX::HLE {
     });*/
     REGISTER_SYSCALL_FORWARD_ERRNO(truncate);
 
-    /*REGISTER_SYSCALL_IMPL(creat, [](FEXCore::Core::InternalThreadState *Thread, const char *pathname, mode_t mode) -> uint64_t {
-      SYSCALL_STUB(creat);
-    });*/
-    REGISTER_SYSCALL_FORWARD_ERRNO(creat);
+    REGISTER_SYSCALL_IMPL(creat, [](FEXCore::Core::InternalThreadState *Thread, const char *pathname, mode_t mode) -> uint64_t {
+      uint64_t Result = ::creat(pathname, mode);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged(AT_FDCWD, pathname);
+      }
+      SYSCALL_ERRNO();
+    });
 
     REGISTER_SYSCALL_IMPL(chroot, [](FEXCore::Core::InternalThreadState *Thread, const char *path) -> uint64_t {
       uint64_t Result = ::chroot(path);
+      if (Result != -1) {
+        FEX::HLE::_SyscallHandler->FM.PathsChanged();
+      }
       SYSCALL_ERRNO();
     });
 
@@ -2,11 +2,21 @@
 #include "Tests/LinuxSyscalls/x64/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
 
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Debug/InternalThreadState.h>
+
+#include <map>
+#include <mutex>
 #include <stddef.h>
 #include <stdint.h>
+#include <sys/mman.h>
 #include <sys/shm.h>
 
 namespace FEX::HLE {
+  // shmdt only gets the address, remember how large each attached segment was
+  static std::mutex AttachedSegmentsMutex;
+  static std::map<uintptr_t, uint64_t> AttachedSegments;
+
   void RegisterSHM() {
     REGISTER_SYSCALL_IMPL(shmget, [](FEXCore::Core::InternalThreadState *Thread, key_t key, size_t size, int shmflg) -> uint64_t {
       uint64_t Result = shmget(key, size, shmflg);
@@ -18,8 +28,41 @@ namespace FEX::HLE {
       SYSCALL_ERRNO();
     });
 
+    REGISTER_SYSCALL_IMPL_X64(shmat, [](FEXCore::Core::InternalThreadState *Thread, int shmid, const void *shmaddr, int shmflg) -> uint64_t {
+      // SHM_REMAP can replace code
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
+      uint64_t Result = reinterpret_cast<uint64_t>(shmat(shmid, shmaddr, shmflg));
+      if (Result != -1) {
+        struct shmid_ds Stat{};
+        if (::shmctl(shmid, IPC_STAT, &Stat) == 0) {
+          int Prot = PROT_READ;
+          Prot |= (shmflg & SHM_RDONLY) ? 0 : PROT_WRITE;
+          Prot |= (shmflg & SHM_EXEC) ? PROT_EXEC : 0;
+          {
+            std::scoped_lock<std::mutex> lk(AttachedSegmentsMutex);
+            AttachedSegments[Result] = Stat.shm_segsz;
+          }
+          FEXCore::Context::GuestMemoryMapped(Thread->CTX, Result, Stat.shm_segsz, Prot);
+        }
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
+      SYSCALL_ERRNO();
+    });
+
     REGISTER_SYSCALL_IMPL(shmdt, [](FEXCore::Core::InternalThreadState *Thread, const void *shmaddr) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
+      std::unique_lock<std::mutex> lk(AttachedSegmentsMutex);
       uint64_t Result = ::shmdt(shmaddr);
+      if (Result != -1) {
+        auto it = AttachedSegments.find(reinterpret_cast<uintptr_t>(shmaddr));
+        if (it != AttachedSegments.end()) {
+          uint64_t Length = it->second;
+          AttachedSegments.erase(it);
+          lk.unlock();
+          FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, reinterpret_cast<uintptr_t>(shmaddr), Length);
+        }
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       SYSCALL_ERRNO();
     });
   }
@@ -1,6 +1,8 @@
 #include "Tests/LinuxSyscalls/Syscalls.h"
 #include "Tests/LinuxSyscalls/x64/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Debug/InternalThreadState.h>
 
 #include <stddef.h>
 #include <stdint.h>
@@ -30,6 +32,7 @@ namespace FEX::HLE {
     });
 
     REGISTER_SYSCALL_IMPL(recvfrom, [](FEXCore::Core::InternalThreadState *Thread, int sockfd, void *buf, size_t len, int flags, struct sockaddr *src_addr, socklen_t *addrlen) -> uint64_t {
+      FEXCore::Context::PrepareGuestMemoryHostWrite(Thread->CTX, reinterpret_cast<uintptr_t>(buf), len);
       uint64_t Result = ::recvfrom(sockfd, buf, len, flags, src_addr, addrlen);
       SYSCALL_ERRNO();
     });
@@ -40,6 +43,7 @@ namespace FEX::HLE {
     });
 
     REGISTER_SYSCALL_IMPL(recvmsg, [](FEXCore::Core::InternalThreadState *Thread, int sockfd, struct msghdr *msg, int flags) -> uint64_t {
+      PrepareKernelWrite(Thread, msg->msg_iov, msg->msg_iovlen);
       uint64_t Result = ::recvmsg(sockfd, msg, flags);
       SYSCALL_ERRNO();
     });
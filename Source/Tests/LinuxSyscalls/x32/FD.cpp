@@ -123,21 +123,23 @@ namespace FEX::HLE::x32 {
     });
 
     REGISTER_SYSCALL_IMPL_X32(readv, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      uint64_t Result = ::readv(fd, &Host_iovec.at(0), iovcnt);
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      PrepareKernelWrite(Thread, Host_iovec, iovcnt);
+      uint64_t Result = ::readv(fd, Host_iovec, iovcnt);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(writev, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
-      uint64_t Result = ::writev(fd, &Host_iovec.at(0), iovcnt);
+
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      uint64_t Result = ::writev(fd, Host_iovec, iovcnt);
       SYSCALL_ERRNO();
     });
 
@@ -300,74 +302,70 @@ namespace FEX::HLE::x32 {
     });
 
     REGISTER_SYSCALL_IMPL_X32(preadv, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt, off_t offset) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      uint64_t Result = ::preadv(fd, &Host_iovec.at(0), iovcnt, offset);
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      PrepareKernelWrite(Thread, Host_iovec, iovcnt);
+      uint64_t Result = ::preadv(fd, Host_iovec, iovcnt, offset);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(pwritev, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt, off_t offset) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      uint64_t Result = ::pwritev(fd, &Host_iovec.at(0), iovcnt, offset);
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      uint64_t Result = ::pwritev(fd, Host_iovec, iovcnt, offset);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(process_vm_readv, [](FEXCore::Core::InternalThreadState *Thread, pid_t pid, const struct iovec32 *local_iov, unsigned long liovcnt, const struct iovec32 *remote_iov, unsigned long riovcnt, unsigned long flags) -> uint64_t {
-      std::vector<iovec> Host_local_iovec(liovcnt);
-      std::vector<iovec> Host_remote_iovec(riovcnt);
-
-      for (int i = 0; i < liovcnt; ++i) {
-        Host_local_iovec[i] = local_iov[i];
+      if (liovcnt > UIO_MAXIOV || riovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      for (int i = 0; i < riovcnt; ++i) {
-        Host_remote_iovec[i] = remote_iov[i];
-      }
+      // Parenthesized to keep the template arguments together in the macro
+      auto Host_local_iovec = (ConvertToScratch<iovec, 0>(local_iov, liovcnt));
+      auto Host_remote_iovec = (ConvertToScratch<iovec, 1>(remote_iov, riovcnt));
 
-      uint64_t Result = ::process_vm_readv(pid, &Host_local_iovec.at(0), liovcnt, &Host_remote_iovec.at(0), riovcnt, flags);
+      uint64_t Result = ::process_vm_readv(pid, Host_local_iovec, liovcnt, Host_remote_iovec, riovcnt, flags);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(process_vm_writev, [](FEXCore::Core::InternalThreadState *Thread, pid_t pid, const struct iovec32 *local_iov, unsigned long liovcnt, const struct iovec32 *remote_iov, unsigned long riovcnt, unsigned long flags) -> uint64_t {
-      std::vector<iovec> Host_local_iovec(liovcnt);
-      std::vector<iovec> Host_remote_iovec(riovcnt);
-
-      for (int i = 0; i < liovcnt; ++i) {
-        Host_local_iovec[i] = local_iov[i];
+      if (liovcnt > UIO_MAXIOV || riovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      for (int i = 0; i < riovcnt; ++i) {
-        Host_remote_iovec[i] = remote_iov[i];
-      }
+      // Parenthesized to keep the template arguments together in the macro
+      auto Host_local_iovec = (ConvertToScratch<iovec, 0>(local_iov, liovcnt));
+      auto Host_remote_iovec = (ConvertToScratch<iovec, 1>(remote_iov, riovcnt));
 
-      uint64_t Result = ::process_vm_writev(pid, &Host_local_iovec.at(0), liovcnt, &Host_remote_iovec.at(0), riovcnt, flags);
+      uint64_t Result = ::process_vm_writev(pid, Host_local_iovec, liovcnt, Host_remote_iovec, riovcnt, flags);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(preadv2, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt, off_t offset, int flags) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      uint64_t Result = ::preadv2(fd, &Host_iovec.at(0), iovcnt, offset, flags);
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      PrepareKernelWrite(Thread, Host_iovec, iovcnt);
+      uint64_t Result = ::preadv2(fd, Host_iovec, iovcnt, offset, flags);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(pwritev2, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec32 *iov, int iovcnt, off_t offset, int flags) -> uint64_t {
-      std::vector<iovec> Host_iovec(iovcnt);
-      for (int i = 0; i < iovcnt; ++i) {
-        Host_iovec[i] = iov[i];
+      if (iovcnt < 0 || iovcnt > UIO_MAXIOV) {
+        return -EINVAL;
       }
 
-      uint64_t Result = ::pwritev2(fd, &Host_iovec.at(0), iovcnt, offset, flags);
+      auto Host_iovec = ConvertToScratch<iovec>(iov, iovcnt);
+      uint64_t Result = ::pwritev2(fd, Host_iovec, iovcnt, offset, flags);
       SYSCALL_ERRNO();
     });
 
@@ -386,8 +384,11 @@ namespace FEX::HLE::x32 {
 
     REGISTER_SYSCALL_IMPL_X32(getdents, [](FEXCore::Core::InternalThreadState *Thread, int fd, void *dirp, uint32_t count) -> uint64_t {
 #ifdef SYS_getdents
-      std::vector<uint8_t> TmpVector(count);
-      void *TmpPtr = reinterpret_cast<void*>(&TmpVector.at(0));
+      // The guest picks the size, the kernel is fine returning fewer entries than would fit
+      // Keeps the scratch buffer of this thread from growing to whatever was asked for
+      constexpr uint32_t MAX_GETDENTS_SIZE = 64 * 1024;
+      count = std::min(count, MAX_GETDENTS_SIZE);
+      void *TmpPtr = ScratchBuffer<>::Get(count);
 
       // Copy the incoming structures to our temporary array
       for (uint64_t Offset = 0, TmpOffset = 0;
@@ -401,6 +402,10 @@ namespace FEX::HLE::x32 {
         }
 
         size_t NewRecLen = Incoming->d_reclen + (sizeof(linux_dirent) - sizeof(linux_dirent_32));
+        if ((TmpOffset + NewRecLen) > count) {
+          break;
+        }
+
         Tmp->d_ino    = Incoming->d_ino;
         Tmp->d_off    = Incoming->d_off;
         Tmp->d_reclen = NewRecLen;
@@ -21,9 +21,16 @@ namespace FEX::HLE::x32 {
 
   void RegisterMemory() {
     REGISTER_SYSCALL_IMPL_X32(mmap, [](FEXCore::Core::InternalThreadState *Thread, uint32_t addr, uint32_t length, int prot, int flags, int fd, int32_t offset) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       auto Result = (uint64_t)static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
         mmap(reinterpret_cast<void*>(addr), length, prot,flags, fd, offset);
 
+      // The allocator returns -errno on failure
+      if (static_cast<int64_t>(Result) >= 0) {
+        FEXCore::Context::GuestMemoryMapped(Thread->CTX, Result, length, prot);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
+
       if (Result != -1 && !(flags & MAP_ANONYMOUS)) {
         auto filename = get_fdpath(fd);
 
@@ -34,9 +41,16 @@ namespace FEX::HLE::x32 {
     });
 
     REGISTER_SYSCALL_IMPL_X32(mmap2, [](FEXCore::Core::InternalThreadState *Thread, uint32_t addr, uint32_t length, int prot, int flags, int fd, uint32_t pgoffset) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       auto Result = (uint64_t)static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
         mmap(reinterpret_cast<void*>(addr), length, prot,flags, fd, (uint64_t)pgoffset * 0x1000);
-      
+
+      // The allocator returns -errno on failure
+      if (static_cast<int64_t>(Result) >= 0) {
+        FEXCore::Context::GuestMemoryMapped(Thread->CTX, Result, length, prot);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
+
       if (Result != -1 && !(flags & MAP_ANONYMOUS)) {
         auto filename = get_fdpath(fd);
 
@@ -47,22 +61,39 @@ namespace FEX::HLE::x32 {
     });
 
     REGISTER_SYSCALL_IMPL_X32(munmap, [](FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       auto Result = static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
         munmap(addr, length);
       if (Result != -1) {
         FEXCore::Context::RemoveNamedRegion(Thread->CTX, (uintptr_t)addr, length);
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, (uintptr_t)addr, length);
       }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       return Result;
     });
 
     REGISTER_SYSCALL_IMPL_X32(mprotect, [](FEXCore::Core::InternalThreadState *Thread, void *addr, uint32_t len, int prot) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       uint64_t Result = ::mprotect(addr, len, prot);
+      if (Result != -1) {
+        FEXCore::Context::GuestMemoryProtected(Thread->CTX, (uintptr_t)addr, len, prot);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X32(mremap, [](FEXCore::Core::InternalThreadState *Thread, void *old_address, size_t old_size, size_t new_size, int flags, void *new_address) -> uint64_t {
-      return reinterpret_cast<uint64_t>(static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
+      uint64_t Result = reinterpret_cast<uint64_t>(static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
         mremap(old_address, old_size, new_size, flags, new_address));
+
+      if (static_cast<int64_t>(Result) >= 0) {
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, (uintptr_t)old_address, old_size);
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, Result, new_size);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
+
+      return Result;
     });
 
     REGISTER_SYSCALL_IMPL_X32(mlockall, [](FEXCore::Core::InternalThreadState *Thread, int flags) -> uint64_t {
@@ -1,9 +1,12 @@
 #include "Tests/LinuxSyscalls/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
 
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Debug/InternalThreadState.h>
 #include <FEXCore/Utils/LogManager.h>
 
 #include <sys/ipc.h>
+#include <sys/mman.h>
 #include <sys/msg.h>
 #include <sys/sem.h>
 #include <sys/shm.h>
@@ -688,13 +691,31 @@ namespace FEX::HLE::x32 {
         break;
       }
       case OP_SHMAT: {
+        // SHM_REMAP can replace code
+        FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
         Result = static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
           shmat(first, reinterpret_cast<const void*>(ptr), second, reinterpret_cast<uint32_t*>(third));
+        if (Result == 0) {
+          struct shmid_ds Stat{};
+          if (::shmctl(first, IPC_STAT, &Stat) == 0) {
+            int Prot = PROT_READ;
+            Prot |= (second & SHM_RDONLY) ? 0 : PROT_WRITE;
+            Prot |= (second & SHM_EXEC) ? PROT_EXEC : 0;
+            FEXCore::Context::GuestMemoryMapped(Thread->CTX, *reinterpret_cast<uint32_t*>(third), Stat.shm_segsz, Prot);
+          }
+        }
+        FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
         break;
       }
       case OP_SHMDT: {
+        uint64_t SegmentSize{};
+        FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
         Result = static_cast<FEX::HLE::x32::x32SyscallHandler*>(FEX::HLE::_SyscallHandler)->GetAllocator()->
-          shmdt(reinterpret_cast<void*>(ptr));
+          shmdt(reinterpret_cast<void*>(ptr), &SegmentSize);
+        if (Result == 0 && SegmentSize) {
+          FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, ptr, SegmentSize);
+        }
+        FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
         break;
       }
       case OP_SHMGET: {
@@ -1,6 +1,8 @@
 #include "Tests/LinuxSyscalls/Syscalls.h"
 #include "Tests/LinuxSyscalls/x32/Syscalls.h"
 
+#include <FEXCore/Core/Context.h>
+#include <FEXCore/Debug/InternalThreadState.h>
 #include <FEXCore/Utils/LogManager.h>
 
 #include <cstring>
@@ -90,6 +92,7 @@ namespace FEX::HLE::x32 {
           break;
         }
         case OP_RECVFROM: {
+          FEXCore::Context::PrepareGuestMemoryHostWrite(Thread->CTX, Arguments[1], Arguments[2]);
           Result = ::recvfrom(
             Arguments[0],
             reinterpret_cast<void*>(Arguments[1]),
@@ -126,16 +129,17 @@ namespace FEX::HLE::x32 {
         case OP_SENDMSG: {
           const struct msghdr32 *guest_msg = reinterpret_cast<const struct msghdr32*>(Arguments[1]);
 
-          struct msghdr HostHeader{};
-          std::vector<iovec> Host_iovec(guest_msg->msg_iovlen);
-          for (int i = 0; i < guest_msg->msg_iovlen; ++i) {
-            Host_iovec[i] = guest_msg->msg_iov[i];
+          if (guest_msg->msg_iovlen > UIO_MAXIOV) {
+            return -EMSGSIZE;
           }
 
+          struct msghdr HostHeader{};
+          auto Host_iovec = ConvertToScratch<iovec>(static_cast<iovec32*>(guest_msg->msg_iov), guest_msg->msg_iovlen);
+
           HostHeader.msg_name = guest_msg->msg_name;
           HostHeader.msg_namelen = guest_msg->msg_namelen;
 
-          HostHeader.msg_iov = &Host_iovec.at(0);
+          HostHeader.msg_iov = Host_iovec;
           HostHeader.msg_iovlen = guest_msg->msg_iovlen;
 
           HostHeader.msg_control = alloca(guest_msg->msg_controllen * 2);
@@ -182,16 +186,17 @@ namespace FEX::HLE::x32 {
         case OP_RECVMSG: {
           struct msghdr32 *guest_msg = reinterpret_cast<struct msghdr32*>(Arguments[1]);
 
-          struct msghdr HostHeader{};
-          std::vector<iovec> Host_iovec(guest_msg->msg_iovlen);
-          for (int i = 0; i < guest_msg->msg_iovlen; ++i) {
-            Host_iovec[i] = guest_msg->msg_iov[i];
+          if (guest_msg->msg_iovlen > UIO_MAXIOV) {
+            return -EMSGSIZE;
           }
 
+          struct msghdr HostHeader{};
+          auto Host_iovec = ConvertToScratch<iovec>(static_cast<iovec32*>(guest_msg->msg_iov), guest_msg->msg_iovlen);
+
           HostHeader.msg_name = guest_msg->msg_name;
           HostHeader.msg_namelen = guest_msg->msg_namelen;
 
-          HostHeader.msg_iov = &Host_iovec.at(0);
+          HostHeader.msg_iov = Host_iovec;
           HostHeader.msg_iovlen = guest_msg->msg_iovlen;
 
           HostHeader.msg_control = alloca(guest_msg->msg_controllen);
@@ -199,11 +204,10 @@ namespace FEX::HLE::x32 {
 
           HostHeader.msg_flags = guest_msg->msg_flags;
 
+          PrepareKernelWrite(Thread, Host_iovec, guest_msg->msg_iovlen);
           Result = ::recvmsg(Arguments[0], &HostHeader, Arguments[2]);
           if (Result != -1) {
-            for (int i = 0; i < guest_msg->msg_iovlen; ++i) {
-              guest_msg->msg_iov[i] = Host_iovec[i];
-            }
+            ConvertArray(static_cast<iovec32*>(guest_msg->msg_iov), Host_iovec, guest_msg->msg_iovlen);
 
             guest_msg->msg_namelen = HostHeader.msg_namelen;
             guest_msg->msg_controllen = HostHeader.msg_controllen;
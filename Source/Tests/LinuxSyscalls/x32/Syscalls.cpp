@@ -455,7 +455,7 @@ restart:
     }
   }
 }
-uint64_t MemAllocator::shmdt(const void* shmaddr) {
+uint64_t MemAllocator::shmdt(const void* shmaddr, uint64_t *SegmentSize) {
   uint32_t AddrPage = reinterpret_cast<uint64_t>(shmaddr) >> PAGE_SHIFT;
   auto it = PageToShm.find(AddrPage);
 
@@ -464,6 +464,9 @@ uint64_t MemAllocator::shmdt(const void* shmaddr) {
     return -EINVAL;
   }
 
+  struct shmid_ds Stat{};
+  *SegmentSize = ::shmctl(it->second, IPC_STAT, &Stat) == 0 ? Stat.shm_segsz : 0;
+
   uint64_t Result = ::shmdt(shmaddr);
   PageToShm.erase(it);
   return Result;
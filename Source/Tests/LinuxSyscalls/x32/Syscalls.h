@@ -54,7 +54,7 @@ public:
   int munmap(void *addr, size_t length);
   void *mremap(void *old_address, size_t old_size, size_t new_size, int flags, void *new_address);
   uint64_t shmat(int shmid, const void* shmaddr, int shmflg, uint32_t *ResultAddress);
-  uint64_t shmdt(const void* shmaddr);
+  uint64_t shmdt(const void* shmaddr, uint64_t *SegmentSize);
   static constexpr bool SearchDown = true;
 
   // PageAddr is a page already shifted to page index
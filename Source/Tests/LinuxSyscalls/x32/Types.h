@@ -2,10 +2,12 @@
 
 #include <FEXCore/Core/SignalDelegator.h>
 
+#include <algorithm>
 #include <bits/types/stack_t.h>
 #include <cstdint>
 #include <cstring>
 #include <fcntl.h>
+#include <memory>
 #include <sys/resource.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
@@ -609,4 +611,46 @@ struct __attribute__((packed)) GuestSigAction_32 {
 static_assert(std::is_trivial<GuestSigAction_32>::value, "Needs to be trivial");
 static_assert(sizeof(GuestSigAction_32) == 24, "Incorrect size");
 
+
+/**
+ * @name Scratch space
+ *
+ * Per thread space for translating syscall arguments without allocating
+ * Grows to the largest request the thread has made and gets reused after that
+ * Each Slot is a separate buffer, so a syscall can hold more than one translation at once
+ * @{ */
+
+template<size_t Slot = 0>
+class ScratchBuffer final {
+public:
+  // Only valid until the next Get on the same Slot from this thread
+  static void *Get(size_t Size) {
+    thread_local std::unique_ptr<uint8_t[]> Buffer;
+    thread_local size_t Capacity{};
+    if (Size > Capacity) {
+      Capacity = std::max<size_t>(Size, 4096);
+      Buffer.reset(new uint8_t[Capacity]);
+    }
+    return Buffer.get();
+  }
+};
+
+// Plain loop over trivial types using the conversion operators above, the compiler is free to vectorize it
+template<typename DestType, typename SrcType>
+void ConvertArray(DestType *Dest, SrcType const *Src, size_t Count) {
+  static_assert(std::is_trivial<DestType>::value && std::is_trivial<SrcType>::value, "Needs to be trivial");
+  for (size_t i = 0; i < Count; ++i) {
+    Dest[i] = Src[i];
+  }
+}
+
+// Converts an array of guest structs in to host structs living in scratch space
+template<typename HostType, size_t Slot = 0, typename GuestType>
+HostType *ConvertToScratch(GuestType const *Guest, size_t Count) {
+  auto Host = static_cast<HostType*>(ScratchBuffer<Slot>::Get(sizeof(HostType) * Count));
+  ConvertArray(Host, Guest, Count);
+  return Host;
+}
+/**  @} */
+
 }
@@ -118,6 +118,7 @@ namespace FEX::HLE::x64 {
     });
 
     REGISTER_SYSCALL_IMPL_X64(readv, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec *iov, int iovcnt) -> uint64_t {
+      PrepareKernelWrite(Thread, iov, iovcnt);
       uint64_t Result = ::readv(fd, iov, iovcnt);
       SYSCALL_ERRNO();
     });
@@ -142,6 +143,7 @@ namespace FEX::HLE::x64 {
     });
 
     REGISTER_SYSCALL_IMPL_X64(preadv, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec *iov, int iovcnt, off_t offset) -> uint64_t {
+      PrepareKernelWrite(Thread, iov, iovcnt);
       uint64_t Result = ::preadv(fd, iov, iovcnt, offset);
       SYSCALL_ERRNO();
     });
@@ -152,6 +154,7 @@ namespace FEX::HLE::x64 {
     });
 
     REGISTER_SYSCALL_IMPL_X64(preadv2, [](FEXCore::Core::InternalThreadState *Thread, int fd, const struct iovec *iov, int iovcnt, off_t offset, int flags) -> uint64_t {
+      PrepareKernelWrite(Thread, iov, iovcnt);
       uint64_t Result = ::preadv2(fd, iov, iovcnt, offset, flags);
       SYSCALL_ERRNO();
     });
@@ -22,16 +22,24 @@ static std::string get_fdpath(int fd)
 namespace FEX::HLE::x64 {
   void RegisterMemory() {
     REGISTER_SYSCALL_IMPL_X64(munmap, [](FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       uint64_t Result = ::munmap(addr, length);
       if (Result != -1) {
         FEXCore::Context::RemoveNamedRegion(Thread->CTX, (uintptr_t)addr, length);
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, (uintptr_t)addr, length);
       }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X64(mmap, [](FEXCore::Core::InternalThreadState *Thread, void *addr, size_t length, int prot, int flags, int fd, off_t offset) -> uint64_t {
       static FEXCore::Config::Value<bool> AOTIRLoad(FEXCore::Config::CONFIG_AOTIR_LOAD, false);
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       uint64_t Result = reinterpret_cast<uint64_t>(::mmap(addr, length, prot, flags, fd, offset));
+      if (Result != -1) {
+        FEXCore::Context::GuestMemoryMapped(Thread->CTX, Result, length, prot);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       if (Result != -1 && !(flags & MAP_ANONYMOUS)) {
         auto filename = get_fdpath(fd);
 
@@ -41,12 +49,23 @@ namespace FEX::HLE::x64 {
     });
 
     REGISTER_SYSCALL_IMPL_X64(mremap, [](FEXCore::Core::InternalThreadState *Thread, void *old_address, size_t old_size, size_t new_size, int flags, void *new_address) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       uint64_t Result = reinterpret_cast<uint64_t>(::mremap(old_address, old_size, new_size, flags, new_address));
+      if (Result != -1) {
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, (uintptr_t)old_address, old_size);
+        FEXCore::Context::GuestMemoryUnmapped(Thread->CTX, Result, new_size);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       SYSCALL_ERRNO();
     });
 
     REGISTER_SYSCALL_IMPL_X64(mprotect, [](FEXCore::Core::InternalThreadState *Thread, void *addr, size_t len, int prot) -> uint64_t {
+      FEXCore::Context::GuestMemoryChangeBegin(Thread->CTX);
       uint64_t Result = ::mprotect(addr, len, prot);
+      if (Result != -1) {
+        FEXCore::Context::GuestMemoryProtected(Thread->CTX, (uintptr_t)addr, len, prot);
+      }
+      FEXCore::Context::GuestMemoryChangeEnd(Thread->CTX);
       SYSCALL_ERRNO();
     });
 
@@ -59,10 +78,5 @@ namespace FEX::HLE::x64 {
       uint64_t Result = ::munlockall();
       SYSCALL_ERRNO();
     });
-
-    REGISTER_SYSCALL_IMPL_X64(shmat, [](FEXCore::Core::InternalThreadState *Thread, int shmid, const void *shmaddr, int shmflg) -> uint64_t {
-      uint64_t Result = reinterpret_cast<uint64_t>(shmat(shmid, shmaddr, shmflg));
-      SYSCALL_ERRNO();
-    });
   }
 }
@@ -71,9 +71,13 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::Value<std::string> OutputLog{FEXCore::Config::CONFIG_OUTPUTLOG, "stderr"};
   FEXCore::Config::Value<std::string> DumpIR{FEXCore::Config::CONFIG_DUMPIR, "no"};
   FEXCore::Config::Value<bool> TSOEnabledConfig{FEXCore::Config::CONFIG_TSO_ENABLED, true};
-  FEXCore::Config::Value<bool> SMCChecksConfig{FEXCore::Config::CONFIG_SMC_CHECKS, false};
+  FEXCore::Config::Value<uint8_t> SMCChecksConfig{FEXCore::Config::CONFIG_SMC_CHECKS, FEXCore::Config::CONFIG_SMC_NONE};
   FEXCore::Config::Value<bool> ABILocalFlags{FEXCore::Config::CONFIG_ABI_LOCAL_FLAGS, false};
   FEXCore::Config::Value<bool> AbiNoPF{FEXCore::Config::CONFIG_ABI_NO_PF, false};
+  FEXCore::Config::Value<uint8_t> HugePages{FEXCore::Config::CONFIG_HUGEPAGES, FEXCore::Config::CONFIG_HUGEPAGES_NONE};
+  FEXCore::Config::Value<bool> NUMALocal{FEXCore::Config::CONFIG_NUMA_LOCAL, false};
+  FEXCore::Config::Value<uint8_t> RegisterAllocator{FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, FEXCore::Config::CONFIG_RA_GRAPH};
+  FEXCore::Config::Value<bool> X87ReducedPrecision{FEXCore::Config::CONFIG_X87_REDUCED_PRECISION, false};
 
   auto Args = FEX::ArgLoader::Get();
 
@@ -93,6 +97,10 @@ int main(int argc, char **argv, char **const envp) {
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_SMC_CHECKS, SMCChecksConfig());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_ABI_LOCAL_FLAGS, ABILocalFlags());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_ABI_NO_PF, AbiNoPF());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_HUGEPAGES, HugePages());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_NUMA_LOCAL, NUMALocal());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_REGISTER_ALLOCATOR, RegisterAllocator());
+  FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_X87_REDUCED_PRECISION, X87ReducedPrecision());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_DUMPIR, DumpIR());
   FEXCore::Config::SetConfig(CTX, FEXCore::Config::CONFIG_VALIDATE_IR_PARSER, true);
   FEXCore::Context::SetCustomCPUBackendFactory(CTX, HostFactory::CPUCreationFactory);
@@ -0,0 +1,102 @@
+#include "Interface/Core/BlockTable.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <vector>
+
+// Compares the LookupCache block table against the std::map it replaced
+// Usage: BlockTableBench [NumBlocks] [NumLookups]
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  double Seconds(Clock::time_point Begin, Clock::time_point End) {
+    return std::chrono::duration<double>(End - Begin).count();
+  }
+
+  void Report(const char *Name, const char *Op, size_t Count, double Time) {
+    printf("%-12s %-8s %12.0f/s  (%zu in %.3fs)\n", Name, Op, Count / Time, Count, Time);
+  }
+
+  template<typename InsertFn, typename FindFn, typename EraseFn>
+  void Run(const char *Name, const std::vector<uint64_t> &Blocks, const std::vector<uint64_t> &Lookups, InsertFn Insert, FindFn Find, EraseFn Erase) {
+    auto Begin = Clock::now();
+    for (auto Block : Blocks) {
+      Insert(Block, Block ^ 0xFFFF'0000);
+    }
+    auto End = Clock::now();
+    Report(Name, "insert", Blocks.size(), Seconds(Begin, End));
+
+    uint64_t Sum{};
+    Begin = Clock::now();
+    for (auto Block : Lookups) {
+      Sum += Find(Block);
+    }
+    End = Clock::now();
+    Report(Name, "lookup", Lookups.size(), Seconds(Begin, End));
+
+    // Invalidate half the blocks and re-add them, like SMC churn
+    Begin = Clock::now();
+    for (size_t i = 0; i < Blocks.size(); i += 2) {
+      Erase(Blocks[i]);
+      Insert(Blocks[i], Blocks[i]);
+    }
+    End = Clock::now();
+    Report(Name, "churn", Blocks.size() / 2, Seconds(Begin, End));
+
+    // Keep the lookups from being optimized out
+    printf("%-12s checksum %lx\n", Name, Sum);
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t NumBlocks = argc > 1 ? strtoull(argv[1], nullptr, 0) : 200'000;
+  size_t NumLookups = argc > 2 ? strtoull(argv[2], nullptr, 0) : 20'000'000;
+
+  // Guest blocks are clustered in a few mappings with variable sized gaps
+  std::mt19937_64 Rand{0x4645'58};
+  std::uniform_int_distribution<uint64_t> Gap{1, 64};
+  std::vector<uint64_t> Blocks;
+  Blocks.reserve(NumBlocks);
+  uint64_t Address = 0x40'0000;
+  for (size_t i = 0; i < NumBlocks; ++i) {
+    if ((i % 50'000) == 0) {
+      Address += 0x1000'0000;
+    }
+    Address += Gap(Rand);
+    Blocks.emplace_back(Address);
+  }
+
+  // Mostly hits with some misses
+  std::vector<uint64_t> Lookups;
+  Lookups.reserve(NumLookups);
+  std::uniform_int_distribution<size_t> Pick{0, NumBlocks - 1};
+  for (size_t i = 0; i < NumLookups; ++i) {
+    auto Block = Blocks[Pick(Rand)];
+    Lookups.emplace_back((i % 8) == 0 ? Block + 1 : Block);
+  }
+
+  {
+    std::map<uint64_t, uint64_t> Map;
+    Run("std::map", Blocks, Lookups,
+      [&](uint64_t Key, uint64_t Value) { Map.emplace(Key, Value); },
+      [&](uint64_t Key) -> uint64_t {
+        auto it = Map.find(Key);
+        return it != Map.end() ? it->second : 0;
+      },
+      [&](uint64_t Key) { Map.erase(Key); });
+  }
+
+  {
+    FEXCore::BlockTable Table;
+    Run("BlockTable", Blocks, Lookups,
+      [&](uint64_t Key, uint64_t Value) { Table.Insert(Key, Value); },
+      [&](uint64_t Key) -> uint64_t { return Table.Find(Key); },
+      [&](uint64_t Key) { Table.Erase(Key); });
+  }
+
+  return 0;
+}
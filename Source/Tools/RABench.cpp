@@ -0,0 +1,162 @@
+#include "Interface/IR/PassManager.h"
+#include "Interface/IR/Passes.h"
+#include "Interface/IR/Passes/RegisterAllocationPass.h"
+
+#include <FEXCore/IR/IR.h>
+#include <FEXCore/IR/IREmitter.h>
+#include <FEXCore/IR/IntrusiveIRList.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Compares the graph and linear scan register allocators on IR dumped with FEX_DUMPIR
+// Usage: RABench [-iIterations] <IR file>...
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  double Seconds(Clock::time_point Begin, Clock::time_point End) {
+    return std::chrono::duration<double>(End - Begin).count();
+  }
+
+  struct Result {
+    double Time{};
+    uint64_t SpillSlots{};
+    uint64_t Spills{};
+    uint64_t Fills{};
+    uint64_t Nodes{};
+  };
+
+  void Report(const char *Name, const char *File, Result const &Res, size_t Iterations) {
+    printf("%-8s %-40s %10.2fus  %6lu nodes  %4lu slots  %5lu spills  %5lu fills\n",
+      Name, File, Res.Time * 1'000'000.0 / Iterations, Res.Nodes, Res.SpillSlots, Res.Spills, Res.Fills);
+  }
+
+  // Same register file the Arm64 JIT hands to the allocator
+  void SetupRegisters(FEXCore::IR::RegisterAllocationPass *RAPass) {
+    constexpr uint32_t NumGPRs = 9;
+    constexpr uint32_t NumSRAGPRs = 16;
+    constexpr uint32_t NumFPRs = 12;
+    constexpr uint32_t NumSRAFPRs = 16;
+    constexpr uint32_t NumGPRPairs = 4;
+
+    RAPass->AllocateRegisterSet(NumGPRs + NumFPRs + NumGPRPairs, 6);
+    RAPass->AddRegisters(FEXCore::IR::GPRClass, NumGPRs);
+    RAPass->AddRegisters(FEXCore::IR::GPRFixedClass, NumSRAGPRs);
+    RAPass->AddRegisters(FEXCore::IR::FPRClass, NumFPRs);
+    RAPass->AddRegisters(FEXCore::IR::FPRFixedClass, NumSRAFPRs);
+    RAPass->AddRegisters(FEXCore::IR::GPRPairClass, NumGPRPairs);
+    RAPass->AddRegisters(FEXCore::IR::ComplexClass, 1);
+
+    for (uint32_t i = 0; i < NumGPRPairs; ++i) {
+      RAPass->AddRegisterConflict(FEXCore::IR::GPRClass, i * 2,     FEXCore::IR::GPRPairClass, i);
+      RAPass->AddRegisterConflict(FEXCore::IR::GPRClass, i * 2 + 1, FEXCore::IR::GPRPairClass, i);
+    }
+  }
+
+  template<typename CreateFn>
+  Result Run(std::string const &Code, size_t Iterations, CreateFn Create) {
+    Result Res{};
+
+    std::unique_ptr<FEXCore::IR::Pass> CompactionPass{FEXCore::IR::CreateIRCompaction()};
+    std::unique_ptr<FEXCore::IR::RegisterAllocationPass> RAPass{Create(CompactionPass.get())};
+    SetupRegisters(RAPass.get());
+
+    for (size_t i = 0; i < Iterations; ++i) {
+      // The allocator rewrites the IR when it spills, so every run starts from a fresh parse
+      std::istringstream in{Code};
+      std::unique_ptr<FEXCore::IR::IREmitter> IREmit{FEXCore::IR::Parse(&in)};
+      if (!IREmit) {
+        return Res;
+      }
+      CompactionPass->Run(IREmit.get());
+
+      auto Begin = Clock::now();
+      RAPass->Run(IREmit.get());
+      auto End = Clock::now();
+      Res.Time += Seconds(Begin, End);
+
+      if (i == 0) {
+        auto IR = IREmit->ViewIR();
+        Res.SpillSlots = RAPass->GetAllocationData()->SpillSlotCount;
+        Res.Nodes = IR.GetSSACount();
+        for (auto [CodeNode, IROp] : IR.GetAllCode()) {
+          Res.Spills += IROp->Op == FEXCore::IR::OP_SPILLREGISTER;
+          Res.Fills += IROp->Op == FEXCore::IR::OP_FILLREGISTER;
+        }
+      }
+    }
+
+    return Res;
+  }
+
+  void Accumulate(Result &Total, Result const &Res) {
+    Total.Time += Res.Time;
+    Total.SpillSlots += Res.SpillSlots;
+    Total.Spills += Res.Spills;
+    Total.Fills += Res.Fills;
+    Total.Nodes += Res.Nodes;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t Iterations = 100;
+  std::vector<const char*> Files;
+  for (int i = 1; i < argc; ++i) {
+    if (argv[i][0] == '-' && argv[i][1] == 'i') {
+      Iterations = strtoull(&argv[i][2], nullptr, 0);
+    }
+    else {
+      Files.emplace_back(argv[i]);
+    }
+  }
+
+  if (Files.empty() || Iterations == 0) {
+    fprintf(stderr, "Usage: %s [-iIterations] <IR file>...\n", argv[0]);
+    return 1;
+  }
+
+  auto CreateGraph = [](FEXCore::IR::Pass *CompactionPass) {
+    return FEXCore::IR::CreateRegisterAllocationPass(CompactionPass, false);
+  };
+
+  auto CreateLinear = [](FEXCore::IR::Pass *CompactionPass) {
+    return FEXCore::IR::CreateLinearScanRegisterAllocationPass(CompactionPass, false);
+  };
+
+  Result GraphTotal{};
+  Result LinearTotal{};
+
+  for (auto File : Files) {
+    std::ifstream fp(File, std::ifstream::binary);
+    if (!fp.is_open()) {
+      fprintf(stderr, "Couldn't open IR file '%s'\n", File);
+      continue;
+    }
+
+    std::stringstream Code;
+    Code << fp.rdbuf();
+
+    auto Graph = Run(Code.str(), Iterations, CreateGraph);
+    auto Linear = Run(Code.str(), Iterations, CreateLinear);
+    Report("graph", File, Graph, Iterations);
+    Report("linear", File, Linear, Iterations);
+
+    Accumulate(GraphTotal, Graph);
+    Accumulate(LinearTotal, Linear);
+  }
+
+  Report("graph", "total", GraphTotal, Iterations);
+  Report("linear", "total", LinearTotal, Iterations);
+  if (LinearTotal.Time > 0) {
+    printf("linear scan compiles %.2fx faster\n", GraphTotal.Time / LinearTotal.Time);
+  }
+
+  return 0;
+}
@@ -0,0 +1,73 @@
+#include <pthread.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+// Guest side thread churn, run it natively and under FEXLoader to compare
+// Usage: ThreadBench [NumThreads] [Concurrent]
+
+namespace {
+  using Clock = std::chrono::steady_clock;
+
+  double Seconds(Clock::time_point Begin, Clock::time_point End) {
+    return std::chrono::duration<double>(End - Begin).count();
+  }
+
+  void Report(const char *Name, size_t Count, double Time) {
+    printf("%-12s %12.0f threads/s  %8.1fus/thread  (%zu in %.3fs)\n", Name, Count / Time, Time * 1'000'000.0 / Count, Count, Time);
+  }
+
+  std::atomic<uint64_t> Work{};
+
+  void *ThreadFunc(void *Arg) {
+    // Touch a little code so every thread has to look up a few blocks
+    Work.fetch_add(reinterpret_cast<uintptr_t>(Arg), std::memory_order_relaxed);
+    return nullptr;
+  }
+}
+
+int main(int argc, char **argv) {
+  size_t NumThreads = argc > 1 ? strtoull(argv[1], nullptr, 0) : 2'000;
+  size_t Concurrent = argc > 2 ? strtoull(argv[2], nullptr, 0) : 8;
+
+  // One thread at a time, like a request handler spawning a worker
+  auto Begin = Clock::now();
+  for (size_t i = 0; i < NumThreads; ++i) {
+    pthread_t Thread;
+    if (pthread_create(&Thread, nullptr, ThreadFunc, reinterpret_cast<void*>(i)) != 0) {
+      perror("pthread_create");
+      return 1;
+    }
+    pthread_join(Thread, nullptr);
+  }
+  auto End = Clock::now();
+  Report("serial", NumThreads, Seconds(Begin, End));
+
+  // Batches of threads alive at the same time, like a pool being resized
+  std::vector<pthread_t> Threads(Concurrent);
+  size_t Created{};
+  Begin = Clock::now();
+  while (Created < NumThreads) {
+    size_t Batch = std::min(Concurrent, NumThreads - Created);
+    for (size_t i = 0; i < Batch; ++i) {
+      if (pthread_create(&Threads[i], nullptr, ThreadFunc, reinterpret_cast<void*>(Created + i)) != 0) {
+        perror("pthread_create");
+        return 1;
+      }
+    }
+    for (size_t i = 0; i < Batch; ++i) {
+      pthread_join(Threads[i], nullptr);
+    }
+    Created += Batch;
+  }
+  End = Clock::now();
+  Report("batched", NumThreads, Seconds(Begin, End));
+
+  // Keep the work from being optimized out
+  printf("checksum %lx\n", Work.load());
+  return 0;
+}
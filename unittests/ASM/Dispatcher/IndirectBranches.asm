@@ -0,0 +1,49 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x82000",
+    "RDX": "0x40"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Indirect calls and returns to targets spread over many pages
+; Every one of them goes through the dispatcher's lookup tables
+; Run with --huge-pages and ENABLE_TLB_STATS to compare TLB misses
+
+mov rsp, 0xe8000000
+
+xor rax, rax
+lea rdi, [rel targets]
+mov rcx, 256
+
+.outer:
+xor rdx, rdx
+
+.inner:
+mov rsi, rdx
+shl rsi, 12
+add rsi, rdi
+call rsi
+inc rdx
+cmp rdx, 64
+jne .inner
+
+dec rcx
+jnz .outer
+
+hlt
+
+; Each target adds its index + 1, 64 * 65 / 2 * 256 in total
+align 4096
+targets:
+%assign i 0
+%rep 64
+  add rax, i + 1
+  ret
+  align 4096
+%assign i i + 1
+%endrep
@@ -0,0 +1,56 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0x64",
+    "RBX": "0x1",
+    "RSI": "0xA"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+mov rsp, 0xe8000000
+
+xor rax, rax
+xor rbx, rbx
+xor rsi, rsi
+
+; Recursion deeper than the return stack, the oldest predictions get overwritten
+mov rcx, 100
+call recurse
+
+; Returns somewhere other than the call pushed, the prediction has to miss
+call swap_return
+mov rbx, 0xdead
+hlt
+
+after_swap:
+or rbx, 1
+
+; The same call and return over and over, once linked these skip the dispatcher
+mov rcx, 10
+.loop:
+call increment
+dec rcx
+jnz .loop
+
+hlt
+
+recurse:
+  add rax, 1
+  dec rcx
+  jz .done
+  call recurse
+.done:
+  ret
+
+swap_return:
+  lea rdx, [rel after_swap]
+  mov [rsp], rdx
+  ret
+
+increment:
+  add rsi, 1
+  ret
@@ -0,0 +1,77 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RBX": "0xa",
+    "RCX": "0x0",
+    "RDX": "0xb",
+    "RDI": "0x105",
+    "R8":  "0xa",
+    "R10": "0x1",
+    "R11": "0x1",
+    "R13": "0x5090d1115191d20",
+    "XMM0": ["0x5090d1115191d20", "0x0"]
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+mov rsp, 0xe0000010
+
+; Carry produced before a diamond and consumed after the merge
+mov rax, -1
+add rax, 2
+jz .carry_never
+mov rbx, 10
+jmp .carry_merge
+
+.carry_never:
+mov rbx, 20
+
+.carry_merge:
+mov rdx, 0
+adc rdx, rbx
+
+; Each arm writes a different value, the merge must not pick either one
+mov rsi, 5
+cmp rsi, 5
+jne .value_arm
+mov rdi, 0x100
+jmp .value_merge
+
+.value_arm:
+mov rdi, 0x200
+
+.value_merge:
+add rdi, rsi
+
+; Accumulators and partial writes carried around a loop
+mov rcx, 4
+mov r8, 0
+mov r10, 0
+mov r11, 0
+
+.gpr_loop:
+add r8, rcx
+mov r10b, cl
+dec rcx
+jnz .gpr_loop
+
+setz r11b
+
+; Vector register carried around a loop
+mov r12, 0x4142434445464748
+movq xmm0, r12
+mov rcx, 2
+
+.xmm_loop:
+paddq xmm0, xmm0
+dec rcx
+jnz .xmm_loop
+
+jmp .xmm_exit
+
+.xmm_exit:
+movq r13, xmm0
+hlt
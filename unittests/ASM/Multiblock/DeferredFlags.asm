@@ -0,0 +1,67 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RBX": "0x55",
+    "RDX": "0x101",
+    "RSI": "0x1",
+    "R9":  "0x85"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+mov rsp, 0xe0000010
+
+; CF, PF, AF, ZF, SF and OF
+%define ARITH_FLAGS 0x8d5
+
+; Every read is in another block than its producer, so the flags have to come from the context
+mov rax, -1
+add rax, 1
+jmp .pushf_block
+
+.pushf_block:
+pushfq
+pop rbx
+and rbx, ARITH_FLAGS
+
+; INC leaves the carry of the SUB before it alone
+mov rcx, 0
+sub rcx, 1
+jmp .inc_block
+
+.inc_block:
+inc rcx
+jmp .set_block
+
+.set_block:
+mov rdx, 0
+setc dl
+setz dh
+
+; 8bit compare, the flags only depend on the low byte
+mov eax, 0x110
+cmp al, 0x20
+jmp .cmp_block
+
+.cmp_block:
+pushfq
+pop r9
+and r9, ARITH_FLAGS
+
+; Signed overflow read by conditional branches
+mov rsi, 0
+mov r8, 0x7fffffffffffffff
+add r8, 1
+jo .of_set
+hlt
+
+.of_set:
+js .sf_set
+hlt
+
+.sf_set:
+mov rsi, 1
+hlt
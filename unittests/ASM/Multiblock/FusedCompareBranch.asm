@@ -0,0 +1,76 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "R8":  "0x1",
+    "R9":  "0x1",
+    "R10": "0x0",
+    "R11": "0x0",
+    "R12": "0x20",
+    "R15": "0x1"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+mov rsp, 0xe0000010
+mov r8, 0
+mov r9, 0
+mov r10, 0
+mov r11, 0
+mov r15, 0
+
+; 64bit SUB, 5 - 7 borrows and goes negative
+mov rax, 5
+sub rax, 7
+setb r8b
+setl r9b
+seta r10b
+setg r11b
+
+; 8bit AND, the sign is bit 7 of the result and CF/OF are cleared
+mov ecx, 0x80
+and cl, 0xff
+jl .and_less
+jmp .fail
+
+.and_less:
+mov ecx, 0x80
+or cl, 0
+jg .fail
+js .or_sign
+jmp .fail
+
+.or_sign:
+; 16bit XOR to zero
+mov edx, 0x1234
+xor dx, 0x1234
+jle .xor_le
+jmp .fail
+
+.xor_le:
+mov edx, 0x1234
+xor dx, 0x1234
+ja .fail
+
+; 16bit TEST on a negative value
+mov edx, 0x8000
+test dx, dx
+jns .fail
+
+; Two selects on the same 32bit SUB
+mov r12, 0x10
+mov r13, 0x20
+mov r14, 0x30
+mov esi, 10
+sub esi, 3
+cmovg r12, r13
+cmovb r12, r14
+
+mov r15, 1
+hlt
+
+.fail:
+mov r15, 0xdead
+hlt
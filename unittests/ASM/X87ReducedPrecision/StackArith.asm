@@ -0,0 +1,52 @@
+%ifdef CONFIG
+{
+  "RegData": {
+    "RAX": "0xc00c000000000000",
+    "RBX": "0x4",
+    "RCX": "0x1",
+    "R8":  "0x0"
+  },
+  "MemoryRegions": {
+    "0x100000000": "4096"
+  }
+}
+%endif
+
+; Runs with --x87-reduced-precision. Every result is exact as a double
+; so the 80bit modes give the same values.
+mov rdx, 0xe0000000
+
+mov rax, 0x3ff8000000000000 ; 1.5
+mov [rdx + 8 * 0], rax
+mov dword [rdx + 8 * 1], 3
+mov rax, 0x3ff0000000000000 ; 1.0
+mov [rdx + 8 * 2], rax
+
+fld qword [rdx + 8 * 0]   ; 1.5
+fiadd dword [rdx + 8 * 1] ; 4.5
+fld st0
+fmulp st1, st0            ; 20.25
+fsqrt                     ; 4.5
+fsub qword [rdx + 8 * 2]  ; 3.5
+fchs                      ; -3.5
+fst qword [rdx + 8 * 3]
+fabs                      ; 3.5
+
+; pi < 3.5, pops
+mov ecx, 0
+fldpi
+fcomip st0, st1
+setc cl
+
+; Rounds to nearest even, pops
+fistp dword [rdx + 8 * 4]
+
+; TOP is back where it started
+fnstsw ax
+and eax, 0x3800
+mov r8, rax
+
+mov rax, [rdx + 8 * 3]
+mov ebx, [rdx + 8 * 4]
+
+hlt